@@ -133,6 +133,11 @@ macro(write_configtable)
   string(APPEND out "Build with runtime logging    : ")
   check_on_or_off("NS3_LOG" "NS3_LOG")
 
+  if(NOT ("${NS3_LOG_STATIC_LEVEL}" STREQUAL ""))
+    string(REPLACE ";" ", " log_static_levels "${NS3_LOG_STATIC_LEVEL}")
+    string(APPEND out "Log levels compiled in        : ${log_static_levels}\n")
+  endif()
+
   string(APPEND out "Build version embedding       : ")
   check_on_or_off("NS3_ENABLE_BUILD_VERSION" "ENABLE_BUILD_VERSION")
 
@@ -166,6 +171,9 @@ macro(write_configtable)
   string(APPEND out "MPI Support                   : ")
   check_on_or_off("NS3_MPI" "MPI_FOUND")
 
+  string(APPEND out "Multithreaded simulation      : ")
+  check_on_or_off("NS3_MTP" "ENABLE_MTP")
+
   string(APPEND out "ns-3 Click Integration        : ")
   check_on_or_off("ON" "NS3_CLICK")
 
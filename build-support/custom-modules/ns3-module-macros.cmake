@@ -167,6 +167,29 @@ function(build_lib)
 
   add_library(ns3::${lib${BLIB_LIBNAME}} ALIAS ${lib${BLIB_LIBNAME}})
 
+  # Compile out the log statements more verbose than the static log level of
+  # the module
+  set(log_static_level ${NS3_LOG_STATIC_LEVEL_DEFAULT})
+  if(DEFINED NS3_LOG_STATIC_LEVEL_${BLIB_LIBNAME})
+    set(log_static_level ${NS3_LOG_STATIC_LEVEL_${BLIB_LIBNAME}})
+  endif()
+  set(log_static_definition)
+  if(NOT ("${log_static_level}" STREQUAL "all"))
+    string(TOUPPER ${log_static_level} log_static_level)
+    set(log_static_definition
+        NS3_LOG_STATIC_MASK=ns3::LOG_LEVEL_${log_static_level}
+    )
+    if(NOT ${XCODE})
+      target_compile_definitions(
+        ${lib${BLIB_LIBNAME}-obj} PRIVATE ${log_static_definition}
+      )
+    else()
+      target_compile_definitions(
+        ${lib${BLIB_LIBNAME}} PRIVATE ${log_static_definition}
+      )
+    endif()
+  endif()
+
   # Associate public headers with library for installation purposes
   set(config_headers)
   if("${BLIB_LIBNAME}" STREQUAL "core")
@@ -459,6 +482,7 @@ function(build_lib)
       endif()
       target_compile_definitions(
         ${test${BLIB_LIBNAME}} PRIVATE NS_TEST_SOURCEDIR="${FOLDER}/test"
+                                       ${log_static_definition}
       )
       if(${PRECOMPILE_HEADERS_ENABLED} AND (NOT ${BLIB_IGNORE_PCH}))
         target_precompile_headers(${test${BLIB_LIBNAME}} REUSE_FROM stdlib_pch)
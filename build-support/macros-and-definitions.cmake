@@ -825,6 +825,12 @@ macro(process_options)
     endif()
   endif()
 
+  set(ENABLE_MTP FALSE)
+  if(${NS3_MTP})
+    add_definitions(-DNS3_MTP)
+    set(ENABLE_MTP TRUE)
+  endif()
+
   mark_as_advanced(Boost_INCLUDE_DIR)
   find_package(Boost)
   if(${Boost_FOUND})
@@ -1118,6 +1124,33 @@ macro(process_options)
   if(${NS3_LOG} OR (${build_profile} STREQUAL "debug"))
     add_definitions(-DNS3_LOG_ENABLE)
   endif()
+
+  # Parse the log levels compiled in: a default level, and module=level
+  # overrides applied by build_lib
+  set(ns3_log_static_levels error warn info function logic debug all)
+  set(NS3_LOG_STATIC_LEVEL_DEFAULT all)
+  foreach(entry ${NS3_LOG_STATIC_LEVEL})
+    if(entry MATCHES "^([^=]+)=(.*)$")
+      set(log_static_module ${CMAKE_MATCH_1})
+      set(log_static_level ${CMAKE_MATCH_2})
+    else()
+      set(log_static_module)
+      set(log_static_level ${entry})
+    endif()
+    string(TOLOWER "${log_static_level}" log_static_level)
+    if(NOT (log_static_level IN_LIST ns3_log_static_levels))
+      message(
+        FATAL_ERROR
+          "Invalid NS3_LOG_STATIC_LEVEL entry ${entry}: "
+          "the level must be one of ${ns3_log_static_levels}"
+      )
+    endif()
+    if(log_static_module)
+      set(NS3_LOG_STATIC_LEVEL_${log_static_module} ${log_static_level})
+    else()
+      set(NS3_LOG_STATIC_LEVEL_DEFAULT ${log_static_level})
+    endif()
+  endforeach()
   # Force enable ns-3 asserts in debug builds and if requested for other build
   # types
   if(${NS3_ASSERT} OR (${build_profile} STREQUAL "debug"))
@@ -1153,6 +1186,10 @@ macro(process_options)
     list(REMOVE_ITEM libs_to_build mpi)
   endif()
 
+  if(NOT ${ENABLE_MTP})
+    list(REMOVE_ITEM libs_to_build mtp)
+  endif()
+
   if(NOT ${ENABLE_VISUALIZER})
     list(REMOVE_ITEM libs_to_build visualizer)
   endif()
@@ -67,9 +67,14 @@ std::string
 CallbackValue::SerializeToString(Ptr<const AttributeChecker> checker) const
 {
     NS_LOG_FUNCTION(this << checker);
-    std::ostringstream oss;
-    oss << PeekPointer(m_value.GetImpl());
-    return oss.str();
+    // A Callback stored inline gets a new impl at each GetImpl(), so
+    // serialize its type, which is the same for equal values.
+    Ptr<CallbackImplBase> impl = m_value.GetImpl();
+    if (!impl)
+    {
+        return "0";
+    }
+    return impl->GetTypeid();
 }
 
 bool
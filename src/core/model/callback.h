@@ -27,8 +27,12 @@
 #include "ptr.h"
 #include "simple-ref-count.h"
 
+#include <cstring>
 #include <functional>
 #include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -327,18 +331,21 @@ class CallbackImpl : public CallbackImplBase
     /** \copydoc GetTypeid() */
     static std::string DoGetTypeid()
     {
-        static std::vector<std::string> vec = {GetCppTypeid<R>(), GetCppTypeid<UArgs>()...};
-
-        static std::string id("CallbackImpl<");
-        for (auto& s : vec)
-        {
-            id.append(s + ",");
-        }
-        if (id.back() == ',')
-        {
-            id.pop_back();
-        }
-        id.push_back('>');
+        // Built once: appending at each call would make the type grow
+        static const std::string id = []() {
+            std::vector<std::string> vec = {GetCppTypeid<R>(), GetCppTypeid<UArgs>()...};
+            std::string id("CallbackImpl<");
+            for (auto& s : vec)
+            {
+                id.append(s + ",");
+            }
+            if (id.back() == ',')
+            {
+                id.pop_back();
+            }
+            id.push_back('>');
+            return id;
+        }();
 
         return id;
     }
@@ -351,22 +358,307 @@ class CallbackImpl : public CallbackImplBase
     std::vector<std::shared_ptr<CallbackComponentBase>> m_components;
 };
 
+/**
+ * \ingroup callbackimpl
+ * Abstract base class for CallbackInlineFunctor.
+ * Provides the operations on the callable object and bound arguments
+ * stored inline in a Callback: copy, destruction, equality test and
+ * conversion to a CallbackImpl.
+ *
+ * The implementations are stateless singletons, so that a Callback
+ * only holds a pointer to them next to its inline storage.
+ */
+class CallbackInlineImplBase
+{
+  public:
+    /**
+     * Copy construct the storage of a Callback.
+     * \param [in] dst The storage to construct.
+     * \param [in] src The storage to copy.
+     */
+    virtual void Copy(void* dst, const void* src) const = 0;
+    /**
+     * Destroy the storage of a Callback.
+     * \param [in] storage The storage.
+     */
+    virtual void Destroy(void* storage) const = 0;
+    /**
+     * Equality test
+     *
+     * \param [in] storage Our storage.
+     * \param [in] other The implementation of the other storage.
+     * \param [in] otherStorage The other storage.
+     * \return \c true if the callable objects and bound arguments are equal
+     */
+    virtual bool IsEqual(const void* storage,
+                         const CallbackInlineImplBase* other,
+                         const void* otherStorage) const = 0;
+    /**
+     * Build the CallbackImpl equivalent to a storage.
+     * \param [in] storage The storage.
+     * \return The CallbackImpl, with the same components.
+     */
+    virtual Ptr<CallbackImplBase> MakeImpl(const void* storage) const = 0;
+
+    /**
+     * \return \c true if the storage can be copied with memcpy and needs
+     * no destruction
+     */
+    bool IsTrivial() const
+    {
+        return m_trivial;
+    }
+
+  protected:
+    /**
+     * Constructor
+     * \param [in] trivial Whether the storage can be copied with memcpy and
+     *             needs no destruction.
+     */
+    constexpr CallbackInlineImplBase(bool trivial)
+        : m_trivial(trivial)
+    {
+    }
+
+    /** The singletons are never destroyed through this class */
+    ~CallbackInlineImplBase() = default;
+
+  private:
+    bool m_trivial; //!< Whether the storage is trivially copyable and destructible
+};
+
+/**
+ * \ingroup callbackimpl
+ * Abstract base class for CallbackInlineFunctor, with the signature of the Callback.
+ *
+ * \tparam R \explicit The return type of the Callback.
+ * \tparam UArgs \explicit The types of any arguments to the Callback.
+ */
+template <typename R, typename... UArgs>
+class CallbackInlineImpl : public CallbackInlineImplBase
+{
+  public:
+    /**
+     * Invoke the callable object stored in a Callback.
+     *
+     * \param [in] storage The storage.
+     * \param uargs The arguments to the Callback.
+     * \return Callback value
+     */
+    virtual R Invoke(const void* storage, UArgs&&... uargs) const = 0;
+
+  protected:
+    using CallbackInlineImplBase::CallbackInlineImplBase;
+    /** The singletons are never destroyed through this class */
+    ~CallbackInlineImpl() = default;
+};
+
+/**
+ * \ingroup callbackimpl
+ * Operations on the callable object and bound arguments of a given type,
+ * stored inline in a Callback.
+ *
+ * \tparam Storage \explicit The std::tuple of the callable object
+ *         and the bound arguments.
+ * \tparam R \explicit The return type of the Callback.
+ * \tparam UArgs \explicit The types of any arguments to the Callback.
+ */
+template <typename Storage, typename R, typename... UArgs>
+class CallbackInlineFunctor final : public CallbackInlineImpl<R, UArgs...>
+{
+  public:
+    /** \return The singleton for this Storage type */
+    static const CallbackInlineFunctor* Get()
+    {
+        // Constant initialized, since the constructor is constexpr
+        // and the destructor trivial
+        static const CallbackInlineFunctor functor;
+        return &functor;
+    }
+
+    void Copy(void* dst, const void* src) const override
+    {
+        new (dst) Storage(*static_cast<const Storage*>(src));
+    }
+
+    void Destroy(void* storage) const override
+    {
+        static_cast<Storage*>(storage)->~Storage();
+    }
+
+    R Invoke(const void* storage, UArgs&&... uargs) const override
+    {
+        return std::apply(
+            [&uargs...](const auto&... comps) -> R {
+                return DoInvoke(comps..., std::forward<UArgs>(uargs)...);
+            },
+            *static_cast<const Storage*>(storage));
+    }
+
+    bool IsEqual(const void* storage,
+                 const CallbackInlineImplBase* other,
+                 const void* otherStorage) const override
+    {
+        // other must have the same type and values as ours
+        return dynamic_cast<const CallbackInlineFunctor*>(other) != nullptr &&
+               DoIsEqual(*static_cast<const Storage*>(storage),
+                         *static_cast<const Storage*>(otherStorage),
+                         std::make_index_sequence<std::tuple_size_v<Storage>>{});
+    }
+
+    Ptr<CallbackImplBase> MakeImpl(const void* storage) const override
+    {
+        return std::apply(
+            [](const auto& func, const auto&... bargs) -> Ptr<CallbackImplBase> {
+                CallbackComponentVector components(
+                    {std::make_shared<CallbackComponent<std::decay_t<decltype(func)>>>(func),
+                     std::make_shared<CallbackComponent<std::decay_t<decltype(bargs)>>>(
+                         bargs)...});
+                return Create<CallbackImpl<R, UArgs...>>(
+                    [func, bargs...](auto&&... uargs) -> R {
+                        return DoInvoke(func, bargs..., std::forward<decltype(uargs)>(uargs)...);
+                    },
+                    components);
+            },
+            *static_cast<const Storage*>(storage));
+    }
+
+  private:
+    /** Constructor, private since the singleton is returned by Get() */
+    constexpr CallbackInlineFunctor()
+        : CallbackInlineImpl<R, UArgs...>(std::is_trivially_copy_constructible_v<Storage> &&
+                                          std::is_trivially_destructible_v<Storage>)
+    {
+    }
+
+    /**
+     * Invoke a callable object, discarding its result if the Callback returns void.
+     *
+     * \param [in] func The callable object.
+     * \param args The bound arguments followed by the arguments to the Callback.
+     * \return Callback value
+     */
+    template <typename F, typename... Args>
+    static R DoInvoke(const F& func, Args&&... args)
+    {
+        if constexpr (std::is_void_v<R>)
+        {
+            std::invoke(func, std::forward<Args>(args)...);
+        }
+        else
+        {
+            return std::invoke(func, std::forward<Args>(args)...);
+        }
+    }
+
+    /**
+     * Compare two storages, component by component.
+     *
+     * \param [in] a The first storage.
+     * \param [in] b The second storage.
+     * \return \c true if all the components are equal
+     */
+    template <std::size_t... INDEX>
+    static bool DoIsEqual(const Storage& a, const Storage& b, std::index_sequence<INDEX...>)
+    {
+        return (!(std::get<INDEX>(a) != std::get<INDEX>(b)) && ...);
+    }
+};
+
 /**
  * \ingroup callbackimpl
  * Base class for Callback class.
- * Provides pimpl abstraction.
+ * Provides pimpl abstraction, and the inline storage of the
+ * small callable objects and their bound arguments.
  */
 class CallbackBase
 {
+    template <typename R, typename... UArgs>
+    friend class Callback;
+
   public:
     CallbackBase()
-        : m_impl()
+        : m_impl(),
+          m_inline(nullptr)
+    {
+    }
+
+    /**
+     * Copy constructor
+     * \param [in] other The CallbackBase to copy
+     */
+    CallbackBase(const CallbackBase& other)
+        : m_impl(other.m_impl),
+          m_inline(nullptr)
+    {
+        CopyInline(other);
+    }
+
+    /**
+     * Move constructor.  The source is left null.
+     * \param [in] other The CallbackBase to move
+     */
+    CallbackBase(CallbackBase&& other)
+        : m_impl(other.m_impl),
+          m_inline(nullptr)
+    {
+        // The inline storage is copied, since a memberwise move would
+        // only copy its bytes
+        CopyInline(other);
+        other.m_impl = nullptr;
+        other.DestroyInline();
+    }
+
+    /**
+     * Copy assignment
+     * \param [in] other The CallbackBase to copy
+     * \return This CallbackBase
+     */
+    CallbackBase& operator=(const CallbackBase& other)
+    {
+        if (this != &other)
+        {
+            DestroyInline();
+            m_impl = other.m_impl;
+            CopyInline(other);
+        }
+        return *this;
+    }
+
+    /**
+     * Move assignment.  The source is left null.
+     * \param [in] other The CallbackBase to move
+     * \return This CallbackBase
+     */
+    CallbackBase& operator=(CallbackBase&& other)
+    {
+        if (this != &other)
+        {
+            DestroyInline();
+            m_impl = other.m_impl;
+            CopyInline(other);
+            other.m_impl = nullptr;
+            other.DestroyInline();
+        }
+        return *this;
+    }
+
+    /** Destructor */
+    ~CallbackBase()
     {
+        DestroyInline();
     }
 
-    /** \return The impl pointer */
+    /**
+     * \return The impl pointer.  For a Callback stored inline this is
+     * a new CallbackImpl, equal to the Callback.
+     */
     Ptr<CallbackImplBase> GetImpl() const
     {
+        if (m_inline != nullptr)
+        {
+            return m_inline->MakeImpl(m_storage);
+        }
         return m_impl;
     }
 
@@ -376,11 +668,53 @@ class CallbackBase
      * \param [in] impl The CallbackImplBase Ptr
      */
     CallbackBase(Ptr<CallbackImplBase> impl)
-        : m_impl(impl)
+        : m_impl(impl),
+          m_inline(nullptr)
+    {
+    }
+
+    /**
+     * Copy the inline storage of another CallbackBase, if any.
+     * Our inline storage must be empty.
+     * \param [in] other The CallbackBase to copy
+     */
+    void CopyInline(const CallbackBase& other)
+    {
+        if (other.m_inline == nullptr)
+        {
+            return;
+        }
+        if (other.m_inline->IsTrivial())
+        {
+            std::memcpy(m_storage, other.m_storage, INLINE_SIZE);
+        }
+        else
+        {
+            other.m_inline->Copy(m_storage, other.m_storage);
+        }
+        m_inline = other.m_inline;
+    }
+
+    /** Destroy the inline storage, if any */
+    void DestroyInline()
     {
+        if (m_inline != nullptr && !m_inline->IsTrivial())
+        {
+            m_inline->Destroy(m_storage);
+        }
+        m_inline = nullptr;
     }
 
-    Ptr<CallbackImplBase> m_impl; //!< the pimpl
+    /**
+     * Size of the inline storage: a pointer to a member function,
+     * the object pointer and two bound arguments of eight bytes.
+     */
+    static constexpr std::size_t INLINE_SIZE = 40;
+
+    Ptr<CallbackImplBase> m_impl;           //!< the pimpl, if not stored inline
+    const CallbackInlineImplBase* m_inline; //!< the inline storage operations, if used
+    /// the inline storage of the callable object and bound arguments
+    alignas(void*) unsigned char m_storage[INLINE_SIZE];
 };
 
 /**
@@ -418,6 +752,11 @@ class CallbackBase
  *   - the pimpl idiom: the Callback class is passed around by
  *     value and delegates the crux of the work to its pimpl
  *     pointer.
+ *   - a small buffer: a function, or a member function with its
+ *     object, and up to two small bound arguments are stored in the
+ *     Callback itself, so that building, copying and invoking them
+ *     does not allocate.  Bind() and the binding constructor always
+ *     build a pimpl.
  *   - a reference list implementation to implement the Callback's
  *     value semantics.
  *
@@ -464,9 +803,10 @@ class Callback : public CallbackBase
     template <typename... BArgs>
     Callback(const Callback<R, BArgs..., UArgs...>& cb, BArgs... bargs)
     {
-        auto f = cb.DoPeekImpl()->GetFunction();
+        const auto cbImpl = cb.DoGetImpl();
+        auto f = cbImpl->GetFunction();
 
-        CallbackComponentVector components(cb.DoPeekImpl()->GetComponents());
+        CallbackComponentVector components(cbImpl->GetComponents());
         components.insert(components.end(),
                           {std::make_shared<CallbackComponent<std::decay_t<BArgs>>>(bargs)...});
 
@@ -477,6 +817,50 @@ class Callback : public CallbackBase
             components);
     }
 
+  private:
+    /**
+     * Implementation of IS_INLINE.
+     *
+     * The other callable objects, lambdas in particular, are not examined
+     * any further: querying the traits of a lambda before std::function
+     * does makes the latter allocate it.
+     *
+     * \tparam T \explicit The type of the callable object
+     * \tparam BArgs \explicit The (decayed) types of the bound arguments
+     * \return \c true if the callable object and bound arguments are stored inline
+     */
+    template <typename T, typename... BArgs>
+    static constexpr bool DoIsInline()
+    {
+        if constexpr (std::is_function_v<std::remove_pointer_t<T>> ||
+                      std::is_member_function_pointer_v<T>)
+        {
+            using Storage = std::tuple<T, BArgs...>;
+            return sizeof(Storage) <= INLINE_SIZE && alignof(Storage) <= alignof(void*) &&
+                   std::is_invocable_r_v<R, const T&, const BArgs&..., UArgs...>;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+  public:
+    /**
+     * Whether a callable object and its bound arguments are stored inline,
+     * rather than in a CallbackImpl.
+     *
+     * They are if the callable object is a function pointer or a pointer to
+     * a member function, they fit in the inline storage and the callable
+     * object can be invoked with the bound arguments as const lvalues, so
+     * that invoking the Callback cannot change them.
+     *
+     * \tparam T \explicit The type of the callable object
+     * \tparam BArgs \explicit The (decayed) types of the bound arguments
+     */
+    template <typename T, typename... BArgs>
+    static constexpr bool IS_INLINE = DoIsInline<T, BArgs...>();
+
     /**
      * Construct from a function and bind some arguments (if any)
      *
@@ -494,23 +878,32 @@ class Callback : public CallbackBase
               typename... BArgs>
     Callback(T func, BArgs... bargs)
     {
-        // store the function in a std::function object
-        std::function<R(BArgs..., UArgs...)> f(func);
-
-        // The original function is comparable if it is a function pointer or
-        // a pointer to a member function or a pointer to a member data.
-        constexpr bool isComp =
-            std::is_function_v<std::remove_pointer_t<T>> || std::is_member_pointer_v<T>;
-
-        CallbackComponentVector components(
-            {std::make_shared<CallbackComponent<T, isComp>>(func),
-             std::make_shared<CallbackComponent<std::decay_t<BArgs>>>(bargs)...});
-
-        m_impl = Create<CallbackImpl<R, UArgs...>>(
-            [f, bargs...](auto&&... uargs) -> R {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
-            },
-            components);
+        if constexpr (IS_INLINE<T, BArgs...>)
+        {
+            using Storage = std::tuple<T, BArgs...>;
+            new (m_storage) Storage(func, bargs...);
+            m_inline = CallbackInlineFunctor<Storage, R, UArgs...>::Get();
+        }
+        else
+        {
+            // store the function in a std::function object
+            std::function<R(BArgs..., UArgs...)> f(func);
+
+            // The original function is comparable if it is a function pointer or
+            // a pointer to a member function or a pointer to a member data.
+            constexpr bool isComp =
+                std::is_function_v<std::remove_pointer_t<T>> || std::is_member_pointer_v<T>;
+
+            CallbackComponentVector components(
+                {std::make_shared<CallbackComponent<T, isComp>>(func),
+                 std::make_shared<CallbackComponent<std::decay_t<BArgs>>>(bargs)...});
+
+            m_impl = Create<CallbackImpl<R, UArgs...>>(
+                [f, bargs...](auto&&... uargs) -> R {
+                    return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
+                },
+                components);
+        }
     }
 
   private:
@@ -530,9 +923,10 @@ class Callback : public CallbackBase
     {
         Callback<R, std::tuple_element_t<sizeof...(bargs) + INDEX, std::tuple<UArgs...>>...> cb;
 
-        const auto f = DoPeekImpl()->GetFunction();
+        const auto impl = DoGetImpl();
+        const auto f = impl->GetFunction();
 
-        CallbackComponentVector components(DoPeekImpl()->GetComponents());
+        CallbackComponentVector components(impl->GetComponents());
         components.insert(components.end(),
                           {std::make_shared<CallbackComponent<std::decay_t<BoundArgs>>>(bargs)...});
 
@@ -568,12 +962,13 @@ class Callback : public CallbackBase
      */
     bool IsNull() const
     {
-        return (DoPeekImpl() == nullptr);
+        return (m_inline == nullptr && DoPeekImpl() == nullptr);
     }
 
     /** Discard the implementation, set it to null */
     void Nullify()
     {
+        DestroyInline();
         m_impl = nullptr;
     }
 
@@ -585,6 +980,11 @@ class Callback : public CallbackBase
      */
     R operator()(UArgs... uargs) const
     {
+        if (m_inline != nullptr)
+        {
+            return static_cast<const CallbackInlineImpl<R, UArgs...>*>(m_inline)
+                ->Invoke(m_storage, std::forward<UArgs>(uargs)...);
+        }
         return (*(DoPeekImpl()))(uargs...);
     }
 
@@ -596,7 +996,11 @@ class Callback : public CallbackBase
      */
     bool IsEqual(const CallbackBase& other) const
     {
-        return m_impl->IsEqual(other.GetImpl());
+        if (m_inline != nullptr && other.m_inline != nullptr)
+        {
+            return m_inline->IsEqual(m_storage, other.m_inline, other.m_storage);
+        }
+        return GetImpl()->IsEqual(other.GetImpl());
     }
 
     /**
@@ -607,7 +1011,12 @@ class Callback : public CallbackBase
      */
     bool CheckType(const CallbackBase& other) const
     {
-        return DoCheckType(other.GetImpl());
+        if (other.m_inline != nullptr)
+        {
+            return dynamic_cast<const CallbackInlineImpl<R, UArgs...>*>(other.m_inline) !=
+                   nullptr;
+        }
+        return DoCheckType(other.m_impl);
     }
 
     /**
@@ -618,10 +1027,9 @@ class Callback : public CallbackBase
      */
     bool Assign(const CallbackBase& other)
     {
-        auto otherImpl = other.GetImpl();
-        if (!DoCheckType(otherImpl))
+        if (!CheckType(other))
         {
-            std::string othTid = otherImpl->GetTypeid();
+            std::string othTid = other.GetImpl()->GetTypeid();
             std::string myTid = CallbackImpl<R, UArgs...>::DoGetTypeid();
             NS_FATAL_ERROR_CONT("Incompatible types. (feed to \"c++filt -t\" if needed)"
                                 << std::endl
@@ -629,17 +1037,24 @@ class Callback : public CallbackBase
                                 << "expected=" << myTid);
             return false;
         }
-        m_impl = const_cast<CallbackImplBase*>(PeekPointer(otherImpl));
+        CallbackBase::operator=(other);
         return true;
     }
 
   private:
-    /** \return The pimpl pointer */
+    /** \return The pimpl pointer, null if stored inline */
     CallbackImpl<R, UArgs...>* DoPeekImpl() const
     {
         return static_cast<CallbackImpl<R, UArgs...>*>(PeekPointer(m_impl));
     }
 
+    /** \return The pimpl pointer, built from the inline storage if needed */
+    Ptr<CallbackImpl<R, UArgs...>> DoGetImpl() const
+    {
+        return Ptr<CallbackImpl<R, UArgs...>>(
+            static_cast<CallbackImpl<R, UArgs...>*>(PeekPointer(GetImpl())));
+    }
+
     /**
      * Check for compatible types
      *
@@ -759,12 +1174,23 @@ MakeNullCallback()
  * \param [in] fnPtr Function pointer
  * \param [in] bargs Bound arguments
  * \return A bound Callback
+ *
+ * The bound arguments are stored in the Callback when they fit,
+ * see Callback::IS_INLINE.
  */
 template <typename R, typename... Args, typename... BArgs>
 auto
 MakeBoundCallback(R (*fnPtr)(Args...), BArgs&&... bargs)
 {
-    return Callback<R, Args...>(fnPtr).Bind(std::forward<BArgs>(bargs)...);
+    using BoundCallback = decltype(Callback<R, Args...>().Bind(std::forward<BArgs>(bargs)...));
+    if constexpr (BoundCallback::template IS_INLINE<R (*)(Args...), std::decay_t<BArgs>...>)
+    {
+        return BoundCallback(fnPtr, bargs...);
+    }
+    else
+    {
+        return Callback<R, Args...>(fnPtr).Bind(std::forward<BArgs>(bargs)...);
+    }
 }
 
 /**
@@ -780,19 +1206,38 @@ MakeBoundCallback(R (*fnPtr)(Args...), BArgs&&... bargs)
  *
  * Build Callbacks for class method members which take varying numbers of arguments
  * and potentially returning a value.
+ *
+ * The bound arguments are stored in the Callback when they fit,
+ * see Callback::IS_INLINE.
  */
 template <typename T, typename OBJ, typename R, typename... Args, typename... BArgs>
 auto
 MakeCallback(R (T::*memPtr)(Args...), OBJ objPtr, BArgs... bargs)
 {
-    return Callback<R, Args...>(memPtr, objPtr).Bind(bargs...);
+    using BoundCallback = decltype(Callback<R, Args...>().Bind(bargs...));
+    if constexpr (BoundCallback::template IS_INLINE<R (T::*)(Args...), OBJ, BArgs...>)
+    {
+        return BoundCallback(memPtr, objPtr, bargs...);
+    }
+    else
+    {
+        return Callback<R, Args...>(memPtr, objPtr).Bind(bargs...);
+    }
 }
 
 template <typename T, typename OBJ, typename R, typename... Args, typename... BArgs>
 auto
 MakeCallback(R (T::*memPtr)(Args...) const, OBJ objPtr, BArgs... bargs)
 {
-    return Callback<R, Args...>(memPtr, objPtr).Bind(bargs...);
+    using BoundCallback = decltype(Callback<R, Args...>().Bind(bargs...));
+    if constexpr (BoundCallback::template IS_INLINE<R (T::*)(Args...) const, OBJ, BArgs...>)
+    {
+        return BoundCallback(memPtr, objPtr, bargs...);
+    }
+    else
+    {
+        return Callback<R, Args...>(memPtr, objPtr).Bind(bargs...);
+    }
 }
 
 /**@}*/
@@ -25,8 +25,12 @@
 #include "object.h"
 #include "pointer.h"
 #include "singleton.h"
+#include "trace-source-accessor.h"
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
+#include <unordered_map>
 
 /**
  * \file
@@ -42,6 +46,247 @@ NS_LOG_COMPONENT_DEFINE("Config");
 namespace Config
 {
 
+/**
+ * \ingroup config-impl
+ * Index of the attributes and trace sources of each TypeId, including
+ * those of its parents, so that resolving a Config path does not search
+ * and copy the TypeId information at each object it visits.
+ */
+class TypeIdIndex : public Singleton<TypeIdIndex>
+{
+  public:
+    /** An attribute through which a Config path reaches other objects. */
+    struct PathAttribute
+    {
+        /** The attribute name. */
+        std::string name;
+        /** Whether the attribute holds an ObjectPtrContainer, or a Pointer. */
+        bool container;
+        /** The attribute found by TypeId::LookupAttributeByName() for this name. */
+        const TypeId::AttributeInformation* lookup;
+    };
+
+    /**
+     * Get the attributes through which a Config path item reaches other
+     * objects.
+     *
+     * \param [in] tid The TypeId of the object.
+     * \param [in] item The path item: an attribute name, or "*".
+     * \returns The attributes, in the order of TypeId::GetAttribute(),
+     *          from \pname{tid} up to its root parent.
+     */
+    const std::vector<PathAttribute>& GetPathAttributes(TypeId tid, const std::string& item);
+    /**
+     * Find an attribute by name, as TypeId::LookupAttributeByName() does.
+     *
+     * \param [in] tid The TypeId of the object.
+     * \param [in] name The attribute name.
+     * \returns The attribute, or \c nullptr if none.
+     */
+    const TypeId::AttributeInformation* LookupAttribute(TypeId tid, const std::string& name);
+    /**
+     * Find a trace source by name, as TypeId::LookupTraceSourceByName() does.
+     *
+     * \param [in] tid The TypeId of the object.
+     * \param [in] name The trace source name.
+     * \returns The trace source, or \c nullptr if none.
+     */
+    const TypeId::TraceSourceInformation* LookupTraceSource(TypeId tid, const std::string& name);
+
+  private:
+    /** The index of a TypeId. */
+    struct Tables
+    {
+        /** The number of attributes of the TypeId and its parents. */
+        std::size_t attributeN{0};
+        /** The number of trace sources of the TypeId and its parents. */
+        std::size_t traceSourceN{0};
+        /** The attributes found by name. */
+        std::unordered_map<std::string, TypeId::AttributeInformation> attributes;
+        /** The trace sources found by name. */
+        std::unordered_map<std::string, TypeId::TraceSourceInformation> traceSources;
+        /** All the attributes which reach other objects. */
+        std::vector<PathAttribute> pathAttributes;
+        /** The attributes which reach other objects, by name. */
+        std::unordered_map<std::string, std::vector<PathAttribute>> pathAttributesByName;
+    };
+
+    /**
+     * Get the index of a TypeId, building it the first time, or when
+     * attributes or trace sources were added since.
+     *
+     * \param [in] tid The TypeId.
+     * \returns The index.
+     */
+    Tables& GetTables(TypeId tid);
+
+    /** The index of each TypeId, by uid. */
+    std::vector<std::unique_ptr<Tables>> m_tables;
+
+}; // class TypeIdIndex
+
+TypeIdIndex::Tables&
+TypeIdIndex::GetTables(TypeId tid)
+{
+    std::size_t attributeN = 0;
+    std::size_t traceSourceN = 0;
+    TypeId parent = tid;
+    TypeId next = tid;
+    do
+    {
+        parent = next;
+        attributeN += parent.GetAttributeN();
+        traceSourceN += parent.GetTraceSourceN();
+        next = parent.GetParent();
+    } while (next != parent);
+
+    uint16_t uid = tid.GetUid();
+    if (uid >= m_tables.size())
+    {
+        m_tables.resize(uid + 1);
+    }
+    auto& tables = m_tables[uid];
+    if (tables && tables->attributeN == attributeN && tables->traceSourceN == traceSourceN)
+    {
+        return *tables;
+    }
+
+    NS_LOG_LOGIC("Index " << tid.GetName());
+    tables = std::make_unique<Tables>();
+    tables->attributeN = attributeN;
+    tables->traceSourceN = traceSourceN;
+    next = tid;
+    do
+    {
+        parent = next;
+        for (std::size_t i = 0; i < parent.GetAttributeN(); ++i)
+        {
+            auto info = parent.GetAttribute(i);
+            // The first attribute of a name, from tid up, shadows the others
+            tables->attributes.emplace(info.name, info);
+        }
+        for (std::size_t i = 0; i < parent.GetTraceSourceN(); ++i)
+        {
+            auto info = parent.GetTraceSource(i);
+            tables->traceSources.emplace(info.name, info);
+        }
+        next = parent.GetParent();
+    } while (next != parent);
+
+    next = tid;
+    do
+    {
+        parent = next;
+        for (std::size_t i = 0; i < parent.GetAttributeN(); ++i)
+        {
+            auto info = parent.GetAttribute(i);
+            bool pointer = dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
+            bool container =
+                dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
+            if (pointer || container)
+            {
+                PathAttribute attribute{info.name, container, &tables->attributes[info.name]};
+                tables->pathAttributes.push_back(attribute);
+                tables->pathAttributesByName[info.name].push_back(attribute);
+            }
+        }
+        next = parent.GetParent();
+    } while (next != parent);
+    return *tables;
+}
+
+const std::vector<TypeIdIndex::PathAttribute>&
+TypeIdIndex::GetPathAttributes(TypeId tid, const std::string& item)
+{
+    static const std::vector<PathAttribute> none;
+    Tables& tables = GetTables(tid);
+    if (item == "*")
+    {
+        return tables.pathAttributes;
+    }
+    auto it = tables.pathAttributesByName.find(item);
+    return it != tables.pathAttributesByName.end() ? it->second : none;
+}
+
+const TypeId::AttributeInformation*
+TypeIdIndex::LookupAttribute(TypeId tid, const std::string& name)
+{
+    Tables& tables = GetTables(tid);
+    auto it = tables.attributes.find(name);
+    return it != tables.attributes.end() ? &it->second : nullptr;
+}
+
+const TypeId::TraceSourceInformation*
+TypeIdIndex::LookupTraceSource(TypeId tid, const std::string& name)
+{
+    Tables& tables = GetTables(tid);
+    auto it = tables.traceSources.find(name);
+    return it != tables.traceSources.end() ? &it->second : nullptr;
+}
+
+/**
+ * \ingroup config-impl
+ * Set an attribute of an object, as ObjectBase::SetAttributeFailSafe()
+ * does, through the TypeIdIndex.
+ *
+ * \param [in] object The object.
+ * \param [in] name The attribute name.
+ * \param [in] value The value.
+ * \returns \c true if the attribute was set.
+ */
+static bool
+SetAttributeFailSafe(Ptr<Object> object, const std::string& name, const AttributeValue& value)
+{
+    auto info = TypeIdIndex::Get()->LookupAttribute(object->GetInstanceTypeId(), name);
+    if (info == nullptr)
+    {
+        return false;
+    }
+    if (info->supportLevel != TypeId::SUPPORTED)
+    {
+        // Let ObjectBase report the deprecated and obsolete attributes
+        return object->SetAttributeFailSafe(name, value);
+    }
+    if (!(info->flags & TypeId::ATTR_SET) || !info->accessor->HasSetter())
+    {
+        return false;
+    }
+    Ptr<AttributeValue> v = info->checker->CreateValidValue(value);
+    return v && info->accessor->Set(PeekPointer(object), *v);
+}
+
+/**
+ * \ingroup config-impl
+ * Connect a trace source of an object, as ObjectBase::TraceConnect() or
+ * ObjectBase::TraceConnectWithoutContext() does, through the TypeIdIndex.
+ *
+ * \param [in] object The object.
+ * \param [in] name The trace source name.
+ * \param [in] context The context, or \c nullptr to connect without context.
+ * \param [in] cb The sink.
+ * \returns \c true if the trace source was connected.
+ */
+static bool
+TraceConnect(Ptr<Object> object,
+             const std::string& name,
+             const std::string* context,
+             const CallbackBase& cb)
+{
+    auto info = TypeIdIndex::Get()->LookupTraceSource(object->GetInstanceTypeId(), name);
+    if (info == nullptr)
+    {
+        return false;
+    }
+    if (info->supportLevel != TypeId::SUPPORTED)
+    {
+        // Let ObjectBase report the deprecated and obsolete trace sources
+        return context ? object->TraceConnect(name, *context, cb)
+                       : object->TraceConnectWithoutContext(name, cb);
+    }
+    return context ? info->accessor->Connect(PeekPointer(object), *context, cb)
+                   : info->accessor->ConnectWithoutContext(PeekPointer(object), cb);
+}
+
 MatchContainer::MatchContainer()
 {
     NS_LOG_FUNCTION(this);
@@ -106,8 +351,11 @@ MatchContainer::Set(std::string name, const AttributeValue& value)
     for (auto tmp = Begin(); tmp != End(); ++tmp)
     {
         Ptr<Object> object = *tmp;
-        // Let ObjectBase::SetAttribute raise any errors
-        object->SetAttribute(name, value);
+        if (!SetAttributeFailSafe(object, name, value))
+        {
+            // Let ObjectBase::SetAttribute raise any errors
+            object->SetAttribute(name, value);
+        }
     }
 }
 
@@ -119,7 +367,7 @@ MatchContainer::SetFailSafe(std::string name, const AttributeValue& value)
     for (auto tmp = Begin(); tmp != End(); ++tmp)
     {
         Ptr<Object> object = *tmp;
-        ok |= object->SetAttributeFailSafe(name, value);
+        ok |= SetAttributeFailSafe(object, name, value);
     }
     return ok;
 }
@@ -143,7 +391,7 @@ MatchContainer::ConnectFailSafe(std::string name, const CallbackBase& cb)
     {
         Ptr<Object> object = m_objects[i];
         std::string ctx = m_contexts[i] + name;
-        ok |= object->TraceConnect(name, ctx, cb);
+        ok |= TraceConnect(object, name, &ctx, cb);
     }
     return ok;
 }
@@ -165,7 +413,7 @@ MatchContainer::ConnectWithoutContextFailSafe(std::string name, const CallbackBa
     for (auto tmp = Begin(); tmp != End(); ++tmp)
     {
         Ptr<Object> object = *tmp;
-        ok |= object->TraceConnectWithoutContext(name, cb);
+        ok |= TraceConnect(object, name, nullptr, cb);
     }
     return ok;
 }
@@ -309,104 +557,159 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 
 /**
  * \ingroup config-impl
- * Abstract class to parse Config paths into object references.
+ * Resolve Config paths into the objects they match.
+ *
+ * The paths are kept in a tree of their items, so that the paths sharing
+ * their leading items, such as the paths of the trace sources of all the
+ * devices of all the nodes, are resolved together in a single walk of
+ * the objects.
  */
 class Resolver
 {
   public:
+    /** Constructor. */
+    Resolver();
+
     /**
-     * Construct from a base Config path.
+     * Add a Config path to resolve.
      *
      * \param [in] path The Config path.
+     * \returns The index of the path.
      */
-    Resolver(std::string path);
-    /** Destructor. */
-    virtual ~Resolver();
+    std::size_t AddPath(std::string path);
 
     /**
-     * Parse the stored Config path into an object reference,
-     * beginning at the indicated root object.
+     * Resolve the Config paths, beginning at the indicated root object.
      *
      * \param [in] root The object corresponding to the current position in
      *                  in the Config path.
      */
     void Resolve(Ptr<Object> root);
 
+    /**
+     * Get the objects matched by a path.
+     *
+     * \param [in] path The index of the path.
+     * \returns The matching objects.
+     */
+    MatchContainer GetMatches(std::size_t path) const;
+
   private:
-    /** Ensure the Config path starts and ends with a '/'. */
-    void Canonicalize();
+    /** A node of the tree of path items. */
+    struct Node
+    {
+        /** The path item leading to this node. */
+        std::string item;
+        /** The TypeId of a "$" item, once looked up. */
+        TypeId tid;
+        /** Whether the TypeId of a "$" item was looked up. */
+        bool hasTid{false};
+        /** The child nodes. */
+        std::vector<std::size_t> children;
+        /** The paths which end at this node. */
+        std::vector<std::size_t> paths;
+    };
+
     /**
-     * Parse the next element in the Config path.
+     * Resolve the items below a node of the tree.
      *
-     * \param [in] path The remaining portion of the Config path.
+     * \param [in] node The node.
      * \param [in] root The object corresponding to the current position
      *                  in the Config path.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    void DoResolve(std::size_t node, Ptr<Object> root);
+    /**
+     * Resolve the item of a node of the tree.
+     *
+     * \param [in] node The node.
+     * \param [in] root The object corresponding to the position of the
+     *                  parent node in the Config path.
+     */
+    void DoResolveItem(std::size_t node, Ptr<Object> root);
     /**
-     * Parse an index on the Config path.
+     * Parse the indexes below a node of the tree.
      *
-     * \param [in] path The remaining Config path.
-     * \param [in,out] vector The resulting list of matching objects.
+     * \param [in] node The node.
+     * \param [in] container The objects which the indexes select.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    void DoArrayResolve(std::size_t node, const ObjectPtrContainerValue& container);
     /**
-     * Handle one object found on the path.
+     * Handle one object found at the end of paths.
      *
+     * \param [in] node The node where the paths end.
      * \param [in] object The current object on the Config path.
      */
-    void DoResolveOne(Ptr<Object> object);
+    void DoResolveOne(std::size_t node, Ptr<Object> object);
     /**
      * Get the current Config path.
      *
      * \returns The current Config path.
      */
     std::string GetResolvedPath() const;
-    /**
-     * Handle one found object.
-     *
-     * \param [in] object The found object.
-     * \param [in] path The matching Config path context.
-     */
-    virtual void DoOne(Ptr<Object> object, std::string path) = 0;
 
+    /** The tree of path items; the first node is the root. */
+    std::vector<Node> m_nodes;
     /** Current list of path tokens. */
     std::vector<std::string> m_workStack;
-    /** The Config path. */
-    std::string m_path;
+    /** The Config paths. */
+    std::vector<std::string> m_paths;
+    /** The objects matched by each path. */
+    std::vector<std::vector<Ptr<Object>>> m_objects;
+    /** The contexts of the objects matched by each path. */
+    std::vector<std::vector<std::string>> m_contexts;
 
 }; // class Resolver
 
-Resolver::Resolver(std::string path)
-    : m_path(path)
-{
-    NS_LOG_FUNCTION(this << path);
-    Canonicalize();
-}
-
-Resolver::~Resolver()
+Resolver::Resolver()
+    : m_nodes(1)
 {
     NS_LOG_FUNCTION(this);
 }
 
-void
-Resolver::Canonicalize()
+std::size_t
+Resolver::AddPath(std::string path)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << path);
+
+    std::size_t index = m_paths.size();
+    m_paths.push_back(path);
+    m_objects.emplace_back();
+    m_contexts.emplace_back();
 
     // ensure that we start and end with a '/'
-    std::string::size_type tmp = m_path.find('/');
-    if (tmp != 0)
+    if (path.find('/') != 0)
+    {
+        path = "/" + path;
+    }
+    if (path.find_last_of('/') != path.size() - 1)
     {
-        // no slash at start
-        m_path = "/" + m_path;
+        path = path + "/";
     }
-    tmp = m_path.find_last_of('/');
-    if (tmp != (m_path.size() - 1))
+
+    std::size_t node = 0;
+    std::string::size_type start = 1;
+    while (start < path.size())
     {
-        // no slash at end
-        m_path = m_path + "/";
+        std::string::size_type next = path.find('/', start);
+        std::string item = path.substr(start, next - start);
+        start = next + 1;
+
+        auto& children = m_nodes[node].children;
+        auto child = std::find_if(children.begin(), children.end(), [this, &item](auto c) {
+            return m_nodes[c].item == item;
+        });
+        if (child != children.end())
+        {
+            node = *child;
+            continue;
+        }
+        children.push_back(m_nodes.size());
+        node = m_nodes.size();
+        m_nodes.emplace_back();
+        m_nodes.back().item = item;
     }
+    m_nodes[node].paths.push_back(index);
+    return index;
 }
 
 void
@@ -414,7 +717,14 @@ Resolver::Resolve(Ptr<Object> root)
 {
     NS_LOG_FUNCTION(this << root);
 
-    DoResolve(m_path, root);
+    DoResolve(0, root);
+}
+
+MatchContainer
+Resolver::GetMatches(std::size_t path) const
+{
+    NS_LOG_FUNCTION(this << path);
+    return MatchContainer(m_objects[path], m_contexts[path], m_paths[path]);
 }
 
 std::string
@@ -431,39 +741,47 @@ Resolver::GetResolvedPath() const
 }
 
 void
-Resolver::DoResolveOne(Ptr<Object> object)
+Resolver::DoResolveOne(std::size_t node, Ptr<Object> object)
 {
-    NS_LOG_FUNCTION(this << object);
+    NS_LOG_FUNCTION(this << node << object);
 
-    NS_LOG_DEBUG("resolved=" << GetResolvedPath());
-    DoOne(object, GetResolvedPath());
+    std::string path = GetResolvedPath();
+    NS_LOG_DEBUG("resolved=" << path);
+    for (auto i : m_nodes[node].paths)
+    {
+        m_objects[i].push_back(object);
+        m_contexts[i].push_back(path);
+    }
 }
 
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Resolver::DoResolve(std::size_t node, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << node << root);
 
-    if (next == std::string::npos)
+    //
+    // If root is zero, we're beginning to see if we can use the object name
+    // service to resolve this path.  It is impossible to have a object name
+    // associated with the root of the object name service since that root
+    // is not an object.  This path must be referring to something in another
+    // namespace and it will have been found already since the name service
+    // is always consulted last.
+    //
+    if (root && !m_nodes[node].paths.empty())
     {
-        //
-        // If root is zero, we're beginning to see if we can use the object name
-        // service to resolve this path.  It is impossible to have a object name
-        // associated with the root of the object name service since that root
-        // is not an object.  This path must be referring to something in another
-        // namespace and it will have been found already since the name service
-        // is always consulted last.
-        //
-        if (root)
-        {
-            DoResolveOne(root);
-        }
-        return;
+        DoResolveOne(node, root);
+    }
+    for (std::size_t i = 0; i < m_nodes[node].children.size(); ++i)
+    {
+        DoResolveItem(m_nodes[node].children[i], root);
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+}
+
+void
+Resolver::DoResolveItem(std::size_t node, Ptr<Object> root)
+{
+    NS_LOG_FUNCTION(this << node << root);
+    const std::string& item = m_nodes[node].item;
 
     //
     // If root is zero, we're beginning to see if we can use the object name
@@ -472,16 +790,12 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     // the root of the "/Names" namespace, so we just ignore it and move on to
     // the next segment.
     //
-    if (!root)
+    if (!root && item.compare(0, 5, "Names") == 0)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
-        {
-            m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
-            m_workStack.pop_back();
-            return;
-        }
+        m_workStack.push_back(item);
+        DoResolve(node, root);
+        m_workStack.pop_back();
+        return;
     }
 
     //
@@ -495,7 +809,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
         m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
+        DoResolve(node, namedObject);
         m_workStack.pop_back();
         return;
     }
@@ -515,116 +829,98 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     if (dollarPos == 0)
     {
         // This is a call to GetObject
-        std::string tidString = item.substr(1, item.size() - 1);
-        NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
-        TypeId tid = TypeId::LookupByName(tidString);
-        Ptr<Object> object = root->GetObject<Object>(tid);
+        if (!m_nodes[node].hasTid)
+        {
+            m_nodes[node].tid = TypeId::LookupByName(item.substr(1, item.size() - 1));
+            m_nodes[node].hasTid = true;
+        }
+        NS_LOG_DEBUG("GetObject=" << item << " on path=" << GetResolvedPath());
+        Ptr<Object> object = root->GetObject<Object>(m_nodes[node].tid);
         if (!object)
         {
-            NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
+            NS_LOG_DEBUG("GetObject (" << item << ") failed on path=" << GetResolvedPath());
             return;
         }
         m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
+        DoResolve(node, object);
         m_workStack.pop_back();
     }
     else
     {
         // this is a normal attribute.
-        TypeId tid;
-        TypeId nextTid = root->GetInstanceTypeId();
-        bool foundMatch = false;
-
-        do
+        const auto& attributes =
+            TypeIdIndex::Get()->GetPathAttributes(root->GetInstanceTypeId(), item);
+        if (attributes.empty())
         {
-            tid = nextTid;
+            NS_LOG_DEBUG("Requested item=" << item
+                                           << " does not exist on path=" << GetResolvedPath());
+            return;
+        }
+        // Read the attribute as ObjectBase::GetAttribute() does
+        auto getAttribute = [&root](const TypeIdIndex::PathAttribute& attribute,
+                                    AttributeValue& value) {
+            const auto info = attribute.lookup;
+            if (info->supportLevel != TypeId::SUPPORTED || !(info->flags & TypeId::ATTR_GET) ||
+                !info->accessor->HasGetter() || !info->accessor->Get(PeekPointer(root), value))
+            {
+                // Let ObjectBase report the errors
+                root->GetAttribute(attribute.name, value);
+            }
+        };
 
-            for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+        for (const auto& attribute : attributes)
+        {
+            if (!attribute.container)
             {
-                TypeId::AttributeInformation info;
-                info = tid.GetAttribute(i);
-                if (info.name != item && item != "*")
+                NS_LOG_DEBUG("GetAttribute(ptr)=" << attribute.name
+                                                  << " on path=" << GetResolvedPath());
+                PointerValue pValue;
+                getAttribute(attribute, pValue);
+                Ptr<Object> object = pValue.Get<Object>();
+                if (!object)
                 {
+                    NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
+                                                            << GetResolvedPath()
+                                                            << "\""
+                                                               " but is null.");
                     continue;
                 }
-                // attempt to cast to a pointer checker.
-                const auto pChecker =
-                    dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
-                if (pChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name
-                                                      << " on path=" << GetResolvedPath());
-                    PointerValue pValue;
-                    root->GetAttribute(info.name, pValue);
-                    Ptr<Object> object = pValue.Get<Object>();
-                    if (!object)
-                    {
-                        NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
-                                                                << GetResolvedPath()
-                                                                << "\""
-                                                                   " but is null.");
-                        continue;
-                    }
-                    foundMatch = true;
-                    m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
-                    m_workStack.pop_back();
-                }
-                // attempt to cast to an object vector.
-                const auto vectorChecker =
-                    dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
-                if (vectorChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
-                    foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
-                    m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
-                    m_workStack.pop_back();
-                }
-                // this could be anything else and we don't know what to do with it.
-                // So, we just ignore it.
+                m_workStack.push_back(attribute.name);
+                DoResolve(node, object);
+                m_workStack.pop_back();
+            }
+            else
+            {
+                NS_LOG_DEBUG("GetAttribute(vector)=" << attribute.name
+                                                     << " on path=" << GetResolvedPath());
+                ObjectPtrContainerValue vector;
+                getAttribute(attribute, vector);
+                m_workStack.push_back(attribute.name);
+                DoArrayResolve(node, vector);
+                m_workStack.pop_back();
             }
-
-            nextTid = tid.GetParent();
-        } while (nextTid != tid);
-
-        if (!foundMatch)
-        {
-            NS_LOG_DEBUG("Requested item=" << item
-                                           << " does not exist on path=" << GetResolvedPath());
-            return;
         }
     }
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::size_t node, const ObjectPtrContainerValue& container)
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(!path.empty());
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
-    {
-        return;
-    }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    NS_LOG_FUNCTION(this << node << &container);
 
-    ArrayMatcher matcher = ArrayMatcher(item);
-    ObjectPtrContainerValue::Iterator it;
-    for (it = container.Begin(); it != container.End(); ++it)
+    for (std::size_t i = 0; i < m_nodes[node].children.size(); ++i)
     {
-        if (matcher.Matches((*it).first))
+        std::size_t child = m_nodes[node].children[i];
+        ArrayMatcher matcher = ArrayMatcher(m_nodes[child].item);
+        ObjectPtrContainerValue::Iterator it;
+        for (it = container.Begin(); it != container.End(); ++it)
         {
-            std::ostringstream oss;
-            oss << (*it).first;
-            m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
-            m_workStack.pop_back();
+            if (matcher.Matches((*it).first))
+            {
+                m_workStack.push_back(std::to_string((*it).first));
+                DoResolve(child, (*it).second);
+                m_workStack.pop_back();
+            }
         }
     }
 }
@@ -652,6 +948,12 @@ class ConfigImpl : public Singleton<ConfigImpl>
     void Disconnect(std::string path, const CallbackBase& cb);
     /** \copydoc ns3::Config::LookupMatches() */
     MatchContainer LookupMatches(std::string path);
+    /**
+     * Resolve the paths of a Resolver from each root, then from the
+     * "/Names" namespace.
+     * \param [in,out] resolver The Resolver.
+     */
+    void Resolve(Resolver& resolver) const;
 
     /** \copydoc ns3::Config::RegisterRootNamespaceObject() */
     void RegisterRootNamespaceObject(Ptr<Object> obj);
@@ -663,7 +965,6 @@ class ConfigImpl : public Singleton<ConfigImpl>
     /** \copydoc ns3::Config::GetRootNamespaceObject() */
     Ptr<Object> GetRootNamespaceObject(std::size_t i) const;
 
-  private:
     /**
      * Break a Config path into the leading path and the last leaf token.
      * \param [in] path The Config path.
@@ -673,6 +974,8 @@ class ConfigImpl : public Singleton<ConfigImpl>
      */
     void ParsePath(std::string path, std::string* root, std::string* leaf) const;
 
+  private:
+
     /** Container type to hold the root Config path tokens. */
     typedef std::vector<Ptr<Object>> Roots;
 
@@ -782,23 +1085,16 @@ ConfigImpl::LookupMatches(std::string path)
 {
     NS_LOG_FUNCTION(this << path);
 
-    class LookupMatchesResolver : public Resolver
-    {
-      public:
-        LookupMatchesResolver(std::string path)
-            : Resolver(path)
-        {
-        }
-
-        void DoOne(Ptr<Object> object, std::string path) override
-        {
-            m_objects.push_back(object);
-            m_contexts.push_back(path);
-        }
+    Resolver resolver;
+    std::size_t index = resolver.AddPath(path);
+    Resolve(resolver);
+    return resolver.GetMatches(index);
+}
 
-        std::vector<Ptr<Object>> m_objects;
-        std::vector<std::string> m_contexts;
-    } resolver = LookupMatchesResolver(path);
+void
+ConfigImpl::Resolve(Resolver& resolver) const
+{
+    NS_LOG_FUNCTION(this << &resolver);
 
     for (auto i = m_roots.begin(); i != m_roots.end(); i++)
     {
@@ -811,8 +1107,6 @@ ConfigImpl::LookupMatches(std::string path)
     // looking at the root of the "/Names" namespace during this go.
     //
     resolver.Resolve(nullptr);
-
-    return MatchContainer(resolver.m_objects, resolver.m_contexts, path);
 }
 
 void
@@ -851,6 +1145,124 @@ ConfigImpl::GetRootNamespaceObject(std::size_t i) const
     return m_roots[i];
 }
 
+/** The kinds of Batch operations. */
+enum BatchOperationKind
+{
+    BATCH_SET,                    //!< Config::Set()
+    BATCH_CONNECT,                //!< Config::Connect()
+    BATCH_CONNECT_WITHOUT_CONTEXT //!< Config::ConnectWithoutContext()
+};
+
+struct Batch::Operation
+{
+    BatchOperationKind kind;   //!< The kind of operation
+    std::string path;          //!< The Config path
+    Ptr<AttributeValue> value; //!< The value to set
+    CallbackBase cb;           //!< The callback to connect
+};
+
+Batch::Batch()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Batch::~Batch()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+Batch::Set(std::string path, const AttributeValue& value)
+{
+    NS_LOG_FUNCTION(this << path << &value);
+    m_operations.push_back({BATCH_SET, path, value.Copy(), CallbackBase()});
+}
+
+void
+Batch::Connect(std::string path, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(this << path << &cb);
+    m_operations.push_back({BATCH_CONNECT, path, nullptr, cb});
+}
+
+void
+Batch::ConnectWithoutContext(std::string path, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(this << path << &cb);
+    m_operations.push_back({BATCH_CONNECT_WITHOUT_CONTEXT, path, nullptr, cb});
+}
+
+std::size_t
+Batch::GetN() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_operations.size();
+}
+
+void
+Batch::Apply() const
+{
+    NS_LOG_FUNCTION(this);
+    DoApply(false);
+}
+
+bool
+Batch::ApplyFailSafe() const
+{
+    NS_LOG_FUNCTION(this);
+    return DoApply(true);
+}
+
+bool
+Batch::DoApply(bool failSafe) const
+{
+    NS_LOG_FUNCTION(this << failSafe);
+
+    ConfigImpl* impl = ConfigImpl::Get();
+    Resolver resolver;
+    std::vector<std::string> leaves;
+    for (const auto& operation : m_operations)
+    {
+        std::string root;
+        std::string leaf;
+        impl->ParsePath(operation.path, &root, &leaf);
+        resolver.AddPath(root);
+        leaves.push_back(leaf);
+    }
+    impl->Resolve(resolver);
+
+    bool ok = true;
+    for (std::size_t i = 0; i < m_operations.size(); ++i)
+    {
+        const Operation& operation = m_operations[i];
+        MatchContainer container = resolver.GetMatches(i);
+        bool done = false;
+        switch (operation.kind)
+        {
+        case BATCH_SET:
+            if (!failSafe)
+            {
+                container.Set(leaves[i], *operation.value);
+                continue;
+            }
+            done = container.SetFailSafe(leaves[i], *operation.value);
+            break;
+        case BATCH_CONNECT:
+            done = container.ConnectFailSafe(leaves[i], operation.cb);
+            break;
+        case BATCH_CONNECT_WITHOUT_CONTEXT:
+            done = container.ConnectWithoutContextFailSafe(leaves[i], operation.cb);
+            break;
+        }
+        if (!done && !failSafe)
+        {
+            NS_FATAL_ERROR("Could not connect callback to " << operation.path);
+        }
+        ok &= done;
+    }
+    return ok;
+}
+
 void
 Reset()
 {
@@ -361,6 +361,92 @@ class MatchContainer
  */
 MatchContainer LookupMatches(std::string path);
 
+/**
+ * \ingroup config
+ * \brief A list of Config operations carried out in a single walk of the
+ * objects.
+ *
+ * Each call to Config::Set() or Config::Connect() walks all the objects
+ * which its path goes through.  When many paths share their leading
+ * items, as the paths of the trace sources of all the devices of all the
+ * nodes do, adding them to a Batch resolves the shared items once:
+ *
+ * \code
+ *   Config::Batch batch;
+ *   batch.Connect("/NodeList/[0-999]/DeviceList/0/MacTx", MakeCallback(&MacTx));
+ *   batch.Connect("/NodeList/[0-999]/DeviceList/0/MacRx", MakeCallback(&MacRx));
+ *   batch.Set("/NodeList/[0-999]/DeviceList/0/Mtu", UintegerValue(1400));
+ *   batch.Apply();
+ * \endcode
+ *
+ * All the paths are resolved before the operations are carried out, in
+ * the order they were added.  The operations therefore must not change
+ * the objects which the other paths go through.
+ */
+class Batch
+{
+  public:
+    /** Constructor. */
+    Batch();
+    /** Destructor. */
+    ~Batch();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    /**
+     * Add the equivalent of Config::Set().
+     * \param [in] path A path to match attributes.
+     * \param [in] value The value to set in all matching attributes.
+     */
+    void Set(std::string path, const AttributeValue& value);
+    /**
+     * Add the equivalent of Config::Connect().
+     * \param [in] path A path to match trace sources.
+     * \param [in] cb The callback to connect to the matching trace sources.
+     */
+    void Connect(std::string path, const CallbackBase& cb);
+    /**
+     * Add the equivalent of Config::ConnectWithoutContext().
+     * \param [in] path A path to match trace sources.
+     * \param [in] cb The callback to connect to the matching trace sources.
+     */
+    void ConnectWithoutContext(std::string path, const CallbackBase& cb);
+
+    /** \returns The number of operations. */
+    std::size_t GetN() const;
+
+    /**
+     * Carry out the operations.  As Config::Set() and Config::Connect(),
+     * this method raises a fatal error if an attribute cannot be set, or
+     * if no trace source matches a Connect() path.
+     */
+    void Apply() const;
+    /**
+     * Carry out the operations, as Config::SetFailSafe() and
+     * Config::ConnectFailSafe() do.
+     * \returns \c true if every operation matched an attribute or a trace
+     *          source.
+     */
+    bool ApplyFailSafe() const;
+
+  private:
+    /** An operation. */
+    struct Operation;
+
+    /**
+     * Carry out the operations.
+     * \param [in] failSafe Whether to carry out the fail safe operations.
+     * \returns \c true if every operation matched an attribute or a trace
+     *          source.
+     */
+    bool DoApply(bool failSafe) const;
+
+    /** The operations. */
+    std::vector<Operation> m_operations;
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -19,12 +19,19 @@
 
 #include "default-simulator-impl.h"
 
+#include "abort.h"
 #include "assert.h"
+#include "boolean.h"
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <fstream>
+#include <iostream>
 
 /**
  * \file
@@ -45,10 +52,23 @@ NS_OBJECT_ENSURE_REGISTERED(DefaultSimulatorImpl);
 TypeId
 DefaultSimulatorImpl::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
-                            .SetParent<SimulatorImpl>()
-                            .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+    static TypeId tid =
+        TypeId("ns3::DefaultSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Core")
+            .AddConstructor<DefaultSimulatorImpl>()
+            .AddAttribute("EventProfiling",
+                          "Record the wall-clock time of each event, by event function type "
+                          "and by context, and print the profile at Simulator::Destroy().",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&DefaultSimulatorImpl::m_eventProfiling),
+                          MakeBooleanChecker())
+            .AddAttribute("EventProfilingFile",
+                          "The file the event profile is written to; empty for the standard "
+                          "error.",
+                          StringValue(""),
+                          MakeStringAccessor(&DefaultSimulatorImpl::m_eventProfilingFile),
+                          MakeStringChecker());
     return tid;
 }
 
@@ -62,8 +82,18 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
+    m_eventsWithContextRing =
+        std::make_unique<EventWithContextSlot[]>(EVENTS_WITH_CONTEXT_RING_SIZE);
+    for (uint64_t i = 0; i < EVENTS_WITH_CONTEXT_RING_SIZE; ++i)
+    {
+        m_eventsWithContextRing[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_eventsWithContextTail = 0;
+    m_eventsWithContextHead = 0;
+    m_eventsWithContextOverflow = false;
     m_mainThreadId = std::this_thread::get_id();
+    m_eventProfiling = false;
+    m_batchNext = 0;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl()
@@ -100,6 +130,22 @@ DefaultSimulatorImpl::Destroy()
             ev->Invoke();
         }
     }
+
+    if (m_profiler)
+    {
+        if (m_eventProfilingFile.empty())
+        {
+            m_profiler->Print(std::clog);
+        }
+        else
+        {
+            std::ofstream os(m_eventProfilingFile);
+            NS_ABORT_MSG_UNLESS(os.is_open(),
+                                "Cannot open event profiling file " << m_eventProfilingFile);
+            m_profiler->Print(os);
+        }
+        m_profiler = nullptr;
+    }
 }
 
 void
@@ -126,10 +172,17 @@ DefaultSimulatorImpl::GetSystemId() const
     return 0;
 }
 
+template <bool PROFILE>
 void
 DefaultSimulatorImpl::ProcessOneEvent()
 {
-    Scheduler::Event next = m_events->RemoveNext();
+    if (m_batchNext == m_batch.size())
+    {
+        m_batch.clear();
+        m_batchNext = 0;
+        m_events->RemoveNextBatch(m_batch);
+    }
+    Scheduler::Event next = m_batch[m_batchNext++];
 
     PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
 
@@ -141,22 +194,107 @@ DefaultSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if constexpr (PROFILE)
+    {
+        auto start = std::chrono::steady_clock::now();
+        next.impl->Invoke();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+        m_profiler->Record(next.impl, next.key.m_context, ns);
+    }
+    else
+    {
+        next.impl->Invoke();
+    }
     next.impl->Unref();
 
     ProcessEventsWithContext();
 }
 
+bool
+DefaultSimulatorImpl::HasNextEvent() const
+{
+    return m_batchNext < m_batch.size() || !m_events->IsEmpty();
+}
+
 bool
 DefaultSimulatorImpl::IsFinished() const
 {
-    return m_events->IsEmpty() || m_stop;
+    return !HasNextEvent() || m_stop;
+}
+
+bool
+DefaultSimulatorImpl::PushEventWithContext(const EventWithContext& ev)
+{
+    uint64_t pos = m_eventsWithContextTail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        EventWithContextSlot& slot =
+            m_eventsWithContextRing[pos & (EVENTS_WITH_CONTEXT_RING_SIZE - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence - pos);
+        if (diff == 0)
+        {
+            // the slot is free for this position, try to claim it
+            if (m_eventsWithContextTail.compare_exchange_weak(pos,
+                                                              pos + 1,
+                                                              std::memory_order_relaxed))
+            {
+                slot.event = ev;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            // pos was reloaded by the failed compare-and-swap
+        }
+        else if (diff < 0)
+        {
+            // the main thread has not read this slot yet: the ring is full
+            return false;
+        }
+        else
+        {
+            // another producer claimed this position
+            pos = m_eventsWithContextTail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void
+DefaultSimulatorImpl::InsertEventWithContext(const EventWithContext& ev)
+{
+    Scheduler::Event event;
+    event.impl = ev.event;
+    event.key.m_ts = m_currentTs + ev.timestamp;
+    event.key.m_context = ev.context;
+    event.key.m_uid = m_uid;
+    m_uid++;
+    m_unscheduledEvents++;
+    m_events->Insert(event);
 }
 
 void
 DefaultSimulatorImpl::ProcessEventsWithContext()
 {
-    if (m_eventsWithContextEmpty)
+    // Drain the ring up to the first slot which is not written yet
+    while (true)
+    {
+        EventWithContextSlot& slot =
+            m_eventsWithContextRing[m_eventsWithContextHead & (EVENTS_WITH_CONTEXT_RING_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_eventsWithContextHead + 1)
+        {
+            break;
+        }
+        InsertEventWithContext(slot.event);
+        slot.sequence.store(m_eventsWithContextHead + EVENTS_WITH_CONTEXT_RING_SIZE,
+                            std::memory_order_release);
+        m_eventsWithContextHead++;
+    }
+
+    // The overflow list holds events more recent than those in the ring:
+    // wait until a producer finishes writing the slot it claimed
+    if (!m_eventsWithContextOverflow.load(std::memory_order_acquire) ||
+        m_eventsWithContextTail.load(std::memory_order_acquire) != m_eventsWithContextHead)
     {
         return;
     }
@@ -166,20 +304,11 @@ DefaultSimulatorImpl::ProcessEventsWithContext()
     {
         std::unique_lock lock{m_eventsWithContextMutex};
         m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
+        m_eventsWithContextOverflow = false;
     }
-    while (!eventsWithContext.empty())
+    for (const auto& ev : eventsWithContext)
     {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
-        Scheduler::Event ev;
-        ev.impl = event.event;
-        ev.key.m_ts = m_currentTs + event.timestamp;
-        ev.key.m_context = event.context;
-        ev.key.m_uid = m_uid;
-        m_uid++;
-        m_unscheduledEvents++;
-        m_events->Insert(ev);
+        InsertEventWithContext(ev);
     }
 }
 
@@ -192,10 +321,33 @@ DefaultSimulatorImpl::Run()
     ProcessEventsWithContext();
     m_stop = false;
 
-    while (!m_events->IsEmpty() && !m_stop)
+    if (m_eventProfiling && !m_profiler)
+    {
+        m_profiler = std::make_unique<EventProfiler>();
+    }
+
+    if (m_profiler)
+    {
+        while (HasNextEvent() && !m_stop)
+        {
+            ProcessOneEvent<true>();
+        }
+    }
+    else
+    {
+        while (HasNextEvent() && !m_stop)
+        {
+            ProcessOneEvent<false>();
+        }
+    }
+
+    // Give the events of an interrupted batch back to the scheduler
+    for (; m_batchNext < m_batch.size(); ++m_batchNext)
     {
-        ProcessOneEvent();
+        m_events->Insert(m_batch[m_batchNext]);
     }
+    m_batch.clear();
+    m_batchNext = 0;
 
     // If the simulator stopped naturally by lack of events, make a
     // consistency test to check that we didn't lose any events along the way.
@@ -264,10 +416,17 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         // Current time added in ProcessEventsWithContext()
         ev.timestamp = delay.GetTimeStep();
         ev.event = event;
+        // Once a producer had to use the overflow list, the others must
+        // use it too so that the ring does not overtake the older events
+        if (!m_eventsWithContextOverflow.load(std::memory_order_acquire) &&
+            PushEventWithContext(ev))
+        {
+            return;
+        }
         {
             std::unique_lock lock{m_eventsWithContextMutex};
             m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
+            m_eventsWithContextOverflow = true;
         }
     }
 }
@@ -338,7 +497,22 @@ DefaultSimulatorImpl::Remove(const EventId& id)
     event.key.m_ts = id.GetTs();
     event.key.m_context = id.GetContext();
     event.key.m_uid = id.GetUid();
-    m_events->Remove(event);
+    // The event may be in the batch being run
+    auto it = m_batch.end();
+    if (id.GetTs() == m_currentTs)
+    {
+        it = std::find_if(m_batch.begin() + m_batchNext, m_batch.end(), [&id](const auto& ev) {
+            return ev.key.m_uid == id.GetUid();
+        });
+    }
+    if (it != m_batch.end())
+    {
+        m_batch.erase(it);
+    }
+    else
+    {
+        m_events->Remove(event);
+    }
     event.impl->Cancel();
     // whenever we remove an event from the event list, we have to unref it.
     event.impl->Unref();
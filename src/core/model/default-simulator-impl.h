@@ -20,11 +20,16 @@
 #ifndef DEFAULT_SIMULATOR_IMPL_H
 #define DEFAULT_SIMULATOR_IMPL_H
 
+#include "event-profiler.h"
+#include "scheduler.h"
 #include "simulator-impl.h"
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 /**
  * \file
@@ -35,13 +40,20 @@
 namespace ns3
 {
 
-// Forward
-class Scheduler;
-
 /**
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * Run() removes all the events which share the earliest timestamp from
+ * the scheduler at once, with Scheduler::RemoveNextBatch(), then runs
+ * them from a contiguous buffer.  Events scheduled meanwhile for the
+ * same timestamp get a larger uid, hence run after the batch, so the
+ * order of the events is unchanged.
+ *
+ * When the EventProfiling attribute is set, the wall-clock time of each
+ * event is recorded in an EventProfiler, whose report is printed at
+ * Simulator::Destroy().  Otherwise the event loop is left untouched.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -81,10 +93,19 @@ class DefaultSimulatorImpl : public SimulatorImpl
   private:
     void DoDispose() override;
 
-    /** Process the next event. */
+    /**
+     * Process the next event.
+     * \tparam PROFILE \c true to record the event in m_profiler.
+     */
+    template <bool PROFILE>
     void ProcessOneEvent();
     /** Move events from a different context into the main event queue. */
     void ProcessEventsWithContext();
+    /**
+     * Check whether there is an event left to run.
+     * \returns \c true if m_batch or m_events holds an event.
+     */
+    bool HasNextEvent() const;
 
     /** Wrap an event with its execution context. */
     struct EventWithContext
@@ -97,15 +118,59 @@ class DefaultSimulatorImpl : public SimulatorImpl
         EventImpl* event;
     };
 
+    /**
+     * A slot of the ring of events from a different context.
+     *
+     * The sequence number tells who owns the slot: it is equal to the
+     * enqueue position when the slot is free for that position, and to
+     * the position plus one once the event has been written.
+     */
+    struct EventWithContextSlot
+    {
+        /** The slot sequence number. */
+        std::atomic<uint64_t> sequence;
+        /** The event. */
+        EventWithContext event;
+    };
+
+    /** Number of slots of the ring, a power of two. */
+    static constexpr uint64_t EVENTS_WITH_CONTEXT_RING_SIZE = 4096;
+
+    /**
+     * Append an event to the ring, without blocking.
+     * \param [in] ev The event.
+     * \returns \c false if the ring is full.
+     */
+    bool PushEventWithContext(const EventWithContext& ev);
+    /**
+     * Insert an event from a different context in the main event queue.
+     * \param [in] ev The event.
+     */
+    void InsertEventWithContext(const EventWithContext& ev);
+
+    /**
+     * Bounded multiple-producer, single-consumer ring of the events from
+     * a different context.  The threads which call ScheduleWithContext()
+     * claim a slot with a compare-and-swap on the enqueue position, the
+     * main thread drains the ring in ProcessEventsWithContext().
+     */
+    std::unique_ptr<EventWithContextSlot[]> m_eventsWithContextRing;
+    /** Next ring position to be written by a producer thread. */
+    alignas(64) std::atomic<uint64_t> m_eventsWithContextTail;
+    /** Next ring position to be read by the main thread. */
+    alignas(64) uint64_t m_eventsWithContextHead;
+
     /** Container type for the events from a different context. */
     typedef std::list<EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * The events from a different context which did not fit in the ring.
+     * Once a producer has used this list, all the producers append to it
+     * until the main thread drains it, to preserve the order of the events
+     * of each producer.
      */
-    bool m_eventsWithContextEmpty;
+    EventsWithContext m_eventsWithContext;
+    /** Flag \c true if m_eventsWithContext may not be empty. */
+    std::atomic<bool> m_eventsWithContextOverflow;
     /** Mutex to control access to the list of events with context. */
     std::mutex m_eventsWithContextMutex;
 
@@ -117,6 +182,14 @@ class DefaultSimulatorImpl : public SimulatorImpl
     bool m_stop;
     /** The event priority queue. */
     Ptr<Scheduler> m_events;
+    /**
+     * The events removed at once from m_events because they share the
+     * earliest timestamp; those from m_batchNext on have not run yet.
+     * The buffer is only filled while Run() is executing.
+     */
+    std::vector<Scheduler::Event> m_batch;
+    /** Index in m_batch of the next event to run. */
+    std::size_t m_batchNext;
 
     /** Next event unique id. */
     uint32_t m_uid;
@@ -136,6 +209,13 @@ class DefaultSimulatorImpl : public SimulatorImpl
 
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
+
+    /** Flag \c true to profile the events. */
+    bool m_eventProfiling;
+    /** The file the event profile is written to, empty for std::clog. */
+    std::string m_eventProfilingFile;
+    /** The event profiler, only allocated when profiling. */
+    std::unique_ptr<EventProfiler> m_profiler;
 };
 
 } // namespace ns3
@@ -19,8 +19,14 @@
 
 #include "event-impl.h"
 
+#include "boolean.h"
+#include "global-value.h"
 #include "log.h"
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 /**
  * \file
  * \ingroup events
@@ -32,13 +38,306 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+/**
+ * \ingroup events
+ * \anchor GlobalValueEventMemoryPool
+ * Serve events from the EventImpl memory pool.
+ *
+ * This is read once, when the first event is created.
+ */
+static GlobalValue g_eventMemoryPool("EventMemoryPool",
+                                     "Allocate events from a pool of fixed size blocks",
+                                     BooleanValue(true),
+                                     MakeBooleanChecker());
+
+namespace
+{
+
+/** Size class granularity, also the block alignment. */
+constexpr std::size_t POOL_GRANULARITY = 16;
+/** Number of size classes; larger events use the global heap. */
+constexpr std::size_t POOL_CLASSES = 16;
+/** Size of the chunks carved into blocks. */
+constexpr std::size_t POOL_CHUNK_SIZE = 32 * 1024;
+/** Number of blocks moved at once between a thread cache and the depot. */
+constexpr uint32_t POOL_BATCH = 64;
+
+/**
+ * Map an event size to its size class.
+ * \param [in] size The event size.
+ * \returns The size class index.
+ */
+inline std::size_t
+SizeClass(std::size_t size)
+{
+    return (size - 1) / POOL_GRANULARITY;
+}
+
+/** A free block, linked through its first bytes. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< Next free block.
+};
+
+/** A list of free blocks of a single size class. */
+struct FreeList
+{
+    FreeBlock* head{nullptr}; //!< First free block.
+    uint32_t count{0};        //!< Number of free blocks.
+
+    /**
+     * Add a block.
+     * \param [in] p The block.
+     */
+    void Push(void* p)
+    {
+        auto block = static_cast<FreeBlock*>(p);
+        block->next = head;
+        head = block;
+        ++count;
+    }
+
+    /**
+     * Remove a block.
+     * \returns The block.
+     */
+    void* Pop()
+    {
+        FreeBlock* block = head;
+        head = block->next;
+        --count;
+        return block;
+    }
+};
+
+/**
+ * The shared part of the event memory pool: the chunks, and the free
+ * blocks which are not held by any thread cache.
+ *
+ * Blocks are counted as outstanding from the moment they leave the depot
+ * until they are returned to it, so the chunks can only be released when
+ * no block is in use or parked in a thread cache.
+ */
+class Depot
+{
+  public:
+    /** Destructor: release the chunks if no block is outstanding. */
+    ~Depot()
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_outstanding == 0)
+        {
+            FreeChunks();
+        }
+        // Otherwise leak the chunks: a block may still be freed later on.
+        g_destroyed = true;
+    }
+
+    /**
+     * Move up to POOL_BATCH blocks of a size class into a thread cache.
+     * \param [in] sizeClass The size class.
+     * \param [in,out] cache The thread cache.
+     * \returns The number of chunks allocated from the heap.
+     */
+    uint32_t Refill(std::size_t sizeClass, FreeList& cache)
+    {
+        std::lock_guard lock(m_mutex);
+        m_releasing = false;
+        uint32_t chunks = 0;
+        FreeList& list = m_free[sizeClass];
+        if (list.count == 0)
+        {
+            std::size_t blockSize = (sizeClass + 1) * POOL_GRANULARITY;
+            auto chunk = static_cast<char*>(::operator new(POOL_CHUNK_SIZE));
+            m_chunks.push_back(chunk);
+            for (std::size_t offset = 0; offset + blockSize <= POOL_CHUNK_SIZE;
+                 offset += blockSize)
+            {
+                list.Push(chunk + offset);
+            }
+            m_bytes += POOL_CHUNK_SIZE;
+            chunks = 1;
+        }
+        for (uint32_t i = 0; i < POOL_BATCH && list.count > 0; ++i)
+        {
+            cache.Push(list.Pop());
+            ++m_outstanding;
+        }
+        return chunks;
+    }
+
+    /**
+     * Return blocks of a size class from a thread cache.
+     * \param [in] sizeClass The size class.
+     * \param [in,out] cache The thread cache.
+     * \param [in] n The number of blocks to return.
+     */
+    void Drain(std::size_t sizeClass, FreeList& cache, uint32_t n)
+    {
+        std::lock_guard lock(m_mutex);
+        for (uint32_t i = 0; i < n && cache.count > 0; ++i)
+        {
+            m_free[sizeClass].Push(cache.Pop());
+            --m_outstanding;
+        }
+        MaybeRelease();
+    }
+
+    /**
+     * Return a single block.
+     * \param [in] sizeClass The size class.
+     * \param [in] p The block.
+     */
+    void Free(std::size_t sizeClass, void* p)
+    {
+        std::lock_guard lock(m_mutex);
+        m_free[sizeClass].Push(p);
+        --m_outstanding;
+        MaybeRelease();
+    }
+
+    /** Release the chunks as soon as no block is outstanding. */
+    void Release()
+    {
+        std::lock_guard lock(m_mutex);
+        m_releasing = true;
+        MaybeRelease();
+    }
+
+    /**
+     * \returns \c true if a release is pending.
+     */
+    bool IsReleasing() const
+    {
+        return m_releasing.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \returns The number of bytes held in chunks.
+     */
+    uint64_t GetBytes()
+    {
+        std::lock_guard lock(m_mutex);
+        return m_bytes;
+    }
+
+    /** Set when the depot has been destroyed, at program exit. */
+    static bool g_destroyed;
+
+  private:
+    /** Free all chunks, if a release is pending and no block is outstanding. */
+    void MaybeRelease()
+    {
+        if (m_releasing && m_outstanding == 0)
+        {
+            FreeChunks();
+        }
+    }
+
+    /** Free all chunks. */
+    void FreeChunks()
+    {
+        for (auto chunk : m_chunks)
+        {
+            ::operator delete(chunk);
+        }
+        m_chunks.clear();
+        for (auto& list : m_free)
+        {
+            list = FreeList();
+        }
+        m_bytes = 0;
+    }
+
+    std::mutex m_mutex;                 //!< Protects the depot.
+    FreeList m_free[POOL_CLASSES];      //!< Free blocks, by size class.
+    std::vector<char*> m_chunks;        //!< All chunks.
+    uint64_t m_outstanding{0};          //!< Blocks outside of the depot.
+    uint64_t m_bytes{0};                //!< Bytes held in chunks.
+    std::atomic<bool> m_releasing{false}; //!< A release is pending.
+};
+
+bool Depot::g_destroyed = false;
+
+/**
+ * Get the depot.
+ * \returns The depot.
+ */
+Depot&
+GetDepot()
+{
+    static Depot depot;
+    return depot;
+}
+
+/**
+ * Per-thread cache of free blocks.  This is trivially destructible,
+ * so it remains usable while the thread exits.
+ */
+struct ThreadCache
+{
+    FreeList lists[POOL_CLASSES]; //!< Free blocks, by size class.
+    uint64_t events;              //!< Events created by this thread.
+    uint64_t heapAllocations;     //!< Heap allocations made by this thread.
+    bool registered;              //!< The cache flusher has been created.
+    bool closed;                  //!< The thread is exiting: bypass the cache.
+};
+
+/** This thread's cache. */
+thread_local ThreadCache t_cache;
+
+/** Return the blocks of this thread's cache to the depot when the thread exits. */
+struct ThreadCacheFlusher
+{
+    /** Mark the cache as registered for flushing. */
+    void Register()
+    {
+        t_cache.registered = true;
+    }
+
+    /** Destructor: flush the cache. */
+    ~ThreadCacheFlusher()
+    {
+        t_cache.closed = true;
+        if (Depot::g_destroyed)
+        {
+            return;
+        }
+        for (std::size_t i = 0; i < POOL_CLASSES; ++i)
+        {
+            GetDepot().Drain(i, t_cache.lists[i], t_cache.lists[i].count);
+        }
+    }
+};
+
+/** The flusher of this thread's cache. */
+thread_local ThreadCacheFlusher t_flusher;
+
+/**
+ * Check the EventMemoryPool global value, once.
+ * \returns \c true if the pool is enabled.
+ */
+bool
+IsPoolEnabled()
+{
+    static bool enabled = []() {
+        BooleanValue value;
+        g_eventMemoryPool.GetValue(value);
+        return value.Get();
+    }();
+    return enabled;
+}
+
+} // unnamed namespace
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
 }
 
 EventImpl::EventImpl()
-    : m_cancel(false)
+    : m_schedulerIndex(0),
+      m_cancel(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -67,4 +366,106 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+// Logging is avoided in the allocation functions, which are called
+// for every event.
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    ++t_cache.events;
+    if (size > POOL_CLASSES * POOL_GRANULARITY || !IsPoolEnabled())
+    {
+        ++t_cache.heapAllocations;
+        return ::operator new(size);
+    }
+    std::size_t sizeClass = SizeClass(size);
+    FreeList& cache = t_cache.lists[sizeClass];
+    if (cache.count == 0)
+    {
+        if (Depot::g_destroyed)
+        {
+            ++t_cache.heapAllocations;
+            return ::operator new(size);
+        }
+        if (!t_cache.registered)
+        {
+            // Construct the depot first, so it outlives the flusher.
+            GetDepot();
+            t_flusher.Register();
+        }
+        t_cache.heapAllocations += GetDepot().Refill(sizeClass, cache);
+    }
+    return cache.Pop();
+}
+
+void*
+EventImpl::operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++t_cache.events;
+    ++t_cache.heapAllocations;
+    return ::operator new(size, alignment);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    if (size > POOL_CLASSES * POOL_GRANULARITY || !IsPoolEnabled())
+    {
+        ::operator delete(p);
+        return;
+    }
+    std::size_t sizeClass = SizeClass(size);
+    if (Depot::g_destroyed)
+    {
+        return;
+    }
+    if (t_cache.closed || GetDepot().IsReleasing())
+    {
+        GetDepot().Free(sizeClass, p);
+        return;
+    }
+    FreeList& cache = t_cache.lists[sizeClass];
+    cache.Push(p);
+    if (cache.count > 2 * POOL_BATCH)
+    {
+        GetDepot().Drain(sizeClass, cache, POOL_BATCH);
+    }
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t /* size */, std::align_val_t alignment)
+{
+    ::operator delete(p, alignment);
+}
+
+void
+EventImpl::ReleaseMemoryPool()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    if (Depot::g_destroyed || !IsPoolEnabled())
+    {
+        return;
+    }
+    for (std::size_t i = 0; i < POOL_CLASSES; ++i)
+    {
+        FreeList& cache = t_cache.lists[i];
+        if (cache.count > 0)
+        {
+            GetDepot().Drain(i, cache, cache.count);
+        }
+    }
+    GetDepot().Release();
+}
+
+EventImpl::MemoryPoolStats
+EventImpl::GetMemoryPoolStats()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    MemoryPoolStats stats;
+    stats.events = t_cache.events;
+    stats.heapAllocations = t_cache.heapAllocations;
+    stats.bytes = Depot::g_destroyed ? 0 : GetDepot().GetBytes();
+    return stats;
+}
+
 } // namespace ns3
@@ -21,6 +21,8 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
+#include <new>
 #include <stdint.h>
 
 /**
@@ -67,6 +69,77 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /**
+     * Record the position of this event in the event list of an indexed
+     * Scheduler, such as HeapScheduler, so it can be removed without a search.
+     *
+     * \param [in] index The position.
+     */
+    void SetSchedulerIndex(std::size_t index);
+    /**
+     * \returns The position recorded by SetSchedulerIndex().
+     */
+    std::size_t GetSchedulerIndex() const;
+
+    /**
+     * Allocate storage for an event from the event memory pool.
+     *
+     * \param [in] size The size of the event object.
+     * \returns The storage.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Allocate storage for an over-aligned event from the global heap.
+     *
+     * \param [in] size The size of the event object.
+     * \param [in] alignment The alignment of the event object.
+     * \returns The storage.
+     */
+    static void* operator new(std::size_t size, std::align_val_t alignment);
+    /**
+     * Return the storage of an event to the event memory pool.
+     *
+     * \param [in] p The storage.
+     * \param [in] size The size of the (dynamic type of the) event object.
+     */
+    static void operator delete(void* p, std::size_t size);
+    /**
+     * Return the storage of an over-aligned event to the global heap.
+     *
+     * \param [in] p The storage.
+     * \param [in] size The size of the (dynamic type of the) event object.
+     * \param [in] alignment The alignment of the event object.
+     */
+    static void operator delete(void* p, std::size_t size, std::align_val_t alignment);
+
+    /**
+     * Release the memory held by the event memory pool.
+     *
+     * The memory is returned to the system immediately if no event is
+     * alive, otherwise as soon as the last live event has been freed,
+     * unless a new event is created in the meantime.
+     * This is called by Simulator::Destroy.
+     */
+    static void ReleaseMemoryPool();
+
+    /** Event memory counters, used by utils/bench-scheduler.cc. */
+    struct MemoryPoolStats
+    {
+        uint64_t events;          /**< Events created. */
+        uint64_t heapAllocations; /**< Allocations from the global heap, including pool chunks. */
+        uint64_t bytes;           /**< Bytes currently held by the pool. */
+    };
+
+    /**
+     * Get the event memory counters.
+     *
+     * The event and allocation counters only include events created
+     * by the calling thread.
+     *
+     * \returns The counters.
+     */
+    static MemoryPoolStats GetMemoryPoolStats();
+
   protected:
     /**
      * Implementation for Invoke().
@@ -77,9 +150,26 @@ class EventImpl : public SimpleRefCount<EventImpl>
     virtual void Notify() = 0;
 
   private:
-    bool m_cancel; /**< Has this event been cancelled. */
+    std::size_t m_schedulerIndex; /**< Position in the event list of an indexed Scheduler. */
+    bool m_cancel;                /**< Has this event been cancelled. */
 };
 
+/*************************************************
+ **  Inline implementations
+ ************************************************/
+
+inline void
+EventImpl::SetSchedulerIndex(std::size_t index)
+{
+    m_schedulerIndex = index;
+}
+
+inline std::size_t
+EventImpl::GetSchedulerIndex() const
+{
+    return m_schedulerIndex;
+}
+
 } // namespace ns3
 
 #endif /* EVENT_IMPL_H */
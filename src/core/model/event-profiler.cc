@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2026 PCDN tracker simulation project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+
+#include "event-impl.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <map>
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventProfiler");
+
+namespace
+{
+
+/**
+ * \ingroup simulator
+ * Number of bits of a duration kept by the histogram bins; durations
+ * below <tt>2 ^ (HISTOGRAM_BITS + 1)</tt> get a bin of their own.
+ */
+constexpr unsigned int HISTOGRAM_BITS = 3;
+
+/**
+ * \ingroup simulator
+ * Sort statistics by decreasing total duration.
+ * \tparam K \deduced The key type.
+ * \param [in,out] stats The statistics to sort.
+ */
+template <typename K>
+void
+SortByTotal(std::vector<std::pair<K, EventProfiler::Stats>>& stats)
+{
+    std::stable_sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+        return a.second.GetTotal() > b.second.GetTotal();
+    });
+}
+
+/**
+ * \ingroup simulator
+ * Print a table of statistics.
+ * \tparam K \deduced The key type.
+ * \tparam F \deduced The type of the key printer.
+ * \param [in] os The output stream.
+ * \param [in] stats The statistics.
+ * \param [in] total The total duration of all the events, in nanoseconds.
+ * \param [in] title The title of the key column.
+ * \param [in] printKey The key printer.
+ */
+template <typename K, typename F>
+void
+PrintTable(std::ostream& os,
+           const std::vector<std::pair<K, EventProfiler::Stats>>& stats,
+           uint64_t total,
+           const std::string& title,
+           F printKey)
+{
+    os << std::setw(12) << "Total(ms)" << std::setw(8) << "Share" << std::setw(12) << "Count"
+       << std::setw(11) << "Mean(us)" << std::setw(11) << "p50(us)" << std::setw(11) << "p90(us)"
+       << std::setw(11) << "p99(us)" << std::setw(11) << "Max(us)"
+       << "  " << title << std::endl;
+    for (const auto& [key, s] : stats)
+    {
+        os << std::setw(12) << s.GetTotal() / 1e6 << std::setw(7)
+           << (total ? 100.0 * s.GetTotal() / total : 0) << "%" << std::setw(12) << s.GetCount()
+           << std::setw(11) << s.GetTotal() / 1e3 / s.GetCount() << std::setw(11)
+           << s.GetPercentile(50) / 1e3 << std::setw(11) << s.GetPercentile(90) / 1e3
+           << std::setw(11) << s.GetPercentile(99) / 1e3 << std::setw(11) << s.GetMax() / 1e3
+           << "  ";
+        printKey(os, key);
+        os << std::endl;
+    }
+}
+
+} // unnamed namespace
+
+std::size_t
+EventProfiler::Stats::GetBin(uint64_t ns)
+{
+    // Durations are grouped by power of two, then each power of two is
+    // split in 2 ^ HISTOGRAM_BITS bins
+    auto width = static_cast<unsigned int>(std::bit_width(ns));
+    if (width <= HISTOGRAM_BITS + 1)
+    {
+        return ns;
+    }
+    unsigned int shift = width - HISTOGRAM_BITS - 1;
+    return (static_cast<std::size_t>(shift) << HISTOGRAM_BITS) + (ns >> shift);
+}
+
+uint64_t
+EventProfiler::Stats::GetBinLowerBound(std::size_t bin)
+{
+    if (bin < (2U << HISTOGRAM_BITS))
+    {
+        return bin;
+    }
+    unsigned int shift = (bin >> HISTOGRAM_BITS) - 1;
+    return static_cast<uint64_t>(bin - (shift << HISTOGRAM_BITS)) << shift;
+}
+
+void
+EventProfiler::Stats::Add(uint64_t ns)
+{
+    m_count++;
+    m_total += ns;
+    m_max = std::max(m_max, ns);
+    std::size_t bin = GetBin(ns);
+    if (bin >= m_histogram.size())
+    {
+        m_histogram.resize(bin + 1, 0);
+    }
+    m_histogram[bin]++;
+}
+
+void
+EventProfiler::Stats::Merge(const Stats& other)
+{
+    m_count += other.m_count;
+    m_total += other.m_total;
+    m_max = std::max(m_max, other.m_max);
+    if (other.m_histogram.size() > m_histogram.size())
+    {
+        m_histogram.resize(other.m_histogram.size(), 0);
+    }
+    for (std::size_t i = 0; i < other.m_histogram.size(); ++i)
+    {
+        m_histogram[i] += other.m_histogram[i];
+    }
+}
+
+uint64_t
+EventProfiler::Stats::GetCount() const
+{
+    return m_count;
+}
+
+uint64_t
+EventProfiler::Stats::GetTotal() const
+{
+    return m_total;
+}
+
+uint64_t
+EventProfiler::Stats::GetMax() const
+{
+    return m_max;
+}
+
+uint64_t
+EventProfiler::Stats::GetPercentile(double p) const
+{
+    NS_ASSERT_MSG(p >= 0 && p <= 100, "Invalid percentile " << p);
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    auto rank = static_cast<uint64_t>(std::ceil(p / 100 * m_count));
+    rank = std::max<uint64_t>(rank, 1);
+    if (rank == m_count)
+    {
+        return m_max;
+    }
+    uint64_t seen = 0;
+    for (std::size_t bin = 0; bin < m_histogram.size(); ++bin)
+    {
+        seen += m_histogram[bin];
+        if (seen >= rank)
+        {
+            if (bin < (2U << HISTOGRAM_BITS))
+            {
+                return bin;
+            }
+            // The middle of the bin
+            unsigned int shift = (bin >> HISTOGRAM_BITS) - 1;
+            return std::min(GetBinLowerBound(bin) + (uint64_t{1} << shift) / 2, m_max);
+        }
+    }
+    return m_max;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>>
+EventProfiler::Stats::GetHistogram() const
+{
+    std::vector<std::pair<uint64_t, uint64_t>> histogram;
+    for (std::size_t bin = 0; bin < m_histogram.size(); ++bin)
+    {
+        if (m_histogram[bin] != 0)
+        {
+            histogram.emplace_back(GetBinLowerBound(bin), m_histogram[bin]);
+        }
+    }
+    return histogram;
+}
+
+void
+EventProfiler::Record(const EventImpl* event, uint32_t context, uint64_t ns)
+{
+    m_functions[&typeid(*event)].Add(ns);
+    m_contexts[context].Add(ns);
+    m_total.Add(ns);
+}
+
+const EventProfiler::Stats&
+EventProfiler::GetTotalStats() const
+{
+    return m_total;
+}
+
+std::vector<std::pair<std::string, EventProfiler::Stats>>
+EventProfiler::GetFunctionStats() const
+{
+    NS_LOG_FUNCTION(this);
+    // The same type may have several type_info objects when it is used
+    // in several libraries: merge them by name
+    std::map<std::string, Stats> byName;
+    for (const auto& [type, stats] : m_functions)
+    {
+        byName[GetFunctionName(*type)].Merge(stats);
+    }
+    std::vector<std::pair<std::string, Stats>> result(byName.begin(), byName.end());
+    SortByTotal(result);
+    return result;
+}
+
+std::vector<std::pair<uint32_t, EventProfiler::Stats>>
+EventProfiler::GetContextStats() const
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<std::pair<uint32_t, Stats>> result(m_contexts.begin(), m_contexts.end());
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    SortByTotal(result);
+    return result;
+}
+
+void
+EventProfiler::Print(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this);
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+
+    uint64_t total = m_total.GetTotal();
+    os << "Event profile: " << m_total.GetCount() << " events, " << total / 1e9
+       << " s in event handlers" << std::endl;
+    os << std::endl << "By function:" << std::endl;
+    PrintTable(os, GetFunctionStats(), total, "Function", [](std::ostream& o, const auto& name) {
+        o << name;
+    });
+    os << std::endl << "By context:" << std::endl;
+    PrintTable(os, GetContextStats(), total, "Context", [](std::ostream& o, uint32_t context) {
+        if (context == Simulator::NO_CONTEXT)
+        {
+            o << "none";
+        }
+        else
+        {
+            o << context;
+        }
+    });
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+std::string
+EventProfiler::GetFunctionName(const std::type_info& type)
+{
+    std::string name = type.name();
+#if (__GNUC__ >= 3)
+    int status;
+    char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if (status == 0)
+    {
+        name = demangled;
+    }
+    std::free(demangled);
+#endif
+
+    // The events created by MakeEvent are local classes of the MakeEvent
+    // function template, whose first parameter is the bound function
+    const std::string prefix = "ns3::MakeEvent";
+    if (name.compare(0, prefix.size(), prefix) != 0)
+    {
+        return name;
+    }
+    std::size_t pos = prefix.size();
+    int depth = 0;
+    // skip the template arguments
+    for (; pos < name.size(); ++pos)
+    {
+        char c = name[pos];
+        depth += (c == '<') - (c == '>');
+        if (depth == 0 && c == '(')
+        {
+            break;
+        }
+    }
+    std::size_t begin = pos + 1;
+    for (pos = begin; pos < name.size(); ++pos)
+    {
+        char c = name[pos];
+        if (depth == 0 && (c == ',' || c == ')'))
+        {
+            return name.substr(begin, pos - begin);
+        }
+        depth += (c == '<' || c == '(') - (c == '>' || c == ')');
+    }
+    return name;
+}
+
+} // namespace ns3
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 PCDN tracker simulation project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3
+{
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Wall-clock profile of the events run by a simulator.
+ *
+ * Each event is accounted for twice: by the dynamic type of its
+ * EventImpl, which MakeEvent() derives from the type of the bound
+ * function, and by its context.  Events bound to different functions
+ * with the same signature therefore share a bucket, whereas each lambda
+ * has its own.
+ *
+ * For each bucket the profiler keeps the number of events, their total
+ * and maximum wall-clock time, and a log-linear histogram of their
+ * durations from which percentiles are estimated within 1/16 of their
+ * value.
+ *
+ * DefaultSimulatorImpl feeds a profiler when its EventProfiling
+ * attribute is set, and prints it at Simulator::Destroy().
+ */
+class EventProfiler
+{
+  public:
+    /** The statistics of a group of events. */
+    class Stats
+    {
+      public:
+        /**
+         * Account for an event.
+         * \param [in] ns The event duration, in nanoseconds.
+         */
+        void Add(uint64_t ns);
+        /**
+         * Account for all the events of another group.
+         * \param [in] other The other group.
+         */
+        void Merge(const Stats& other);
+        /** \returns The number of events. */
+        uint64_t GetCount() const;
+        /** \returns The total duration of the events, in nanoseconds. */
+        uint64_t GetTotal() const;
+        /** \returns The longest event duration, in nanoseconds. */
+        uint64_t GetMax() const;
+        /**
+         * Estimate a percentile of the event durations.
+         * \param [in] p The percentile, between 0 and 100.
+         * \returns The estimated duration, in nanoseconds.
+         */
+        uint64_t GetPercentile(double p) const;
+        /**
+         * Get the histogram of the event durations.
+         * \returns The lower bound of each non-empty bin, in nanoseconds,
+         *          and its number of events, by increasing duration.
+         */
+        std::vector<std::pair<uint64_t, uint64_t>> GetHistogram() const;
+
+      private:
+        /**
+         * Get the histogram bin of a duration.
+         * \param [in] ns The duration, in nanoseconds.
+         * \returns The bin index.
+         */
+        static std::size_t GetBin(uint64_t ns);
+        /**
+         * Get the lower bound of a histogram bin.
+         * \param [in] bin The bin index.
+         * \returns The shortest duration of the bin, in nanoseconds.
+         */
+        static uint64_t GetBinLowerBound(std::size_t bin);
+
+        uint64_t m_count{0};              //!< Number of events
+        uint64_t m_total{0};              //!< Total duration
+        uint64_t m_max{0};                //!< Longest duration
+        std::vector<uint64_t> m_histogram; //!< Event count of each bin
+    };
+
+    /**
+     * Account for an event.
+     * \param [in] event The event.
+     * \param [in] context The event context.
+     * \param [in] ns The wall-clock duration of the event, in nanoseconds.
+     */
+    void Record(const EventImpl* event, uint32_t context, uint64_t ns);
+
+    /** \returns The statistics of all the events. */
+    const Stats& GetTotalStats() const;
+    /**
+     * Get the statistics of each event function type.
+     * \returns The function names and their statistics, by decreasing
+     *          total duration.
+     */
+    std::vector<std::pair<std::string, Stats>> GetFunctionStats() const;
+    /**
+     * Get the statistics of each event context.
+     * \returns The contexts and their statistics, by decreasing total
+     *          duration.
+     */
+    std::vector<std::pair<uint32_t, Stats>> GetContextStats() const;
+
+    /**
+     * Print the profile.
+     * \param [in] os The output stream.
+     */
+    void Print(std::ostream& os) const;
+
+    /**
+     * Get a readable name for the type of an event.
+     *
+     * For the events created by MakeEvent(), this is the type of the
+     * bound function, otherwise the demangled name of the event type.
+     * \param [in] type The type of the EventImpl.
+     * \returns The name.
+     */
+    static std::string GetFunctionName(const std::type_info& type);
+
+  private:
+    /** The statistics of each EventImpl type. */
+    std::unordered_map<const std::type_info*, Stats> m_functions;
+    /** The statistics of each context. */
+    std::unordered_map<uint32_t, Stats> m_contexts;
+    /** The statistics of all the events. */
+    Stats m_total;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
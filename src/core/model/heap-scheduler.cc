@@ -128,6 +128,8 @@ HeapScheduler::Exch(std::size_t a, std::size_t b)
     Event tmp(m_heap[a]);
     m_heap[a] = m_heap[b];
     m_heap[b] = tmp;
+    m_heap[a].impl->SetSchedulerIndex(a);
+    m_heap[b].impl->SetSchedulerIndex(b);
 }
 
 bool
@@ -152,10 +154,10 @@ HeapScheduler::IsEmpty() const
 }
 
 void
-HeapScheduler::BottomUp()
+HeapScheduler::BottomUp(std::size_t start)
 {
-    NS_LOG_FUNCTION(this);
-    std::size_t index = Last();
+    NS_LOG_FUNCTION(this << start);
+    std::size_t index = start;
     while (!IsRoot(index) && IsLessStrictly(index, Parent(index)))
     {
         Exch(index, Parent(index));
@@ -203,7 +205,8 @@ HeapScheduler::Insert(const Event& ev)
 {
     NS_LOG_FUNCTION(this << &ev);
     m_heap.push_back(ev);
-    BottomUp();
+    ev.impl->SetSchedulerIndex(Last());
+    BottomUp(Last());
 }
 
 Scheduler::Event
@@ -228,19 +231,17 @@ void
 HeapScheduler::Remove(const Event& ev)
 {
     NS_LOG_FUNCTION(this << &ev);
-    std::size_t uid = ev.key.m_uid;
-    for (std::size_t i = 1; i < m_heap.size(); i++)
+    std::size_t i = ev.impl->GetSchedulerIndex();
+    NS_ASSERT(i < m_heap.size() && m_heap[i].key.m_uid == ev.key.m_uid);
+    NS_ASSERT(m_heap[i].impl == ev.impl);
+    Exch(i, Last());
+    m_heap.pop_back();
+    if (!IsBottom(i))
     {
-        if (uid == m_heap[i].key.m_uid)
-        {
-            NS_ASSERT(m_heap[i].impl == ev.impl);
-            Exch(i, Last());
-            m_heap.pop_back();
-            TopDown(i);
-            return;
-        }
+        // The last item may belong above or below the removed one.
+        BottomUp(i);
+        TopDown(i);
     }
-    NS_ASSERT(false);
 }
 
 } // namespace ns3
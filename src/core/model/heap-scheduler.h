@@ -52,6 +52,10 @@ namespace ns3
  *    the index of the root is 1.
  *  - It uses a slightly non-standard while loop for top-down heapify
  *    to move one if statement out of the loop.
+ *  - The heap is indexed: each event records its position in the heap
+ *    (see EventImpl::SetSchedulerIndex()), so Remove() does not have
+ *    to search for it.  This makes Simulator::Remove() cheap, even when
+ *    most events are removed before they expire.
  *
  * \par Time Complexity
  *
@@ -60,7 +64,7 @@ namespace ns3
  * Insert()     | Logarithmic     | Heapify
  * IsEmpty()    | Constant        | Explicit queue size
  * PeekNext()   | Constant        | Heap kept sorted
- * Remove()     | Logarithmic     | Search, heapify
+ * Remove()     | Logarithmic     | Heapify
  * RemoveNext() | Logarithmic     | Heapify
  *
  * \par Memory Complexity
@@ -171,8 +175,12 @@ class HeapScheduler : public Scheduler
      * \param [in] b The second item.
      */
     inline void Exch(std::size_t a, std::size_t b);
-    /** Percolate a newly inserted Last item to its proper position. */
-    void BottomUp();
+    /**
+     * Percolate an item up to its proper position.
+     *
+     * \param [in] start Starting entry.
+     */
+    void BottomUp(std::size_t start);
     /**
      * Percolate a deletion bubble down the heap.
      *
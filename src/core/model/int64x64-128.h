@@ -74,6 +74,8 @@ class int64x64_t
      * this define.
      */
 #define HP_MAX_64 (std::pow(2.0L, 64))
+    /// Smallest double which does not fit in an int64_t, 2^63.
+    static constexpr double HP_MAX_63_DOUBLE = 9223372036854775808.0;
 
   public:
     /**
@@ -110,8 +112,29 @@ class int64x64_t
      */
     inline int64x64_t(const double value)
     {
-        const int64x64_t tmp((long double)value);
-        _v = tmp._v;
+        const bool negative = value < 0;
+        const double v = negative ? -value : value;
+        if (!(v < HP_MAX_63_DOUBLE))
+        {
+            const int64x64_t tmp((long double)value);
+            _v = tmp._v;
+            return;
+        }
+        // Same as the long double constructor: the integer and fractional
+        // parts of a double are exact, without the long double std::modf()
+        const int64_t ihi = v;
+        long double flo = v - ihi;
+        flo = flo * HP_MAX_64 + 0.5L;
+        int128_t hi = ihi;
+        const uint64_t lo = flo;
+        if (flo >= HP_MAX_64)
+        {
+            // conversion to uint64 rolled over
+            ++hi;
+        }
+        _v = hi << 64;
+        _v |= lo;
+        _v = negative ? -_v : _v;
     }
 
     inline int64x64_t(const long double value)
@@ -430,7 +453,7 @@ class int64x64_t
      *
      * Mathematically this should produce a Q128.128 value;
      * we keep the central 128 bits, representing the Q64.64 result.
-     * We assert on integer overflow beyond the 64-bit integer portion.
+     * Integer overflow beyond the 64-bit integer portion is not detected.
      *
      * \param [in] a First factor.
      * \param [in] b Second factor.
@@ -447,12 +470,18 @@ class int64x64_t
      * the multiplication mathematically produces a Q128.128 fixed point number.
      * We want the middle 128 bits from the result, truncating both the
      * high and low 64 bits.  To achieve this, we carry out the multiplication
-     * explicitly with 64-bit operands and 128-bit intermediate results.
+     * explicitly with 64-bit operands and 128-bit intermediate results,
+     * which the compiler maps to single 64x64 to 128-bit multiplications.
      */
     static uint128_t Umul(const uint128_t a, const uint128_t b);
     /**
      * Unsigned division of Q64.64 values.
      *
+     * The result is truncated: this is the integer part of
+     * `a * 2^64 / b`, which takes a single 128 by 64-bit division
+     * when \pname{b} is an integer, and otherwise a 128-bit division
+     * followed by a normalized 192 by 128-bit division of the remainder.
+     *
      * \param [in] a Numerator.
      * \param [in] b Denominator.
      * \return The Q64.64 representation of `a / b`.
@@ -473,6 +502,67 @@ class int64x64_t
 
 }; // class int64x64_t
 
+inline void
+int64x64_t::Mul(const int64x64_t& o)
+{
+    const bool negative = (_v < 0) != (o._v < 0);
+    const uint128_t a = _v < 0 ? -_v : _v;
+    const uint128_t b = o._v < 0 ? -o._v : o._v;
+    const uint128_t result = Umul(a, b);
+    _v = negative ? -result : result;
+}
+
+inline uint128_t
+int64x64_t::Umul(const uint128_t a, const uint128_t b)
+{
+    const uint64_t aL = a;
+    const uint64_t bL = b;
+    const uint64_t aH = a >> 64;
+    const uint64_t bH = b >> 64;
+
+    // Multiplying (a.h 2^64 + a.l) x (b.h 2^64 + b.l) =
+    //             2^128 a.h b.h + 2^64*(a.h b.l+b.h a.l) + a.l b.l
+    const uint128_t loPart = static_cast<uint128_t>(aL) * bL;
+    const uint128_t midPart = static_cast<uint128_t>(aL) * bH + static_cast<uint128_t>(aH) * bL;
+    const uint128_t hiPart = static_cast<uint128_t>(aH) * bH;
+
+    // Adding 64-bit terms to get 128-bit results, with carries
+    uint128_t result = (loPart >> 64) + (midPart & HP_MASK_LO);
+    result += ((midPart >> 64) + (hiPart & HP_MASK_LO)) << 64;
+    return result;
+}
+
+inline void
+int64x64_t::Div(const int64x64_t& o)
+{
+    const bool negative = (_v < 0) != (o._v < 0);
+    const uint128_t a = _v < 0 ? -_v : _v;
+    const uint128_t b = o._v < 0 ? -o._v : o._v;
+    const int128_t result = Udiv(a, b);
+    _v = negative ? -result : result;
+}
+
+inline void
+int64x64_t::MulByInvert(const int64x64_t& o)
+{
+    const bool negResult = _v < 0;
+    const uint128_t a = negResult ? -_v : _v;
+    const uint128_t result = UmulByInvert(a, o._v);
+    _v = negResult ? -result : result;
+}
+
+inline uint128_t
+int64x64_t::UmulByInvert(const uint128_t a, const uint128_t b)
+{
+    const uint64_t aL = a;
+    const uint64_t bL = b;
+    const uint64_t aH = a >> 64;
+    const uint64_t bH = b >> 64;
+    const uint128_t hi = static_cast<uint128_t>(aH) * bH;
+    const uint128_t mid = (static_cast<uint128_t>(aH) * bL + static_cast<uint128_t>(aL) * bH) >> 64;
+    return hi + mid;
+}
+
 } // namespace ns3
 
 #endif /* INT64X64_128_H */
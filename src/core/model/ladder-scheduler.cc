@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2026 PCDN tracker simulation project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+#include "type-id.h"
+#include "uinteger.h"
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace
+{
+/**
+ * Upper limit on the number of buckets in a single rung,
+ * to bound the memory spent on (mostly empty) buckets when
+ * the top holds a very large number of events.
+ */
+constexpr uint32_t MAX_BUCKETS = 1U << 16;
+
+} // unnamed namespace
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LadderScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<LadderScheduler>()
+            .AddAttribute("ThresholdSize",
+                          "Bucket size above which a bucket is split into a new rung",
+                          UintegerValue(50),
+                          MakeUintegerAccessor(&LadderScheduler::m_threshold),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxRungs",
+                          "Maximum number of rungs in the ladder",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&LadderScheduler::m_maxRungs),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topMin(UINT64_MAX),
+      m_topMax(0),
+      m_topStart(0),
+      m_nRungs(0),
+      m_bottomHead(0),
+      m_qSize(0),
+      m_threshold(50),
+      m_maxRungs(8)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint32_t
+LadderScheduler::BucketIndex(const Rung& rung, uint64_t ts)
+{
+    NS_ASSERT(ts >= rung.start);
+    uint64_t index = (ts - rung.start) / rung.width;
+    return static_cast<uint32_t>(std::min<uint64_t>(index, rung.nBuckets - 1));
+}
+
+uint64_t
+LadderScheduler::CurrentStart(const Rung& rung)
+{
+    return rung.start + rung.current * rung.width;
+}
+
+LadderScheduler::Rung&
+LadderScheduler::SpawnRung(uint64_t nBuckets, uint64_t minTs, uint64_t maxTs)
+{
+    NS_LOG_FUNCTION(this << nBuckets << minTs << maxTs);
+    NS_ASSERT(nBuckets > 0);
+    nBuckets = std::min<uint64_t>(nBuckets, MAX_BUCKETS);
+
+    if (m_nRungs == m_rungs.size())
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs++];
+    // Keep the storage of a retired rung unless it is much larger than needed.
+    if (rung.buckets.size() < nBuckets || rung.buckets.size() > 4 * nBuckets)
+    {
+        rung.buckets.resize(nBuckets);
+    }
+    rung.nBuckets = static_cast<uint32_t>(nBuckets);
+    rung.start = minTs;
+    rung.width = (maxTs - minTs) / nBuckets + 1;
+    rung.current = 0;
+    rung.count = 0;
+    NS_LOG_LOGIC("rung " << m_nRungs - 1 << ": nBuckets=" << nBuckets << ", start=" << minTs
+                         << ", width=" << rung.width);
+    return rung;
+}
+
+void
+LadderScheduler::Distribute(Rung& rung, Bucket& events)
+{
+    NS_LOG_FUNCTION(this << events.size());
+    for (const auto& ev : events)
+    {
+        rung.buckets[BucketIndex(rung, ev.key.m_ts)].push_back(ev);
+    }
+    rung.count += events.size();
+    events.clear();
+}
+
+void
+LadderScheduler::TransferToBottom(Bucket& bucket)
+{
+    NS_LOG_FUNCTION(this << bucket.size());
+    NS_ASSERT(m_bottomHead == m_bottom.size());
+    m_bottom.clear();
+    m_bottomHead = 0;
+    // Swap rather than copy, so the buffers circulate between the tiers.
+    std::swap(m_bottom, bucket);
+    std::sort(m_bottom.begin(), m_bottom.end());
+}
+
+void
+LadderScheduler::InsertBottom(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.key.m_ts << ev.key.m_uid);
+    if (m_bottomHead > 0 && ev < m_bottom[m_bottomHead])
+    {
+        // Earlier than everything pending: reuse a slot already dequeued.
+        m_bottom[--m_bottomHead] = ev;
+        return;
+    }
+    auto it = std::upper_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev);
+    m_bottom.insert(it, ev);
+    if (m_bottom.size() - m_bottomHead > m_threshold)
+    {
+        SpillBottom();
+    }
+}
+
+void
+LadderScheduler::SpillBottom()
+{
+    NS_LOG_FUNCTION(this);
+    uint64_t minTs = m_bottom[m_bottomHead].key.m_ts;
+    uint64_t maxTs = m_bottom.back().key.m_ts;
+    if (m_nRungs >= m_maxRungs || minTs == maxTs)
+    {
+        return;
+    }
+    m_bottom.erase(m_bottom.begin(), m_bottom.begin() + m_bottomHead);
+    m_bottomHead = 0;
+    Rung& rung = SpawnRung(m_bottom.size(), minTs, maxTs);
+    Distribute(rung, m_bottom);
+    Refill();
+}
+
+void
+LadderScheduler::Refill()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_bottomHead < m_bottom.size())
+    {
+        return;
+    }
+    m_bottom.clear();
+    m_bottomHead = 0;
+
+    while (true)
+    {
+        if (m_nRungs == 0)
+        {
+            if (m_top.empty())
+            {
+                return;
+            }
+            NS_LOG_LOGIC("transfer " << m_top.size() << " events from top");
+            m_topStart = m_topMax + 1;
+            if (m_top.size() <= m_threshold || m_topMin == m_topMax)
+            {
+                TransferToBottom(m_top);
+            }
+            else
+            {
+                Rung& rung = SpawnRung(m_top.size(), m_topMin, m_topMax);
+                Distribute(rung, m_top);
+            }
+            m_topMin = UINT64_MAX;
+            m_topMax = 0;
+            if (m_nRungs == 0)
+            {
+                return;
+            }
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        if (rung.count == 0)
+        {
+            --m_nRungs;
+            continue;
+        }
+        while (rung.buckets[rung.current].empty())
+        {
+            ++rung.current;
+        }
+        NS_ASSERT(rung.current < rung.nBuckets);
+        Bucket& bucket = rung.buckets[rung.current];
+        ++rung.current;
+        rung.count -= bucket.size();
+        if (rung.count == 0)
+        {
+            // Retire the rung now, so a new rung can take its place.
+            --m_nRungs;
+        }
+
+        if (bucket.size() > m_threshold && m_nRungs < m_maxRungs)
+        {
+            auto [minIt, maxIt] = std::minmax_element(bucket.begin(), bucket.end());
+            uint64_t minTs = minIt->key.m_ts;
+            uint64_t maxTs = maxIt->key.m_ts;
+            if (minTs != maxTs)
+            {
+                // The new rung may reuse the storage of the one just retired.
+                std::swap(m_scratch, bucket);
+                Rung& child = SpawnRung(m_scratch.size(), minTs, maxTs);
+                Distribute(child, m_scratch);
+                continue;
+            }
+        }
+        TransferToBottom(bucket);
+        return;
+    }
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    ++m_qSize;
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+        Refill();
+        return;
+    }
+    for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+        Rung& rung = m_rungs[i];
+        if (ts >= CurrentStart(rung))
+        {
+            rung.buckets[BucketIndex(rung, ts)].push_back(ev);
+            ++rung.count;
+            Refill();
+            return;
+        }
+    }
+    InsertBottom(ev);
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    NS_ASSERT(m_bottomHead < m_bottom.size());
+    return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    NS_ASSERT(m_bottomHead < m_bottom.size());
+    Scheduler::Event ev = m_bottom[m_bottomHead++];
+    --m_qSize;
+    Refill();
+    NS_LOG_LOGIC("remove ts=" << ev.key.m_ts << ", key=" << ev.key.m_uid);
+    return ev;
+}
+
+void
+LadderScheduler::RemoveNextBatch(std::vector<Event>& events)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    uint64_t ts = m_bottom[m_bottomHead].key.m_ts;
+    // The events with this timestamp may not all be in the bottom yet:
+    // refill it until a later timestamp shows up
+    do
+    {
+        std::size_t end = m_bottomHead;
+        while (end < m_bottom.size() && m_bottom[end].key.m_ts == ts)
+        {
+            ++end;
+        }
+        events.insert(events.end(), m_bottom.begin() + m_bottomHead, m_bottom.begin() + end);
+        m_qSize -= end - m_bottomHead;
+        m_bottomHead = end;
+        Refill();
+    } while (!IsEmpty() && m_bottom[m_bottomHead].key.m_ts == ts);
+    NS_LOG_LOGIC("remove batch ts=" << ts);
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+    uint64_t ts = ev.key.m_ts;
+
+    // Swap the event with the last one of an unsorted bucket, and drop it.
+    auto removeFrom = [&ev](Bucket& bucket) -> bool {
+        for (auto& i : bucket)
+        {
+            if (i.key.m_uid == ev.key.m_uid)
+            {
+                NS_ASSERT(ev.impl == i.impl);
+                i = bucket.back();
+                bucket.pop_back();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (ts >= m_topStart)
+    {
+        bool found [[maybe_unused]] = removeFrom(m_top);
+        NS_ASSERT(found);
+        if (m_top.empty())
+        {
+            m_topMin = UINT64_MAX;
+            m_topMax = 0;
+        }
+        --m_qSize;
+        return;
+    }
+    for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+        Rung& rung = m_rungs[i];
+        if (ts >= CurrentStart(rung))
+        {
+            bool found [[maybe_unused]] = removeFrom(rung.buckets[BucketIndex(rung, ts)]);
+            NS_ASSERT(found);
+            --rung.count;
+            --m_qSize;
+            return;
+        }
+    }
+    auto it = std::lower_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev);
+    NS_ASSERT(it != m_bottom.end() && *it == ev);
+    NS_ASSERT(ev.impl == it->impl);
+    m_bottom.erase(it);
+    --m_qSize;
+    Refill();
+}
+
+} // namespace ns3
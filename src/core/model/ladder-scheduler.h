@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 PCDN tracker simulation project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Tang, Goh and Thng][Tang].
+ * The event list is split into three tiers:
+ *
+ * - the \em top, an unsorted `std::vector` holding all events later
+ *   than the region currently being worked on;
+ * - a small number of \em rungs, each an array of buckets covering
+ *   a contiguous time span.  Each bucket is an unsorted `std::vector`;
+ * - the \em bottom, a sorted `std::vector` of the imminent events,
+ *   from which RemoveNext() pops.
+ *
+ * When the bottom runs dry the first non-empty bucket of the lowest
+ * rung is either sorted into the bottom or, if it holds more than
+ * \c ThresholdSize events, spread over a new finer-grained rung.
+ * When all rungs are exhausted the top is distributed over a new rung
+ * whose bucket width is derived from the span and the number of events
+ * in the top.  Unlike the CalendarScheduler, the structure is never
+ * rebuilt as a whole; each event is moved at most once per rung.
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Bucket storage is recycled: emptied buckets and retired rungs keep
+ * their capacity, so in steady state Insert() and RemoveNext() do not
+ * allocate.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to top or bucket; small sorted bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Front of the bottom
+ * Remove()     | Linear          | Search within top or bucket
+ * RemoveNext() | ~Constant       | Pop bottom; occasional bucket transfer
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 2 x 3 x `sizeof (*)` + rungs<br/>(~48 bytes) | `std::vector`
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+    void RemoveNextBatch(std::vector<Scheduler::Event>& events) override;
+
+  private:
+    /** Ladder bucket type: an unsorted vector of Events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder: an array of equal width buckets. */
+    struct Rung
+    {
+        std::vector<Bucket> buckets; /**< The buckets, some of which may be retained but unused. */
+        uint32_t nBuckets;           /**< Number of buckets in use. */
+        uint64_t start;              /**< Timestamp of the start of the first bucket. */
+        uint64_t width;              /**< Bucket width, in dimensionless time units. */
+        uint32_t current;            /**< Index of the next bucket to be dequeued. */
+        uint64_t count;              /**< Number of events stored in this rung. */
+    };
+
+    /**
+     * Find the bucket index of a timestamp in a rung.
+     *
+     * The last bucket also collects any timestamp beyond the nominal span
+     * of the rung.
+     *
+     * \param [in] rung The rung.
+     * \param [in] ts The dimensionless timestamp.
+     * \returns The bucket index.
+     */
+    static inline uint32_t BucketIndex(const Rung& rung, uint64_t ts);
+    /**
+     * Timestamp at which the current bucket of a rung starts;
+     * events at or after this timestamp belong in the rung.
+     *
+     * \param [in] rung The rung.
+     * \returns The start timestamp of the current bucket.
+     */
+    static inline uint64_t CurrentStart(const Rung& rung);
+    /**
+     * Activate a new rung below the existing ones, reusing storage
+     * from a previously retired rung if possible.
+     *
+     * \param [in] nBuckets The number of buckets.
+     * \param [in] minTs The smallest timestamp to be stored.
+     * \param [in] maxTs The largest timestamp to be stored.
+     * \returns The new rung.
+     */
+    Rung& SpawnRung(uint64_t nBuckets, uint64_t minTs, uint64_t maxTs);
+    /**
+     * Move a set of events into a rung.
+     *
+     * \param [in,out] rung The rung.
+     * \param [in,out] events The events, cleared on return.
+     */
+    void Distribute(Rung& rung, Bucket& events);
+    /**
+     * Insert an event in the sorted bottom.
+     *
+     * \param [in] ev The new Event.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+    /** Spill an oversized bottom back into a new rung, if possible. */
+    void SpillBottom();
+    /**
+     * Refill the bottom from the rungs or the top if it is empty,
+     * restoring the invariant that the bottom is non-empty whenever
+     * the queue is non-empty.
+     */
+    void Refill();
+    /**
+     * Sort a bucket into the (empty) bottom.
+     *
+     * \param [in,out] bucket The bucket, cleared on return.
+     */
+    void TransferToBottom(Bucket& bucket);
+
+    /** The top: events later than \c m_topStart, unsorted. */
+    Bucket m_top;
+    /** Smallest timestamp in the top. */
+    uint64_t m_topMin;
+    /** Largest timestamp in the top. */
+    uint64_t m_topMax;
+    /** Events at or after this timestamp go in the top. */
+    uint64_t m_topStart;
+    /** The rungs; only the first \c m_nRungs are active. */
+    std::vector<Rung> m_rungs;
+    /** Number of active rungs. */
+    uint32_t m_nRungs;
+    /** The bottom: imminent events, sorted in increasing order from \c m_bottomHead. */
+    Bucket m_bottom;
+    /** Index of the earliest event in the bottom. */
+    std::size_t m_bottomHead;
+    /** Holds a bucket being split while its rung is recycled. */
+    Bucket m_scratch;
+    /** Number of events in queue. */
+    uint64_t m_qSize;
+
+    /** Bucket size above which a bucket is split into a new rung. */
+    uint32_t m_threshold;
+    /** Maximum number of active rungs. */
+    uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -96,6 +96,20 @@ ListScheduler::RemoveNext()
     return next;
 }
 
+void
+ListScheduler::RemoveNextBatch(std::vector<Event>& events)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_events.empty());
+    uint64_t ts = m_events.front().key.m_ts;
+    auto end = m_events.begin();
+    for (; end != m_events.end() && end->key.m_ts == ts; ++end)
+    {
+        events.push_back(*end);
+    }
+    m_events.erase(m_events.begin(), end);
+}
+
 void
 ListScheduler::Remove(const Event& ev)
 {
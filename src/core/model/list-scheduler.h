@@ -82,6 +82,7 @@ class ListScheduler : public Scheduler
     Scheduler::Event PeekNext() const override;
     Scheduler::Event RemoveNext() override;
     void Remove(const Scheduler::Event& ev) override;
+    void RemoveNextBatch(std::vector<Scheduler::Event>& events) override;
 
   private:
     /** Event list type: a simple list of Events. */
@@ -0,0 +1,1064 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "log-binary.h"
+
+#include "environment-variable.h"
+#include "fatal-error.h"
+#include "nstime.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#ifndef __WIN32__
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup logging
+ * Binary log output implementation.
+ *
+ * A binary log starts with the 8 bytes of MAGIC, followed by entries of
+ * two kinds, in native byte order:
+ * - SITE: the <tt>uint32_t</tt> id, level and source line of a logging
+ *   statement, and its component, file and function names;
+ * - BLOCK: the index of the thread which wrote the records, the time
+ *   resolution, and the size of the records which follow.
+ *
+ * Each record holds the site id, the RecordFlags, the simulation time and
+ * context when RecordFlags::HAS_TIME is set, then the arguments, each
+ * preceded by its LogBinaryRecord::Tag, up to LogBinaryRecord::END.
+ * A site is always written before the first block which refers to it.
+ */
+
+namespace
+{
+
+/** The first bytes of a binary log. */
+constexpr char MAGIC[8] = {'n', 's', '3', 'b', 'l', 'o', 'g', '1'};
+
+/** The kinds of entries of a binary log. */
+enum Entry : uint8_t
+{
+    SITE = 1,  //!< A logging statement
+    BLOCK = 2, //!< A block of records
+};
+
+/** The flags of a record. */
+enum RecordFlags : uint8_t
+{
+    HAS_TIME = 0x01,     //!< The record holds the simulation time and context
+    PREFIX_TIME = 0x02,  //!< LOG_PREFIX_TIME was enabled
+    PREFIX_NODE = 0x04,  //!< LOG_PREFIX_NODE was enabled
+    PREFIX_FUNC = 0x08,  //!< LOG_PREFIX_FUNC was enabled
+    PREFIX_LEVEL = 0x10, //!< LOG_PREFIX_LEVEL was enabled
+};
+
+/** The size of the buffer of records of each thread. */
+constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+/** The number of blocks waiting to be written beyond which the threads wait. */
+constexpr std::size_t MAX_PENDING_BLOCKS = 64;
+/** The longest string accepted by the decoder. */
+constexpr uint32_t MAX_STRING = 1 << 30;
+
+/** A logging statement. */
+struct Site
+{
+    uint32_t level;       //!< The log level
+    uint32_t line;        //!< The source line
+    std::string component; //!< The log component name
+    std::string file;     //!< The source file
+    std::string function; //!< The function name
+};
+
+/** A buffer of records. */
+struct Block
+{
+    std::unique_ptr<char[]> data; //!< The records
+    std::size_t size{0};          //!< The size of the records
+    std::size_t capacity{0};      //!< The size of the buffer
+    uint32_t thread{0};           //!< The index of the thread
+    uint8_t resolution{0};        //!< The time resolution
+
+    /**
+     * Grow the buffer, keeping the records.
+     * \param [in] capacity The new buffer size.
+     */
+    void Grow(std::size_t capacity)
+    {
+        auto bigger = std::make_unique<char[]>(capacity);
+        std::copy_n(data.get(), size, bigger.get());
+        data = std::move(bigger);
+        this->capacity = capacity;
+    }
+};
+
+/**
+ * Append a value to a byte string.
+ * \tparam T \deduced The value type.
+ * \param [in,out] out The byte string.
+ * \param [in] value The value.
+ */
+template <typename T>
+void
+Append(std::string& out, const T& value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * Append a string and its length to a byte string.
+ * \param [in,out] out The byte string.
+ * \param [in] value The string.
+ */
+void
+AppendString(std::string& out, const std::string& value)
+{
+    Append(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+/**
+ * The binary log file, and the thread which writes the blocks of records
+ * handed over by the simulation threads.
+ */
+class Sink
+{
+  public:
+    Sink()
+    {
+#ifndef __WIN32__
+        pthread_atfork(&Sink::Prepare, &Sink::Parent, &Sink::Child);
+#endif
+    }
+
+    ~Sink()
+    {
+        Close();
+    }
+
+    /**
+     * Open a binary log file.
+     * \param [in] filename The file name.
+     */
+    void Open(const std::string& filename)
+    {
+        Close();
+        m_filename = filename;
+        OpenFile(filename);
+        {
+            std::lock_guard lock(m_mutex);
+            m_sitesWritten = 0;
+            m_stop = false;
+            m_accepting = true;
+        }
+        m_writer = std::thread(&Sink::Write, this);
+        m_open.store(true, std::memory_order_release);
+    }
+
+    /** Write the pending blocks and close the file. */
+    void Close()
+    {
+        if (!m_open.exchange(false, std::memory_order_acq_rel))
+        {
+            return;
+        }
+        {
+            std::lock_guard lock(m_mutex);
+            m_accepting = false;
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        if (m_writer.joinable())
+        {
+            m_writer.join();
+        }
+        m_file.close();
+    }
+
+    /** \returns \c true if a file is open. */
+    bool IsOpen() const
+    {
+        return m_open.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Register a logging statement.
+     * \param [in] site The statement.
+     * \returns The site id.
+     */
+    uint32_t Register(Site site)
+    {
+        std::lock_guard lock(m_mutex);
+        m_sites.push_back(std::move(site));
+        return static_cast<uint32_t>(m_sites.size() - 1);
+    }
+
+    /** \returns The index of a new thread. */
+    uint32_t NewThread()
+    {
+        return m_threads.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Hand a block over to the writer; the block is dropped if no file is
+     * open.  Waits while too many blocks are pending.
+     * \param [in,out] block The block, replaced by an empty one.
+     */
+    void Submit(Block& block)
+    {
+        uint32_t thread = block.thread;
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this]() { return !m_accepting || m_pending.size() < MAX_PENDING_BLOCKS; });
+        if (!m_accepting)
+        {
+            block.size = 0;
+            return;
+        }
+        if (!m_writer.joinable())
+        {
+            // A forked process starts its own writer
+            m_writer = std::thread(&Sink::Write, this);
+        }
+        block.resolution = static_cast<uint8_t>(ns3::Time::GetResolution());
+        m_pending.push_back(std::move(block));
+        block = Block();
+        if (!m_free.empty())
+        {
+            block = std::move(m_free.back());
+            m_free.pop_back();
+        }
+        block.thread = thread;
+        m_cv.notify_all();
+    }
+
+    /** Wait until all the blocks handed over are written. */
+    void Flush()
+    {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_pending.empty() && !m_busy; });
+        if (m_accepting)
+        {
+            m_file.flush();
+        }
+    }
+
+  private:
+    /**
+     * Open the file and write the magic number.
+     * \param [in] filename The file name.
+     */
+    void OpenFile(const std::string& filename)
+    {
+        m_file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            NS_FATAL_ERROR("Cannot open binary log file " << filename);
+        }
+        m_file.write(MAGIC, sizeof(MAGIC));
+    }
+
+#ifndef __WIN32__
+    /**
+     * Before a fork: hand the records of the forking thread over, so that
+     * the child does not log them again, and wait until the writer thread
+     * leaves the critical section.
+     */
+    static void Prepare();
+    /** After a fork, in the parent: let the writer thread go on. */
+    static void Parent();
+    /**
+     * After a fork, in the child: forget the writer thread, the blocks and
+     * the file of the parent, and log to a file of the child.
+     */
+    static void Child();
+#endif
+
+    /** The writer thread. */
+    void Write()
+    {
+        std::unique_lock lock(m_mutex);
+        while (true)
+        {
+            m_cv.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+            if (m_pending.empty())
+            {
+                break;
+            }
+            Block block = std::move(m_pending.front());
+            m_pending.pop_front();
+            // Copy the new sites, which the records of the block may use
+            std::string header;
+            for (; m_sitesWritten < m_sites.size(); ++m_sitesWritten)
+            {
+                const Site& site = m_sites[m_sitesWritten];
+                Append(header, SITE);
+                Append(header, static_cast<uint32_t>(m_sitesWritten));
+                Append(header, site.level);
+                Append(header, site.line);
+                AppendString(header, site.component);
+                AppendString(header, site.file);
+                AppendString(header, site.function);
+            }
+            m_busy = true;
+            lock.unlock();
+
+            Append(header, BLOCK);
+            Append(header, block.thread);
+            Append(header, block.resolution);
+            Append(header, static_cast<uint32_t>(block.size));
+            m_file.write(header.data(), header.size());
+            m_file.write(block.data.get(), block.size);
+
+            lock.lock();
+            m_busy = false;
+            block.size = 0;
+            m_free.push_back(std::move(block));
+            m_cv.notify_all();
+        }
+        m_file.flush();
+    }
+
+    std::atomic<bool> m_open{false};     //!< A file is open
+    std::atomic<uint32_t> m_threads{0};  //!< The number of threads seen
+    std::mutex m_mutex;                  //!< Protects the members below
+    std::condition_variable m_cv;        //!< Signals changes of the members below
+    bool m_accepting{false};             //!< The blocks are written
+    bool m_stop{false};                  //!< The writer must stop
+    bool m_busy{false};                  //!< The writer is writing a block
+    std::deque<Block> m_pending;         //!< The blocks to write
+    std::vector<Block> m_free;           //!< The blocks to reuse
+    std::vector<Site> m_sites;           //!< All the sites
+    std::size_t m_sitesWritten{0};       //!< The number of sites in the file
+    std::string m_filename;              //!< The name given to Open()
+    std::ofstream m_file;                //!< The binary log file
+    std::thread m_writer;                //!< The writer thread
+};
+
+/**
+ * Get the binary log sink.
+ * \returns The sink.
+ */
+Sink&
+GetSink()
+{
+    // Never destroyed, as the destructors of other static objects may log
+    static Sink* sink = new Sink;
+    return *sink;
+}
+
+/**
+ * Close the binary log when the program exits, after the threads handed
+ * over their records.  The messages logged later go to \c std::clog.
+ */
+class SinkCloser
+{
+  public:
+    SinkCloser()
+    {
+        GetSink();
+    }
+
+    ~SinkCloser()
+    {
+        GetSink().Close();
+    }
+};
+
+/** Close the binary log at exit. */
+SinkCloser g_sinkCloser;
+
+/**
+ * Whether the record buffer of the calling thread was destroyed, when the
+ * thread exits; the thread then logs to \c std::clog.
+ */
+thread_local bool t_bufferDestroyed = false;
+
+/** The records of a thread. */
+struct ThreadBuffer
+{
+    ThreadBuffer()
+    {
+        block.thread = GetSink().NewThread();
+    }
+
+    ~ThreadBuffer()
+    {
+        if (block.size > 0)
+        {
+            GetSink().Submit(block);
+        }
+        t_bufferDestroyed = true;
+    }
+
+    Block block;                 //!< The records to hand over
+    std::size_t recordStart{0};  //!< The start of the top-level record in the block
+    std::size_t depth{0};        //!< The number of records being filled
+    std::vector<std::string> nested; //!< The records logged while filling another one
+    std::string deferred;        //!< The nested records to append after the top-level one
+    std::vector<std::unique_ptr<std::ostringstream>> formats; //!< Format stream of each depth
+};
+
+/**
+ * Get the record buffer of the calling thread.
+ * \returns The buffer.
+ */
+ThreadBuffer&
+GetThreadBuffer()
+{
+    thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+/** Hand the complete records of the calling thread over to the sink. */
+void
+SubmitThreadBuffer()
+{
+    if (!t_bufferDestroyed)
+    {
+        ThreadBuffer& buffer = GetThreadBuffer();
+        if (buffer.block.size > 0 && buffer.depth == 0)
+        {
+            GetSink().Submit(buffer.block);
+            buffer.recordStart = 0;
+        }
+    }
+}
+
+#ifndef __WIN32__
+void
+Sink::Prepare()
+{
+    Sink& sink = GetSink();
+    if (sink.IsOpen())
+    {
+        SubmitThreadBuffer();
+    }
+    sink.m_mutex.lock();
+}
+
+void
+Sink::Parent()
+{
+    GetSink().m_mutex.unlock();
+}
+
+void
+Sink::Child()
+{
+    Sink& sink = GetSink();
+    // The copies are not destroyed: the mutex was locked before the fork,
+    // and the thread object refers to a thread of the parent
+    new (&sink.m_mutex) std::mutex;
+    new (&sink.m_cv) std::condition_variable;
+    new (&sink.m_writer) std::thread;
+    sink.m_pending.clear();
+    sink.m_busy = false;
+    if (!sink.IsOpen())
+    {
+        return;
+    }
+    // The buffer and the offset of the stream are those of the parent,
+    // which writes them: leave the stream, and its descriptor, open
+    new (&sink.m_file) std::ofstream;
+    sink.m_sitesWritten = 0;
+    sink.OpenFile(sink.m_filename + "." + std::to_string(getpid()));
+}
+#endif
+
+/**
+ * Make room at the end of the block of a thread, handing the block over
+ * when it is full.
+ * \param [in,out] buffer The thread buffer.
+ * \param [in] size The size needed.
+ * \returns Where to write.
+ */
+char*
+Reserve(ThreadBuffer& buffer, std::size_t size)
+{
+    Block& block = buffer.block;
+    if (block.size + size > block.capacity)
+    {
+        if (buffer.recordStart > 0)
+        {
+            // Hand the complete records over, and move the record being
+            // filled to the start of a new block
+            std::string partial(block.data.get() + buffer.recordStart,
+                                block.size - buffer.recordStart);
+            block.size = buffer.recordStart;
+            GetSink().Submit(block);
+            buffer.recordStart = 0;
+            if (block.capacity < BLOCK_SIZE)
+            {
+                block.Grow(BLOCK_SIZE);
+            }
+            std::copy(partial.begin(), partial.end(), block.data.get());
+            block.size = partial.size();
+        }
+        if (block.size + size > block.capacity)
+        {
+            block.Grow(std::max(BLOCK_SIZE, 2 * (block.size + size)));
+        }
+    }
+    char* p = block.data.get() + block.size;
+    block.size += size;
+    return p;
+}
+
+/**
+ * Write bytes in the record being filled at some depth.
+ * \param [in,out] buffer The thread buffer.
+ * \param [in] depth The record depth.
+ * \param [in] data The bytes.
+ * \param [in] size The number of bytes.
+ */
+void
+Write(ThreadBuffer& buffer, std::size_t depth, const void* data, std::size_t size)
+{
+    if (depth == 1)
+    {
+        std::memcpy(Reserve(buffer, size), data, size);
+    }
+    else
+    {
+        buffer.nested[depth - 2].append(static_cast<const char*>(data), size);
+    }
+}
+
+/**
+ * Decode a binary log.
+ * \param [in] is The binary log.
+ * \param [out] os The stream where the log messages are written.
+ * \returns \c true if the whole log was decoded.
+ */
+bool Decode(std::istream& is, std::ostream& os);
+
+/**
+ * Decode the records of a block.
+ * \param [in] data The records.
+ * \param [in] size The size of the records.
+ * \param [in] resolution The time resolution.
+ * \param [in] sites The sites.
+ * \param [out] os The stream where the log messages are written.
+ * \returns \c true if the records are valid.
+ */
+bool
+DecodeBlock(const char* data,
+            std::size_t size,
+            uint8_t resolution,
+            const std::vector<Site>& sites,
+            std::ostream& os);
+
+} // unnamed namespace
+
+namespace ns3
+{
+
+void
+LogSetBinaryFile(const std::string& filename)
+{
+    Sink& sink = GetSink();
+    if (sink.IsOpen())
+    {
+        SubmitThreadBuffer();
+    }
+    sink.Close();
+    if (!filename.empty())
+    {
+        sink.Open(filename);
+    }
+}
+
+bool
+LogIsBinary()
+{
+    return GetSink().IsOpen() && !t_bufferDestroyed;
+}
+
+void
+LogFlushBinary()
+{
+    SubmitThreadBuffer();
+    GetSink().Flush();
+}
+
+LogBinarySite::LogBinarySite(const LogComponent& component,
+                             LogLevel level,
+                             const char* file,
+                             int line,
+                             const char* function)
+    : m_id(GetSink().Register(
+          {level, static_cast<uint32_t>(line), component.Name(), file, function}))
+{
+}
+
+uint32_t
+LogBinarySite::GetId() const
+{
+    return m_id;
+}
+
+LogBinaryRecord::LogBinaryRecord(const LogBinarySite& site, const LogComponent& component)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    m_depth = ++buffer.depth;
+    if (m_depth == 1)
+    {
+        buffer.recordStart = buffer.block.size;
+    }
+    else if (buffer.nested.size() < m_depth - 1)
+    {
+        buffer.nested.resize(m_depth - 1);
+    }
+
+    uint8_t flags = 0;
+    flags |= component.IsEnabled(LOG_PREFIX_TIME) ? PREFIX_TIME : 0;
+    flags |= component.IsEnabled(LOG_PREFIX_NODE) ? PREFIX_NODE : 0;
+    flags |= component.IsEnabled(LOG_PREFIX_FUNC) ? PREFIX_FUNC : 0;
+    flags |= component.IsEnabled(LOG_PREFIX_LEVEL) ? PREFIX_LEVEL : 0;
+    // The simulator installs the time printer once it exists
+    bool hasTime = LogGetTimePrinter() != nullptr;
+    flags |= hasTime ? HAS_TIME : 0;
+
+    uint32_t id = site.GetId();
+    Write(buffer, m_depth, &id, sizeof(id));
+    Write(buffer, m_depth, &flags, sizeof(flags));
+    if (hasTime)
+    {
+        int64_t ts = Simulator::Now().GetTimeStep();
+        uint32_t context = Simulator::GetContext();
+        Write(buffer, m_depth, &ts, sizeof(ts));
+        Write(buffer, m_depth, &context, sizeof(context));
+    }
+}
+
+LogBinaryRecord::~LogBinaryRecord()
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint8_t end = END;
+    Write(buffer, m_depth, &end, sizeof(end));
+    if (m_formatted)
+    {
+        auto& os = GetFormatStream();
+        os.flags(std::ios_base::boolalpha | std::ios_base::dec | std::ios_base::skipws);
+        os.precision(6);
+        os.width(0);
+        os.fill(' ');
+    }
+    --buffer.depth;
+    if (m_depth == 1)
+    {
+        if (!buffer.deferred.empty())
+        {
+            Write(buffer, 1, buffer.deferred.data(), buffer.deferred.size());
+            buffer.deferred.clear();
+        }
+        buffer.recordStart = buffer.block.size;
+    }
+    else
+    {
+        buffer.deferred.append(buffer.nested[m_depth - 2]);
+        buffer.nested[m_depth - 2].clear();
+    }
+}
+
+LogBinaryRecord&
+LogBinaryRecord::operator<<(std::ostream& (*manipulator)(std::ostream&))
+{
+    auto& os = GetFormatStream();
+    manipulator(os);
+    PutString(os.view());
+    os.str("");
+    return *this;
+}
+
+LogBinaryRecord&
+LogBinaryRecord::operator<<(std::ios_base& (*manipulator)(std::ios_base&))
+{
+    manipulator(GetFormatStream());
+    CheckFormat();
+    return *this;
+}
+
+void
+LogBinaryRecord::PutString(std::string_view value, bool quoted)
+{
+    if (value.empty() && !quoted)
+    {
+        return;
+    }
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint8_t tag = STRING;
+    auto size = static_cast<uint32_t>(value.size() + (quoted ? 2 : 0));
+    Write(buffer, m_depth, &tag, sizeof(tag));
+    Write(buffer, m_depth, &size, sizeof(size));
+    if (quoted)
+    {
+        Write(buffer, m_depth, "\"", 1);
+    }
+    Write(buffer, m_depth, value.data(), value.size());
+    if (quoted)
+    {
+        Write(buffer, m_depth, "\"", 1);
+    }
+}
+
+void
+LogBinaryRecord::Put(Tag tag, const void* data, std::size_t size)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    Write(buffer, m_depth, &tag, sizeof(tag));
+    Write(buffer, m_depth, data, size);
+}
+
+std::ostringstream&
+LogBinaryRecord::GetFormatStream()
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    while (buffer.formats.size() < m_depth)
+    {
+        auto os = std::make_unique<std::ostringstream>();
+        os->setf(std::ios_base::boolalpha);
+        buffer.formats.push_back(std::move(os));
+    }
+    return *buffer.formats[m_depth - 1];
+}
+
+void
+LogBinaryRecord::CheckFormat()
+{
+    auto& os = GetFormatStream();
+    m_formatted = m_formatted ||
+                  os.flags() != (std::ios_base::boolalpha | std::ios_base::dec |
+                                 std::ios_base::skipws) ||
+                  os.precision() != 6 || os.width() != 0 || os.fill() != ' ';
+}
+
+LogBinaryParameters::LogBinaryParameters(LogBinaryRecord& record)
+    : m_record(record)
+{
+}
+
+bool
+LogBinaryDecode(std::istream& is, std::ostream& os)
+{
+    auto flags = os.flags();
+    auto precision = os.precision();
+    bool ok = Decode(is, os);
+    os.flags(flags);
+    os.precision(precision);
+    return ok;
+}
+
+} // namespace ns3
+
+namespace
+{
+
+bool
+Decode(std::istream& is, std::ostream& os)
+{
+    char magic[sizeof(MAGIC)];
+    if (!is.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC))
+    {
+        return false;
+    }
+
+    auto read = [&is](auto& value) {
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    };
+    auto readString = [&is, &read](std::string& value) {
+        uint32_t size;
+        if (!read(size) || size > MAX_STRING)
+        {
+            return false;
+        }
+        value.resize(size);
+        return static_cast<bool>(is.read(value.data(), size));
+    };
+
+    std::vector<Site> sites;
+    std::vector<char> records;
+    uint8_t entry;
+    while (read(entry))
+    {
+        if (entry == SITE)
+        {
+            uint32_t id;
+            Site site;
+            if (!read(id) || !read(site.level) || !read(site.line) ||
+                !readString(site.component) || !readString(site.file) ||
+                !readString(site.function))
+            {
+                return false;
+            }
+            if (id >= sites.size())
+            {
+                sites.resize(id + 1);
+            }
+            sites[id] = std::move(site);
+        }
+        else if (entry == BLOCK)
+        {
+            uint32_t thread;
+            uint8_t resolution;
+            uint32_t size;
+            if (!read(thread) || !read(resolution) || !read(size))
+            {
+                return false;
+            }
+            records.resize(size);
+            if (!is.read(records.data(), size) ||
+                !DecodeBlock(records.data(), size, resolution, sites, os))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return is.eof();
+}
+
+bool
+DecodeBlock(const char* data,
+            std::size_t size,
+            uint8_t resolution,
+            const std::vector<Site>& sites,
+            std::ostream& os)
+{
+    using Tag = ns3::LogBinaryRecord::Tag;
+    std::size_t pos = 0;
+    auto read = [data, size, &pos](auto& value) {
+        if (pos + sizeof(value) > size)
+        {
+            return false;
+        }
+        std::memcpy(&value, data + pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    };
+
+    // The time precision of DefaultTimePrinter
+    int precision = 5;
+    switch (resolution)
+    {
+    case ns3::Time::US:
+        precision = 6;
+        break;
+    case ns3::Time::NS:
+        precision = 9;
+        break;
+    case ns3::Time::PS:
+        precision = 12;
+        break;
+    case ns3::Time::FS:
+        precision = 15;
+        break;
+    default:
+        break;
+    }
+    // The duration of a time step, in seconds, as a multiplier or divisor
+    static const double MULTIPLIERS[] = {365 * 86400.0, 86400.0, 3600.0, 60.0, 1.0};
+    static const double DIVISORS[] = {1e3, 1e6, 1e9, 1e12, 1e15};
+    if (resolution >= ns3::Time::LAST)
+    {
+        return false;
+    }
+
+    os << std::boolalpha;
+    while (pos < size)
+    {
+        uint32_t id;
+        uint8_t recordFlags;
+        if (!read(id) || !read(recordFlags) || id >= sites.size())
+        {
+            return false;
+        }
+        const Site& site = sites[id];
+
+        if (recordFlags & HAS_TIME)
+        {
+            int64_t ts;
+            uint32_t context;
+            if (!read(ts) || !read(context))
+            {
+                return false;
+            }
+            if (recordFlags & PREFIX_TIME)
+            {
+                double seconds = resolution <= ns3::Time::S
+                                     ? ts * MULTIPLIERS[resolution]
+                                     : ts / DIVISORS[resolution - ns3::Time::MS];
+                os << std::fixed << std::setprecision(precision) << std::showpos << seconds
+                   << "s " << std::noshowpos << std::defaultfloat << std::setprecision(6);
+            }
+            if (recordFlags & PREFIX_NODE)
+            {
+                if (context == ns3::Simulator::NO_CONTEXT)
+                {
+                    os << "-1 ";
+                }
+                else
+                {
+                    os << context << " ";
+                }
+            }
+        }
+
+        bool function = site.level == ns3::LOG_FUNCTION;
+        if (function)
+        {
+            os << site.component << ":" << site.function << "(";
+        }
+        else
+        {
+            if (recordFlags & PREFIX_FUNC)
+            {
+                os << site.component << ":" << site.function << "(): ";
+            }
+            if (recordFlags & PREFIX_LEVEL)
+            {
+                os << "[" << ns3::LogComponent::GetLevelLabel(ns3::LogLevel(site.level)) << "] ";
+            }
+        }
+
+        bool first = true;
+        uint8_t tag;
+        while (true)
+        {
+            if (!read(tag))
+            {
+                return false;
+            }
+            if (tag == Tag::END)
+            {
+                break;
+            }
+            if (function && !first)
+            {
+                os << ", ";
+            }
+            first = false;
+            switch (tag)
+            {
+            case Tag::STRING: {
+                uint32_t length;
+                if (!read(length) || pos + length > size)
+                {
+                    return false;
+                }
+                os.write(data + pos, length);
+                pos += length;
+                break;
+            }
+            case Tag::CHAR: {
+                char c;
+                if (!read(c))
+                {
+                    return false;
+                }
+                os << c;
+                break;
+            }
+            case Tag::BOOL: {
+                bool b;
+                if (!read(b))
+                {
+                    return false;
+                }
+                os << b;
+                break;
+            }
+            case Tag::INT: {
+                int64_t i;
+                if (!read(i))
+                {
+                    return false;
+                }
+                os << i;
+                break;
+            }
+            case Tag::UINT: {
+                uint64_t u;
+                if (!read(u))
+                {
+                    return false;
+                }
+                os << u;
+                break;
+            }
+            case Tag::DOUBLE: {
+                double d;
+                if (!read(d))
+                {
+                    return false;
+                }
+                os << d;
+                break;
+            }
+            case Tag::POINTER: {
+                uint64_t p;
+                if (!read(p))
+                {
+                    return false;
+                }
+                os << reinterpret_cast<const void*>(p);
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        os << (function ? ")\n" : "\n");
+    }
+    return true;
+}
+
+/**
+ * Select the binary log output from the \c NS_LOG_BINARY environment
+ * variable.
+ */
+class BinaryEnvVar
+{
+  public:
+    BinaryEnvVar()
+    {
+        auto [found, filename] = ns3::EnvironmentVariable::Get("NS_LOG_BINARY");
+        if (found && !filename.empty())
+        {
+            ns3::LogSetBinaryFile(filename);
+        }
+    }
+};
+
+/** Handle \c NS_LOG_BINARY at startup. */
+BinaryEnvVar g_binaryEnvVar;
+
+} // unnamed namespace
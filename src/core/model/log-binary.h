@@ -0,0 +1,373 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_LOG_BINARY_H
+#define NS3_LOG_BINARY_H
+
+#include "log.h"
+
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup logging
+ * Binary log output declarations.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup logging
+ *
+ * Send the log messages to a binary file instead of \c std::clog.
+ *
+ * Instead of formatting each message, the \c NS_LOG macros then write a
+ * compact record into a buffer of the calling thread: the id of the
+ * logging statement, the simulation time and context, the enabled prefixes
+ * and the raw values of the message arguments.  Full buffers are written
+ * to \p filename by a background thread.  The \c decode-binary-log
+ * program, or LogBinaryDecode(), renders the records as the text the
+ * \c NS_LOG macros would have printed.
+ *
+ * Arithmetic values, characters, strings and pointers are recorded as is;
+ * the values of other types are formatted with their output operator.
+ * The records do not include \c NS_LOG_APPEND_CONTEXT, and the time is
+ * printed by DefaultTimePrinter() whatever the TimePrinter in use.
+ * \c NS_LOG_UNCOND still prints to \c std::clog, as do the messages
+ * logged after the file is closed at program exit.
+ *
+ * The binary output can also be selected with the \c NS_LOG_BINARY
+ * environment variable, set to the file name.
+ *
+ * A process forked while the binary output is open, for instance by
+ * SimulationCheckpoint::Fork(), writes its records to a file of its own,
+ * named after \p filename followed by a dot and the process id.
+ *
+ * \param [in] filename The file name, or an empty string to flush and
+ *             close the binary output and go back to \c std::clog.
+ */
+void LogSetBinaryFile(const std::string& filename);
+
+/**
+ * \ingroup logging
+ * Check whether the log messages go to a binary file.
+ * \returns \c true if LogSetBinaryFile() selected a file.
+ */
+bool LogIsBinary();
+
+/**
+ * \ingroup logging
+ * Write the log records buffered so far by the calling thread to the
+ * binary file, and wait until all the records handed over by the threads
+ * are written.
+ *
+ * The other threads hand over their buffer when it is full, and when they
+ * exit.
+ */
+void LogFlushBinary();
+
+/**
+ * \ingroup logging
+ * Decode a binary log.
+ * \param [in] is The binary log.
+ * \param [out] os The stream where the log messages are written.
+ * \returns \c true if the whole log was decoded, \c false if it is
+ *          truncated or corrupted.
+ */
+bool LogBinaryDecode(std::istream& is, std::ostream& os);
+
+/**
+ * \ingroup logging
+ *
+ * A logging statement in the binary log.
+ *
+ * Each \c NS_LOG statement registers a static LogBinarySite the first
+ * time it writes to the binary log; the records only carry its id.
+ */
+class LogBinarySite
+{
+  public:
+    /**
+     * Register a logging statement.
+     * \param [in] component The log component of the statement.
+     * \param [in] level The level of the statement.
+     * \param [in] file The source file.
+     * \param [in] line The source line.
+     * \param [in] function The function name.
+     */
+    LogBinarySite(const LogComponent& component,
+                  LogLevel level,
+                  const char* file,
+                  int line,
+                  const char* function);
+
+    /** \returns The site id. */
+    uint32_t GetId() const;
+
+  private:
+    uint32_t m_id; //!< The site id.
+};
+
+/**
+ * \ingroup logging
+ *
+ * A record of the binary log, filled by the \c NS_LOG macros with the
+ * message arguments, and committed to the buffer of the calling thread
+ * when destroyed.
+ */
+class LogBinaryRecord
+{
+  public:
+    /** The types of the arguments in a record. */
+    enum Tag : uint8_t
+    {
+        END = 0,     //!< End of the record
+        STRING = 1,  //!< uint32_t length and characters
+        CHAR = 2,    //!< A character
+        BOOL = 3,    //!< A boolean
+        INT = 4,     //!< int64_t
+        UINT = 5,    //!< uint64_t
+        DOUBLE = 6,  //!< double
+        POINTER = 7, //!< uint64_t address
+    };
+
+    /**
+     * Start a record.
+     * \param [in] site The logging statement.
+     * \param [in] component The log component, for the enabled prefixes.
+     */
+    LogBinaryRecord(const LogBinarySite& site, const LogComponent& component);
+    /** Commit the record. */
+    ~LogBinaryRecord();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    LogBinaryRecord(const LogBinaryRecord&) = delete;
+    LogBinaryRecord& operator=(const LogBinaryRecord&) = delete;
+
+    /**
+     * Record a message argument.
+     *
+     * The argument is taken by forwarding reference, so that the types
+     * whose output operator takes a non-const reference can be logged.
+     *
+     * \tparam T \deduced The argument type.
+     * \param [in] value The argument.
+     * \returns This record, so it's chainable.
+     */
+    template <typename T>
+    LogBinaryRecord& operator<<(T&& value);
+
+    /**
+     * Record a stream manipulator, such as \c std::endl.
+     * \param [in] manipulator The manipulator.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryRecord& operator<<(std::ostream& (*manipulator)(std::ostream&));
+
+    /**
+     * Record a formatting manipulator, such as \c std::hex.
+     * \param [in] manipulator The manipulator.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryRecord& operator<<(std::ios_base& (*manipulator)(std::ios_base&));
+
+    /**
+     * Record a string argument.
+     * \param [in] value The string.
+     * \param [in] quoted Whether to surround the string with quotes.
+     */
+    void PutString(std::string_view value, bool quoted = false);
+
+  private:
+    /**
+     * Record a value of fixed size.
+     * \param [in] tag The value type.
+     * \param [in] data The value.
+     * \param [in] size The value size.
+     */
+    void Put(Tag tag, const void* data, std::size_t size);
+
+    /**
+     * Record an argument through the output operator.
+     * \tparam T \deduced The argument type.
+     * \param [in] value The argument.
+     */
+    template <typename T>
+    void PutFormatted(T&& value);
+
+    /**
+     * Get the stream which formats the arguments of this record.
+     * \returns The stream.
+     */
+    std::ostringstream& GetFormatStream();
+
+    /**
+     * Check whether the format stream left its default state, in which
+     * case the following arguments are all formatted, to honor the
+     * formatting manipulators.
+     */
+    void CheckFormat();
+
+    std::size_t m_depth;     //!< Nesting depth of this record in its thread.
+    bool m_formatted{false}; //!< Format all the following arguments.
+};
+
+/**
+ * \ingroup logging
+ * Insert the function arguments of \c NS_LOG_FUNCTION in a binary record,
+ * as ParameterLogger does in text.
+ */
+class LogBinaryParameters
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] record The record.
+     */
+    LogBinaryParameters(LogBinaryRecord& record);
+
+    /**
+     * Record a function argument.
+     * \tparam T \deduced The argument type.
+     * \param [in] param The argument.
+     * \returns This LogBinaryParameters, so it's chainable.
+     */
+    template <typename T>
+    LogBinaryParameters& operator<<(const T& param);
+
+    /**
+     * Overload for vectors, to record each element.
+     * \tparam T \deduced The vector element type.
+     * \param [in] vector The vector of arguments.
+     * \returns This LogBinaryParameters, so it's chainable.
+     */
+    template <typename T>
+    LogBinaryParameters& operator<<(const std::vector<T>& vector);
+
+  private:
+    LogBinaryRecord& m_record; //!< The record.
+};
+
+/*************************************************************************
+ *  Implementation of the templates declared above.
+ *************************************************************************/
+
+template <typename T>
+LogBinaryRecord&
+LogBinaryRecord::operator<<(T&& value)
+{
+    using U = std::remove_cvref_t<T>;
+    if (m_formatted)
+    {
+        PutFormatted(std::forward<T>(value));
+    }
+    else if constexpr (std::is_same_v<U, bool>)
+    {
+        Put(BOOL, &value, sizeof(value));
+    }
+    else if constexpr (std::is_same_v<U, char> || std::is_same_v<U, signed char> ||
+                       std::is_same_v<U, unsigned char>)
+    {
+        Put(CHAR, &value, sizeof(value));
+    }
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U> && sizeof(U) <= 8)
+    {
+        auto v = static_cast<int64_t>(value);
+        Put(INT, &v, sizeof(v));
+    }
+    else if constexpr (std::is_integral_v<U> && std::is_unsigned_v<U> && sizeof(U) <= 8)
+    {
+        auto v = static_cast<uint64_t>(value);
+        Put(UINT, &v, sizeof(v));
+    }
+    else if constexpr (std::is_same_v<U, float> || std::is_same_v<U, double>)
+    {
+        auto v = static_cast<double>(value);
+        Put(DOUBLE, &v, sizeof(v));
+    }
+    else if constexpr (std::is_convertible_v<T, const char*>)
+    {
+        const char* s = value;
+        PutString(s ? std::string_view(s) : std::string_view("(null)"));
+    }
+    else if constexpr (std::is_convertible_v<T, std::string_view>)
+    {
+        PutString(value);
+    }
+    else if constexpr (std::is_pointer_v<U> && !std::is_function_v<std::remove_pointer_t<U>>)
+    {
+        auto v = reinterpret_cast<uint64_t>(static_cast<const volatile void*>(value));
+        Put(POINTER, &v, sizeof(v));
+    }
+    else
+    {
+        PutFormatted(std::forward<T>(value));
+    }
+    return *this;
+}
+
+template <typename T>
+void
+LogBinaryRecord::PutFormatted(T&& value)
+{
+    auto& os = GetFormatStream();
+    os << std::forward<T>(value);
+    PutString(os.view());
+    os.str("");
+    CheckFormat();
+}
+
+template <typename T>
+LogBinaryParameters&
+LogBinaryParameters::operator<<(const T& param)
+{
+    if constexpr (std::is_convertible_v<T, std::string>)
+    {
+        m_record.PutString(std::string_view(param), true);
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        // Use + unary operator to cast uint8_t / int8_t to uint32_t / int32_t, respectively
+        m_record << +param;
+    }
+    else
+    {
+        m_record << param;
+    }
+    return *this;
+}
+
+template <typename T>
+LogBinaryParameters&
+LogBinaryParameters::operator<<(const std::vector<T>& vector)
+{
+    for (const auto& i : vector)
+    {
+        *this << i;
+    }
+    return *this;
+}
+
+} // namespace ns3
+
+#endif /* NS3_LOG_BINARY_H */
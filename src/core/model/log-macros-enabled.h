@@ -182,16 +182,31 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(level))                                                                \
+        if constexpr (NS_LOG_STATIC_ENABLED(level))                                                \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            NS_LOG_APPEND_FUNC_PREFIX;                                                             \
-            NS_LOG_APPEND_LEVEL_PREFIX(level);                                                     \
-            auto flags = std::clog.setf(std::ios_base::boolalpha);                                 \
-            std::clog << msg << std::endl;                                                         \
-            std::clog.flags(flags);                                                                \
+            if (g_log.IsEnabled(level))                                                            \
+            {                                                                                      \
+                if (ns3::LogIsBinary())                                                            \
+                {                                                                                  \
+                    static const ns3::LogBinarySite ns3LogSite(g_log,                              \
+                                                               level,                              \
+                                                               __FILE__,                           \
+                                                               __LINE__,                           \
+                                                               __FUNCTION__);                      \
+                    ns3::LogBinaryRecord(ns3LogSite, g_log) << msg;                                \
+                }                                                                                  \
+                else                                                                               \
+                {                                                                                  \
+                    NS_LOG_APPEND_TIME_PREFIX;                                                     \
+                    NS_LOG_APPEND_NODE_PREFIX;                                                     \
+                    NS_LOG_APPEND_CONTEXT;                                                         \
+                    NS_LOG_APPEND_FUNC_PREFIX;                                                     \
+                    NS_LOG_APPEND_LEVEL_PREFIX(level);                                             \
+                    auto flags = std::clog.setf(std::ios_base::boolalpha);                         \
+                    std::clog << msg << std::endl;                                                 \
+                    std::clog.flags(flags);                                                        \
+                }                                                                                  \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
@@ -207,12 +222,27 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
+        if constexpr (NS_LOG_STATIC_ENABLED(ns3::LOG_FUNCTION))                                    \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            std::clog << g_log.Name() << ":" << __FUNCTION__ << "()" << std::endl;                 \
+            if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                \
+            {                                                                                      \
+                if (ns3::LogIsBinary())                                                            \
+                {                                                                                  \
+                    static const ns3::LogBinarySite ns3LogSite(g_log,                              \
+                                                               ns3::LOG_FUNCTION,                  \
+                                                               __FILE__,                           \
+                                                               __LINE__,                           \
+                                                               __FUNCTION__);                      \
+                    ns3::LogBinaryRecord ns3LogRecord(ns3LogSite, g_log);                          \
+                }                                                                                  \
+                else                                                                               \
+                {                                                                                  \
+                    NS_LOG_APPEND_TIME_PREFIX;                                                     \
+                    NS_LOG_APPEND_NODE_PREFIX;                                                     \
+                    NS_LOG_APPEND_CONTEXT;                                                         \
+                    std::clog << g_log.Name() << ":" << __FUNCTION__ << "()" << std::endl;         \
+                }                                                                                  \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
@@ -241,16 +271,32 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
+        if constexpr (NS_LOG_STATIC_ENABLED(ns3::LOG_FUNCTION))                                    \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            std::clog << g_log.Name() << ":" << __FUNCTION__ << "(";                               \
-            auto flags = std::clog.setf(std::ios_base::boolalpha);                                 \
-            ns3::ParameterLogger(std::clog) << parameters;                                         \
-            std::clog.flags(flags);                                                                \
-            std::clog << ")" << std::endl;                                                         \
+            if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                \
+            {                                                                                      \
+                if (ns3::LogIsBinary())                                                            \
+                {                                                                                  \
+                    static const ns3::LogBinarySite ns3LogSite(g_log,                              \
+                                                               ns3::LOG_FUNCTION,                  \
+                                                               __FILE__,                           \
+                                                               __LINE__,                           \
+                                                               __FUNCTION__);                      \
+                    ns3::LogBinaryRecord ns3LogRecord(ns3LogSite, g_log);                          \
+                    ns3::LogBinaryParameters(ns3LogRecord) << parameters;                          \
+                }                                                                                  \
+                else                                                                               \
+                {                                                                                  \
+                    NS_LOG_APPEND_TIME_PREFIX;                                                     \
+                    NS_LOG_APPEND_NODE_PREFIX;                                                     \
+                    NS_LOG_APPEND_CONTEXT;                                                         \
+                    std::clog << g_log.Name() << ":" << __FUNCTION__ << "(";                       \
+                    auto flags = std::clog.setf(std::ios_base::boolalpha);                         \
+                    ns3::ParameterLogger(std::clog) << parameters;                                 \
+                    std::clog.flags(flags);                                                        \
+                    std::clog << ")" << std::endl;                                                 \
+                }                                                                                  \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
@@ -166,6 +166,34 @@ void LogComponentDisableAll(LogLevel level);
 
 } // namespace ns3
 
+#ifndef NS3_LOG_STATIC_MASK
+/**
+ * The log levels compiled in.
+ *
+ * The build system sets this, for each module, from the
+ * \c NS3_LOG_STATIC_LEVEL CMake option: the statements of the levels
+ * left out compile to nothing, whatever the runtime log configuration.
+ * By default, all the levels are compiled in.
+ */
+#define NS3_LOG_STATIC_MASK ns3::LOG_LEVEL_ALL
+#endif
+
+/**
+ * Check at compile time whether a log level is compiled in.
+ *
+ * \param [in] level The log level.
+ * \returns \c true if the statements of \p level are compiled in.
+ */
+#define NS_LOG_STATIC_ENABLED(level) (((level) & (NS3_LOG_STATIC_MASK)) != 0)
+
+/**
+ * The log levels which are not compiled in, which a LogComponent
+ * blocks so that they cannot be enabled at runtime.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ */
+#define NS_LOG_STATIC_BLOCKED static_cast<ns3::LogLevel>(ns3::LOG_ALL & ~(NS3_LOG_STATIC_MASK))
+
 /**
  * Define a Log component with a specific name.
  *
@@ -200,7 +228,7 @@ void LogComponentDisableAll(LogLevel level);
  * \param [in] name The log component name.
  */
 #define NS_LOG_COMPONENT_DEFINE(name)                                                              \
-    static ns3::LogComponent g_log = ns3::LogComponent(name, __FILE__)
+    static ns3::LogComponent g_log = ns3::LogComponent(name, __FILE__, NS_LOG_STATIC_BLOCKED)
 
 /**
  * Define a logging component with a mask.
@@ -211,7 +239,10 @@ void LogComponentDisableAll(LogLevel level);
  * \param [in] mask The default mask.
  */
 #define NS_LOG_COMPONENT_DEFINE_MASK(name, mask)                                                   \
-    static ns3::LogComponent g_log = ns3::LogComponent(name, __FILE__, mask)
+    static ns3::LogComponent g_log =                                                               \
+        ns3::LogComponent(name,                                                                    \
+                          __FILE__,                                                                \
+                          static_cast<ns3::LogLevel>((mask) | NS_LOG_STATIC_BLOCKED))
 
 /**
  * Declare a reference to a Log component.
@@ -509,4 +540,7 @@ ParameterLogger::operator<<(const std::vector<T>& vector)
 
 /**@}*/ // \ingroup logging
 
+// The NS_LOG macros write to the binary log when one is selected
+#include "log-binary.h"
+
 #endif /* NS3_LOG_H */
@@ -0,0 +1,341 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "memory-accounting.h"
+
+#include "abort.h"
+#include "assert.h"
+#include "environment-variable.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
+/**
+ * \file
+ * \ingroup object
+ * ns3::MemoryAccounting implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MemoryAccounting");
+
+namespace
+{
+
+/** A counter, shared by the simulation threads in multithreaded builds. */
+#ifdef NS3_MTP
+using Counter = std::atomic<int64_t>;
+#else
+using Counter = int64_t;
+#endif
+
+/** The counters of a TypeId or a category. */
+struct Entry
+{
+    Counter count{0}; //!< Number of live instances.
+    Counter bytes{0}; //!< Number of live bytes.
+    Counter peak{0};  //!< Largest number of live bytes so far.
+};
+
+/** The number of TypeId uids. */
+constexpr uint32_t MAX_TYPE_IDS = 1 << 16;
+/** The maximum number of categories. */
+constexpr uint32_t MAX_CATEGORIES = 32;
+
+/** Whether the memory is accounted for. */
+bool g_enabled = false;
+/**
+ * The entries of the TypeIds, indexed by uid, allocated by Enable().
+ * They are never released, as Objects may be deleted by the static
+ * destructors.
+ */
+Entry* g_types = nullptr;
+/** The entries of the categories. */
+Entry g_categories[MAX_CATEGORIES];
+/** The names of the categories. */
+const char* g_categoryNames[MAX_CATEGORIES];
+/** The number of registered categories. */
+uint32_t g_categoryCount = 0;
+/** The stream on which Simulator::Destroy() prints the usage. */
+std::ostream* g_reportStream = nullptr;
+/** The maximum number of entries printed by Simulator::Destroy(). */
+uint32_t g_reportEntries = 0;
+
+/**
+ * Update an entry.
+ * \param [in,out] entry The entry.
+ * \param [in] count The change of the number of live instances.
+ * \param [in] bytes The change of the number of live bytes.
+ */
+void
+Update(Entry& entry, int64_t count, int64_t bytes)
+{
+#ifdef NS3_MTP
+    entry.count.fetch_add(count, std::memory_order_relaxed);
+    int64_t now = entry.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = entry.peak.load(std::memory_order_relaxed);
+    while (now > peak &&
+           !entry.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+    {
+    }
+#else
+    entry.count += count;
+    entry.bytes += bytes;
+    entry.peak = std::max(entry.peak, entry.bytes);
+#endif
+}
+
+/**
+ * Get the usage recorded by an entry.
+ * \param [in] name The name of the entry.
+ * \param [in] entry The entry.
+ * \returns The usage.
+ */
+MemoryAccounting::Usage
+GetEntryUsage(const std::string& name, const Entry& entry)
+{
+    return {name, entry.count, entry.bytes, entry.peak};
+}
+
+/**
+ * Get the size of the instances of a TypeId.
+ * \param [in] tid The TypeId.
+ * \returns The size, 0 if it was not recorded.
+ */
+int64_t
+GetTypeSize(TypeId tid)
+{
+    std::size_t size = tid.GetSize();
+    // Types not registered with NS_OBJECT_ENSURE_REGISTERED have no size
+    return size == static_cast<std::size_t>(-1) ? 0 : static_cast<int64_t>(size);
+}
+
+} // unnamed namespace
+
+void
+MemoryAccounting::Enable()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    if (g_enabled)
+    {
+        return;
+    }
+    g_types = new Entry[MAX_TYPE_IDS];
+    g_enabled = true;
+}
+
+bool
+MemoryAccounting::IsEnabled()
+{
+    return g_enabled;
+}
+
+void
+MemoryAccounting::SetDestroyReport(std::ostream* os, uint32_t maxEntries)
+{
+    NS_LOG_FUNCTION(os << maxEntries);
+    g_reportStream = os;
+    g_reportEntries = maxEntries;
+}
+
+uint32_t
+MemoryAccounting::RegisterCategory(const char* name)
+{
+    NS_LOG_FUNCTION(name);
+    NS_ABORT_MSG_IF(g_categoryCount == MAX_CATEGORIES, "Too many memory categories");
+    g_categoryNames[g_categoryCount] = name;
+    return g_categoryCount++;
+}
+
+void
+MemoryAccounting::Allocated(uint32_t category, std::size_t bytes)
+{
+    if (g_enabled)
+    {
+        NS_ASSERT(category < g_categoryCount);
+        Update(g_categories[category], 1, static_cast<int64_t>(bytes));
+    }
+}
+
+void
+MemoryAccounting::Released(uint32_t category, std::size_t bytes)
+{
+    if (g_enabled)
+    {
+        NS_ASSERT(category < g_categoryCount);
+        Update(g_categories[category], -1, -static_cast<int64_t>(bytes));
+    }
+}
+
+bool
+MemoryAccounting::ObjectCreated(TypeId tid)
+{
+    if (!g_enabled)
+    {
+        return false;
+    }
+    Update(g_types[tid.GetUid()], 1, GetTypeSize(tid));
+    return true;
+}
+
+void
+MemoryAccounting::ObjectDestroyed(TypeId tid)
+{
+    NS_ASSERT(g_enabled);
+    Update(g_types[tid.GetUid()], -1, -GetTypeSize(tid));
+}
+
+MemoryAccounting::Usage
+MemoryAccounting::GetUsage(TypeId tid)
+{
+    NS_LOG_FUNCTION(tid);
+    if (g_types == nullptr)
+    {
+        return {tid.GetName(), 0, 0, 0};
+    }
+    return GetEntryUsage(tid.GetName(), g_types[tid.GetUid()]);
+}
+
+MemoryAccounting::Usage
+MemoryAccounting::GetUsage(const std::string& name)
+{
+    NS_LOG_FUNCTION(name);
+    for (uint32_t i = 0; i < g_categoryCount; ++i)
+    {
+        if (name == g_categoryNames[i])
+        {
+            return GetEntryUsage(name, g_categories[i]);
+        }
+    }
+    return {name, 0, 0, 0};
+}
+
+std::vector<MemoryAccounting::Usage>
+MemoryAccounting::GetUsages()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    std::vector<Usage> usages;
+    if (g_types != nullptr)
+    {
+        for (uint16_t i = 0; i < TypeId::GetRegisteredN(); ++i)
+        {
+            TypeId tid = TypeId::GetRegistered(i);
+            const Entry& entry = g_types[tid.GetUid()];
+            if (entry.peak != 0 || entry.count != 0)
+            {
+                usages.push_back(GetEntryUsage(tid.GetName(), entry));
+            }
+        }
+    }
+    for (uint32_t i = 0; i < g_categoryCount; ++i)
+    {
+        if (g_categories[i].peak != 0 || g_categories[i].count != 0)
+        {
+            usages.push_back(GetEntryUsage(g_categoryNames[i], g_categories[i]));
+        }
+    }
+    std::sort(usages.begin(), usages.end(), [](const Usage& a, const Usage& b) {
+        if (a.bytes != b.bytes)
+        {
+            return a.bytes > b.bytes;
+        }
+        if (a.peak != b.peak)
+        {
+            return a.peak > b.peak;
+        }
+        return a.name < b.name;
+    });
+    return usages;
+}
+
+void
+MemoryAccounting::Print(std::ostream& os, uint32_t maxEntries)
+{
+    NS_LOG_FUNCTION(&os << maxEntries);
+    const int nwidth = 48;
+    const int fwidth = 14;
+    auto usages = GetUsages();
+    os << std::left << std::setw(nwidth) << "Type" << std::right << std::setw(fwidth) << "Count"
+       << std::setw(fwidth) << "Bytes" << std::setw(fwidth) << "Peak bytes" << std::endl;
+    int64_t count = 0;
+    int64_t bytes = 0;
+    for (std::size_t i = 0; i < usages.size(); ++i)
+    {
+        const auto& usage = usages[i];
+        count += usage.count;
+        bytes += usage.bytes;
+        if (maxEntries == 0 || i < maxEntries)
+        {
+            os << std::left << std::setw(nwidth) << usage.name << std::right << std::setw(fwidth)
+               << usage.count << std::setw(fwidth) << usage.bytes << std::setw(fwidth)
+               << usage.peak << std::endl;
+        }
+    }
+    if (maxEntries != 0 && usages.size() > maxEntries)
+    {
+        os << "(" << usages.size() - maxEntries << " more)" << std::endl;
+    }
+    os << std::left << std::setw(nwidth) << "Total" << std::right << std::setw(fwidth) << count
+       << std::setw(fwidth) << bytes << std::endl;
+}
+
+void
+MemoryAccounting::ReportAtDestroy()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    if (g_enabled && g_reportStream != nullptr)
+    {
+        Print(*g_reportStream, g_reportEntries);
+    }
+}
+
+namespace
+{
+
+/**
+ * Enable the memory accounting, and its report at Simulator::Destroy(),
+ * from the \c NS_MEMORY_ACCOUNTING environment variable.
+ */
+class MemoryAccountingEnvVar
+{
+  public:
+    MemoryAccountingEnvVar()
+    {
+        auto [found, value] = EnvironmentVariable::Get("NS_MEMORY_ACCOUNTING");
+        if (found)
+        {
+            long entries = std::strtol(value.c_str(), nullptr, 10);
+            MemoryAccounting::Enable();
+            MemoryAccounting::SetDestroyReport(&std::clog,
+                                               entries > 0 ? static_cast<uint32_t>(entries) : 0);
+        }
+    }
+};
+
+/** Handle \c NS_MEMORY_ACCOUNTING at startup. */
+MemoryAccountingEnvVar g_memoryAccountingEnvVar;
+
+} // unnamed namespace
+
+} // namespace ns3
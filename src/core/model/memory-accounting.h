@@ -0,0 +1,182 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include "type-id.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup object
+ * ns3::MemoryAccounting declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup object
+ * \ingroup debugging
+ *
+ * \brief Count the live instances and their bytes, per TypeId, to find
+ * which models use the memory of a large simulation.
+ *
+ * Once enabled, each Object built by CreateObject(), ObjectFactory::Create()
+ * or CopyObject() is accounted for under its TypeId, with the size recorded
+ * by NS_OBJECT_ENSURE_REGISTERED(), until it is deleted.  The objects built
+ * before the accounting was enabled are never counted.  The sizes are
+ * those of the objects themselves: the memory they own, such as their
+ * containers, is not included.
+ *
+ * The memory which does not belong to an Object, such as the packets and
+ * their buffers, is accounted for in named categories, which the modules
+ * register with RegisterCategory() and update with Allocated() and
+ * Released().  The network module registers \c Packet, \c Buffer::Data,
+ * \c Buffer::Chain, \c PacketMetadata::Data and \c PacketMetadata::Node,
+ * and the free lists of \c Buffer::Data and \c PacketMetadata::Data.  As
+ * the categories have no per-instance record, the accounting should be
+ * enabled before the first packet is created.
+ *
+ * The accounting is disabled by default, and costs a function call per
+ * object then.  It is enabled with Enable(), or with the
+ * \c NS_MEMORY_ACCOUNTING environment variable, which also prints the
+ * usage when Simulator::Destroy() is called:
+ *
+ * \code
+ *   $ NS_MEMORY_ACCOUNTING=20 ./ns3 run my-program
+ * \endcode
+ *
+ * prints the 20 largest entries, or all of them if the value is not a
+ * positive number.  ShowProgress::SetMemoryReport() prints the usage
+ * periodically while the simulation runs.
+ */
+class MemoryAccounting
+{
+  public:
+    /** The memory used by a TypeId or a category. */
+    struct Usage
+    {
+        std::string name; //!< The TypeId or category name.
+        int64_t count;    //!< Number of live instances.
+        int64_t bytes;    //!< Number of live bytes.
+        int64_t peak;     //!< Largest number of live bytes so far.
+    };
+
+    /** Start accounting for the memory. */
+    static void Enable();
+
+    /**
+     * Check if the memory is accounted for.
+     * \returns \c true if the accounting is enabled.
+     */
+    static bool IsEnabled();
+
+    /**
+     * Print the usage when Simulator::Destroy() is called.
+     *
+     * \param [in] os The stream to print on, or \c nullptr to print nothing.
+     * \param [in] maxEntries The maximum number of entries to print, 0 for all.
+     */
+    static void SetDestroyReport(std::ostream* os, uint32_t maxEntries = 0);
+
+    /**
+     * Register a category of memory which does not belong to an Object.
+     *
+     * Usually called once, at static initialization.
+     *
+     * \param [in] name The name of the category, which must outlive the
+     *             program, such as a string literal.
+     * \returns The category identifier.
+     */
+    static uint32_t RegisterCategory(const char* name);
+
+    /**
+     * Account for an allocation in a category, if enabled.
+     * \param [in] category The category identifier.
+     * \param [in] bytes The size of the allocation.
+     */
+    static void Allocated(uint32_t category, std::size_t bytes);
+
+    /**
+     * Account for a deallocation in a category, if enabled.
+     * \param [in] category The category identifier.
+     * \param [in] bytes The size of the allocation.
+     */
+    static void Released(uint32_t category, std::size_t bytes);
+
+    /**
+     * Account for a new Object.
+     *
+     * Invoked by Object only.
+     *
+     * \param [in] tid The TypeId of the Object.
+     * \returns \c true if the Object was accounted for, and must be
+     *          released with ObjectDestroyed().
+     */
+    static bool ObjectCreated(TypeId tid);
+
+    /**
+     * Account for the deletion of an Object accounted for by
+     * ObjectCreated().
+     * \param [in] tid The TypeId of the Object.
+     */
+    static void ObjectDestroyed(TypeId tid);
+
+    /**
+     * Get the memory used by the instances of a TypeId.
+     * \param [in] tid The TypeId.
+     * \returns The usage.
+     */
+    static Usage GetUsage(TypeId tid);
+
+    /**
+     * Get the memory used by a category.
+     * \param [in] name The category name.
+     * \returns The usage, empty if the category does not exist.
+     */
+    static Usage GetUsage(const std::string& name);
+
+    /**
+     * Get the memory used by all the TypeIds and categories which had
+     * live instances.
+     * \returns The usages, by decreasing number of live bytes.
+     */
+    static std::vector<Usage> GetUsages();
+
+    /**
+     * Print the usages as a table, by decreasing number of live bytes,
+     * followed by the totals.
+     * \param [in] os The stream to print on.
+     * \param [in] maxEntries The maximum number of entries to print, 0 for all.
+     */
+    static void Print(std::ostream& os, uint32_t maxEntries = 0);
+
+    /**
+     * Print the usage if requested by SetDestroyReport().
+     *
+     * Invoked by Simulator::Destroy() only.
+     */
+    static void ReportAtDestroy();
+};
+
+} // namespace ns3
+
+#endif /* MEMORY_ACCOUNTING_H */
@@ -23,9 +23,11 @@
 #include "assert.h"
 #include "attribute.h"
 #include "log.h"
+#include "memory-accounting.h"
 #include "object-factory.h"
 #include "string.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <sstream>
@@ -48,6 +50,107 @@ NS_LOG_COMPONENT_DEFINE("Object");
 
 NS_OBJECT_ENSURE_REGISTERED(Object);
 
+/**
+ * The results of the lookups by TypeId in a list of aggregates.
+ *
+ * This is an open-addressed hash table keyed by the TypeId uid, with
+ * linear probing, which grows with the number of TypeIds looked up.
+ * Failed lookups are recorded too, with a null Object.  The aggregates
+ * only change when Objects are aggregated, which creates a new list, or
+ * when an Object is deleted, which clears the cache, so the entries never
+ * become stale.
+ *
+ * As the order of the aggregates, the cache is not protected against
+ * concurrent lookups in the same aggregates.
+ */
+struct Object::LookupCache
+{
+    /** Initial number of entries, a power of 2. */
+    static constexpr uint32_t MIN_SIZE = 8;
+    /** Number of entries beyond which the cache is cleared instead of grown. */
+    static constexpr uint32_t MAX_SIZE = 1024;
+
+    /** A cached lookup. */
+    struct Entry
+    {
+        uint16_t uid;   //!< The TypeId uid, 0 if the entry is free
+        Object* object; //!< The matching Object, or \c nullptr
+    };
+
+    /** Constructor. */
+    LookupCache()
+        : used(0),
+          entries(MIN_SIZE, Entry{0, nullptr})
+    {
+    }
+
+    /**
+     * Find a cached lookup.
+     * \param [in] uid The TypeId uid, not 0.
+     * \returns The entry, or \c nullptr if the lookup is not cached.
+     */
+    const Entry* Find(uint16_t uid) const
+    {
+        const uint32_t mask = entries.size() - 1;
+        for (uint32_t i = uid & mask; entries[i].uid != 0; i = (i + 1) & mask)
+        {
+            if (entries[i].uid == uid)
+            {
+                return &entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Cache a lookup which is not cached yet.
+     * \param [in] uid The TypeId uid, not 0.
+     * \param [in] object The matching Object, or \c nullptr.
+     */
+    void Insert(uint16_t uid, Object* object)
+    {
+        // Keep the load factor at most 3/4
+        if (4 * (used + 1) > 3 * entries.size())
+        {
+            std::vector<Entry> old(entries.size() < MAX_SIZE ? 2 * entries.size()
+                                                             : entries.size(),
+                                   Entry{0, nullptr});
+            old.swap(entries);
+            used = 0;
+            if (old.size() < entries.size())
+            {
+                for (const auto& entry : old)
+                {
+                    if (entry.uid != 0)
+                    {
+                        Insert(entry.uid, entry.object);
+                    }
+                }
+            }
+        }
+        const uint32_t mask = entries.size() - 1;
+        uint32_t i = uid & mask;
+        while (entries[i].uid != 0)
+        {
+            i = (i + 1) & mask;
+        }
+        entries[i] = {uid, object};
+        used++;
+    }
+
+    /** Forget all the lookups. */
+    void Clear()
+    {
+        std::fill(entries.begin(), entries.end(), Entry{0, nullptr});
+        used = 0;
+    }
+
+    /** The number of entries used. */
+    uint32_t used;
+    /** The entries; their number is a power of 2. */
+    std::vector<Entry> entries;
+};
+
 Object::AggregateIterator::AggregateIterator()
     : m_object(nullptr),
       m_current(0)
@@ -97,10 +200,12 @@ Object::Object()
       m_disposed(false),
       m_initialized(false),
       m_aggregates((Aggregates*)std::malloc(sizeof(Aggregates))),
-      m_getObjectCount(0)
+      m_getObjectCount(0),
+      m_accounted(false)
 {
     NS_LOG_FUNCTION(this);
     m_aggregates->n = 1;
+    m_aggregates->cache = nullptr;
     m_aggregates->buffer[0] = this;
 }
 
@@ -120,13 +225,20 @@ Object::~Object()
             m_aggregates->n--;
         }
     }
+    // the cached lookups may point to this object
+    ClearLookupCache(m_aggregates);
     // finally, if all objects have been removed from the list,
     // delete the aggregate list
     if (m_aggregates->n == 0)
     {
+        delete m_aggregates->cache;
         std::free(m_aggregates);
     }
     m_aggregates = nullptr;
+    if (m_accounted)
+    {
+        MemoryAccounting::ObjectDestroyed(m_tid);
+    }
 }
 
 Object::Object(const Object& o)
@@ -134,9 +246,11 @@ Object::Object(const Object& o)
       m_disposed(false),
       m_initialized(false),
       m_aggregates((Aggregates*)std::malloc(sizeof(Aggregates))),
-      m_getObjectCount(0)
+      m_getObjectCount(0),
+      m_accounted(MemoryAccounting::ObjectCreated(o.m_tid))
 {
     m_aggregates->n = 1;
+    m_aggregates->cache = nullptr;
     m_aggregates->buffer[0] = this;
 }
 
@@ -153,6 +267,18 @@ Object::DoGetObject(TypeId tid) const
     NS_LOG_FUNCTION(this << tid);
     NS_ASSERT(CheckLoose());
 
+    const uint16_t uid = tid.GetUid();
+    LookupCache* cache = m_aggregates->cache;
+    if (cache != nullptr && uid != 0)
+    {
+        const LookupCache::Entry* entry = cache->Find(uid);
+        if (entry != nullptr)
+        {
+            return entry->object;
+        }
+    }
+
+    Object* found = nullptr;
     uint32_t n = m_aggregates->n;
     TypeId objectTid = Object::GetTypeId();
     for (uint32_t i = 0; i < n; i++)
@@ -165,21 +291,30 @@ Object::DoGetObject(TypeId tid) const
         }
         if (cur == tid)
         {
-            // This is an attempt to 'cache' the result of this lookup.
-            // the idea is that if we perform a lookup for a TypeId on this object,
-            // we are likely to perform the same lookup later so, we make sure
-            // that the aggregate array is sorted by the number of accesses
-            // to each object.
+            // Keep the aggregate array sorted by the number of lookups
+            // which were not cached, so that the objects looked up for many
+            // types come first.
 
             // first, increment the access count
             current->m_getObjectCount++;
             // then, update the sort
             UpdateSortedArray(m_aggregates, i);
-            // finally, return the match
-            return const_cast<Object*>(current);
+            found = current;
+            break;
         }
     }
-    return nullptr;
+
+    // Finally, cache the result; uid 0 is the unregistered TypeId
+    if (uid != 0)
+    {
+        if (cache == nullptr)
+        {
+            cache = new LookupCache;
+            m_aggregates->cache = cache;
+        }
+        cache->Insert(uid, found);
+    }
+    return found;
 }
 
 void
@@ -241,6 +376,16 @@ restart:
     }
 }
 
+void
+Object::ClearLookupCache(Aggregates* aggregates)
+{
+    NS_LOG_FUNCTION(aggregates);
+    if (aggregates->cache != nullptr)
+    {
+        aggregates->cache->Clear();
+    }
+}
+
 void
 Object::UpdateSortedArray(Aggregates* aggregates, uint32_t j) const
 {
@@ -269,6 +414,7 @@ Object::AggregateObject(Ptr<Object> o)
     uint32_t total = m_aggregates->n + other->m_aggregates->n;
     auto aggregates = (Aggregates*)std::malloc(sizeof(Aggregates) + (total - 1) * sizeof(Object*));
     aggregates->n = total;
+    aggregates->cache = nullptr;
 
     // copy our buffer to the new buffer
     std::memcpy(&aggregates->buffer[0],
@@ -319,6 +465,8 @@ Object::AggregateObject(Ptr<Object> o)
     }
 
     // Now that we are done with them, we can free our old aggregate buffers
+    delete a->cache;
+    delete b->cache;
     std::free(a);
     std::free(b);
 }
@@ -345,7 +493,13 @@ Object::SetTypeId(TypeId tid)
 {
     NS_LOG_FUNCTION(this << tid);
     NS_ASSERT(Check());
+    if (m_accounted)
+    {
+        MemoryAccounting::ObjectDestroyed(m_tid);
+    }
     m_tid = tid;
+    m_accounted = MemoryAccounting::ObjectCreated(tid);
+    ClearLookupCache(m_aggregates);
 }
 
 void
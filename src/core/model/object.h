@@ -331,6 +331,9 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
 
     /**@}*/
 
+    /** A cache of the lookups by TypeId in the aggregates. */
+    struct LookupCache;
+
     /**
      * The list of Objects aggregated to this one.
      *
@@ -347,6 +350,8 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
     {
         /** The number of entries in \c buffer. */
         uint32_t n;
+        /** The results of the previous lookups, or \c nullptr. */
+        LookupCache* cache;
         /** The array of Objects. */
         Object* buffer[1];
     };
@@ -354,6 +359,9 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
     /**
      * Find an Object of TypeId tid in the aggregates of this Object.
      *
+     * The result, found or not, is cached in the aggregates, so that
+     * repeated lookups of the same TypeId take constant time.
+     *
      * \param [in] tid The TypeId we're looking for
      * \return The matching Object, if it is found
      */
@@ -398,6 +406,12 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      */
     void Construct(const AttributeConstructionList& attributes);
 
+    /**
+     * Forget the lookups cached for a list of aggregates.
+     *
+     * \param [in,out] aggregates The list of aggregated Objects.
+     */
+    static void ClearLookupCache(Aggregates* aggregates);
     /**
      * Keep the list of aggregates in most-recently-used order
      *
@@ -444,6 +458,11 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      * the array of aggregates in most-frequently accessed order.
      */
     uint32_t m_getObjectCount;
+    /**
+     * Set to \c true when this Object is counted by MemoryAccounting
+     * under its TypeId.
+     */
+    bool m_accounted;
 };
 
 template <typename T>
@@ -90,27 +90,129 @@ PriorityQueueScheduler::RemoveNext()
     return ev;
 }
 
+bool
+PriorityQueueScheduler::EventPriorityQueue::empty() const
+{
+    return m_heap.empty();
+}
+
+const Scheduler::Event&
+PriorityQueueScheduler::EventPriorityQueue::top() const
+{
+    NS_ASSERT(!m_heap.empty());
+    return m_heap.front();
+}
+
+void
+PriorityQueueScheduler::EventPriorityQueue::push(const Scheduler::Event& ev)
+{
+    m_heap.push_back(ev);
+    ev.impl->SetSchedulerIndex(m_heap.size() - 1);
+    SiftUp(m_heap.size() - 1);
+}
+
+void
+PriorityQueueScheduler::EventPriorityQueue::pop()
+{
+    NS_ASSERT(!m_heap.empty());
+    Scheduler::Event last = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty())
+    {
+        Place(0, last);
+        SiftDown(0);
+    }
+}
+
 bool
 PriorityQueueScheduler::EventPriorityQueue::remove(const Scheduler::Event& ev)
 {
-    auto it = std::find(this->c.begin(), this->c.end(), ev);
-    if (it != this->c.end())
+    std::size_t pos = ev.impl->GetSchedulerIndex();
+    if (pos >= m_heap.size() || m_heap[pos].key.m_uid != ev.key.m_uid)
+    {
+        return false;
+    }
+    Scheduler::Event last = m_heap.back();
+    m_heap.pop_back();
+    if (pos < m_heap.size())
+    {
+        // The last event may belong above or below the removed one.
+        Place(pos, last);
+        if (!SiftUp(pos))
+        {
+            SiftDown(pos);
+        }
+    }
+    return true;
+}
+
+void
+PriorityQueueScheduler::EventPriorityQueue::Place(std::size_t pos, const Scheduler::Event& ev)
+{
+    m_heap[pos] = ev;
+    ev.impl->SetSchedulerIndex(pos);
+}
+
+bool
+PriorityQueueScheduler::EventPriorityQueue::SiftUp(std::size_t pos)
+{
+    // Move the parents down into the hole, and place the event last.
+    Scheduler::Event ev = m_heap[pos];
+    std::size_t start = pos;
+    while (pos > 0)
     {
-        this->c.erase(it);
-        std::make_heap(this->c.begin(), this->c.end(), this->comp);
-        return true;
+        std::size_t parent = (pos - 1) / 2;
+        if (!(ev < m_heap[parent]))
+        {
+            break;
+        }
+        Place(pos, m_heap[parent]);
+        pos = parent;
     }
-    else
+    if (pos == start)
     {
         return false;
     }
+    Place(pos, ev);
+    return true;
+}
+
+void
+PriorityQueueScheduler::EventPriorityQueue::SiftDown(std::size_t pos)
+{
+    Scheduler::Event ev = m_heap[pos];
+    std::size_t start = pos;
+    std::size_t size = m_heap.size();
+    while (true)
+    {
+        std::size_t child = 2 * pos + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && m_heap[child + 1] < m_heap[child])
+        {
+            ++child;
+        }
+        if (!(m_heap[child] < ev))
+        {
+            break;
+        }
+        Place(pos, m_heap[child]);
+        pos = child;
+    }
+    if (pos != start)
+    {
+        Place(pos, ev);
+    }
 }
 
 void
 PriorityQueueScheduler::Remove(const Scheduler::Event& ev)
 {
-    NS_LOG_FUNCTION(this);
-    m_queue.remove(ev);
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    bool found [[maybe_unused]] = m_queue.remove(ev);
+    NS_ASSERT(found);
 }
 
 } // namespace ns3
@@ -22,11 +22,8 @@
 
 #include "scheduler.h"
 
-#include <algorithm>
-#include <functional>
-#include <queue>
 #include <stdint.h>
-#include <utility>
+#include <vector>
 
 /**
  * \file
@@ -41,18 +38,22 @@ namespace ns3
  * \ingroup scheduler
  * \brief a std::priority_queue event scheduler
  *
- * This class implements an event scheduler using
- * `std::priority_queue` on a `std::vector`.
+ * This class implements an event scheduler using a binary heap
+ * on a `std::vector`, with the same interface as `std::priority_queue`.
+ * Unlike `std::priority_queue`, the heap is indexed: each event
+ * records its position in the heap (see EventImpl::SetSchedulerIndex()),
+ * so an event can be removed without searching for it and
+ * rebuilding the heap.
  *
  * \par Time Complexity
  *
  * Operation    | Amortized %Time  | Reason
  * :----------- | :--------------- | :-----
- * Insert()     | Logarithmic      | `std::push_heap()`
+ * Insert()     | Logarithmic      | Sift up
  * IsEmpty()    | Constant         | `std::vector::empty()`
  * PeekNext()   | Constant         | `std::vector::front()`
- * Remove()     | Linear           | `std::find()` and `std::make_heap()`
- * RemoveNext() | Logarithmic      | `std::pop_heap()`
+ * Remove()     | Logarithmic      | Sift up or down
+ * RemoveNext() | Logarithmic      | Sift down
  *
  * \par Memory Complexity
  *
@@ -85,20 +86,57 @@ class PriorityQueueScheduler : public Scheduler
 
   private:
     /**
-     * Custom priority_queue which supports remove,
+     * Indexed priority queue which supports remove,
      * and returns entries in _increasing_ time order.
      */
-    class EventPriorityQueue : public std::priority_queue<Scheduler::Event,
-                                                          std::vector<Scheduler::Event>,
-                                                          std::greater<>>
+    class EventPriorityQueue
     {
       public:
+        /**
+         * \returns \c true if the queue is empty.
+         */
+        bool empty() const;
+        /**
+         * \returns The earliest event.
+         */
+        const Scheduler::Event& top() const;
+        /**
+         * Add an event.
+         * \param [in] ev The event.
+         */
+        void push(const Scheduler::Event& ev);
+        /** Remove the earliest event. */
+        void pop();
         /**
          * \copydoc PriorityQueueScheduler::Remove()
          * \returns \c true if the event was found, false otherwise.
          */
         bool remove(const Scheduler::Event& ev);
 
+      private:
+        /**
+         * Store an event at a heap position, and record the position.
+         * \param [in] pos The heap position.
+         * \param [in] ev The event.
+         */
+        void Place(std::size_t pos, const Scheduler::Event& ev);
+        /**
+         * Move the event at a heap position towards the front
+         * until its parent is earlier.
+         * \param [in] pos The heap position.
+         * \returns \c true if the event was moved.
+         */
+        bool SiftUp(std::size_t pos);
+        /**
+         * Move the event at a heap position towards the back
+         * until its children are later.
+         * \param [in] pos The heap position.
+         */
+        void SiftDown(std::size_t pos);
+
+        /** The heap. */
+        std::vector<Scheduler::Event> m_heap;
+
     }; // class EventPriorityQueue
 
     /** The event queue. */
@@ -38,6 +38,10 @@
 #include <cmath>
 #include <iostream>
 
+#ifdef NS3_MTP
+#include <mutex>
+#endif
+
 /**
  * \file
  * \ingroup randomvariable
@@ -49,6 +53,21 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("RandomVariableStream");
 
+/**
+ * \ingroup randomvariable
+ * The first stream of the list of all the RandomVariableStreams, for
+ * RandomVariableStream::ReseedAll().
+ */
+static RandomVariableStream* g_firstStream = nullptr;
+
+#ifdef NS3_MTP
+/**
+ * \ingroup randomvariable
+ * Protects the list of all the RandomVariableStreams.
+ */
+static std::mutex g_streamsMutex;
+#endif
+
 NS_OBJECT_ENSURE_REGISTERED(RandomVariableStream);
 
 TypeId
@@ -77,14 +96,42 @@ RandomVariableStream::GetTypeId()
 }
 
 RandomVariableStream::RandomVariableStream()
-    : m_rng(nullptr)
+    : m_rng(nullptr),
+      m_rngIndex(0),
+      m_prevStream(nullptr)
 {
     NS_LOG_FUNCTION(this);
+#ifdef NS3_MTP
+    std::lock_guard lock(g_streamsMutex);
+#endif
+    m_nextStream = g_firstStream;
+    if (m_nextStream != nullptr)
+    {
+        m_nextStream->m_prevStream = this;
+    }
+    g_firstStream = this;
 }
 
 RandomVariableStream::~RandomVariableStream()
 {
     NS_LOG_FUNCTION(this);
+    {
+#ifdef NS3_MTP
+        std::lock_guard lock(g_streamsMutex);
+#endif
+        if (m_prevStream != nullptr)
+        {
+            m_prevStream->m_nextStream = m_nextStream;
+        }
+        else
+        {
+            g_firstStream = m_nextStream;
+        }
+        if (m_nextStream != nullptr)
+        {
+            m_nextStream->m_prevStream = m_prevStream;
+        }
+    }
     delete m_rng;
 }
 
@@ -109,6 +156,16 @@ RandomVariableStream::GetInteger()
     return static_cast<uint32_t>(GetValue());
 }
 
+void
+RandomVariableStream::GetValues(std::span<double> values)
+{
+    NS_LOG_FUNCTION(this << values.size());
+    for (auto& v : values)
+    {
+        v = GetValue();
+    }
+}
+
 void
 RandomVariableStream::SetStream(int64_t stream)
 {
@@ -122,16 +179,16 @@ RandomVariableStream::SetStream(int64_t stream)
         // number assignment.
         uint64_t nextStream = RngSeedManager::GetNextStreamIndex();
         NS_ASSERT(nextStream <= ((1ULL) << 63));
-        m_rng = new RngStream(RngSeedManager::GetSeed(), nextStream, RngSeedManager::GetRun());
+        m_rngIndex = nextStream;
     }
     else
     {
         // The last 2^63 streams are reserved for deterministic stream
         // number assignment.
         uint64_t base = ((1ULL) << 63);
-        uint64_t target = base + stream;
-        m_rng = new RngStream(RngSeedManager::GetSeed(), target, RngSeedManager::GetRun());
+        m_rngIndex = base + stream;
     }
+    m_rng = new RngStream(RngSeedManager::GetSeed(), m_rngIndex, RngSeedManager::GetRun());
     m_stream = stream;
 }
 
@@ -149,6 +206,41 @@ RandomVariableStream::Peek() const
     return m_rng;
 }
 
+void
+RandomVariableStream::Reseed()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_rng == nullptr)
+    {
+        // Not initialized yet: the stream will use the current run
+        return;
+    }
+    delete m_rng;
+    // Keep the automatic stream index, rather than allocate a new one, so
+    // that the stream draws what it would have drawn in the new run
+    m_rng = new RngStream(RngSeedManager::GetSeed(), m_rngIndex, RngSeedManager::GetRun());
+    DoReseed();
+}
+
+void
+RandomVariableStream::ReseedAll()
+{
+    NS_LOG_FUNCTION_NOARGS();
+#ifdef NS3_MTP
+    std::lock_guard lock(g_streamsMutex);
+#endif
+    for (auto stream = g_firstStream; stream != nullptr; stream = stream->m_nextStream)
+    {
+        stream->Reseed();
+    }
+}
+
+void
+RandomVariableStream::DoReseed()
+{
+    NS_LOG_FUNCTION(this);
+}
+
 NS_OBJECT_ENSURE_REGISTERED(UniformRandomVariable);
 
 TypeId
@@ -226,6 +318,31 @@ UniformRandomVariable::GetInteger()
     return static_cast<uint32_t>(GetValue(m_min, m_max + 1));
 }
 
+void
+UniformRandomVariable::GetValues(std::span<double> values)
+{
+    NS_LOG_FUNCTION(this << values.size());
+    Peek()->RandU01(values);
+
+    // Same arithmetic as GetValue(double,double), in loops without branches
+    const double min = m_min;
+    const double max = m_max;
+    if (IsAntithetic())
+    {
+        for (auto& v : values)
+        {
+            v = min + (max - (min + v * (max - min)));
+        }
+    }
+    else
+    {
+        for (auto& v : values)
+        {
+            v = min + v * (max - min);
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(ConstantRandomVariable);
 
 TypeId
@@ -455,6 +572,34 @@ ExponentialRandomVariable::GetValue()
     return GetValue(m_mean, m_bound);
 }
 
+void
+ExponentialRandomVariable::GetValues(std::span<double> values)
+{
+    NS_LOG_FUNCTION(this << values.size());
+    const double mean = m_mean;
+    const double bound = m_bound;
+    const bool antithetic = IsAntithetic();
+
+    // Each value takes one uniform variate, and the values above the bound
+    // are dropped: draw as many variates as values are missing, so that
+    // none is drawn in excess, and compact the accepted values in place.
+    std::size_t n = 0;
+    while (n < values.size())
+    {
+        const std::size_t end = values.size();
+        Peek()->RandU01(values.subspan(n));
+        for (std::size_t i = n; i < end; ++i)
+        {
+            double v = antithetic ? 1 - values[i] : values[i];
+            double r = -mean * std::log(v);
+            if (bound == 0 || r <= bound)
+            {
+                values[n++] = r;
+            }
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(ParetoRandomVariable);
 
 TypeId
@@ -554,6 +699,34 @@ ParetoRandomVariable::GetValue()
     return GetValue(m_scale, m_shape, m_bound);
 }
 
+void
+ParetoRandomVariable::GetValues(std::span<double> values)
+{
+    NS_LOG_FUNCTION(this << values.size());
+    const double scale = m_scale;
+    const double shape = m_shape;
+    const double bound = m_bound;
+    const bool antithetic = IsAntithetic();
+
+    // As in ExponentialRandomVariable::GetValues(), draw as many variates
+    // as values are missing and compact the accepted values in place.
+    std::size_t n = 0;
+    while (n < values.size())
+    {
+        const std::size_t end = values.size();
+        Peek()->RandU01(values.subspan(n));
+        for (std::size_t i = n; i < end; ++i)
+        {
+            double v = antithetic ? 1 - values[i] : values[i];
+            double r = (scale * (1.0 / std::pow(v, 1.0 / shape)));
+            if (bound == 0 || r <= bound)
+            {
+                values[n++] = r;
+            }
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(WeibullRandomVariable);
 
 TypeId
@@ -711,6 +884,13 @@ NormalRandomVariable::GetBound() const
     return m_bound;
 }
 
+void
+NormalRandomVariable::DoReseed()
+{
+    NS_LOG_FUNCTION(this);
+    m_nextValid = false;
+}
+
 double
 NormalRandomVariable::GetValue(double mean, double variance, double bound)
 {
@@ -776,6 +956,69 @@ NormalRandomVariable::GetValue()
     return GetValue(m_mean, m_variance, m_bound);
 }
 
+void
+NormalRandomVariable::GetValues(std::span<double> values)
+{
+    NS_LOG_FUNCTION(this << values.size());
+    const double mean = m_mean;
+    const double variance = m_variance;
+    const double bound = m_bound;
+    const bool antithetic = IsAntithetic();
+
+    std::size_t n = 0;
+    if (m_nextValid && !values.empty())
+    { // use previously generated
+        m_nextValid = false;
+        double x2 = mean + m_v2 * m_y * std::sqrt(variance);
+        if (std::fabs(x2 - mean) <= bound)
+        {
+            values[n++] = x2;
+        }
+    }
+
+    // Each pair of uniform variates gives at most two values: drawing half
+    // as many pairs as values are missing never draws a pair which
+    // GetValue() would not have drawn.  As in GetValue(), the second value
+    // of the last pair is cached if only the first one is needed.
+    constexpr std::size_t MAX_PAIRS = 32;
+    double u[2 * MAX_PAIRS];
+    while (n < values.size())
+    {
+        const std::size_t pairs = std::min((values.size() - n + 1) / 2, MAX_PAIRS);
+        Peek()->RandU01(std::span<double>(u, 2 * pairs));
+        for (std::size_t i = 0; i < pairs; ++i)
+        {
+            double u1 = antithetic ? 1 - u[2 * i] : u[2 * i];
+            double u2 = antithetic ? 1 - u[2 * i + 1] : u[2 * i + 1];
+            double v1 = 2 * u1 - 1;
+            double v2 = 2 * u2 - 1;
+            double w = v1 * v1 + v2 * v2;
+            if (w > 1.0)
+            {
+                continue;
+            }
+            double y = std::sqrt((-2 * std::log(w)) / w);
+            double x1 = mean + v1 * y * std::sqrt(variance);
+            if (std::fabs(x1 - mean) <= bound)
+            {
+                values[n++] = x1;
+                if (n == values.size())
+                {
+                    m_nextValid = true;
+                    m_y = y;
+                    m_v2 = v2;
+                    break;
+                }
+            }
+            double x2 = mean + v2 * y * std::sqrt(variance);
+            if (std::fabs(x2 - mean) <= bound)
+            {
+                values[n++] = x2;
+            }
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(LogNormalRandomVariable);
 
 TypeId
@@ -823,6 +1066,13 @@ LogNormalRandomVariable::GetSigma() const
     return m_sigma;
 }
 
+void
+LogNormalRandomVariable::DoReseed()
+{
+    NS_LOG_FUNCTION(this);
+    m_nextValid = false;
+}
+
 // The code from this function was adapted from the GNU Scientific
 // Library 1.8:
 /* randist/lognormal.c
@@ -956,6 +1206,13 @@ GammaRandomVariable::GetBeta() const
     return m_beta;
 }
 
+void
+GammaRandomVariable::DoReseed()
+{
+    NS_LOG_FUNCTION(this);
+    m_nextValid = false;
+}
+
 /*
   The code for the following generator functions was adapted from ns-2
   tools/ranvar.cc
@@ -1586,14 +1843,14 @@ EmpiricalRandomVariable::PreSample(double& value)
     value = r;
     bool valid = false;
     // check extrema
-    if (r <= m_empCdf.begin()->first)
+    if (r <= m_cdfProbabilities.front())
     {
-        value = m_empCdf.begin()->second; // Less than first
+        value = m_cdfValues.front(); // Less than first
         valid = true;
     }
-    else if (r >= m_empCdf.rbegin()->first)
+    else if (r >= m_cdfProbabilities.back())
     {
-        value = m_empCdf.rbegin()->second; // Greater than last
+        value = m_cdfValues.back(); // Greater than last
         valid = true;
     }
     return valid;
@@ -1628,9 +1885,7 @@ EmpiricalRandomVariable::DoSampleCDF(double r)
     NS_LOG_FUNCTION(this << r);
 
     // Find first CDF that is greater than r
-    auto bound = m_empCdf.upper_bound(r);
-
-    return bound->second;
+    return m_cdfValues[FindUpper(r)];
 }
 
 double
@@ -1657,20 +1912,15 @@ EmpiricalRandomVariable::DoInterpolate(double r)
     // Return a value from the empirical distribution
     // This code based (loosely) on code by Bruce Mah (Thanks Bruce!)
 
-    // search
-    auto upper = m_empCdf.upper_bound(r);
-    auto lower = std::prev(upper, 1);
-
-    if (upper == m_empCdf.begin())
-    {
-        lower = upper;
-    }
+    // search; r is above the first CDF, so upper is not the first point
+    std::size_t upper = FindUpper(r);
+    std::size_t lower = upper - 1;
 
     // Interpolate random value in range [v1..v2) based on [c1 .. r .. c2)
-    double c1 = lower->first;
-    double c2 = upper->first;
-    double v1 = lower->second;
-    double v2 = upper->second;
+    double c1 = m_cdfProbabilities[lower];
+    double c2 = m_cdfProbabilities[upper];
+    double v1 = m_cdfValues[lower];
+    double v2 = m_cdfValues[upper];
 
     double value = (v1 + ((v2 - v1) / (c2 - c1)) * (r - c1));
     return value;
@@ -1691,6 +1941,24 @@ EmpiricalRandomVariable::CDF(double v, double c)
     }
 
     m_empCdf[c] = v;
+    m_validated = false;
+}
+
+std::size_t
+EmpiricalRandomVariable::FindUpper(double r) const
+{
+    // Start from the guide entry of r, which is exact unless r * n was
+    // rounded across an interval boundary, then adjust in either direction.
+    std::size_t i = m_cdfGuide[static_cast<std::size_t>(r * (m_cdfGuide.size() - 1))];
+    while (m_cdfProbabilities[i - 1] > r)
+    {
+        --i;
+    }
+    while (m_cdfProbabilities[i] <= r)
+    {
+        ++i;
+    }
+    return i;
 }
 
 void
@@ -1735,6 +2003,30 @@ EmpiricalRandomVariable::Validate()
                        << lastCdfPair->first << ", Value: " << lastCdfPair->second);
     }
 
+    // Flatten the CDF for the searches
+    m_cdfProbabilities.clear();
+    m_cdfValues.clear();
+    for (const auto& [c, v] : m_empCdf)
+    {
+        m_cdfProbabilities.push_back(c);
+        m_cdfValues.push_back(v);
+    }
+
+    // Build the guide table; r is at most 1, so r * n is at most n.  The
+    // searched r is above the first probability, so no entry is 0.
+    const std::size_t n = m_cdfProbabilities.size();
+    m_cdfGuide.resize(n + 1);
+    std::size_t upper = 1;
+    for (std::size_t j = 0; j <= n; ++j)
+    {
+        const double start = static_cast<double>(j) / n;
+        while (upper < n - 1 && m_cdfProbabilities[upper] <= start)
+        {
+            ++upper;
+        }
+        m_cdfGuide[j] = upper;
+    }
+
     m_validated = true;
 }
 
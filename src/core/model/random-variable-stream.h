@@ -31,7 +31,9 @@
 #include "type-id.h"
 
 #include <map>
+#include <span>
 #include <stdint.h>
+#include <vector>
 
 /**
  * \file
@@ -150,10 +152,45 @@ class RandomVariableStream : public Object
      */
     virtual double GetValue() = 0;
 
+    /**
+     * \brief Fill a buffer with the next random values drawn from the
+     * distribution.
+     *
+     * The values are those that as many calls to GetValue() would return,
+     * in the same order, and the stream is left in the same state, so that
+     * the results do not depend on how the values are drawn.  The base
+     * implementation calls GetValue() for each value; the common
+     * distributions draw their uniform variates in bulk instead.
+     *
+     * \param [out] values The buffer to fill.
+     */
+    virtual void GetValues(std::span<double> values);
+
     /** \copydoc GetValue() */
     // The base implementation returns `(uint32_t)GetValue()`
     virtual uint32_t GetInteger();
 
+    /**
+     * \brief Restart this stream at the beginning of the substream of the
+     * current run.
+     *
+     * The stream keeps its stream number, and draws from the substream
+     * of the current RngSeedManager::GetRun() value, as if it had been
+     * created now.  The values cached from past draws are discarded.
+     */
+    void Reseed();
+
+    /**
+     * \brief Restart all the existing streams at the beginning of the
+     * substream of the current run.
+     *
+     * This calls Reseed() on every RandomVariableStream, so that a process
+     * which changed the run number with RngSeedManager::SetRun() after
+     * creating its random variables, such as a replication forked by
+     * ReplicationRunner, draws the numbers of its new run.
+     */
+    static void ReseedAll();
+
   protected:
     /**
      * \brief Get the pointer to the underlying RngStream.
@@ -161,10 +198,27 @@ class RandomVariableStream : public Object
      */
     RngStream* Peek() const;
 
+    /**
+     * \brief Discard the state derived from the past draws, when the
+     * stream is reseeded.
+     *
+     * The base implementation does nothing.
+     */
+    virtual void DoReseed();
+
   private:
     /** Pointer to the underlying RngStream. */
     RngStream* m_rng;
 
+    /** The index of the underlying RngStream, automatic or not. */
+    uint64_t m_rngIndex;
+
+    /** The previous stream in the list of all the streams. */
+    RandomVariableStream* m_prevStream;
+
+    /** The next stream in the list of all the streams. */
+    RandomVariableStream* m_nextStream;
+
     /** Indicates if antithetic values should be generated by this RNG stream. */
     bool m_isAntithetic;
 
@@ -284,6 +338,9 @@ class UniformRandomVariable : public RandomVariableStream
      */
     uint32_t GetInteger() override;
 
+    // Inherited
+    void GetValues(std::span<double> values) override;
+
   private:
     /** The lower bound on values that can be returned by this RNG stream. */
     double m_min;
@@ -592,6 +649,7 @@ class ExponentialRandomVariable : public RandomVariableStream
 
     // Inherited
     double GetValue() override;
+    void GetValues(std::span<double> values) override;
     using RandomVariableStream::GetInteger;
 
   private:
@@ -728,6 +786,7 @@ class ParetoRandomVariable : public RandomVariableStream
 
     // Inherited
     double GetValue() override;
+    void GetValues(std::span<double> values) override;
     using RandomVariableStream::GetInteger;
 
   private:
@@ -1017,8 +1076,13 @@ class NormalRandomVariable : public RandomVariableStream
 
     // Inherited
     double GetValue() override;
+    void GetValues(std::span<double> values) override;
     using RandomVariableStream::GetInteger;
 
+  protected:
+    // Inherited
+    void DoReseed() override;
+
   private:
     /** The mean value for the normal distribution returned by this RNG stream. */
     double m_mean;
@@ -1170,6 +1234,10 @@ class LogNormalRandomVariable : public RandomVariableStream
     double GetValue() override;
     using RandomVariableStream::GetInteger;
 
+  protected:
+    // Inherited
+    void DoReseed() override;
+
   private:
     /** The mu value for the log-normal distribution returned by this RNG stream. */
     double m_mu;
@@ -1283,6 +1351,10 @@ class GammaRandomVariable : public RandomVariableStream
     double GetValue() override;
     using RandomVariableStream::GetInteger;
 
+  protected:
+    // Inherited
+    void DoReseed() override;
+
   private:
     /**
      * \brief Returns a random double from a normal distribution with the specified mean, variance,
@@ -1967,6 +2039,15 @@ class DeterministicRandomVariable : public RandomVariableStream
  * If an instance of this RNG is configured to return antithetic values,
  * the actual value returned, \f$x'\f$, is generated by using
  * \f$ 1 - u \f$ instead. of \f$u\f$ on [0, 1].
+ *
+ * \par Performance.
+ *
+ * The first value drawn after the last call to CDF() copies the CDF into
+ * sorted arrays, with a guide table which maps each of as many equal
+ * intervals of [0, 1] as there are points to the first point above the
+ * start of the interval.  Each value then takes a constant expected
+ * number of comparisons, whatever the number of points, and is the same
+ * as a binary search of the CDF would give.
  */
 class EmpiricalRandomVariable : public RandomVariableStream
 {
@@ -2058,6 +2139,15 @@ class EmpiricalRandomVariable : public RandomVariableStream
      * \returns The interpolated CDF at \pname{r}
      */
     double DoInterpolate(double r);
+    /**
+     * \brief Find the first CDF point above a probability.
+     *
+     * \param [in] r The probability, strictly between the first and the
+     *            last CDF probabilities.
+     * \returns The index of the first point of m_cdfProbabilities greater
+     *          than \p r.
+     */
+    std::size_t FindUpper(double r) const;
 
     /** \c true once the CDF has been validated. */
     bool m_validated;
@@ -2067,6 +2157,15 @@ class EmpiricalRandomVariable : public RandomVariableStream
      * Key: CDF F(x) [0, 1] | Value: domain value (x) [-inf, inf].
      */
     std::map<double, double> m_empCdf;
+    /** The CDF probabilities F(x) of m_empCdf, in increasing order. */
+    std::vector<double> m_cdfProbabilities;
+    /** The domain values x of m_empCdf, in the order of m_cdfProbabilities. */
+    std::vector<double> m_cdfValues;
+    /**
+     * The guide table of m_cdfProbabilities: entry \c j is the index of the
+     * first probability greater than \c j divided by the number of points.
+     */
+    std::vector<uint32_t> m_cdfGuide;
     /**
      * If \c true GetValue will interpolate,
      * otherwise treat CDF as normal histogram.
@@ -17,6 +17,7 @@
 
 #include "realtime-simulator-impl.h"
 
+#include "abort.h"
 #include "assert.h"
 #include "boolean.h"
 #include "enum.h"
@@ -27,10 +28,15 @@
 #include "ptr.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
 #include "synchronizer.h"
 #include "wall-clock-synchronizer.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <mutex>
 #include <thread>
 
@@ -70,7 +76,26 @@ RealtimeSimulatorImpl::GetTypeId()
                           "SynchronizationMode=HardLimit)",
                           TimeValue(Seconds(0.1)),
                           MakeTimeAccessor(&RealtimeSimulatorImpl::m_hardLimit),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("BatchQuantum",
+                          "Once the simulator has waited for an event, the events due within "
+                          "this time after it run without waiting, possibly ahead of real time. "
+                          "Zero waits for each event.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RealtimeSimulatorImpl::m_batchQuantum),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("LatenessStatistics",
+                          "Record the lateness and jitter of the events with respect to real "
+                          "time, and print them at Simulator::Destroy().",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RealtimeSimulatorImpl::m_latenessStatistics),
+                          MakeBooleanChecker())
+            .AddAttribute("LatenessStatisticsFile",
+                          "The file the lateness statistics are written to; empty for the "
+                          "standard error.",
+                          StringValue(""),
+                          MakeStringAccessor(&RealtimeSimulatorImpl::m_latenessStatisticsFile),
+                          MakeStringChecker());
     return tid;
 }
 
@@ -86,6 +111,9 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
+    m_batchEnd = 0;
+    m_latenessStatistics = false;
+    m_lastLateness = 0;
 
     m_main = std::this_thread::get_id();
 
@@ -136,6 +164,22 @@ RealtimeSimulatorImpl::Destroy()
             ev->Invoke();
         }
     }
+
+    if (m_latenessStatistics && m_lateness.GetCount() > 0)
+    {
+        if (m_latenessStatisticsFile.empty())
+        {
+            PrintLatenessStats(std::clog);
+        }
+        else
+        {
+            std::ofstream os(m_latenessStatisticsFile);
+            NS_ABORT_MSG_UNLESS(os.is_open(),
+                                "Cannot open lateness statistics file "
+                                    << m_latenessStatisticsFile);
+            PrintLatenessStats(os);
+        }
+    }
 }
 
 void
@@ -225,9 +269,19 @@ RealtimeSimulatorImpl::ProcessOneEvent()
             //
             // tsNext is the simulation time of the next event we want to execute.
             //
-            tsNow = m_synchronizer->GetCurrentRealtime();
             tsNext = NextTs();
 
+            //
+            // If the next event is due within the batch quantum which started with
+            // the last wait, run it at once: we neither read the clock nor wait.
+            //
+            if (m_batchQuantum.IsStrictlyPositive() && tsNext <= m_batchEnd)
+            {
+                break;
+            }
+
+            tsNow = m_synchronizer->GetCurrentRealtime();
+
             //
             // tsDelay is therefore the real time we need to delay in order to bring the
             // real time in sync with the simulation time.  If we wait for this amount of
@@ -293,6 +347,11 @@ RealtimeSimulatorImpl::ProcessOneEvent()
         if (m_synchronizer->Synchronize(tsNow, tsDelay))
         {
             NS_LOG_LOGIC("Interrupted ...");
+            //
+            // The events due within the batch quantum after now will run without
+            // waiting again.
+            //
+            m_batchEnd = std::max(tsNow, tsNext) + m_batchQuantum.GetTimeStep();
             break;
         }
 
@@ -358,20 +417,34 @@ RealtimeSimulatorImpl::ProcessOneEvent()
         // been asked to commit ritual suicide.
         //
         // We check the simulation time against the current real time to make this
-        // judgement.
+        // judgement.  The events of a batch may run ahead of real time by up to the
+        // batch quantum, which is not held against us.
         //
+        uint64_t tsFinal = 0;
+        if (m_synchronizationMode == SYNC_HARD_LIMIT || m_latenessStatistics)
+        {
+            tsFinal = m_synchronizer->GetCurrentRealtime();
+        }
+        if (m_latenessStatistics)
+        {
+            RecordLateness(tsFinal);
+        }
         if (m_synchronizationMode == SYNC_HARD_LIMIT)
         {
-            uint64_t tsFinal = m_synchronizer->GetCurrentRealtime();
             uint64_t tsJitter;
+            auto tsQuantum = static_cast<uint64_t>(m_batchQuantum.GetTimeStep());
 
             if (tsFinal >= m_currentTs)
             {
                 tsJitter = tsFinal - m_currentTs;
             }
+            else if (m_currentTs - tsFinal > tsQuantum)
+            {
+                tsJitter = m_currentTs - tsFinal - tsQuantum;
+            }
             else
             {
-                tsJitter = m_currentTs - tsFinal;
+                tsJitter = 0;
             }
 
             if (tsJitter > static_cast<uint64_t>(m_hardLimit.GetTimeStep()))
@@ -395,6 +468,18 @@ RealtimeSimulatorImpl::ProcessOneEvent()
     event->Unref();
 }
 
+void
+RealtimeSimulatorImpl::RecordLateness(uint64_t tsReal)
+{
+    int64_t lateness = TimeStep(tsReal).GetNanoSeconds() - TimeStep(m_currentTs).GetNanoSeconds();
+    m_lateness.Add(std::max<int64_t>(lateness, 0));
+    if (m_lateness.GetCount() > 1)
+    {
+        m_jitter.Add(std::abs(lateness - m_lastLateness));
+    }
+    m_lastLateness = lateness;
+}
+
 bool
 RealtimeSimulatorImpl::IsFinished() const
 {
@@ -431,6 +516,7 @@ RealtimeSimulatorImpl::Run()
 
     m_stop = false;
     m_running = true;
+    m_batchEnd = 0;
     m_synchronizer->SetOrigin(m_currentTs);
 
     // Sleep until signalled
@@ -557,7 +643,8 @@ RealtimeSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay,
             // realtime clock.  If we're not, then m_currentTs is where we stopped.
             //
             ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
-            ts += delay.GetTimeStep();
+            // The current event may run ahead of real time, in a batch
+            ts = std::max(ts, m_currentTs) + delay.GetTimeStep();
         }
 
         NS_ASSERT_MSG(ts >= m_currentTs,
@@ -600,7 +687,9 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext(uint32_t context,
     {
         std::unique_lock lock{m_mutex};
 
-        uint64_t ts = m_synchronizer->GetCurrentRealtime() + time.GetTimeStep();
+        // The current event may run ahead of real time, in a batch
+        uint64_t ts =
+            std::max(m_synchronizer->GetCurrentRealtime(), m_currentTs) + time.GetTimeStep();
         NS_ASSERT_MSG(ts >= m_currentTs,
                       "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
         Scheduler::Event ev;
@@ -633,6 +722,8 @@ RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(uint32_t context, EventImp
         // realtime clock.  If we're not, then m_currentTs is were we stopped.
         //
         uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
+        // The current event may run ahead of real time, in a batch
+        ts = std::max(ts, m_currentTs);
         NS_ASSERT_MSG(ts >= m_currentTs,
                       "RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(): schedule for time "
                       "< m_currentTs");
@@ -823,6 +914,53 @@ RealtimeSimulatorImpl::SetHardLimit(Time limit)
     m_hardLimit = limit;
 }
 
+const EventProfiler::Stats&
+RealtimeSimulatorImpl::GetLatenessStats() const
+{
+    return m_lateness;
+}
+
+const EventProfiler::Stats&
+RealtimeSimulatorImpl::GetJitterStats() const
+{
+    return m_jitter;
+}
+
+void
+RealtimeSimulatorImpl::PrintLatenessStats(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this);
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+
+    os << "Realtime lateness: " << m_lateness.GetCount() << " events" << std::endl;
+    os << std::setw(11) << "Mean(us)" << std::setw(11) << "p50(us)" << std::setw(11) << "p90(us)"
+       << std::setw(11) << "p99(us)" << std::setw(11) << "Max(us)" << std::endl;
+    for (const auto& [name, stats] : {std::make_pair("Lateness", &m_lateness),
+                                      std::make_pair("Jitter", &m_jitter)})
+    {
+        double mean = stats->GetCount() ? stats->GetTotal() / 1e3 / stats->GetCount() : 0;
+        os << std::setw(11) << mean << std::setw(11) << stats->GetPercentile(50) / 1e3
+           << std::setw(11) << stats->GetPercentile(90) / 1e3 << std::setw(11)
+           << stats->GetPercentile(99) / 1e3 << std::setw(11) << stats->GetMax() / 1e3 << "  "
+           << name << std::endl;
+    }
+    for (const auto& [name, stats] : {std::make_pair("lateness", &m_lateness),
+                                      std::make_pair("jitter", &m_jitter)})
+    {
+        os << std::endl << "Histogram of the " << name << ":" << std::endl;
+        os << std::setw(11) << "From(us)" << std::setw(12) << "Count" << std::endl;
+        for (const auto& [low, count] : stats->GetHistogram())
+        {
+            os << std::setw(11) << low / 1e3 << std::setw(12) << count << std::endl;
+        }
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
 Time
 RealtimeSimulatorImpl::GetHardLimit() const
 {
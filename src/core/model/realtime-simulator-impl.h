@@ -20,6 +20,7 @@
 
 #include "assert.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 #include "log.h"
 #include "ptr.h"
 #include "scheduler.h"
@@ -28,6 +29,8 @@
 
 #include <list>
 #include <mutex>
+#include <ostream>
+#include <string>
 #include <thread>
 
 /**
@@ -50,6 +53,19 @@ namespace ns3
  * \ingroup realtime
  *
  * Realtime version of SimulatorImpl.
+ *
+ * By default the simulator waits for the wall-clock time of each event
+ * before running it.  When the BatchQuantum attribute is positive, once
+ * the simulator has waited for an event, it also runs all the events due
+ * within the quantum after it without waiting again: these events may run
+ * up to one quantum ahead of real time, in exchange for one wait per batch
+ * rather than per event.
+ *
+ * When the LatenessStatistics attribute is set, the simulator records how
+ * late each event starts with respect to real time, and the jitter, which
+ * is the change of lateness between consecutive events, in log-linear
+ * histograms.  They are available from GetLatenessStats() and
+ * GetJitterStats(), and printed at Simulator::Destroy().
  */
 class RealtimeSimulatorImpl : public SimulatorImpl
 {
@@ -163,6 +179,33 @@ class RealtimeSimulatorImpl : public SimulatorImpl
      */
     Time GetHardLimit() const;
 
+    /**
+     * Get the lateness of the events, if the LatenessStatistics attribute
+     * is set.
+     *
+     * The lateness is the real time elapsed between the simulation time of
+     * an event and its start; the events run ahead of real time count as
+     * not late.
+     *
+     * \returns The lateness statistics, in nanoseconds.
+     */
+    const EventProfiler::Stats& GetLatenessStats() const;
+    /**
+     * Get the jitter of the events, if the LatenessStatistics attribute
+     * is set.
+     *
+     * The jitter is the absolute change of lateness between an event and
+     * the previous one.
+     *
+     * \returns The jitter statistics, in nanoseconds.
+     */
+    const EventProfiler::Stats& GetJitterStats() const;
+    /**
+     * Print the lateness and jitter statistics and histograms.
+     * \param [in] os The output stream.
+     */
+    void PrintLatenessStats(std::ostream& os) const;
+
   private:
     /**
      * Is the simulator running?
@@ -181,6 +224,11 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     uint64_t NextTs() const;
     /** Process the next event. */
     void ProcessOneEvent();
+    /**
+     * Account for the lateness of the event about to run.
+     * \param [in] tsReal The current real time.
+     */
+    void RecordLateness(uint64_t tsReal);
     /** Destructor implementation. */
     void DoDispose() override;
 
@@ -227,6 +275,22 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     /** The maximum allowable drift from real-time in SYNC_HARD_LIMIT mode. */
     Time m_hardLimit;
 
+    /** The events due within this time after a wait are run without waiting. */
+    Time m_batchQuantum;
+    /** The timestep until which the events run without waiting. */
+    uint64_t m_batchEnd;
+
+    /** Whether the lateness of the events is recorded. */
+    bool m_latenessStatistics;
+    /** The file the lateness statistics are written to, empty for std::clog. */
+    std::string m_latenessStatisticsFile;
+    /** The lateness of the events. */
+    EventProfiler::Stats m_lateness;
+    /** The jitter of the events. */
+    EventProfiler::Stats m_jitter;
+    /** The lateness of the previous event, negative if it ran early, in ns. */
+    int64_t m_lastLateness;
+
     /** Main thread. */
     std::thread::id m_main;
 };
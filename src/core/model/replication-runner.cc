@@ -0,0 +1,291 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication-runner.h"
+
+#include "abort.h"
+#include "log.h"
+#include "random-variable-stream.h"
+#include "rng-seed-manager.h"
+#include "simulation-checkpoint.h"
+#include "system-path.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+#ifndef __WIN32__
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ReplicationRunner implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ReplicationRunner");
+
+/** The last line of a complete metrics file. */
+static const std::string g_endOfMetrics = "end";
+
+/**
+ * Get the 97.5% quantile of the Student t distribution, which gives the
+ * half width of a 95% confidence interval of a mean.
+ * \param [in] degrees The degrees of freedom, at least 1.
+ * \returns The quantile, rounded up for the degrees of freedom between
+ *          the tabulated ones.
+ */
+static double
+StudentQuantile975(uint32_t degrees)
+{
+    static const double small[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                   2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                   2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                   2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    const uint32_t tabulated = sizeof(small) / sizeof(small[0]);
+    if (degrees <= tabulated)
+    {
+        return small[degrees - 1];
+    }
+    if (degrees < 40)
+    {
+        return small[tabulated - 1];
+    }
+    if (degrees < 60)
+    {
+        return 2.021;
+    }
+    if (degrees < 120)
+    {
+        return 2.000;
+    }
+    // Within 1% of the normal quantile from there on
+    return degrees < 1000 ? 1.980 : 1.960;
+}
+
+ReplicationRunner::ReplicationRunner(uint32_t replications, uint32_t maxParallel)
+    : m_replications(replications),
+      m_maxParallel(maxParallel),
+      m_firstRun(RngSeedManager::GetRun()),
+      m_run(RngSeedManager::GetRun()),
+      m_replication(SimulationCheckpoint::ORIGINAL),
+      m_failed(0)
+{
+    NS_LOG_FUNCTION(this << replications << maxParallel);
+}
+
+void
+ReplicationRunner::SetFirstRun(uint64_t run)
+{
+    NS_LOG_FUNCTION(this << run);
+    m_firstRun = run;
+}
+
+bool
+ReplicationRunner::Fork()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(m_directory.empty(), "ReplicationRunner::Fork() called twice");
+    m_directory = SystemPath::MakeTemporaryDirectoryName();
+    SystemPath::MakeDirectories(m_directory);
+    m_values.clear();
+
+    uint32_t replication = SimulationCheckpoint::Fork(m_replications, m_maxParallel);
+    if (replication != SimulationCheckpoint::ORIGINAL)
+    {
+        m_replication = replication;
+        m_run = m_firstRun + replication;
+        RngSeedManager::SetRun(m_run);
+        RandomVariableStream::ReseedAll();
+        NS_LOG_INFO("replication " << replication << " uses run " << m_run);
+        return true;
+    }
+
+    Collect();
+    return false;
+}
+
+uint64_t
+ReplicationRunner::GetRun() const
+{
+    return m_run;
+}
+
+void
+ReplicationRunner::Record(const std::string& name, double value)
+{
+    NS_LOG_FUNCTION(this << name << value);
+    NS_ABORT_MSG_IF(name.empty() || name == g_endOfMetrics ||
+                        name.find_first_of(" \t\n") != std::string::npos,
+                    "Invalid metric name \"" << name << "\"");
+    m_values[name].push_back(value);
+}
+
+void
+ReplicationRunner::Finish()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_replication == SimulationCheckpoint::ORIGINAL,
+                    "ReplicationRunner::Finish() called outside of a replication");
+    std::ofstream os(GetFileName(m_replication));
+    NS_ABORT_MSG_UNLESS(os.is_open(), "Cannot write " << GetFileName(m_replication));
+    os << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto& [name, values] : m_values)
+    {
+        for (auto value : values)
+        {
+            os << name << " " << value << "\n";
+        }
+    }
+    os << g_endOfMetrics << std::endl;
+}
+
+uint32_t
+ReplicationRunner::GetFailedReplications() const
+{
+    return m_failed;
+}
+
+std::vector<double>
+ReplicationRunner::GetValues(const std::string& name) const
+{
+    auto it = m_values.find(name);
+    if (it == m_values.end())
+    {
+        return {};
+    }
+    return it->second;
+}
+
+std::map<std::string, ReplicationRunner::Summary>
+ReplicationRunner::GetSummaries() const
+{
+    std::map<std::string, Summary> summaries;
+    for (const auto& [name, values] : m_values)
+    {
+        Summary summary{0,
+                        0,
+                        0,
+                        std::numeric_limits<double>::max(),
+                        std::numeric_limits<double>::lowest(),
+                        0};
+        // Welford's algorithm, as the mean may be large compared with the
+        // deviations
+        double m2 = 0;
+        for (auto value : values)
+        {
+            summary.count++;
+            double delta = value - summary.mean;
+            summary.mean += delta / summary.count;
+            m2 += delta * (value - summary.mean);
+            summary.min = std::min(summary.min, value);
+            summary.max = std::max(summary.max, value);
+        }
+        if (summary.count > 1)
+        {
+            summary.stddev = std::sqrt(m2 / (summary.count - 1));
+            summary.error95 =
+                StudentQuantile975(summary.count - 1) * summary.stddev / std::sqrt(summary.count);
+        }
+        summaries[name] = summary;
+    }
+    return summaries;
+}
+
+void
+ReplicationRunner::Print(std::ostream& os) const
+{
+    const int nwidth = 20;
+    const int fwidth = 14;
+    os << std::left << std::setw(nwidth) << "Metric" << std::right << std::setw(fwidth)
+       << "Count" << std::setw(fwidth) << "Mean" << std::setw(fwidth) << "+/-95%"
+       << std::setw(fwidth) << "Stddev" << std::setw(fwidth) << "Min" << std::setw(fwidth)
+       << "Max" << std::endl;
+    for (const auto& [name, summary] : GetSummaries())
+    {
+        os << std::left << std::setw(nwidth) << name << std::right << std::setw(fwidth)
+           << summary.count << std::setw(fwidth) << summary.mean << std::setw(fwidth)
+           << summary.error95 << std::setw(fwidth) << summary.stddev << std::setw(fwidth)
+           << summary.min << std::setw(fwidth) << summary.max << std::endl;
+    }
+    if (m_failed > 0)
+    {
+        os << m_failed << " of " << m_replications << " replications failed" << std::endl;
+    }
+}
+
+std::string
+ReplicationRunner::GetFileName(uint32_t replication) const
+{
+    return SystemPath::Append(m_directory, "replication-" + std::to_string(replication));
+}
+
+void
+ReplicationRunner::Collect()
+{
+    NS_LOG_FUNCTION(this);
+    m_failed = 0;
+    for (uint32_t replication = 0; replication < m_replications; ++replication)
+    {
+        std::string fileName = GetFileName(replication);
+        std::ifstream is(fileName);
+        std::map<std::string, std::vector<double>> values;
+        std::string name;
+        bool complete = false;
+        while (is >> name)
+        {
+            if (name == g_endOfMetrics)
+            {
+                complete = true;
+                break;
+            }
+            double value;
+            if (!(is >> value))
+            {
+                break;
+            }
+            values[name].push_back(value);
+        }
+        is.close();
+        std::remove(fileName.c_str());
+
+        // Only count the replications which finished, so that the
+        // summaries are not biased towards the partial ones
+        if (!complete)
+        {
+            NS_LOG_WARN("replication " << replication << " (run " << m_firstRun + replication
+                                       << ") did not finish");
+            m_failed++;
+            continue;
+        }
+        for (auto& [metric, v] : values)
+        {
+            auto& all = m_values[metric];
+            all.insert(all.end(), v.begin(), v.end());
+        }
+    }
+#ifndef __WIN32__
+    rmdir(m_directory.c_str());
+#endif
+}
+
+} // namespace ns3
@@ -0,0 +1,222 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ReplicationRunner declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Run independent replications of a simulation in parallel
+ * processes, after building the scenario once.
+ *
+ * The replications are forked, with SimulationCheckpoint::Fork(), once
+ * the scenario is built, so that the setup is paid once and the
+ * read-only state, such as routing tables or traces loaded in memory, is
+ * shared by all the replications through copy-on-write.  Each replication
+ * sets its own run number with RngSeedManager::SetRun(), from the first
+ * run number on, and reseeds the random variables created so far, so
+ * that it draws the numbers of that run.
+ *
+ * Each replication records its metrics with Record(); the original
+ * process collects them and computes their mean, standard deviation and
+ * 95% confidence interval across the replications.
+ *
+ * \code
+ *   BuildScenario();
+ *   FlowMonitorHelper flowmon;
+ *   Ptr<FlowMonitor> monitor = flowmon.InstallAll();
+ *
+ *   ReplicationRunner runner(100);
+ *   if (runner.Fork())
+ *   {
+ *       // A replication
+ *       Simulator::Stop(Seconds(60));
+ *       Simulator::Run();
+ *       for (const auto& [flow, stats] : monitor->GetFlowStats())
+ *       {
+ *           runner.Record("rxBytes", stats.rxBytes);
+ *           runner.Record("delay", (stats.delaySum / stats.rxPackets).GetSeconds());
+ *       }
+ *       monitor->SerializeToXmlFile("flowmon-" + std::to_string(runner.GetRun()) + ".xml",
+ *                                   false, false);
+ *       Simulator::Destroy();
+ *       runner.Finish();
+ *       return 0;
+ *   }
+ *   runner.Print(std::cout);
+ *   Simulator::Destroy();
+ * \endcode
+ *
+ * The random numbers drawn before the fork, for instance to place the
+ * nodes, come from the run of the original process, and are the same
+ * in all the replications.  After the fork, each random variable starts
+ * over at the beginning of its substream for the run of the replication.
+ * A replication is therefore identical to a simulation of its run which
+ * draws no random number during the setup.
+ *
+ * The limitations of SimulationCheckpoint apply: DefaultSimulatorImpl
+ * only, no model running threads, and outputs opened before the fork
+ * shared by all the replications.
+ */
+class ReplicationRunner
+{
+  public:
+    /**
+     * Summary of the values of a metric across the replications.
+     */
+    struct Summary
+    {
+        uint32_t count; //!< Number of values.
+        double mean;    //!< Mean of the values.
+        double stddev;  //!< Sample standard deviation of the values.
+        double min;     //!< Smallest value.
+        double max;     //!< Largest value.
+        /**
+         * Half width of the 95% confidence interval of the mean, from the
+         * Student t distribution with \c count - 1 degrees of freedom.
+         */
+        double error95;
+    };
+
+    /**
+     * Constructor.
+     *
+     * \param [in] replications The number of replications.
+     * \param [in] maxParallel The maximum number of replications running
+     *             at once, 0 for the number of hardware threads.
+     */
+    ReplicationRunner(uint32_t replications, uint32_t maxParallel = 0);
+
+    /**
+     * Set the run number of the first replication.
+     *
+     * The replications use the run numbers \p run to
+     * \p run + replications - 1.  The default is the run number of the
+     * original process, from RngSeedManager::GetRun().
+     *
+     * \param [in] run The run number of the first replication.
+     */
+    void SetFirstRun(uint64_t run);
+
+    /**
+     * Fork the replications.
+     *
+     * In each replication, sets the run number and reseeds the random
+     * variables, then returns \c true.  In the original process, waits
+     * until all the replications have exited, collects their metrics and
+     * returns \c false.
+     *
+     * \returns \c true in a replication, \c false in the original process.
+     */
+    bool Fork();
+
+    /**
+     * Get the run number of this replication.
+     * \returns The run number of this replication, or the run number of
+     *          the original process.
+     */
+    uint64_t GetRun() const;
+
+    /**
+     * Record a value of a metric in this replication.
+     *
+     * A metric can be recorded several times in a replication, for
+     * instance once per flow: all the values count in the summary.
+     *
+     * \param [in] name The name of the metric, without white space.
+     * \param [in] value The value.
+     */
+    void Record(const std::string& name, double value);
+
+    /**
+     * Pass the metrics recorded in this replication to the original
+     * process.  Must be called once, at the end of each replication.
+     */
+    void Finish();
+
+    /**
+     * Get the number of replications which did not finish successfully.
+     *
+     * Only meaningful in the original process, after Fork() returned.
+     * \returns The number of replications which failed or did not call
+     *          Finish().
+     */
+    uint32_t GetFailedReplications() const;
+
+    /**
+     * Get the values of a metric recorded by all the replications.
+     *
+     * Only meaningful in the original process, after Fork() returned.
+     * \param [in] name The name of the metric.
+     * \returns The values, ordered by run number then in the order of
+     *          the Record() calls.
+     */
+    std::vector<double> GetValues(const std::string& name) const;
+
+    /**
+     * Get the summaries of all the metrics.
+     *
+     * Only meaningful in the original process, after Fork() returned.
+     * \returns The summaries, by metric name.
+     */
+    std::map<std::string, Summary> GetSummaries() const;
+
+    /**
+     * Print the summaries of all the metrics, one metric per line.
+     * \param [in] os The output stream.
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /**
+     * Get the name of the file which passes the metrics of a replication.
+     * \param [in] replication The replication number.
+     * \returns The file name.
+     */
+    std::string GetFileName(uint32_t replication) const;
+
+    /** Read the metrics of the replications, and remove their files. */
+    void Collect();
+
+    uint32_t m_replications; //!< Number of replications.
+    uint32_t m_maxParallel;  //!< Maximum number of replications at once.
+    uint64_t m_firstRun;     //!< Run number of the first replication.
+    uint64_t m_run;          //!< Run number of this process.
+    uint32_t m_replication;  //!< Replication number of this process.
+    std::string m_directory; //!< Directory of the metrics files.
+    uint32_t m_failed;       //!< Number of failed replications.
+    /** The values of the metrics, by name. */
+    std::map<std::string, std::vector<double>> m_values;
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
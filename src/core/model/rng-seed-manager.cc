@@ -24,6 +24,10 @@
 #include "log.h"
 #include "uinteger.h"
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 /**
  * \file
  * \ingroup randomvariable
@@ -40,7 +44,18 @@ NS_LOG_COMPONENT_DEFINE("RngSeedManager");
  * The next random number generator stream number to use
  * for automatic assignment.
  */
+#ifdef NS3_MTP
+static std::atomic<uint64_t> g_nextStreamIndex = 0;
+#else
 static uint64_t g_nextStreamIndex = 0;
+#endif
+#ifdef NS3_MTP
+/**
+ * \relates RngSeedManager
+ * The stream index counter of the calling thread, if any.
+ */
+static thread_local uint64_t* g_threadStreamIndex = nullptr;
+#endif
 /**
  * \relates RngSeedManager
  * \anchor GlobalValueRngSeed
@@ -107,9 +122,21 @@ uint64_t
 RngSeedManager::GetNextStreamIndex()
 {
     NS_LOG_FUNCTION_NOARGS();
-    uint64_t next = g_nextStreamIndex;
-    g_nextStreamIndex++;
-    return next;
+#ifdef NS3_MTP
+    if (g_threadStreamIndex != nullptr)
+    {
+        return (*g_threadStreamIndex)++;
+    }
+#endif
+    return g_nextStreamIndex++;
+}
+
+#ifdef NS3_MTP
+void
+RngSeedManager::SetThreadStreamIndexCounter(uint64_t* counter)
+{
+    g_threadStreamIndex = counter;
 }
+#endif
 
 } // namespace ns3
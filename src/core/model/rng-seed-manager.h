@@ -104,6 +104,20 @@ class RngSeedManager
      * \returns The next stream index.
      */
     static uint64_t GetNextStreamIndex();
+
+#ifdef NS3_MTP
+    /**
+     * Set the counter GetNextStreamIndex() uses in the calling thread.
+     *
+     * Parallel simulator implementations give each logical process its
+     * own counter, starting at a base which depends on the logical
+     * process only, so that the stream indices do not depend on the
+     * interleaving of the threads.
+     *
+     * \param [in] counter The counter, or \c nullptr to use the global one.
+     */
+    static void SetThreadStreamIndexCounter(uint64_t* counter);
+#endif
 };
 
 /** Alias for compatibility. */
@@ -18,6 +18,7 @@
 
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
+#include <span>
 #include <stdint.h>
 #include <string>
 
@@ -70,6 +71,16 @@ class RngStream
      * \returns The next random.
      */
     double RandU01();
+    /**
+     * Generate the next random numbers for this stream, as the same
+     * number of calls to RandU01() would.
+     *
+     * The state is kept in local variables for the whole buffer, instead
+     * of being loaded and stored for each number.
+     *
+     * \param [out] values The buffer to fill.
+     */
+    void RandU01(std::span<double> values);
 
   private:
     /**
@@ -47,4 +47,18 @@ Scheduler::GetTypeId()
     return tid;
 }
 
+void
+Scheduler::RemoveNextBatch(std::vector<Event>& events)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Event next = RemoveNext();
+    uint64_t ts = next.key.m_ts;
+    events.push_back(next);
+    while (!IsEmpty() && PeekNext().key.m_ts == ts)
+    {
+        events.push_back(RemoveNext());
+    }
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "object.h"
 
 #include <stdint.h>
+#include <vector>
 
 /**
  * \file
@@ -111,6 +112,14 @@ class EventImpl;
  *      <td class="markdownTableBodyLeft"> 0 </td>
  * </tr>
  * <tr class="markdownTableBody">
+ *      <td class="markdownTableBodyLeft"> LadderScheduler </td>
+ *      <td class="markdownTableBodyLeft"> Ladder of `std::vector` buckets </td>
+ *      <td class="markdownTableBodyLeft"> Constant </td>
+ *      <td class="markdownTableBodyLeft"> Constant </td>
+ *      <td class="markdownTableBodyLeft"> 48 bytes </td>
+ *      <td class="markdownTableBodyLeft"> 0 </td>
+ * </tr>
+ * <tr class="markdownTableBody">
  *      <td class="markdownTableBodyLeft"> ListScheduler </td>
  *      <td class="markdownTableBodyLeft"> `std::list` </td>
  *      <td class="markdownTableBodyLeft"> Linear </td>
@@ -128,7 +137,7 @@ class EventImpl;
  * </tr>
  * <tr class="markdownTableBody">
  *      <td class="markdownTableBodyLeft"> PriorityQueueScheduler </td>
- *      <td class="markdownTableBodyLeft"> `std::priority_queue<,std::vector>` </td>
+ *      <td class="markdownTableBodyLeft"> Indexed heap on `std::vector` </td>
  *      <td class="markdownTableBodyLeft"> Logarithmic  </td>
  *      <td class="markdownTableBodyLeft"> Logarithmic </td>
  *      <td class="markdownTableBodyLeft"> 24 bytes </td>
@@ -226,6 +235,19 @@ class Scheduler : public Object
      * \param [in] ev The event to remove
      */
     virtual void Remove(const Event& ev) = 0;
+    /**
+     * Remove all the events which share the earliest timestamp.
+     *
+     * The events are appended to \pname{events} in the order in which
+     * successive calls to RemoveNext() would return them.  The default
+     * implementation does just that; schedulers which keep the earliest
+     * events together override it to remove them in one pass.
+     *
+     * This method cannot be invoked if the list is empty.
+     *
+     * \param [in,out] events The container the events are appended to.
+     */
+    virtual void RemoveNextBatch(std::vector<Event>& events);
 };
 
 /**
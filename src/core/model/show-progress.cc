@@ -28,6 +28,7 @@
 
 #include "event-id.h"
 #include "log.h"
+#include "memory-accounting.h"
 #include "nstime.h"
 #include "simulator.h"
 
@@ -55,7 +56,8 @@ ShowProgress::ShowProgress(const Time interval /* = Seconds (1.0) */,
       m_printer(DefaultTimePrinter),
       m_os(&os),
       m_verbose(false),
-      m_repCount(0)
+      m_repCount(0),
+      m_memoryEntries(0)
 {
     NS_LOG_FUNCTION(this << interval);
     ScheduleCheckProgress();
@@ -98,6 +100,13 @@ ShowProgress::SetVerbose(bool verbose)
     m_verbose = verbose;
 }
 
+void
+ShowProgress::SetMemoryReport(uint32_t maxEntries)
+{
+    NS_LOG_FUNCTION(this << maxEntries);
+    m_memoryEntries = maxEntries;
+}
+
 void
 ShowProgress::SetStream(std::ostream& os)
 {
@@ -139,6 +148,11 @@ ShowProgress::GiveFeedback(uint64_t nEvents, int64x64_t ratio, int64x64_t speed)
             << nEvents << " events processed" << std::endl
             << std::flush;
 
+    if (m_memoryEntries > 0 && MemoryAccounting::IsEnabled())
+    {
+        MemoryAccounting::Print(*m_os, m_memoryEntries);
+    }
+
     // Restore stream state
     m_os->precision(precision);
     m_os->flags(flags);
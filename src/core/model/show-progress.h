@@ -132,6 +132,15 @@ class ShowProgress
      */
     void SetVerbose(bool verbose);
 
+    /**
+     * Print the memory used by the largest TypeIds after each progress
+     * message, when the MemoryAccounting is enabled.
+     *
+     * \param [in] maxEntries The number of TypeIds and memory categories
+     *             to print; 0, the default, prints no memory usage.
+     */
+    void SetMemoryReport(uint32_t maxEntries);
+
   private:
     /**
      * Start the elapsed wallclock timestamp and print the start time.
@@ -188,10 +197,11 @@ class ShowProgress
     EventId m_event;                  //!< The next progress event.
     uint64_t m_eventCount;            //!< Simulator event count
 
-    TimePrinter m_printer; //!< The TimePrinter to use
-    std::ostream* m_os;    //!< The output stream to use.
-    bool m_verbose;        //!< Verbose mode flag
-    uint64_t m_repCount;   //!< Number of CheckProgress events
+    TimePrinter m_printer;    //!< The TimePrinter to use
+    std::ostream* m_os;       //!< The output stream to use.
+    bool m_verbose;           //!< Verbose mode flag
+    uint64_t m_repCount;      //!< Number of CheckProgress events
+    uint32_t m_memoryEntries; //!< Number of memory usages to print
 
 }; // class ShowProgress
 
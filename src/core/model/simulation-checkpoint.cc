@@ -0,0 +1,161 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulation-checkpoint.h"
+
+#include "abort.h"
+#include "default-simulator-impl.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <thread>
+
+#ifndef __WIN32__
+#include <cerrno>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulationCheckpoint implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SimulationCheckpoint");
+
+namespace
+{
+
+/** \ingroup simulator The variant number of this process. */
+uint32_t g_variant = SimulationCheckpoint::ORIGINAL;
+/** \ingroup simulator The number of variants which failed. */
+uint32_t g_failedVariants = 0;
+
+} // unnamed namespace
+
+uint32_t
+SimulationCheckpoint::Fork(uint32_t variants, uint32_t maxParallel)
+{
+    NS_LOG_FUNCTION(variants << maxParallel);
+#ifdef __WIN32__
+    NS_FATAL_ERROR("SimulationCheckpoint is not supported on Windows");
+#else
+    NS_ABORT_MSG_IF(g_variant != ORIGINAL, "Cannot fork a variant again");
+    NS_ABORT_MSG_UNLESS(Simulator::GetImplementation()->GetInstanceTypeId() ==
+                            DefaultSimulatorImpl::GetTypeId(),
+                        "SimulationCheckpoint requires DefaultSimulatorImpl");
+    if (maxParallel == 0)
+    {
+        maxParallel = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    // Do not let the children print what is buffered so far once more
+    std::cout.flush();
+    std::cerr.flush();
+    std::clog.flush();
+    std::fflush(nullptr);
+
+    g_failedVariants = 0;
+    std::map<pid_t, uint32_t> children;
+    uint32_t next = 0;
+    while (next < variants || !children.empty())
+    {
+        if (next < variants && children.size() < maxParallel)
+        {
+            pid_t pid = fork();
+            NS_ABORT_MSG_IF(pid < 0,
+                            "Cannot fork variant " << next << ": " << std::strerror(errno));
+            if (pid == 0)
+            {
+                g_variant = next;
+                NS_LOG_INFO("variant " << next << " starts at " << Simulator::Now().As(Time::S));
+                return next;
+            }
+            children[pid] = next++;
+            continue;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            NS_ABORT_MSG_UNLESS(errno == EINTR,
+                                "Cannot wait for variants: " << std::strerror(errno));
+            continue;
+        }
+        auto it = children.find(pid);
+        if (it == children.end())
+        {
+            // Not one of ours
+            continue;
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            NS_LOG_WARN("variant " << it->second << " failed with status " << status);
+            g_failedVariants++;
+        }
+        else
+        {
+            NS_LOG_INFO("variant " << it->second << " done");
+        }
+        children.erase(it);
+    }
+#endif
+    return ORIGINAL;
+}
+
+void
+SimulationCheckpoint::ScheduleFork(const Time& delay,
+                                   uint32_t variants,
+                                   Callback<void, uint32_t> setup,
+                                   uint32_t maxParallel)
+{
+    NS_LOG_FUNCTION(delay << variants << maxParallel);
+    Simulator::Schedule(delay, [variants, setup, maxParallel]() {
+        uint32_t variant = Fork(variants, maxParallel);
+        if (variant == ORIGINAL)
+        {
+            Simulator::Stop();
+        }
+        else if (!setup.IsNull())
+        {
+            setup(variant);
+        }
+    });
+}
+
+uint32_t
+SimulationCheckpoint::GetVariant()
+{
+    return g_variant;
+}
+
+uint32_t
+SimulationCheckpoint::GetFailedVariants()
+{
+    return g_failedVariants;
+}
+
+} // namespace ns3
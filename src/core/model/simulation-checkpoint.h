@@ -0,0 +1,130 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATION_CHECKPOINT_H
+#define SIMULATION_CHECKPOINT_H
+
+#include "callback.h"
+#include "nstime.h"
+
+#include <cstdint>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulationCheckpoint declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Checkpoint a running simulation and fork variants from it.
+ *
+ * A checkpoint is taken by forking the simulation process: the process
+ * which called Fork() keeps the state of the simulation at that time
+ * (the scheduled events, the nodes with their attributes, the position
+ * of every random number stream...) and each variant restarts from it in
+ * a child process, where it can change parameters, for instance with
+ * Config::Set(), before the simulation resumes.  This saves running the
+ * warm-up phase of an experiment once per variant.
+ *
+ * \code
+ *   SimulationCheckpoint::ScheduleFork(Seconds(1200), 8, MakeCallback(&SetupVariant));
+ *   Simulator::Run();
+ *   if (SimulationCheckpoint::GetVariant() != SimulationCheckpoint::ORIGINAL)
+ *   {
+ *       WriteResults(SimulationCheckpoint::GetVariant());
+ *   }
+ *   Simulator::Destroy();
+ * \endcode
+ *
+ * The original process waits, at most \c maxParallel variants running at
+ * once, until all of them have exited, then resumes: ScheduleFork()
+ * stops its simulation at the checkpoint.
+ *
+ * Limitations:
+ * - Only DefaultSimulatorImpl is supported, since fork() only duplicates
+ *   the calling thread.  For the same reason, models running threads,
+ *   such as emulated devices, cannot be forked.
+ * - Files and sockets opened before the checkpoint are shared by all the
+ *   variants: the outputs of each variant should be opened after the
+ *   checkpoint, under a name which depends on the variant.
+ * - The variants are exact copies: random variables draw the same
+ *   numbers in all of them, unless a variant changes their stream.
+ * - The checkpoint only lives in memory, as long as the original process.
+ * - Not available on Windows.
+ */
+class SimulationCheckpoint
+{
+  public:
+    /** The variant number of the original process. */
+    static constexpr uint32_t ORIGINAL = 0xffffffff;
+
+    /**
+     * Fork the simulation into variants.
+     *
+     * Must be called from the main simulation thread, usually from an
+     * event.  In each child process, returns the variant number, from 0
+     * to \p variants - 1.  In the original process, waits until all the
+     * children have exited, then returns ORIGINAL.
+     *
+     * \param [in] variants The number of variants.
+     * \param [in] maxParallel The maximum number of variants running at
+     *             once, 0 for the number of hardware threads.
+     * \returns The variant number, or ORIGINAL.
+     */
+    static uint32_t Fork(uint32_t variants, uint32_t maxParallel = 0);
+
+    /**
+     * Schedule a checkpoint.
+     *
+     * After \p delay, fork the simulation into \p variants variants, call
+     * \p setup with the variant number in each of them, and stop the
+     * simulation of the original process once all variants are done.
+     *
+     * \param [in] delay The delay until the checkpoint.
+     * \param [in] variants The number of variants.
+     * \param [in] setup The function which configures a variant.
+     * \param [in] maxParallel The maximum number of variants running at
+     *             once, 0 for the number of hardware threads.
+     */
+    static void ScheduleFork(const Time& delay,
+                             uint32_t variants,
+                             Callback<void, uint32_t> setup,
+                             uint32_t maxParallel = 0);
+
+    /**
+     * Get the variant number of this process.
+     * \returns The variant number, or ORIGINAL if this process is not a
+     *          variant.
+     */
+    static uint32_t GetVariant();
+
+    /**
+     * Get the number of variants which did not exit successfully.
+     *
+     * Only meaningful in the original process, after Fork() returned.
+     * \returns The number of variants which exited with a non-zero status
+     *          or were killed by a signal.
+     */
+    static uint32_t GetFailedVariants();
+};
+
+} // namespace ns3
+
+#endif /* SIMULATION_CHECKPOINT_H */
@@ -24,6 +24,7 @@
 #include "global-value.h"
 #include "log.h"
 #include "map-scheduler.h"
+#include "memory-accounting.h"
 #include "object-factory.h"
 #include "ptr.h"
 #include "scheduler.h"
@@ -148,6 +149,8 @@ Simulator::Destroy()
     {
         return;
     }
+    // Report the memory of the simulation before it is released
+    MemoryAccounting::ReportAtDestroy();
     /* Note: we have to call LogSetTimePrinter (0) below because if we do not do
      * this, and restart a simulation after this call to Destroy, (which is
      * legal), Simulator::GetImpl will trigger again an infinite recursion until
@@ -158,6 +161,8 @@ Simulator::Destroy()
     (*pimpl)->Destroy();
     (*pimpl)->Unref();
     *pimpl = nullptr;
+    m_stopEvent = EventId();
+    EventImpl::ReleaseMemoryPool();
 }
 
 void
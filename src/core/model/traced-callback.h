@@ -22,7 +22,7 @@
 
 #include "callback.h"
 
-#include <list>
+#include <vector>
 
 /**
  * \file
@@ -86,10 +86,24 @@ class TracedCallback
     void Disconnect(const CallbackBase& callback, std::string path);
     /**
      * \brief Functor which invokes the chain of Callbacks.
+     *
+     * A Callback connected by one of the Callbacks of the chain is
+     * invoked in the same call.  Connecting or disconnecting a Callback
+     * during the call may move the others in memory, so a Callback doing
+     * so must not use its own bound arguments afterwards.
+     *
      * \tparam Ts \deduced Types of the functor arguments.
      * \param [in] args The arguments to the functor
      */
-    void operator()(Ts... args) const;
+    void operator()(Ts... args) const
+    {
+        // Most trace sources have no sink: keep this test inline.
+        if (m_callbackList.empty())
+        {
+            return;
+        }
+        Invoke(args...);
+    }
     /**
      * \brief Checks if the Callbacks list is empty.
      * \return true if the Callbacks list is empty.
@@ -108,12 +122,18 @@ class TracedCallback
     /**@}*/
 
   private:
+    /**
+     * Invoke the chain of Callbacks, which is not empty.
+     * \param [in] args The arguments to the functor
+     */
+    void Invoke(const Ts&... args) const;
+
     /**
      * Container type for holding the chain of Callbacks.
      *
      * \tparam Ts \deduced Types of the functor arguments.
      */
-    typedef std::list<Callback<void, Ts...>> CallbackList;
+    typedef std::vector<Callback<void, Ts...>> CallbackList;
     /** The chain of Callbacks. */
     CallbackList m_callbackList;
 };
@@ -190,11 +210,12 @@ TracedCallback<Ts...>::Disconnect(const CallbackBase& callback, std::string path
 
 template <typename... Ts>
 void
-TracedCallback<Ts...>::operator()(Ts... args) const
+TracedCallback<Ts...>::Invoke(const Ts&... args) const
 {
-    for (auto i = m_callbackList.begin(); i != m_callbackList.end(); i++)
+    // Indices rather than iterators, which Connect may invalidate.
+    for (std::size_t i = 0; i < m_callbackList.size(); ++i)
     {
-        (*i)(args...);
+        m_callbackList[i](args...);
     }
 }
 
@@ -41,7 +41,15 @@ TypeId
 WallClockSynchronizer::GetTypeId()
 {
     static TypeId tid =
-        TypeId("ns3::WallClockSynchronizer").SetParent<Synchronizer>().SetGroupName("Core");
+        TypeId("ns3::WallClockSynchronizer")
+            .SetParent<Synchronizer>()
+            .SetGroupName("Core")
+            .AddAttribute("SpinThreshold",
+                          "How long before the target time a wait stops sleeping and starts "
+                          "busy-waiting; zero for three system clock ticks.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&WallClockSynchronizer::m_spinThreshold),
+                          MakeTimeChecker(Seconds(0)));
     return tid;
 }
 
@@ -194,7 +202,10 @@ WallClockSynchronizer::DoSynchronize(uint64_t nsCurrent, uint64_t nsDelay)
     // If we want to be more accurate than a jiffy (we do) then we need to sleep
     // for some number of jiffies and then busy wait for any leftover time.
     //
-    uint64_t numberJiffies = ns / m_jiffy;
+    uint64_t spinNs = m_spinThreshold.IsStrictlyPositive()
+                          ? static_cast<uint64_t>(m_spinThreshold.GetNanoSeconds())
+                          : 3 * m_jiffy;
+    uint64_t numberJiffies = ns > spinNs ? (ns - spinNs) / m_jiffy : 0;
     NS_LOG_INFO("Synchronize numberJiffies = " << numberJiffies);
     //
     // This is where the real world interjects its very ugly head.  The code
@@ -213,11 +224,10 @@ WallClockSynchronizer::DoSynchronize(uint64_t nsCurrent, uint64_t nsDelay)
     // waiting (doing nothing).
     //
     // I'm not really sure about this number -- a boss of mine once said, "pick
-    // a number and it'll be wrong."  But this works for now.
+    // a number and it'll be wrong."  So the busy-wait lasts three jiffies by
+    // default, and the SpinThreshold attribute tunes it for the machine.
     //
-    // \todo Hardcoded tunable parameter below.
-    //
-    if (numberJiffies > 3)
+    if (numberJiffies > 0)
     {
         NS_LOG_INFO("SleepWait for " << numberJiffies * m_jiffy << " ns");
         NS_LOG_INFO("SleepWait until " << nsCurrent + numberJiffies * m_jiffy << " ns");
@@ -227,7 +237,7 @@ WallClockSynchronizer::DoSynchronize(uint64_t nsCurrent, uint64_t nsDelay)
         // interrupted by a Signal.  In this case, we need to return and let the
         // simulator re-evaluate what to do.
         //
-        if (!SleepWait((numberJiffies - 3) * m_jiffy))
+        if (!SleepWait(numberJiffies * m_jiffy))
         {
             NS_LOG_INFO("SleepWait interrupted");
             return false;
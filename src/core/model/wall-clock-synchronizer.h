@@ -18,6 +18,7 @@
 #ifndef WALL_CLOCK_CLOCK_SYNCHRONIZER_H
 #define WALL_CLOCK_CLOCK_SYNCHRONIZER_H
 
+#include "nstime.h"
 #include "synchronizer.h"
 
 #include <condition_variable>
@@ -62,6 +63,11 @@ namespace ns3
  * to use the function @c clock_nanosleep() to sleep until a simulation Time
  * specified by the caller.
  *
+ * A sleep usually lasts longer than requested, so each wait sleeps until
+ * the SpinThreshold attribute before the target time, then busy-waits for
+ * the rest.  A larger threshold makes the events less late, at the cost
+ * of CPU time.
+ *
  * @todo Add more on jiffies, sleep, processes, etc.
  *
  */
@@ -165,6 +171,11 @@ class WallClockSynchronizer : public Synchronizer
     uint64_t m_jiffy;
     /** Time recorded by DoEventStart. */
     uint64_t m_nsEventStart;
+    /**
+     * The part of each wait spent busy-waiting rather than sleeping;
+     * zero for three jiffies.
+     */
+    Time m_spinThreshold;
 
     /** Condition variable for thread synchronizer. */
     std::condition_variable m_conditionVariable;
@@ -16,9 +16,11 @@
  */
 
 #include "ns3/callback.h"
+#include "ns3/simple-ref-count.h"
 #include "ns3/test.h"
 
 #include <stdint.h>
+#include <utility>
 
 using namespace ns3;
 
@@ -991,6 +993,191 @@ NullifyCallbackTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(target1.IsNull(), true, "Nullified Callback reports not IsNull()");
 }
 
+/**
+ * \ingroup callback-tests
+ *
+ * Test the Callbacks stored inline: their equality with the Callbacks
+ * built by Bind(), the copies of their bound arguments and the
+ * conversions to CallbackBase.
+ */
+class InlineCallbackTestCase : public TestCase
+{
+  public:
+    InlineCallbackTestCase();
+
+    /**
+     * Member function used to test the inline Callbacks.
+     *
+     * \param a first argument
+     * \param b second argument
+     * \param c third argument
+     * \return the sum of the arguments
+     */
+    int TargetMember(double a, int b, int c)
+    {
+        return static_cast<int>(a) + b + c;
+    }
+
+  private:
+    void DoRun() override;
+};
+
+/**
+ * Reference counted class bound to the Callbacks.
+ */
+class InlineCallbackCounted : public SimpleRefCount<InlineCallbackCounted>
+{
+};
+
+/**
+ * Non-member function used to test the inline Callbacks.
+ *
+ * \param counted A reference counted object
+ * \param a first number
+ * \param b second number
+ * \return the sum of the numbers
+ */
+static int
+InlineCallbackTarget(Ptr<InlineCallbackCounted> counted [[maybe_unused]], int a, int b)
+{
+    return a + b;
+}
+
+/**
+ * Non-member function accumulating into a bound argument.
+ *
+ * \param total The bound total
+ * \param n The number to add
+ * \return the new total
+ */
+static int
+InlineCallbackAccumulate(int& total, int n)
+{
+    total += n;
+    return total;
+}
+
+InlineCallbackTestCase::InlineCallbackTestCase()
+    : TestCase("Check the Callbacks stored inline")
+{
+}
+
+void
+InlineCallbackTestCase::DoRun()
+{
+    //
+    // A member function with two bound arguments, stored inline, is equal to
+    // the same Callbacks built by Bind() and the binding constructor.
+    //
+    Callback<int, int> target1a =
+        MakeCallback(&InlineCallbackTestCase::TargetMember, this, 1.5, 2);
+    Callback<int, double, int, int> target1 =
+        MakeCallback(&InlineCallbackTestCase::TargetMember, this);
+    Callback<int, int> target1b = target1.Bind(1.5, 2);
+    Callback<int, int> target1c(Callback<int, int, int>(target1, 1.5), 2);
+    NS_TEST_ASSERT_MSG_EQ(
+        (Callback<int, int>::IS_INLINE<decltype(&InlineCallbackTestCase::TargetMember),
+                                       InlineCallbackTestCase*,
+                                       double,
+                                       int>),
+        true,
+        "Callback not stored inline");
+    NS_TEST_ASSERT_MSG_EQ(target1a(3), 6, "Wrong value returned");
+    NS_TEST_ASSERT_MSG_EQ(target1a.IsEqual(target1b), true, "Equality test failed");
+    NS_TEST_ASSERT_MSG_EQ(target1b.IsEqual(target1a), true, "Equality test failed");
+    NS_TEST_ASSERT_MSG_EQ(target1c.IsEqual(target1a), true, "Equality test failed");
+    NS_TEST_ASSERT_MSG_EQ(
+        target1a.IsEqual(MakeCallback(&InlineCallbackTestCase::TargetMember, this, 1.5, 3)),
+        false,
+        "Callbacks with different bound arguments compare equal");
+    NS_TEST_ASSERT_MSG_EQ(target1a.IsEqual(target1.Bind(1.5, 3)),
+                          false,
+                          "Callbacks with different bound arguments compare equal");
+
+    //
+    // Copies and assignments compare equal and outlive the original.
+    //
+    Callback<int, int> target2;
+    {
+        Callback<int, int> copy(target1a);
+        NS_TEST_ASSERT_MSG_EQ(copy.IsEqual(target1a), true, "Equality test failed");
+        target2 = copy;
+        copy.Nullify();
+        NS_TEST_ASSERT_MSG_EQ(copy.IsNull(), true, "Nullified Callback reports not IsNull()");
+    }
+    NS_TEST_ASSERT_MSG_EQ(target2.IsNull(), false, "Copied Callback reports IsNull()");
+    NS_TEST_ASSERT_MSG_EQ(target2(4), 7, "Wrong value returned");
+    NS_TEST_ASSERT_MSG_EQ(target2.IsEqual(target1b), true, "Equality test failed");
+    target2 = target1b;
+    NS_TEST_ASSERT_MSG_EQ(target2.IsEqual(target1a), true, "Equality test failed");
+
+    //
+    // Bound arguments which are not trivially copyable are copied and
+    // released with the Callbacks.
+    //
+    Ptr<InlineCallbackCounted> counted = Create<InlineCallbackCounted>();
+    {
+        Callback<int, int> target3a = MakeBoundCallback(&InlineCallbackTarget, counted, 4);
+        Callback<int, int> target3b(target3a);
+        NS_TEST_ASSERT_MSG_EQ(counted->GetReferenceCount(), 3, "Bound Ptr not copied");
+        NS_TEST_ASSERT_MSG_EQ(target3b(2), 6, "Wrong value returned");
+        Callback<int, Ptr<InlineCallbackCounted>, int, int> target3 =
+            MakeCallback(&InlineCallbackTarget);
+        NS_TEST_ASSERT_MSG_EQ(target3b.IsEqual(target3.Bind(counted, 4)),
+                              true,
+                              "Equality test failed");
+        NS_TEST_ASSERT_MSG_EQ(target3b.IsEqual(target3.Bind(counted, 5)),
+                              false,
+                              "Callbacks with different bound arguments compare equal");
+    }
+    NS_TEST_ASSERT_MSG_EQ(counted->GetReferenceCount(), 1, "Bound Ptr not released");
+
+    //
+    // An argument bound to a non-const reference is still shared by the
+    // copies of the Callback.
+    //
+    Callback<int, int> target4a = MakeBoundCallback(&InlineCallbackAccumulate, 10);
+    Callback<int, int> target4b = target4a;
+    NS_TEST_ASSERT_MSG_EQ(target4a(1), 11, "Wrong value returned");
+    NS_TEST_ASSERT_MSG_EQ(target4b(2), 13, "Bound argument not shared by the copies");
+
+    //
+    // An inline Callback goes through CallbackBase and CallbackValue.
+    //
+    CallbackValue value(target1a);
+    Callback<int, int> target5a;
+    NS_TEST_ASSERT_MSG_EQ(value.GetAccessor(target5a), true, "Callback type mismatch");
+    NS_TEST_ASSERT_MSG_EQ(target5a.IsEqual(target1a), true, "Equality test failed");
+    NS_TEST_ASSERT_MSG_EQ(target5a(0), 3, "Wrong value returned");
+    Callback<int, double> target5b;
+    NS_TEST_ASSERT_MSG_EQ(target5b.CheckType(target1a), false, "Callback type mismatch");
+    NS_TEST_ASSERT_MSG_EQ(value.SerializeToString(nullptr),
+                          CallbackValue(target1b).SerializeToString(nullptr),
+                          "Equal Callbacks serialized differently");
+    NS_TEST_ASSERT_MSG_EQ(value.SerializeToString(nullptr),
+                          CallbackValue(target1a).SerializeToString(nullptr),
+                          "Equal Callbacks serialized differently");
+
+    //
+    // A moved Callback keeps its target and bound arguments, and leaves
+    // the source null.
+    //
+    {
+        Callback<int, int> target6a = MakeBoundCallback(&InlineCallbackTarget, counted, 4);
+        Callback<int, int> target6b(std::move(target6a));
+        NS_TEST_ASSERT_MSG_EQ(target6a.IsNull(), true, "Moved Callback not null");
+        NS_TEST_ASSERT_MSG_EQ(target6b(2), 6, "Wrong value returned");
+        NS_TEST_ASSERT_MSG_EQ(counted->GetReferenceCount(), 2, "Bound Ptr copied");
+        target6a = std::move(target6b);
+        NS_TEST_ASSERT_MSG_EQ(target6b.IsNull(), true, "Moved Callback not null");
+        NS_TEST_ASSERT_MSG_EQ(target6a(3), 7, "Wrong value returned");
+        target2 = std::move(target1b);
+        NS_TEST_ASSERT_MSG_EQ(target1b.IsNull(), true, "Moved Callback not null");
+        NS_TEST_ASSERT_MSG_EQ(target2.IsEqual(target1a), true, "Equality test failed");
+    }
+    NS_TEST_ASSERT_MSG_EQ(counted->GetReferenceCount(), 1, "Bound Ptr not released");
+}
+
 /**
  * \ingroup callback-tests
  *
@@ -1197,6 +1384,7 @@ CallbackTestSuite::CallbackTestSuite()
     AddTestCase(new MakeBoundCallbackTestCase, TestCase::QUICK);
     AddTestCase(new CallbackEqualityTestCase, TestCase::QUICK);
     AddTestCase(new NullifyCallbackTestCase, TestCase::QUICK);
+    AddTestCase(new InlineCallbackTestCase, TestCase::QUICK);
     AddTestCase(new MakeCallbackTemplatesTestCase, TestCase::QUICK);
 }
 
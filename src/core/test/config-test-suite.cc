@@ -864,6 +864,123 @@ SearchAttributesOfParentObjectsTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), 42, "Object Attribute \"X\" not settable in derived class");
 }
 
+/**
+ * \ingroup config-tests
+ * Test for the operations on several paths applied by Config::Batch.
+ */
+class BatchConfigTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    BatchConfigTestCase();
+
+    /** Destructor. */
+    ~BatchConfigTestCase() override
+    {
+    }
+
+    /**
+     * Trace callback without context.
+     * \param oldValue The old value.
+     * \param newValue The new value.
+     */
+    void Trace(int16_t oldValue [[maybe_unused]], int16_t newValue)
+    {
+        m_newValue = newValue;
+    }
+
+    /**
+     * Trace callback with context path.
+     * \param path The context path.
+     * \param old The old value.
+     * \param newValue The new value.
+     */
+    void TraceWithPath(std::string path, int16_t old [[maybe_unused]], int16_t newValue)
+    {
+        m_newValue = newValue;
+        m_path = path;
+    }
+
+  private:
+    void DoRun() override;
+
+    int16_t m_newValue; //!< Flag to detect tracing result.
+    std::string m_path; //!< The context path.
+};
+
+BatchConfigTestCase::BatchConfigTestCase()
+    : TestCase("Check the operations on several paths applied by Config::Batch")
+{
+}
+
+void
+BatchConfigTestCase::DoRun()
+{
+    IntegerValue iv;
+
+    //
+    // Name a root object, so that the paths do not match the objects left
+    // under the root namespace by the other tests, with four objects in its
+    // NodesA vector, each of which has an object as NodeB.
+    //
+    Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject>();
+    Names::Add("BatchRoot", root);
+    std::vector<Ptr<ConfigTestObject>> nodesA;
+    std::vector<Ptr<ConfigTestObject>> nodesB;
+    for (int i = 0; i < 4; ++i)
+    {
+        nodesA.push_back(CreateObject<ConfigTestObject>());
+        nodesB.push_back(CreateObject<ConfigTestObject>());
+        root->AddNodeA(nodesA.back());
+        nodesA.back()->SetNodeB(nodesB.back());
+    }
+
+    Config::Batch batch;
+    batch.Connect("/Names/BatchRoot/NodesA/*/Source",
+                  MakeCallback(&BatchConfigTestCase::TraceWithPath, this));
+    batch.ConnectWithoutContext("/Names/BatchRoot/NodesA/[1-2]/NodeB/Source",
+                                MakeCallback(&BatchConfigTestCase::Trace, this));
+    batch.Set("/Names/BatchRoot/NodesA/*/NodeB/A", IntegerValue(3));
+    batch.Set("/Names/BatchRoot/NodesA/3/B", IntegerValue(4));
+    NS_TEST_ASSERT_MSG_EQ(batch.GetN(), 4, "Wrong number of operations");
+    batch.Apply();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        m_newValue = 0;
+        m_path = "";
+        nodesA[i]->SetAttribute("Source", IntegerValue(-2 - i));
+        NS_TEST_ASSERT_MSG_EQ(m_newValue, -2 - i, "Trace " << i << " did not fire as expected");
+        NS_TEST_ASSERT_MSG_EQ(m_path,
+                              "/Names/BatchRoot/NodesA/" + std::to_string(i) + "/Source",
+                              "Trace " << i << " did not provide expected context");
+
+        m_newValue = 0;
+        nodesB[i]->SetAttribute("Source", IntegerValue(-6 - i));
+        NS_TEST_ASSERT_MSG_EQ(m_newValue,
+                              ((i == 1 || i == 2) ? -6 - i : 0),
+                              "Trace of NodeB " << i << " is wrong");
+
+        nodesB[i]->GetAttribute("A", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(), 3, "Attribute A of NodeB " << i << " not set");
+        nodesA[i]->GetAttribute("B", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(), (i == 3 ? 4 : 9), "Attribute B of " << i << " is wrong");
+    }
+
+    //
+    // An operation which matches nothing fails, the others are applied.
+    //
+    Config::Batch failing;
+    failing.ConnectWithoutContext("/Names/BatchRoot/NodesA/*/Missing",
+                                  MakeCallback(&BatchConfigTestCase::Trace, this));
+    failing.Set("/Names/BatchRoot/NodesA/*/A", IntegerValue(5));
+    NS_TEST_ASSERT_MSG_EQ(failing.ApplyFailSafe(), false, "Missing trace source not detected");
+    nodesA[0]->GetAttribute("A", iv);
+    NS_TEST_ASSERT_MSG_EQ(iv.Get(), 5, "Attribute A not set");
+
+    Names::Clear();
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -882,6 +999,7 @@ ConfigTestSuite::ConfigTestSuite()
     AddTestCase(new UnderRootNamespaceConfigTestCase);
     AddTestCase(new ObjectVectorConfigTestCase);
     AddTestCase(new SearchAttributesOfParentObjectsTestCase);
+    AddTestCase(new BatchConfigTestCase);
 }
 
 /**
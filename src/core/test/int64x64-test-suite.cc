@@ -1088,6 +1088,107 @@ Int64x64InvertTestCase::DoRun()
     Check(1000000000000000LL);
 }
 
+/**
+ * \ingroup int64x64-tests
+ *
+ * Test: division is truncated to the last fraction bit, whether the
+ * divisor is an integer, less than one, or has both parts.
+ */
+class Int64x64DivisionTestCase : public TestCase
+{
+  public:
+    Int64x64DivisionTestCase();
+    void DoRun() override;
+    /**
+     * Check the quotient of two values.
+     * \param test The test number.
+     * \param numerator The numerator.
+     * \param denominator The denominator.
+     * \param expect The expected quotient.
+     */
+    void Check(const int test,
+               const int64x64_t numerator,
+               const int64x64_t denominator,
+               const int64x64_t expect);
+};
+
+Int64x64DivisionTestCase::Int64x64DivisionTestCase()
+    : TestCase("Truncated division")
+{
+}
+
+void
+Int64x64DivisionTestCase::Check(const int test,
+                                const int64x64_t numerator,
+                                const int64x64_t denominator,
+                                const int64x64_t expect)
+{
+    const int64x64_t value = numerator / denominator;
+    const bool pass = value == expect;
+
+    std::cout << GetParent()->GetName() << " Division: " << (pass ? "pass " : "FAIL ") << test
+              << ": " << numerator << " / " << denominator << " = " << value
+              << " == " << expect << std::endl;
+
+    NS_TEST_ASSERT_MSG_EQ(value, expect, "Division failure in test case " << test);
+}
+
+void
+Int64x64DivisionTestCase::DoRun()
+{
+    std::cout << std::endl;
+    std::cout << GetParent()->GetName() << " Division: " << GetName() << std::endl;
+
+    // The other implementations round differently
+    if (int64x64_t::implementation != int64x64_t::int128_impl)
+    {
+        std::cout << "Skipping the exact quotients of this implementation" << std::endl;
+        return;
+    }
+
+    // Integer divisors
+    Check(0, int64x64_t(1, 0), int64x64_t(3, 0), int64x64_t(0, 0x5555555555555555ULL));
+    Check(1,
+          int64x64_t(2000000000, 0),
+          int64x64_t(3, 0),
+          int64x64_t(666666666, 0xaaaaaaaaaaaaaaaaULL));
+    Check(2, int64x64_t(12000, 0), int64x64_t(100000000, 0), int64x64_t(0, 0x0007dd441355475aULL));
+
+    // Divisors less than one
+    Check(3,
+          int64x64_t(1, 0),
+          int64x64_t(0, 0x4ccccccccccccccdULL),
+          int64x64_t(3, 0x5555555555555553ULL));
+
+    // Divisors with integer and fraction parts
+    Check(4,
+          int64x64_t(1000000000, 0),
+          int64x64_t(1, 0x8000000000000000ULL),
+          int64x64_t(666666666, 0xaaaaaaaaaaaaaaaaULL));
+    Check(5,
+          int64x64_t(4611686018427387903LL, 0x123456789abcdef0ULL),
+          int64x64_t(12345, 0xadcd1234fedc5678ULL),
+          int64x64_t(373546570577610LL, 0x84cc10e846150ed6ULL));
+    Check(6,
+          int64x64_t(1099511627776LL, 0x199999999999999aULL),
+          int64x64_t(1099511627776LL, 0x0000000000000010ULL),
+          int64x64_t(1, 0x0000000000199999ULL));
+    Check(7,
+          int64x64_t(9223372036854775807LL, 0xffffffffffffffffULL),
+          int64x64_t(9223372036854775807LL, 0xffffffffffffffffULL),
+          int64x64_t(1, 0));
+
+    // Negative operands are truncated toward zero
+    Check(8,
+          int64x64_t(-8, 0xc000000000000000ULL),
+          int64x64_t(2, 0x8000000000000000ULL),
+          int64x64_t(-3, 0x199999999999999aULL));
+    Check(9,
+          int64x64_t(5, 0x0000000000000001ULL),
+          int64x64_t(-65537, 0x0000000000000001ULL),
+          int64x64_t(-1, 0xfffb0004fffb0005ULL));
+}
+
 /**
  * \ingroup int64x64-tests
  *
@@ -1570,6 +1671,7 @@ class Int64x64TestSuite : public TestSuite
         AddTestCase(new Int64x64Bug863TestCase(), TestCase::QUICK);
         AddTestCase(new Int64x64Bug1786TestCase(), TestCase::QUICK);
         AddTestCase(new Int64x64InvertTestCase(), TestCase::QUICK);
+        AddTestCase(new Int64x64DivisionTestCase(), TestCase::QUICK);
         AddTestCase(new Int64x64DoubleTestCase(), TestCase::QUICK);
     }
 };
@@ -0,0 +1,444 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log-binary.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef __WIN32__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * \ingroup log-binary-tests
+ * Binary log test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup log-binary-tests Binary log test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+NS_LOG_COMPONENT_DEFINE("LogBinaryTestSuite");
+
+/**
+ * \ingroup log-binary-tests
+ * Base class of the binary log tests, which runs the same logging
+ * statements to text and to a binary log.
+ */
+class LogBinaryTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] name The test name.
+     */
+    LogBinaryTestCase(const std::string& name);
+
+  protected:
+    /**
+     * Run a function logging to \c std::clog.
+     * \param [in] f The function.
+     * \returns The log output.
+     */
+    std::string LogText(std::function<void()> f);
+    /**
+     * Run a function logging to a binary log, then decode it.
+     * \param [in] f The function.
+     * \returns The decoded log output.
+     */
+    std::string LogBinary(std::function<void()> f);
+};
+
+LogBinaryTestCase::LogBinaryTestCase(const std::string& name)
+    : TestCase(name)
+{
+}
+
+std::string
+LogBinaryTestCase::LogText(std::function<void()> f)
+{
+    std::ostringstream log;
+    auto clog = std::clog.rdbuf(log.rdbuf());
+    f();
+    std::clog.rdbuf(clog);
+    return log.str();
+}
+
+std::string
+LogBinaryTestCase::LogBinary(std::function<void()> f)
+{
+    std::string filename = CreateTempDirFilename("log.bin");
+    LogSetBinaryFile(filename);
+    NS_TEST_EXPECT_MSG_EQ(LogIsBinary(), true, "Binary log not enabled");
+    f();
+    LogSetBinaryFile("");
+    NS_TEST_EXPECT_MSG_EQ(LogIsBinary(), false, "Binary log not disabled");
+
+    std::ifstream is(filename, std::ios::binary);
+    std::ostringstream log;
+    NS_TEST_EXPECT_MSG_EQ(LogBinaryDecode(is, log), true, "Cannot decode the binary log");
+    return log.str();
+}
+
+/**
+ * \ingroup log-binary-tests
+ * A type whose output operator takes a non-const reference.
+ */
+struct NonConstPrintable
+{
+    int value; //!< The printed value
+};
+
+/**
+ * \ingroup log-binary-tests
+ * Output operator taking a non-const reference, as some models define.
+ * \param [in,out] os The output stream.
+ * \param [in] p The printed object.
+ * \returns The output stream.
+ */
+std::ostream&
+operator<<(std::ostream& os, NonConstPrintable& p)
+{
+    return os << "printable " << p.value;
+}
+
+/**
+ * \ingroup log-binary-tests
+ * Check that a decoded binary log reads as the text log.
+ */
+class LogBinaryMessagesTestCase : public LogBinaryTestCase
+{
+  public:
+    LogBinaryMessagesTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Log messages of all kinds.
+     * \param [in] s A string.
+     * \param [in] v A vector.
+     */
+    void Log(const std::string& s, const std::vector<int>& v);
+};
+
+LogBinaryMessagesTestCase::LogBinaryMessagesTestCase()
+    : LogBinaryTestCase("Check the messages of a binary log")
+{
+}
+
+void
+LogBinaryMessagesTestCase::Log(const std::string& s, const std::vector<int>& v)
+{
+    NS_LOG_FUNCTION(this << s << v << 'c' << uint8_t(7) << true << 2.5);
+    NS_LOG_FUNCTION_NOARGS();
+    int8_t i8 = -3;
+    uint64_t u64 = 18000000000000000000ULL;
+    const char* cstr = "c string";
+    NS_LOG_ERROR("int " << -42 << " unsigned " << 42U << " i8 " << i8 << " u64 " << u64);
+    NS_LOG_WARN("bool " << false << " double " << 3.14159265 << " float " << 0.1F);
+    NS_LOG_INFO("char " << 'x' << " string " << s << " c string " << cstr);
+    NS_LOG_LOGIC("pointer " << this << " null " << static_cast<void*>(nullptr));
+    NS_LOG_DEBUG("time " << Seconds(1.5) << " endl" << std::endl << "done");
+    NS_LOG_DEBUG("hex " << std::hex << 255 << " width [" << std::setw(5) << 42 << "]");
+    NS_LOG_DEBUG("back to decimal " << 255 << " precision " << 3.14159265);
+    NonConstPrintable printable{5};
+    NS_LOG_DEBUG("non-const " << printable);
+}
+
+void
+LogBinaryMessagesTestCase::DoRun()
+{
+    g_log.Enable(LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+    std::vector<int> v{1, 2, 3};
+
+    // Without simulator, then in an event with a context
+    Simulator::Destroy();
+    auto text = LogText([&]() { Log("outside", v); });
+    auto binary = LogBinary([&]() { Log("outside", v); });
+    NS_TEST_EXPECT_MSG_EQ(binary, text, "Wrong messages outside of the simulation");
+
+    Simulator::ScheduleWithContext(3, Seconds(1.25), [&]() {
+        text = LogText([&]() { Log("event", v); });
+        binary = LogBinary([&]() { Log("event", v); });
+    });
+    Simulator::Run();
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(binary, text, "Wrong messages in an event");
+
+    g_log.Enable(LOG_LEVEL_ALL);
+    g_log.Disable(LOG_PREFIX_ALL);
+    text = LogText([&]() { Log("no prefix", v); });
+    binary = LogBinary([&]() { Log("no prefix", v); });
+    NS_TEST_EXPECT_MSG_EQ(binary, text, "Wrong messages without prefixes");
+    g_log.Disable(LOG_LEVEL_ALL);
+}
+
+/**
+ * \ingroup log-binary-tests
+ * Check binary logs larger than the buffers, from several threads.
+ */
+class LogBinaryBlocksTestCase : public LogBinaryTestCase
+{
+  public:
+    LogBinaryBlocksTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Log many long messages.
+     * \param [in] thread The thread number.
+     */
+    static void Log(int thread);
+
+    /**
+     * Sort the lines of a log, as the threads hand their records over in
+     * batches.
+     * \param [in] log The log.
+     * \returns The log with its lines sorted.
+     */
+    static std::string SortLines(const std::string& log);
+
+    /** An object which logs while it is printed. */
+    struct Nested
+    {
+    };
+
+    /**
+     * Print a Nested object.
+     * \param [in,out] os The output stream.
+     * \param [in] nested The object.
+     * \returns The output stream.
+     */
+    friend std::ostream& operator<<(std::ostream& os, const Nested& nested)
+    {
+        NS_LOG_DEBUG("nested message");
+        return os << "nested";
+    }
+};
+
+LogBinaryBlocksTestCase::LogBinaryBlocksTestCase()
+    : LogBinaryTestCase("Check binary logs larger than the buffers")
+{
+}
+
+void
+LogBinaryBlocksTestCase::Log(int thread)
+{
+    std::string s(1000, 'a' + thread);
+    for (int i = 0; i < 200; ++i)
+    {
+        NS_LOG_INFO(thread << " " << i << " " << s);
+    }
+}
+
+std::string
+LogBinaryBlocksTestCase::SortLines(const std::string& log)
+{
+    std::vector<std::string> lines;
+    std::istringstream is(log);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        lines.push_back(line);
+    }
+    std::sort(lines.begin(), lines.end());
+    std::string sorted;
+    for (const auto& l : lines)
+    {
+        sorted += l + "\n";
+    }
+    return sorted;
+}
+
+void
+LogBinaryBlocksTestCase::DoRun()
+{
+    g_log.Enable(LOG_LEVEL_ALL);
+
+    auto text = LogText([]() { Log(0); });
+    auto binary = LogBinary([]() { Log(0); });
+    NS_TEST_EXPECT_MSG_EQ(binary, text, "Wrong messages in several blocks");
+
+    // Each thread hands its records over when it exits
+    binary = LogBinary([]() {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back(&LogBinaryBlocksTestCase::Log, i);
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+    });
+    text = LogText([]() {
+        for (int i = 0; i < 4; ++i)
+        {
+            Log(i);
+        }
+    });
+    NS_TEST_EXPECT_MSG_EQ(SortLines(binary), SortLines(text), "Wrong messages of the threads");
+
+    // The message logged while formatting another one comes after it
+    binary = LogBinary([]() { NS_LOG_DEBUG("outer " << Nested() << " end"); });
+    NS_TEST_EXPECT_MSG_EQ(binary, "outer nested end\nnested message\n", "Wrong nested messages");
+
+    // A truncated log is detected
+    std::string filename = CreateTempDirFilename("log.bin");
+    LogSetBinaryFile(filename);
+    Log(0);
+    LogSetBinaryFile("");
+    std::ifstream is(filename, std::ios::binary);
+    std::string truncated((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    truncated.resize(truncated.size() - 10);
+    std::istringstream tis(truncated);
+    std::ostringstream log;
+    NS_TEST_EXPECT_MSG_EQ(LogBinaryDecode(tis, log), false, "Truncated log not detected");
+
+    g_log.Disable(LOG_LEVEL_ALL);
+}
+
+#ifndef __WIN32__
+/**
+ * \ingroup log-binary-tests
+ * Check that a process forked while the binary log is open logs to a file
+ * of its own, and that the parent log is not affected.
+ */
+class LogBinaryForkTestCase : public LogBinaryTestCase
+{
+  public:
+    LogBinaryForkTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Decode a binary log.
+     * \param [in] filename The file name.
+     * \returns The decoded log output.
+     */
+    std::string Decode(const std::string& filename);
+};
+
+LogBinaryForkTestCase::LogBinaryForkTestCase()
+    : LogBinaryTestCase("Check the binary logs of a forked process")
+{
+}
+
+std::string
+LogBinaryForkTestCase::Decode(const std::string& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    std::ostringstream log;
+    NS_TEST_EXPECT_MSG_EQ(LogBinaryDecode(is, log), true, "Cannot decode " << filename);
+    return log.str();
+}
+
+void
+LogBinaryForkTestCase::DoRun()
+{
+    g_log.Enable(LOG_LEVEL_INFO);
+    std::string filename = CreateTempDirFilename("log.bin");
+    LogSetBinaryFile(filename);
+    NS_LOG_INFO("before the fork");
+
+    // The child logs more than the writer thread may have pending
+    const int records = 400000;
+    pid_t pid = fork();
+    NS_TEST_ASSERT_MSG_NE(pid, -1, "fork() failed");
+    if (pid == 0)
+    {
+        // A child blocked on the writer is killed
+        alarm(60);
+        for (int i = 0; i < records; ++i)
+        {
+            NS_LOG_INFO("child " << i);
+        }
+        LogSetBinaryFile("");
+        _exit(0);
+    }
+    NS_LOG_INFO("parent");
+    LogSetBinaryFile("");
+    int status = 0;
+    NS_TEST_ASSERT_MSG_EQ(waitpid(pid, &status, 0), pid, "waitpid() failed");
+    NS_TEST_ASSERT_MSG_EQ(WIFEXITED(status), true, "Child killed by signal " << WTERMSIG(status));
+    NS_TEST_EXPECT_MSG_EQ(WEXITSTATUS(status), 0, "Child failed");
+    g_log.Disable(LOG_LEVEL_ALL);
+
+    NS_TEST_EXPECT_MSG_EQ(Decode(filename), "before the fork\nparent\n", "Wrong parent log");
+    std::string child = Decode(filename + "." + std::to_string(pid));
+    std::string expected;
+    for (int i = 0; i < records; ++i)
+    {
+        expected += "child " + std::to_string(i) + "\n";
+    }
+    NS_TEST_EXPECT_MSG_EQ((child == expected), true, "Wrong child log");
+}
+#endif
+
+/**
+ * \ingroup log-binary-tests
+ * Binary log test suite.
+ */
+class LogBinaryTestSuite : public TestSuite
+{
+  public:
+    LogBinaryTestSuite();
+};
+
+LogBinaryTestSuite::LogBinaryTestSuite()
+    : TestSuite("log-binary")
+{
+#ifdef NS3_LOG_ENABLE
+    AddTestCase(new LogBinaryMessagesTestCase);
+    AddTestCase(new LogBinaryBlocksTestCase);
+#ifndef __WIN32__
+    AddTestCase(new LogBinaryForkTestCase);
+#endif
+#endif
+}
+
+/**
+ * \ingroup log-binary-tests
+ * LogBinaryTestSuite instance variable.
+ */
+static LogBinaryTestSuite g_logBinaryTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
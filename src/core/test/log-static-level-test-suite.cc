@@ -0,0 +1,144 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Build this file as if its module was configured with
+// NS3_LOG_STATIC_LEVEL=warn, whatever the actual configuration
+#undef NS3_LOG_STATIC_MASK
+#define NS3_LOG_STATIC_MASK ns3::LOG_LEVEL_WARN
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * \ingroup log-static-level-tests
+ * Static log level test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup log-static-level-tests Static log level test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+NS_LOG_COMPONENT_DEFINE("LogStaticLevelTestSuite");
+
+static_assert(NS_LOG_STATIC_ENABLED(LOG_ERROR), "LOG_ERROR should be compiled in");
+static_assert(NS_LOG_STATIC_ENABLED(LOG_WARN), "LOG_WARN should be compiled in");
+static_assert(!NS_LOG_STATIC_ENABLED(LOG_INFO), "LOG_INFO should be compiled out");
+static_assert(!NS_LOG_STATIC_ENABLED(LOG_FUNCTION), "LOG_FUNCTION should be compiled out");
+static_assert(!NS_LOG_STATIC_ENABLED(LOG_LOGIC), "LOG_LOGIC should be compiled out");
+static_assert(!NS_LOG_STATIC_ENABLED(LOG_DEBUG), "LOG_DEBUG should be compiled out");
+
+/**
+ * \ingroup log-static-level-tests
+ *
+ * Check that the log statements above the static log level are neither
+ * evaluated nor enabled at runtime.
+ */
+class LogStaticLevelTestCase : public TestCase
+{
+  public:
+    LogStaticLevelTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Count the evaluations of a log message.
+     * \returns The number of evaluations so far.
+     */
+    int Evaluate();
+
+    int m_evaluations; //!< Number of evaluations of the log messages.
+};
+
+LogStaticLevelTestCase::LogStaticLevelTestCase()
+    : TestCase("Check that log levels above the static level are compiled out"),
+      m_evaluations(0)
+{
+}
+
+int
+LogStaticLevelTestCase::Evaluate()
+{
+    return ++m_evaluations;
+}
+
+void
+LogStaticLevelTestCase::DoRun()
+{
+    g_log.Enable(LOG_LEVEL_ALL);
+    NS_TEST_EXPECT_MSG_EQ(g_log.IsEnabled(LOG_ERROR), true, "LOG_ERROR not enabled");
+    NS_TEST_EXPECT_MSG_EQ(g_log.IsEnabled(LOG_WARN), true, "LOG_WARN not enabled");
+    NS_TEST_EXPECT_MSG_EQ(g_log.IsEnabled(LOG_INFO), false, "LOG_INFO enabled");
+    NS_TEST_EXPECT_MSG_EQ(g_log.IsEnabled(LOG_FUNCTION), false, "LOG_FUNCTION enabled");
+    NS_TEST_EXPECT_MSG_EQ(g_log.IsEnabled(LOG_LOGIC), false, "LOG_LOGIC enabled");
+    NS_TEST_EXPECT_MSG_EQ(g_log.IsEnabled(LOG_DEBUG), false, "LOG_DEBUG enabled");
+
+    std::ostringstream log;
+    auto clog = std::clog.rdbuf(log.rdbuf());
+    NS_LOG_ERROR("error " << Evaluate());
+    NS_LOG_WARN("warn " << Evaluate());
+    NS_LOG_INFO("info " << Evaluate());
+    NS_LOG_FUNCTION(Evaluate());
+    NS_LOG_LOGIC("logic " << Evaluate());
+    NS_LOG_DEBUG("debug " << Evaluate());
+    std::clog.rdbuf(clog);
+    g_log.Disable(LOG_LEVEL_ALL);
+
+#ifdef NS3_LOG_ENABLE
+    NS_TEST_EXPECT_MSG_EQ(m_evaluations, 2, "Wrong number of messages evaluated");
+    NS_TEST_EXPECT_MSG_EQ(log.str(), "error 1\nwarn 2\n", "Wrong log output");
+#else
+    NS_TEST_EXPECT_MSG_EQ(m_evaluations, 0, "Messages evaluated without logging");
+    NS_TEST_EXPECT_MSG_EQ(log.str(), "", "Log output without logging");
+#endif
+}
+
+/**
+ * \ingroup log-static-level-tests
+ * Static log level test suite.
+ */
+class LogStaticLevelTestSuite : public TestSuite
+{
+  public:
+    LogStaticLevelTestSuite();
+};
+
+LogStaticLevelTestSuite::LogStaticLevelTestSuite()
+    : TestSuite("log-static-level")
+{
+    AddTestCase(new LogStaticLevelTestCase);
+}
+
+/**
+ * \ingroup log-static-level-tests
+ * LogStaticLevelTestSuite instance variable.
+ */
+static LogStaticLevelTestSuite g_logStaticLevelTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
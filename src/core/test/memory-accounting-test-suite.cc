@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/memory-accounting.h"
+#include "ns3/object-factory.h"
+#include "ns3/object.h"
+#include "ns3/test.h"
+
+#include <sstream>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup memory-accounting-tests
+ * MemoryAccounting test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup memory-accounting-tests MemoryAccounting tests
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup memory-accounting-tests
+ *
+ * \brief An Object counted by the test.
+ */
+class AccountedObject : public Object
+{
+  public:
+    /**
+     * \brief Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::tests::AccountedObject")
+                                .SetParent<Object>()
+                                .SetGroupName("Core")
+                                .HideFromDocumentation()
+                                .AddConstructor<AccountedObject>();
+        return tid;
+    }
+
+  private:
+    [[maybe_unused]] uint8_t m_payload[100]; //!< Make the object larger than Object.
+};
+
+NS_OBJECT_ENSURE_REGISTERED(AccountedObject);
+
+/**
+ * \ingroup memory-accounting-tests
+ *
+ * \brief Check the live instances and bytes counted per TypeId and per
+ * category.
+ */
+class MemoryAccountingTestCase : public TestCase
+{
+  public:
+    MemoryAccountingTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MemoryAccountingTestCase::MemoryAccountingTestCase()
+    : TestCase("Check the memory accounted for per TypeId and category")
+{
+}
+
+void
+MemoryAccountingTestCase::DoRun()
+{
+    MemoryAccounting::Enable();
+    NS_TEST_ASSERT_MSG_EQ(MemoryAccounting::IsEnabled(), true, "Not enabled");
+
+    const TypeId tid = AccountedObject::GetTypeId();
+    const int64_t size = sizeof(AccountedObject);
+    auto base = MemoryAccounting::GetUsage(tid);
+    NS_TEST_EXPECT_MSG_EQ(base.name, tid.GetName(), "Wrong name");
+
+    {
+        std::vector<Ptr<AccountedObject>> objects;
+        for (int i = 0; i < 3; ++i)
+        {
+            objects.push_back(CreateObject<AccountedObject>());
+        }
+        ObjectFactory factory;
+        factory.SetTypeId(tid);
+        objects.push_back(factory.Create<AccountedObject>());
+        objects.push_back(CopyObject(objects[0]));
+
+        auto usage = MemoryAccounting::GetUsage(tid);
+        NS_TEST_EXPECT_MSG_EQ(usage.count, base.count + 5, "Wrong count");
+        NS_TEST_EXPECT_MSG_EQ(usage.bytes, base.bytes + 5 * size, "Wrong bytes");
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(usage.peak, base.bytes + 5 * size, "Wrong peak");
+
+        objects.pop_back();
+        usage = MemoryAccounting::GetUsage(tid);
+        NS_TEST_EXPECT_MSG_EQ(usage.count, base.count + 4, "Wrong count after a deletion");
+
+        bool found = false;
+        for (const auto& u : MemoryAccounting::GetUsages())
+        {
+            found |= (u.name == tid.GetName() && u.count == usage.count);
+        }
+        NS_TEST_EXPECT_MSG_EQ(found, true, "TypeId not listed");
+
+        std::ostringstream os;
+        MemoryAccounting::Print(os);
+        NS_TEST_EXPECT_MSG_NE(os.str().find(tid.GetName()), std::string::npos, "Not printed");
+    }
+    auto usage = MemoryAccounting::GetUsage(tid);
+    NS_TEST_EXPECT_MSG_EQ(usage.count, base.count, "Objects not released");
+    NS_TEST_EXPECT_MSG_EQ(usage.bytes, base.bytes, "Bytes not released");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(usage.peak, base.bytes + 5 * size, "Peak not kept");
+
+    // Categories
+    static const uint32_t category = MemoryAccounting::RegisterCategory("Test category");
+    auto before = MemoryAccounting::GetUsage("Test category");
+    MemoryAccounting::Allocated(category, 1000);
+    MemoryAccounting::Allocated(category, 24);
+    auto during = MemoryAccounting::GetUsage("Test category");
+    NS_TEST_EXPECT_MSG_EQ(during.count, before.count + 2, "Wrong category count");
+    NS_TEST_EXPECT_MSG_EQ(during.bytes, before.bytes + 1024, "Wrong category bytes");
+    MemoryAccounting::Released(category, 1000);
+    MemoryAccounting::Released(category, 24);
+    auto after = MemoryAccounting::GetUsage("Test category");
+    NS_TEST_EXPECT_MSG_EQ(after.count, before.count, "Category not released");
+    NS_TEST_EXPECT_MSG_EQ(after.bytes, before.bytes, "Category bytes not released");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(after.peak, before.bytes + 1024, "Wrong category peak");
+
+    auto unknown = MemoryAccounting::GetUsage("No such category");
+    NS_TEST_EXPECT_MSG_EQ(unknown.count, 0, "Unknown category counted");
+}
+
+/**
+ * \ingroup memory-accounting-tests
+ *
+ * \brief MemoryAccounting test suite.
+ */
+class MemoryAccountingTestSuite : public TestSuite
+{
+  public:
+    MemoryAccountingTestSuite();
+};
+
+MemoryAccountingTestSuite::MemoryAccountingTestSuite()
+    : TestSuite("memory-accounting")
+{
+    AddTestCase(new MemoryAccountingTestCase(), TestCase::QUICK);
+}
+
+/// Static variable for test initialization.
+static MemoryAccountingTestSuite g_memoryAccountingTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -22,6 +22,8 @@
 #include "ns3/object.h"
 #include "ns3/test.h"
 
+#include <vector>
+
 /**
  * \file
  * \ingroup core-tests
@@ -464,6 +466,84 @@ AggregateObjectTestCase::DoRun()
     NS_TEST_ASSERT_MSG_NE(baseA, nullptr, "Unable to GetObject on released object");
 }
 
+/**
+ * \ingroup object-tests
+ * Test the lookups of the aggregates are cached correctly.
+ */
+class CachedGetObjectTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    CachedGetObjectTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+CachedGetObjectTestCase::CachedGetObjectTestCase()
+    : TestCase("Check the cached lookups of GetObject")
+{
+}
+
+void
+CachedGetObjectTestCase::DoRun()
+{
+    Ptr<BaseA> baseA = CreateObject<BaseA>();
+    Ptr<DerivedB> derivedB = CreateObject<DerivedB>();
+
+    //
+    // A failed lookup must not hide an Object aggregated afterwards.
+    //
+    NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(), nullptr, "Unexpected BaseB aggregate");
+    NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(), nullptr, "Unexpected cached BaseB aggregate");
+    NS_TEST_ASSERT_MSG_EQ(derivedB->GetObject<BaseA>(), nullptr, "Unexpected BaseA aggregate");
+    baseA->AggregateObject(derivedB);
+    for (int i = 0; i < 2; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(), derivedB, "Cannot find the BaseB part");
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<DerivedB>(), derivedB, "Cannot find DerivedB");
+        NS_TEST_ASSERT_MSG_EQ(derivedB->GetObject<BaseA>(), baseA, "Cannot find BaseA");
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<DerivedA>(), nullptr, "Unexpected DerivedA");
+    }
+
+    //
+    // Look up more types than the cache holds, twice, and check each
+    // result against the TypeId hierarchy.
+    //
+    std::vector<Ptr<Object>> found(TypeId::GetRegisteredN());
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (uint16_t i = 0; i < TypeId::GetRegisteredN(); ++i)
+        {
+            TypeId tid = TypeId::GetRegistered(i);
+            if (tid == Object::GetTypeId() || tid == ObjectBase::GetTypeId())
+            {
+                // Any of the aggregates, or none of them
+                continue;
+            }
+            Ptr<Object> object = baseA->GetObject<Object>(tid);
+            Ptr<Object> expected;
+            if (tid == BaseA::GetTypeId() || BaseA::GetTypeId().IsChildOf(tid))
+            {
+                expected = baseA;
+            }
+            else if (tid == DerivedB::GetTypeId() || DerivedB::GetTypeId().IsChildOf(tid))
+            {
+                expected = derivedB;
+            }
+            NS_TEST_ASSERT_MSG_EQ(object, expected, "Wrong aggregate for " << tid.GetName());
+            if (pass == 0)
+            {
+                found[i] = object;
+            }
+            else
+            {
+                NS_TEST_ASSERT_MSG_EQ(object, found[i], "Lookup changed for " << tid.GetName());
+            }
+        }
+    }
+}
+
 /**
  * \ingroup object-tests
  * Test an Object factory can create Objects
@@ -565,6 +645,7 @@ ObjectTestSuite::ObjectTestSuite()
 {
     AddTestCase(new CreateObjectTestCase);
     AddTestCase(new AggregateObjectTestCase);
+    AddTestCase(new CachedGetObjectTestCase);
     AddTestCase(new ObjectFactoryTestCase);
 }
 
@@ -32,6 +32,7 @@
 #include <cmath>
 #include <ctime>
 #include <fstream>
+#include <map>
 #include <gsl/gsl_cdf.h>
 #include <gsl/gsl_histogram.h>
 #include <gsl/gsl_randist.h>
@@ -2532,6 +2533,108 @@ EmpiricalAntitheticTestCase::DoRun()
                               "Wrong mean value.");
 }
 
+/**
+ * \ingroup rng-tests
+ * Test case for the lookups of the empirical distribution random variable
+ * stream generator, against a search of the CDF.
+ */
+class EmpiricalLookupTestCase : public TestCaseBase
+{
+  public:
+    // Constructor
+    EmpiricalLookupTestCase();
+
+  private:
+    // Inherited
+    void DoRun() override;
+
+    /**
+     * Draw values from an empirical distribution and compare them with a
+     * search of its CDF, for the same uniform variates.
+     * \param [in] cdf The CDF, from probabilities to values.
+     * \param [in] interpolate Whether to interpolate.
+     */
+    void Check(const std::map<double, double>& cdf, bool interpolate);
+};
+
+EmpiricalLookupTestCase::EmpiricalLookupTestCase()
+    : TestCaseBase("Empirical Random Variable lookups")
+{
+}
+
+void
+EmpiricalLookupTestCase::Check(const std::map<double, double>& cdf, bool interpolate)
+{
+    Ptr<EmpiricalRandomVariable> x = CreateObject<EmpiricalRandomVariable>();
+    x->SetInterpolate(interpolate);
+    for (const auto& [c, v] : cdf)
+    {
+        x->CDF(v, c);
+    }
+    // Same stream, so the uniform variates of x are the values of u
+    Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable>();
+    x->SetStream(17);
+    u->SetStream(17);
+
+    for (uint32_t i = 0; i < N_MEASUREMENTS; ++i)
+    {
+        double r = u->GetValue();
+        double expected;
+        if (r <= cdf.begin()->first)
+        {
+            expected = cdf.begin()->second;
+        }
+        else if (r >= cdf.rbegin()->first)
+        {
+            expected = cdf.rbegin()->second;
+        }
+        else
+        {
+            auto upper = cdf.upper_bound(r);
+            auto lower = std::prev(upper);
+            expected = upper->second;
+            if (interpolate)
+            {
+                expected = lower->second + ((upper->second - lower->second) /
+                                            (upper->first - lower->first)) *
+                                               (r - lower->first);
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(x->GetValue(), expected, "Wrong value for " << r);
+    }
+}
+
+void
+EmpiricalLookupTestCase::DoRun()
+{
+    NS_LOG_FUNCTION(this);
+    SetTestSuiteSeed();
+
+    // A CDF of many unevenly spaced points, not starting at 0 nor ending at 1
+    std::map<double, double> cdf;
+    for (uint32_t i = 1; i < 10000; ++i)
+    {
+        double c = 0.05 + 0.9 * std::pow(i / 10000.0, 3);
+        cdf[c] = i;
+    }
+    Check(cdf, false);
+    Check(cdf, true);
+
+    // A few points, with exactly representable probabilities
+    cdf = {{0.0, 1}, {0.25, 2}, {0.5, 4}, {0.75, 8}, {1.0, 16}};
+    Check(cdf, false);
+    Check(cdf, true);
+
+    // Points added after values were drawn are taken into account
+    Ptr<EmpiricalRandomVariable> x = CreateObject<EmpiricalRandomVariable>();
+    x->CDF(1.0, 0.0);
+    x->CDF(2.0, 1.0);
+    NS_TEST_ASSERT_MSG_EQ(x->GetValue(), 2.0, "Wrong value before adding a point");
+    x->CDF(3.0, 0.0);
+    x->CDF(3.0, 1.0);
+    NS_TEST_ASSERT_MSG_EQ(x->GetValue(), 3.0, "Points added after drawing values ignored");
+}
+
 /**
  * \ingroup rng-tests
  * Test case for caching of Normal RV parameters (see issue #302)
@@ -2922,6 +3025,7 @@ RandomVariableSuite::RandomVariableSuite()
     AddTestCase(new DeterministicTestCase);
     AddTestCase(new EmpiricalTestCase);
     AddTestCase(new EmpiricalAntitheticTestCase);
+    AddTestCase(new EmpiricalLookupTestCase);
     /// Issue #302:  NormalRandomVariable produces stale values
     AddTestCase(new NormalCachingTestCase);
     AddTestCase(new BernoulliTestCase);
@@ -0,0 +1,190 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/double.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * RandomVariableStream::GetValues() test suite.
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that RandomVariableStream::GetValues() returns the values of
+ * repeated GetValue() calls.
+ */
+class RandomVariableStreamValuesTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] name The name of the random variables.
+     * \param [in] factory The factory of the random variables.
+     * \param [in] antithetic Whether the random variables are antithetic.
+     */
+    RandomVariableStreamValuesTestCase(const std::string& name,
+                                       const ObjectFactory& factory,
+                                       bool antithetic);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Create a random variable.
+     * \returns The random variable.
+     */
+    Ptr<RandomVariableStream> Create() const;
+
+    ObjectFactory m_factory; //!< The factory of the random variables
+    bool m_antithetic;       //!< Whether the random variables are antithetic
+};
+
+RandomVariableStreamValuesTestCase::RandomVariableStreamValuesTestCase(
+    const std::string& name,
+    const ObjectFactory& factory,
+    bool antithetic)
+    : TestCase("Check GetValues() of " + name + (antithetic ? ", antithetic" : "")),
+      m_factory(factory),
+      m_antithetic(antithetic)
+{
+}
+
+Ptr<RandomVariableStream>
+RandomVariableStreamValuesTestCase::Create() const
+{
+    Ptr<RandomVariableStream> rv = m_factory.Create<RandomVariableStream>();
+    rv->SetStream(42);
+    rv->SetAntithetic(m_antithetic);
+    return rv;
+}
+
+void
+RandomVariableStreamValuesTestCase::DoRun()
+{
+    Ptr<RandomVariableStream> single = Create();
+    Ptr<RandomVariableStream> bulk = Create();
+
+    // Interleave bulk and single draws, so that the stream and the cached
+    // values are left as GetValue() would leave them
+    const std::vector<std::size_t> sizes = {1, 2, 3, 7, 64, 65, 200, 0, 1, 1000};
+    std::size_t count = 0;
+    for (auto size : sizes)
+    {
+        std::vector<double> values(size);
+        bulk->GetValues(values);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            double expected = single->GetValue();
+            NS_TEST_ASSERT_MSG_EQ(values[i], expected, "Wrong value " << count + i);
+        }
+        count += size;
+        NS_TEST_ASSERT_MSG_EQ(bulk->GetValue(), single->GetValue(), "Wrong value after bulk");
+    }
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RandomVariableStream::GetValues() test suite.
+ */
+class RandomVariableStreamValuesTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    RandomVariableStreamValuesTestSuite();
+
+  private:
+    /**
+     * Add the test cases of a random variable.
+     * \param [in] name The name of the random variables.
+     * \param [in] factory The factory of the random variables.
+     */
+    void AddTestCases(const std::string& name, const ObjectFactory& factory);
+};
+
+RandomVariableStreamValuesTestSuite::RandomVariableStreamValuesTestSuite()
+    : TestSuite("random-variable-stream-values")
+{
+    AddTestCases("a uniform distribution",
+                 ObjectFactory("ns3::UniformRandomVariable",
+                               "Min",
+                               DoubleValue(-3),
+                               "Max",
+                               DoubleValue(5)));
+    AddTestCases("an exponential distribution",
+                 ObjectFactory("ns3::ExponentialRandomVariable", "Mean", DoubleValue(2)));
+    AddTestCases("a bounded exponential distribution",
+                 ObjectFactory("ns3::ExponentialRandomVariable",
+                               "Mean",
+                               DoubleValue(2),
+                               "Bound",
+                               DoubleValue(1.5)));
+    AddTestCases("a Pareto distribution",
+                 ObjectFactory("ns3::ParetoRandomVariable", "Shape", DoubleValue(1.5)));
+    AddTestCases("a bounded Pareto distribution",
+                 ObjectFactory("ns3::ParetoRandomVariable",
+                               "Shape",
+                               DoubleValue(1.5),
+                               "Bound",
+                               DoubleValue(2)));
+    AddTestCases("a normal distribution",
+                 ObjectFactory("ns3::NormalRandomVariable",
+                               "Mean",
+                               DoubleValue(1),
+                               "Variance",
+                               DoubleValue(4)));
+    AddTestCases("a bounded normal distribution",
+                 ObjectFactory("ns3::NormalRandomVariable",
+                               "Mean",
+                               DoubleValue(1),
+                               "Variance",
+                               DoubleValue(4),
+                               "Bound",
+                               DoubleValue(1)));
+    // Uses the default implementation
+    AddTestCases("a Weibull distribution", ObjectFactory("ns3::WeibullRandomVariable"));
+}
+
+void
+RandomVariableStreamValuesTestSuite::AddTestCases(const std::string& name,
+                                                  const ObjectFactory& factory)
+{
+    AddTestCase(new RandomVariableStreamValuesTestCase(name, factory, false));
+    AddTestCase(new RandomVariableStreamValuesTestCase(name, factory, true));
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RandomVariableStreamValuesTestSuite instance variable.
+ */
+static RandomVariableStreamValuesTestSuite g_randomVariableStreamValuesTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
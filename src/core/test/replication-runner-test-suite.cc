@@ -0,0 +1,211 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/replication-runner.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+/**
+ * \file
+ * \ingroup replication-tests
+ * ReplicationRunner test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup replication-tests ReplicationRunner tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup replication-tests
+ *
+ * \brief Check that the replications draw the numbers of their run, and
+ * that their metrics are collected.
+ *
+ * The random variables are created, and draw a few numbers, before the
+ * fork; each replication then records the numbers it draws, which are
+ * compared with those drawn by fresh random variables of the same run.
+ * One replication exits without calling Finish().
+ */
+class ReplicationRunnerTestCase : public TestCase
+{
+  public:
+    ReplicationRunnerTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Create the random variables. */
+    void CreateVariables();
+
+    /** The number of replications. */
+    static constexpr uint32_t REPLICATIONS = 4;
+    /** The replication which does not finish. */
+    static constexpr uint32_t FAILING_REPLICATION = 2;
+    /** The run number of the first replication. */
+    static constexpr uint64_t FIRST_RUN = 10;
+    /** The number of values drawn from each variable by a replication. */
+    static constexpr uint32_t DRAWS = 5;
+
+    Ptr<UniformRandomVariable> m_uniform; //!< A uniform random variable.
+    Ptr<NormalRandomVariable> m_normal;   //!< A normal random variable, which caches values.
+};
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase()
+    : TestCase("Check the metrics of independent replications")
+{
+}
+
+void
+ReplicationRunnerTestCase::CreateVariables()
+{
+    m_uniform = CreateObject<UniformRandomVariable>();
+    m_uniform->SetStream(1);
+    m_normal = CreateObject<NormalRandomVariable>();
+    m_normal->SetStream(2);
+}
+
+void
+ReplicationRunnerTestCase::DoRun()
+{
+    Simulator::Destroy();
+    uint64_t originalRun = RngSeedManager::GetRun();
+
+    // The setup draws numbers, and leaves a value cached in the normal
+    // variable
+    CreateVariables();
+    m_uniform->GetValue();
+    m_normal->GetValue();
+
+    ReplicationRunner runner(REPLICATIONS, 2);
+    runner.SetFirstRun(FIRST_RUN);
+    if (runner.Fork())
+    {
+        // A replication: record the draws and leave without going back
+        // to the test framework of the original process
+        for (uint32_t i = 0; i < DRAWS; ++i)
+        {
+            runner.Record("uniform", m_uniform->GetValue());
+            runner.Record("normal", m_normal->GetValue());
+        }
+        runner.Record("run", runner.GetRun());
+        if (runner.GetRun() != FIRST_RUN + FAILING_REPLICATION)
+        {
+            runner.Finish();
+        }
+        std::_Exit(0);
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(RngSeedManager::GetRun(), originalRun, "Run changed in the original");
+    NS_TEST_EXPECT_MSG_EQ(runner.GetRun(), originalRun, "Wrong run of the original");
+    NS_TEST_EXPECT_MSG_EQ(runner.GetFailedReplications(), 1, "Wrong failed replications");
+
+    std::vector<double> uniform = runner.GetValues("uniform");
+    std::vector<double> normal = runner.GetValues("normal");
+    std::vector<double> runs = runner.GetValues("run");
+    NS_TEST_ASSERT_MSG_EQ(uniform.size(), (REPLICATIONS - 1) * DRAWS, "Wrong number of values");
+    NS_TEST_ASSERT_MSG_EQ(normal.size(), (REPLICATIONS - 1) * DRAWS, "Wrong number of values");
+    NS_TEST_ASSERT_MSG_EQ(runs.size(), REPLICATIONS - 1, "Wrong number of runs");
+
+    uint32_t index = 0;
+    for (uint32_t replication = 0; replication < REPLICATIONS; ++replication)
+    {
+        if (replication == FAILING_REPLICATION)
+        {
+            continue;
+        }
+        uint64_t run = FIRST_RUN + replication;
+        NS_TEST_EXPECT_MSG_EQ(runs[index / DRAWS], run, "Replications out of order");
+        RngSeedManager::SetRun(run);
+        CreateVariables();
+        for (uint32_t i = 0; i < DRAWS; ++i, ++index)
+        {
+            NS_TEST_EXPECT_MSG_EQ(uniform[index], m_uniform->GetValue(), "Run " << run);
+            NS_TEST_EXPECT_MSG_EQ(normal[index], m_normal->GetValue(), "Run " << run);
+        }
+    }
+    RngSeedManager::SetRun(originalRun);
+
+    auto summaries = runner.GetSummaries();
+    NS_TEST_ASSERT_MSG_EQ(summaries.size(), 3, "Wrong number of metrics");
+    const auto& summary = summaries["uniform"];
+    double sum = 0;
+    for (auto value : uniform)
+    {
+        sum += value;
+    }
+    NS_TEST_EXPECT_MSG_EQ(summary.count, uniform.size(), "Wrong count");
+    NS_TEST_EXPECT_MSG_EQ_TOL(summary.mean, sum / uniform.size(), 1e-12, "Wrong mean");
+    NS_TEST_EXPECT_MSG_EQ(summary.min, *std::min_element(uniform.begin(), uniform.end()), "");
+    NS_TEST_EXPECT_MSG_EQ(summary.max, *std::max_element(uniform.begin(), uniform.end()), "");
+
+    // Known values: mean 5, sample variance 32 / 7
+    ReplicationRunner known(1);
+    for (double value : {2, 4, 4, 4, 5, 5, 7, 9})
+    {
+        known.Record("x", value);
+    }
+    auto x = known.GetSummaries()["x"];
+    NS_TEST_EXPECT_MSG_EQ(x.count, 8, "Wrong count");
+    NS_TEST_EXPECT_MSG_EQ_TOL(x.mean, 5, 1e-12, "Wrong mean");
+    NS_TEST_EXPECT_MSG_EQ_TOL(x.stddev, std::sqrt(32.0 / 7), 1e-12, "Wrong stddev");
+    // The Student t quantile for 7 degrees of freedom
+    NS_TEST_EXPECT_MSG_EQ_TOL(x.error95, 2.365 * std::sqrt(32.0 / 7) / std::sqrt(8), 1e-12, "");
+    NS_TEST_EXPECT_MSG_EQ(x.min, 2, "Wrong min");
+    NS_TEST_EXPECT_MSG_EQ(x.max, 9, "Wrong max");
+
+    // Five replications: mean 3, sample variance 2.5, 4 degrees of freedom
+    ReplicationRunner five(1);
+    for (double value : {1, 2, 3, 4, 5})
+    {
+        five.Record("y", value);
+    }
+    auto y = five.GetSummaries()["y"];
+    NS_TEST_EXPECT_MSG_EQ_TOL(y.error95, 2.776 * std::sqrt(2.5) / std::sqrt(5), 1e-12, "");
+
+    m_uniform = nullptr;
+    m_normal = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup replication-tests
+ *
+ * \brief ReplicationRunner test suite.
+ */
+class ReplicationRunnerTestSuite : public TestSuite
+{
+  public:
+    ReplicationRunnerTestSuite();
+};
+
+ReplicationRunnerTestSuite::ReplicationRunnerTestSuite()
+    : TestSuite("replication-runner")
+{
+#ifndef __WIN32__
+    AddTestCase(new ReplicationRunnerTestCase(), TestCase::QUICK);
+#endif
+}
+
+/// Static variable for test initialization.
+static ReplicationRunnerTestSuite g_replicationRunnerTestSuite;
@@ -0,0 +1,191 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulation-checkpoint.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cstdlib>
+#include <fstream>
+
+/**
+ * \file
+ * \ingroup checkpoint-tests
+ * SimulationCheckpoint test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup checkpoint-tests SimulationCheckpoint tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup checkpoint-tests
+ *
+ * \brief Check that the variants forked from a checkpoint behave as
+ * simulations which changed the same parameter at the same time.
+ *
+ * An event draws a random number every millisecond and accumulates it,
+ * multiplied by a factor.  The simulation is forked after 50 ms into
+ * variants which each set a different factor; the result of each
+ * variant is compared with an uninterrupted simulation which sets the
+ * same factor after 50 ms.
+ */
+class SimulationCheckpointTestCase : public TestCase
+{
+  public:
+    SimulationCheckpointTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Draw a random number and schedule the next draw. */
+    void Tick();
+    /**
+     * Set the factor.
+     * \param [in] variant The variant number.
+     */
+    void SetFactor(uint32_t variant);
+    /**
+     * Run the scenario.
+     * \param [in] fork \c true to fork the variants, \c false to run
+     *             \p variant without checkpoint.
+     * \param [in] variant The variant to run without checkpoint.
+     */
+    void RunScenario(bool fork, uint32_t variant);
+
+    /** The number of variants. */
+    static constexpr uint32_t VARIANTS = 4;
+    /** The variant which exits with an error. */
+    static constexpr uint32_t FAILING_VARIANT = 3;
+
+    Ptr<UniformRandomVariable> m_rng; //!< The random stream.
+    uint64_t m_factor;                //!< The current factor.
+    uint64_t m_sum;                   //!< Sum of the draws times the factor.
+    uint32_t m_ticks;                 //!< Number of draws.
+};
+
+SimulationCheckpointTestCase::SimulationCheckpointTestCase()
+    : TestCase("Check variants forked from a checkpoint")
+{
+}
+
+void
+SimulationCheckpointTestCase::Tick()
+{
+    m_sum += m_factor * m_rng->GetInteger(0, 1000);
+    m_ticks++;
+    Simulator::Schedule(MilliSeconds(1), &SimulationCheckpointTestCase::Tick, this);
+}
+
+void
+SimulationCheckpointTestCase::SetFactor(uint32_t variant)
+{
+    m_factor = variant + 2;
+}
+
+void
+SimulationCheckpointTestCase::RunScenario(bool fork, uint32_t variant)
+{
+    m_rng = CreateObject<UniformRandomVariable>();
+    m_rng->SetStream(1);
+    m_factor = 1;
+    m_sum = 0;
+    m_ticks = 0;
+    Simulator::Schedule(Seconds(0), &SimulationCheckpointTestCase::Tick, this);
+    if (fork)
+    {
+        SimulationCheckpoint::ScheduleFork(
+            MilliSeconds(50),
+            VARIANTS,
+            MakeCallback(&SimulationCheckpointTestCase::SetFactor, this),
+            2);
+    }
+    else
+    {
+        Simulator::Schedule(MilliSeconds(50),
+                            &SimulationCheckpointTestCase::SetFactor,
+                            this,
+                            variant);
+    }
+    Simulator::Stop(MilliSeconds(100));
+    Simulator::Run();
+}
+
+void
+SimulationCheckpointTestCase::DoRun()
+{
+    Simulator::Destroy();
+    NS_TEST_ASSERT_MSG_EQ(SimulationCheckpoint::GetVariant(),
+                          SimulationCheckpoint::ORIGINAL,
+                          "Not the original process");
+
+    RunScenario(true, 0);
+    uint32_t variant = SimulationCheckpoint::GetVariant();
+    if (variant != SimulationCheckpoint::ORIGINAL)
+    {
+        // A variant: report the result and leave without going back to
+        // the test framework of the original process
+        std::ofstream os(CreateTempDirFilename("variant-" + std::to_string(variant)));
+        os << Simulator::Now().GetTimeStep() << " " << m_ticks << " " << m_sum << std::endl;
+        os.close();
+        std::_Exit(variant == FAILING_VARIANT ? 1 : 0);
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MilliSeconds(50), "Original not stopped");
+    NS_TEST_EXPECT_MSG_EQ(SimulationCheckpoint::GetFailedVariants(), 1, "Wrong failed variants");
+    Simulator::Destroy();
+
+    for (uint32_t i = 0; i < VARIANTS; ++i)
+    {
+        RunScenario(false, i);
+        Simulator::Destroy();
+
+        std::ifstream is(CreateTempDirFilename("variant-" + std::to_string(i)));
+        NS_TEST_ASSERT_MSG_EQ(is.is_open(), true, "No result for variant " << i);
+        int64_t now;
+        uint32_t ticks;
+        uint64_t sum;
+        is >> now >> ticks >> sum;
+        NS_TEST_EXPECT_MSG_EQ(now, MilliSeconds(100).GetTimeStep(), "Variant " << i);
+        NS_TEST_EXPECT_MSG_EQ(ticks, m_ticks, "Variant " << i);
+        NS_TEST_EXPECT_MSG_EQ(sum, m_sum, "Variant " << i);
+    }
+}
+
+/**
+ * \ingroup checkpoint-tests
+ *
+ * \brief SimulationCheckpoint test suite.
+ */
+class SimulationCheckpointTestSuite : public TestSuite
+{
+  public:
+    SimulationCheckpointTestSuite();
+};
+
+SimulationCheckpointTestSuite::SimulationCheckpointTestSuite()
+    : TestSuite("simulation-checkpoint")
+{
+#ifndef __WIN32__
+    AddTestCase(new SimulationCheckpointTestCase(), TestCase::QUICK);
+#endif
+}
+
+/// Static variable for test initialization.
+static SimulationCheckpointTestSuite g_simulationCheckpointTestSuite;
@@ -16,14 +16,29 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/boolean.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/config.h"
+#include "ns3/event-profiler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
+#include "ns3/make-event.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/realtime-simulator-impl.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -209,6 +224,517 @@ SimulatorEventsTestCase::DoRun()
     Simulator::Destroy();
     NS_TEST_EXPECT_MSG_EQ(m_destroyId.IsExpired(), true, "Event should have expired now");
     NS_TEST_EXPECT_MSG_EQ(m_destroy, true, "Event should have run");
+
+    // Drop the last references to the events, so their memory can be released.
+    m_idC = EventId();
+    m_destroyId = EventId();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the ordering of a Scheduler under a hold-model workload.
+ *
+ * Events are inserted with random delays, including bursts sharing the
+ * same timestamp, and occasionally removed; every RemoveNext() must return
+ * the same event as a reference `std::map`.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check the event ordering of " + schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    auto rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+
+    std::map<Scheduler::EventKey, Ptr<EventImpl>> pending;
+    uint32_t uid = 0;
+    uint64_t now = 0;
+
+    auto insert = [&](uint64_t ts) {
+        Ptr<EventImpl> impl(MakeEvent([]() {}), false);
+        Scheduler::Event ev{PeekPointer(impl), {ts, uid++, 0}};
+        scheduler->Insert(ev);
+        pending.emplace(ev.key, impl);
+    };
+
+    for (uint32_t i = 0; i < 2000; ++i)
+    {
+        insert(rng->GetInteger(0, 1000000));
+    }
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        insert(500000);
+    }
+
+    Scheduler::EventKey last{0, 0, 0};
+    for (uint32_t i = 0; i < 20000 && !pending.empty(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), false, "Scheduler should not be empty");
+        Scheduler::Event next = scheduler->PeekNext();
+        NS_TEST_ASSERT_MSG_EQ(next.key.m_uid, pending.begin()->first.m_uid, "Wrong event peeked");
+        next = scheduler->RemoveNext();
+        NS_TEST_ASSERT_MSG_EQ(next.key.m_uid, pending.begin()->first.m_uid, "Wrong event removed");
+        NS_TEST_ASSERT_MSG_EQ((i == 0 || last < next.key), true, "Events out of order");
+        pending.erase(pending.begin());
+        last = next.key;
+        now = next.key.m_ts;
+
+        uint32_t action = rng->GetInteger(0, 99);
+        if (action == 0)
+        {
+            // burst of simultaneous events
+            for (uint32_t j = 0; j < 60; ++j)
+            {
+                insert(now + 10);
+            }
+        }
+        else if (action < 10)
+        {
+            auto it = pending.lower_bound({now + rng->GetInteger(0, 1000), 0, 0});
+            if (it != pending.end())
+            {
+                scheduler->Remove({PeekPointer(it->second), it->first});
+                pending.erase(it);
+            }
+        }
+        else if (action < 95)
+        {
+            insert(now + rng->GetInteger(0, 1000));
+        }
+        else
+        {
+            insert(now + rng->GetInteger(0, 10000000));
+        }
+    }
+    std::vector<Scheduler::Event> batch;
+    while (!pending.empty())
+    {
+        batch.clear();
+        scheduler->RemoveNextBatch(batch);
+        uint64_t ts = pending.begin()->first.m_ts;
+        for (const auto& next : batch)
+        {
+            NS_TEST_ASSERT_MSG_EQ(next.key.m_uid,
+                                  pending.begin()->first.m_uid,
+                                  "Wrong event removed in batch");
+            pending.erase(pending.begin());
+        }
+        NS_TEST_ASSERT_MSG_EQ((pending.empty() || pending.begin()->first.m_ts > ts),
+                              true,
+                              "Incomplete batch");
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), true, "Scheduler should be empty");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the events sharing a timestamp, which DefaultSimulatorImpl
+ * runs in batches.
+ *
+ * The events of a batch remove and cancel later events of the same batch,
+ * schedule new events for the same timestamp and stop the simulator in the
+ * middle of the batch.
+ */
+class SimulatorBatchTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SimulatorBatchTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    /**
+     * An event of the batch.
+     * \param [in] id The event id.
+     */
+    void Handle(uint32_t id);
+
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+    std::vector<EventId> m_ids;       //!< The EventIds of the batch.
+    std::vector<uint32_t> m_run;      //!< The ids of the events run.
+};
+
+SimulatorBatchTestCase::SimulatorBatchTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check simultaneous events with " + schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SimulatorBatchTestCase::Handle(uint32_t id)
+{
+    m_run.push_back(id);
+    switch (id)
+    {
+    case 5:
+        Simulator::Remove(m_ids[20]);
+        Simulator::Cancel(m_ids[21]);
+        break;
+    case 10:
+        Simulator::ScheduleNow(&SimulatorBatchTestCase::Handle, this, 100);
+        break;
+    case 30:
+        NS_TEST_EXPECT_MSG_EQ(Simulator::IsExpired(m_ids[31]), false, "Event expired too soon");
+        Simulator::Stop();
+        break;
+    }
+}
+
+void
+SimulatorBatchTestCase::DoRun()
+{
+    Simulator::SetScheduler(m_schedulerFactory);
+    m_ids.clear();
+    m_run.clear();
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        m_ids.push_back(
+            Simulator::Schedule(MicroSeconds(1), &SimulatorBatchTestCase::Handle, this, i));
+        Simulator::Schedule(MicroSeconds(2), &SimulatorBatchTestCase::Handle, this, 200 + i);
+    }
+
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i <= 30; ++i)
+    {
+        if (i != 20 && i != 21)
+        {
+            expected.push_back(i);
+        }
+    }
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MicroSeconds(1), "Stopped at the wrong time");
+    NS_TEST_ASSERT_MSG_EQ(m_run.size(), expected.size(), "Wrong events before Stop");
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_run[i], expected[i], "Wrong order before Stop");
+    }
+    NS_TEST_EXPECT_MSG_EQ(Simulator::IsExpired(m_ids[31]), false, "Pending event expired");
+
+    for (uint32_t i = 31; i < 50; ++i)
+    {
+        expected.push_back(i);
+    }
+    expected.push_back(100);
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        expected.push_back(200 + i);
+    }
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_run.size(), expected.size(), "Wrong events");
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_run[i], expected[i], "Wrong order");
+    }
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MicroSeconds(2), "Wrong end time");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the EventImpl memory pool with events of various sizes.
+ */
+class SimulatorEventMemoryTestCase : public TestCase
+{
+  public:
+    SimulatorEventMemoryTestCase();
+    void DoRun() override;
+
+  private:
+    uint64_t m_sum; //!< Sum of the values received by the events.
+};
+
+SimulatorEventMemoryTestCase::SimulatorEventMemoryTestCase()
+    : TestCase("Check the event memory pool")
+{
+}
+
+void
+SimulatorEventMemoryTestCase::DoRun()
+{
+    /** An over-aligned event argument. */
+    struct alignas(64) Aligned
+    {
+        uint64_t value; //!< The value.
+    };
+
+    m_sum = 0;
+    uint64_t one = 1;
+    std::array<uint64_t, 64> large{};
+    large.fill(1);
+    Aligned aligned{1};
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        Simulator::Schedule(NanoSeconds(i), [this]() { ++m_sum; });
+        Simulator::Schedule(NanoSeconds(i), [this, one]() { m_sum += one; });
+        Simulator::Schedule(NanoSeconds(i), [this, large]() { m_sum += large[63]; });
+        Simulator::Schedule(NanoSeconds(i), [this, aligned]() {
+            NS_TEST_EXPECT_MSG_EQ(reinterpret_cast<uintptr_t>(&aligned) % 64,
+                                  0,
+                                  "Over-aligned event is misaligned");
+            m_sum += aligned.value;
+        });
+    }
+    EventId cancelled = Simulator::Schedule(Seconds(1), [this]() { m_sum += 1000000; });
+    Simulator::Cancel(cancelled);
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_sum, 4000, "Wrong number of events executed");
+
+    auto stats = EventImpl::GetMemoryPoolStats();
+    NS_TEST_EXPECT_MSG_LT(stats.heapAllocations, stats.events, "Events not served from the pool");
+
+    // The cancelled event is still referenced, so the pool is kept.
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_GT(EventImpl::GetMemoryPoolStats().bytes, 0, "Pool released too early");
+    cancelled = EventId();
+    NS_TEST_EXPECT_MSG_EQ(EventImpl::GetMemoryPoolStats().bytes, 0, "Pool not released");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the event profiler of DefaultSimulatorImpl.
+ */
+class SimulatorEventProfilerTestCase : public TestCase
+{
+  public:
+    SimulatorEventProfilerTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * An event which runs for some wall-clock time.
+     * \param [in] us The duration, in microseconds.
+     */
+    void Busy(uint32_t us);
+    /** An event which does nothing. */
+    static void Idle();
+};
+
+SimulatorEventProfilerTestCase::SimulatorEventProfilerTestCase()
+    : TestCase("Check the event profiler")
+{
+}
+
+void
+SimulatorEventProfilerTestCase::Busy(uint32_t us)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < end)
+    {
+    }
+}
+
+void
+SimulatorEventProfilerTestCase::Idle()
+{
+}
+
+void
+SimulatorEventProfilerTestCase::DoRun()
+{
+    EventProfiler::Stats stats;
+    for (uint64_t ns = 1; ns <= 1000; ++ns)
+    {
+        stats.Add(ns);
+    }
+    NS_TEST_EXPECT_MSG_EQ(stats.GetCount(), 1000, "Wrong count");
+    NS_TEST_EXPECT_MSG_EQ(stats.GetTotal(), 500500, "Wrong total");
+    NS_TEST_EXPECT_MSG_EQ(stats.GetMax(), 1000, "Wrong maximum");
+    NS_TEST_EXPECT_MSG_EQ(stats.GetPercentile(0), 1, "Wrong minimum");
+    NS_TEST_EXPECT_MSG_EQ(stats.GetPercentile(100), 1000, "Wrong maximum percentile");
+    NS_TEST_EXPECT_MSG_EQ_TOL(stats.GetPercentile(50), 500, 500 / 16, "Wrong median");
+    NS_TEST_EXPECT_MSG_EQ_TOL(stats.GetPercentile(99), 990, 990 / 16, "Wrong 99th percentile");
+    uint64_t binned = 0;
+    uint64_t previous = 0;
+    for (const auto& [low, count] : stats.GetHistogram())
+    {
+        NS_TEST_EXPECT_MSG_GT(low, previous, "Bins out of order");
+        binned += count;
+        previous = low;
+    }
+    NS_TEST_EXPECT_MSG_EQ(binned, 1000, "Wrong histogram count");
+    NS_TEST_EXPECT_MSG_EQ(stats.GetHistogram().front().first, 1, "Wrong first bin");
+    NS_TEST_EXPECT_MSG_EQ(stats.GetHistogram().back().first, 960, "Wrong last bin");
+
+    EventImpl* event = MakeEvent(&SimulatorEventProfilerTestCase::Busy, this, 0);
+    NS_TEST_EXPECT_MSG_EQ(EventProfiler::GetFunctionName(typeid(*event)),
+                          "void (SimulatorEventProfilerTestCase::*)(unsigned int)",
+                          "Wrong function name");
+    event->Unref();
+
+    std::string file = CreateTempDirFilename("event-profile.txt");
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfiling", BooleanValue(true));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfilingFile", StringValue(file));
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        Simulator::ScheduleWithContext(7,
+                                       MicroSeconds(i),
+                                       &SimulatorEventProfilerTestCase::Busy,
+                                       this,
+                                       100);
+    }
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        Simulator::Schedule(MicroSeconds(i), &SimulatorEventProfilerTestCase::Idle);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfiling", BooleanValue(false));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfilingFile", StringValue(""));
+
+    std::ifstream is(file);
+    NS_TEST_ASSERT_MSG_EQ(is.is_open(), true, "No profile written");
+    std::string line;
+    std::getline(is, line);
+    NS_TEST_EXPECT_MSG_EQ(line.find("Event profile: 110 events"), 0, "Wrong header " << line);
+
+    // The first function and the first context are the busy ones
+    std::string section;
+    std::map<std::string, std::string> first;
+    while (std::getline(is, line))
+    {
+        if (line.find("By ") == 0)
+        {
+            section = line;
+            std::getline(is, line); // column titles
+            std::getline(is, line);
+            first[section] = line;
+        }
+    }
+    NS_TEST_EXPECT_MSG_NE(first["By function:"].find(
+                              "void (SimulatorEventProfilerTestCase::*)(unsigned int)"),
+                          std::string::npos,
+                          "Wrong slowest function " << first["By function:"]);
+    std::istringstream iss(first["By context:"]);
+    double total;
+    std::string share;
+    uint64_t count;
+    std::string context;
+    iss >> total >> share >> count;
+    while (iss >> context)
+    {
+    }
+    NS_TEST_EXPECT_MSG_EQ(count, 10, "Wrong count of the slowest context");
+    NS_TEST_EXPECT_MSG_EQ(context, "7", "Wrong slowest context");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(total, 1.0, "Busy events too short");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the batches and the lateness statistics of
+ * RealtimeSimulatorImpl.
+ *
+ * The events run at most one quantum ahead of real time, and all of them
+ * are accounted for by the statistics.  How many events share a batch
+ * depends on the load of the machine, so it is not checked.
+ */
+class RealtimeBatchTestCase : public TestCase
+{
+  public:
+    RealtimeBatchTestCase();
+    void DoRun() override;
+
+  private:
+    /** Record how the event runs with respect to real time. */
+    void Check();
+
+    uint32_t m_events{0}; //!< Number of events run.
+    Time m_maxAhead;      //!< The largest advance of an event on real time.
+};
+
+RealtimeBatchTestCase::RealtimeBatchTestCase()
+    : TestCase("Check the batches of the realtime simulator")
+{
+}
+
+void
+RealtimeBatchTestCase::Check()
+{
+    auto impl = DynamicCast<RealtimeSimulatorImpl>(Simulator::GetImplementation());
+    m_maxAhead = Max(m_maxAhead, Simulator::Now() - impl->RealtimeNow());
+    m_events++;
+}
+
+void
+RealtimeBatchTestCase::DoRun()
+{
+    std::string file = CreateTempDirFilename("lateness.txt");
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::RealtimeSimulatorImpl"));
+    Config::SetDefault("ns3::RealtimeSimulatorImpl::BatchQuantum", TimeValue(MilliSeconds(50)));
+    // A loaded machine may run late: do not abort then
+    Config::SetDefault("ns3::RealtimeSimulatorImpl::SynchronizationMode",
+                       StringValue("BestEffort"));
+    Config::SetDefault("ns3::RealtimeSimulatorImpl::LatenessStatistics", BooleanValue(true));
+    Config::SetDefault("ns3::RealtimeSimulatorImpl::LatenessStatisticsFile", StringValue(file));
+    Config::SetDefault("ns3::WallClockSynchronizer::SpinThreshold", TimeValue(MicroSeconds(200)));
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        Simulator::Schedule(MicroSeconds(400 * i), &RealtimeBatchTestCase::Check, this);
+    }
+    Simulator::Schedule(MilliSeconds(100), &RealtimeBatchTestCase::Check, this);
+    // The realtime simulator waits for external events until it is stopped
+    Simulator::Stop(MilliSeconds(101));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_events, 101, "Wrong number of events");
+    // Allow for the granularity of the clock at the end of the waits
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(m_maxAhead,
+                                MilliSeconds(51),
+                                "An event ran more than a quantum ahead of real time");
+
+    auto impl = DynamicCast<RealtimeSimulatorImpl>(Simulator::GetImplementation());
+    NS_TEST_ASSERT_MSG_NE(impl, nullptr, "Not a realtime simulator");
+    // The stop event is accounted for too
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLatenessStats().GetCount(), 102, "Wrong lateness count");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetJitterStats().GetCount(), 101, "Wrong jitter count");
+    std::ostringstream os;
+    impl->PrintLatenessStats(os);
+    NS_TEST_EXPECT_MSG_EQ(os.str().find("Realtime lateness: 102 events"), 0, "Wrong report");
+
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    Config::SetDefault("ns3::RealtimeSimulatorImpl::BatchQuantum", TimeValue(Seconds(0)));
+    Config::SetDefault("ns3::RealtimeSimulatorImpl::LatenessStatistics", BooleanValue(false));
+    Config::SetDefault("ns3::RealtimeSimulatorImpl::LatenessStatisticsFile", StringValue(""));
+    Config::SetDefault("ns3::WallClockSynchronizer::SpinThreshold", TimeValue(Seconds(0)));
+
+    std::ifstream is(file);
+    NS_TEST_ASSERT_MSG_EQ(is.is_open(), true, "No statistics written");
+    std::string line;
+    std::getline(is, line);
+    NS_TEST_EXPECT_MSG_EQ(line, "Realtime lateness: 102 events", "Wrong header");
 }
 
 /**
@@ -730,6 +1256,32 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+
+        AddTestCase(new SimulatorEventMemoryTestCase(), TestCase::QUICK);
+        AddTestCase(new SimulatorEventProfilerTestCase(), TestCase::QUICK);
+        AddTestCase(new RealtimeBatchTestCase(), TestCase::QUICK);
+
+        for (const auto& tid : {MapScheduler::GetTypeId(),
+                                HeapScheduler::GetTypeId(),
+                                CalendarScheduler::GetTypeId(),
+                                PriorityQueueScheduler::GetTypeId(),
+                                LadderScheduler::GetTypeId()})
+        {
+            factory.SetTypeId(tid);
+            AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        }
+        for (const auto& tid : {ListScheduler::GetTypeId(),
+                                MapScheduler::GetTypeId(),
+                                HeapScheduler::GetTypeId(),
+                                CalendarScheduler::GetTypeId(),
+                                PriorityQueueScheduler::GetTypeId(),
+                                LadderScheduler::GetTypeId()})
+        {
+            factory.SetTypeId(tid);
+            AddTestCase(new SimulatorBatchTestCase(factory), TestCase::QUICK);
+        }
     }
 };
 
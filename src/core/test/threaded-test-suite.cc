@@ -20,6 +20,7 @@
 #include "ns3/config.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/list-scheduler.h"
+#include "ns3/log.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
@@ -27,12 +28,16 @@
 
 #include <chrono> // seconds, milliseconds
 #include <ctime>
+#include <atomic>
 #include <list>
 #include <thread> // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
+NS_LOG_COMPONENT_DEFINE("ThreadedTestSuite");
+
 /// Maximum number of threads.
 constexpr int MAXTHREADS = 64;
 
@@ -278,6 +283,161 @@ ThreadedSimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Stress the injection of events from several threads.
+ *
+ * Several producer threads call Simulator::ScheduleWithContext() as fast
+ * as they can while the simulation runs.  Check that every event is
+ * delivered once, with its context, and that the events of each producer
+ * are delivered in order.  The injection throughput is logged.
+ */
+class ThreadedSimulatorInjectionTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param simulatorType The simulator type.
+     * \param threads The number of producer threads.
+     * \param events The number of events scheduled by each producer.
+     */
+    ThreadedSimulatorInjectionTestCase(const std::string& simulatorType,
+                                       unsigned int threads,
+                                       uint32_t events);
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Body of the producer threads.
+     * \param threadno The thread number.
+     */
+    void Produce(unsigned int threadno);
+    /**
+     * Receive an event from a producer.
+     * \param threadno The producer thread number.
+     * \param seq The sequence number of the event.
+     */
+    void Receive(unsigned int threadno, uint32_t seq);
+    /** Stop the simulation once all events have been received. */
+    void Poll();
+
+    std::string m_simulatorType;     //!< Simulator type.
+    unsigned int m_threads;          //!< The number of producer threads.
+    uint32_t m_events;               //!< The number of events of each producer.
+    std::vector<uint32_t> m_next;    //!< Next expected sequence number of each producer.
+    uint64_t m_received;             //!< Total number of events received.
+    std::atomic<bool> m_go;          //!< Start flag of the producers.
+    std::string m_error;             //!< Error condition.
+    std::vector<std::thread> m_pool; //!< The producer threads.
+};
+
+ThreadedSimulatorInjectionTestCase::ThreadedSimulatorInjectionTestCase(
+    const std::string& simulatorType,
+    unsigned int threads,
+    uint32_t events)
+    : TestCase("Check injection of " + std::to_string(events) + " events from each of " +
+               std::to_string(threads) + " threads in " + simulatorType),
+      m_simulatorType(simulatorType),
+      m_threads(threads),
+      m_events(events)
+{
+}
+
+void
+ThreadedSimulatorInjectionTestCase::Produce(unsigned int threadno)
+{
+    while (!m_go)
+    {
+        std::this_thread::yield();
+    }
+    for (uint32_t seq = 0; seq < m_events; ++seq)
+    {
+        Simulator::ScheduleWithContext(threadno,
+                                       Time(0),
+                                       &ThreadedSimulatorInjectionTestCase::Receive,
+                                       this,
+                                       threadno,
+                                       seq);
+    }
+}
+
+void
+ThreadedSimulatorInjectionTestCase::Receive(unsigned int threadno, uint32_t seq)
+{
+    if (Simulator::GetContext() != threadno)
+    {
+        m_error = "Bad context";
+    }
+    if (m_next[threadno] != seq)
+    {
+        m_error = "Out of order event from thread " + std::to_string(threadno);
+    }
+    m_next[threadno] = seq + 1;
+    ++m_received;
+}
+
+void
+ThreadedSimulatorInjectionTestCase::Poll()
+{
+    if (m_received == static_cast<uint64_t>(m_threads) * m_events)
+    {
+        Simulator::Stop();
+        return;
+    }
+    Simulator::Schedule(MicroSeconds(1), &ThreadedSimulatorInjectionTestCase::Poll, this);
+}
+
+void
+ThreadedSimulatorInjectionTestCase::DoSetup()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(m_simulatorType));
+    m_next.assign(m_threads, 0);
+    m_received = 0;
+    m_go = false;
+    m_error = "";
+}
+
+void
+ThreadedSimulatorInjectionTestCase::DoTeardown()
+{
+    m_pool.clear();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+void
+ThreadedSimulatorInjectionTestCase::DoRun()
+{
+    Simulator::Schedule(MicroSeconds(1), &ThreadedSimulatorInjectionTestCase::Poll, this);
+    for (unsigned int i = 0; i < m_threads; ++i)
+    {
+        m_pool.emplace_back(&ThreadedSimulatorInjectionTestCase::Produce, this, i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    m_go = true;
+    Simulator::Run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    for (auto& thread : m_pool)
+    {
+        thread.join();
+    }
+    Simulator::Destroy();
+
+    NS_LOG_INFO(m_simulatorType << ", " << m_threads << " threads: " << m_received
+                                << " events in " << elapsed.count() << " s, "
+                                << m_received / elapsed.count() << " events/s");
+
+    NS_TEST_EXPECT_MSG_EQ(m_error.empty(), true, m_error);
+    NS_TEST_EXPECT_MSG_EQ(m_received,
+                          static_cast<uint64_t>(m_threads) * m_events,
+                          "Lost events");
+}
+
 /**
  * \ingroup threaded-tests
  *
@@ -298,6 +458,7 @@ class ThreadedSimulatorTestSuite : public TestSuite
             "ns3::HeapScheduler",
             "ns3::MapScheduler",
             "ns3::CalendarScheduler",
+            "ns3::LadderScheduler",
         };
         unsigned int threadCounts[] = {0, 2, 10, 20};
         ObjectFactory factory;
@@ -315,6 +476,14 @@ class ThreadedSimulatorTestSuite : public TestSuite
                 }
             }
         }
+
+        for (auto& threadCount : {1, 4, 8})
+        {
+            AddTestCase(new ThreadedSimulatorInjectionTestCase("ns3::DefaultSimulatorImpl",
+                                                               threadCount,
+                                                               100000),
+                        TestCase::QUICK);
+        }
     }
 };
 
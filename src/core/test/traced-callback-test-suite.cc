@@ -18,6 +18,8 @@
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
 
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -133,6 +135,111 @@ BasicTracedCallbackTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(m_two, true, "Callback CbTwo not called");
 }
 
+/**
+ * \ingroup tracedcallback-tests
+ *
+ * TracedCallback Test case, check the order in which the Callbacks of a
+ * chain are invoked as they are connected and disconnected.
+ */
+class OrderTracedCallbackTestCase : public TestCase
+{
+  public:
+    OrderTracedCallbackTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Callback recording its identifier.
+     * \param id The identifier of the Callback.
+     * \param value The traced value.
+     */
+    void Record(int id, int value);
+
+    /**
+     * Callback connecting another Callback to the chain.
+     * \param value The traced value.
+     */
+    void ConnectMore(int value);
+
+    TracedCallback<int> m_trace; //!< The TracedCallback under test.
+    std::vector<int> m_calls;    //!< The identifiers of the invoked Callbacks.
+};
+
+OrderTracedCallbackTestCase::OrderTracedCallbackTestCase()
+    : TestCase("Check the order of TracedCallback invocations")
+{
+}
+
+void
+OrderTracedCallbackTestCase::Record(int id, int value)
+{
+    m_calls.push_back(id);
+}
+
+void
+OrderTracedCallbackTestCase::ConnectMore(int value)
+{
+    m_calls.push_back(9);
+    auto cb = MakeCallback(&OrderTracedCallbackTestCase::Record, this).Bind(5);
+    m_trace.ConnectWithoutContext(cb);
+}
+
+void
+OrderTracedCallbackTestCase::DoRun()
+{
+    std::vector<Callback<void, int>> cbs;
+    for (int id = 0; id < 4; ++id)
+    {
+        cbs.push_back(MakeCallback(&OrderTracedCallbackTestCase::Record, this).Bind(id));
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(m_trace.IsEmpty(), true, "TracedCallback not initially empty");
+    m_trace(0);
+    NS_TEST_ASSERT_MSG_EQ(m_calls.empty(), true, "Callback called on an empty chain");
+
+    for (const auto& cb : cbs)
+    {
+        m_trace.ConnectWithoutContext(cb);
+    }
+    NS_TEST_ASSERT_MSG_EQ(m_trace.IsEmpty(), false, "TracedCallback unexpectedly empty");
+    m_trace(0);
+    NS_TEST_ASSERT_MSG_EQ((m_calls == std::vector<int>{0, 1, 2, 3}), true, "Wrong order");
+
+    //
+    // Disconnecting the first Callback keeps the order of the others,
+    // and disconnecting it again does nothing.
+    //
+    m_trace.DisconnectWithoutContext(cbs[0]);
+    m_trace.DisconnectWithoutContext(cbs[0]);
+    m_trace.DisconnectWithoutContext(cbs[2]);
+    m_calls.clear();
+    m_trace(0);
+    NS_TEST_ASSERT_MSG_EQ((m_calls == std::vector<int>{1, 3}), true, "Wrong order");
+
+    //
+    // A Callback connected again goes to the end of the chain.
+    //
+    m_trace.ConnectWithoutContext(cbs[0]);
+    m_calls.clear();
+    m_trace(0);
+    NS_TEST_ASSERT_MSG_EQ((m_calls == std::vector<int>{1, 3, 0}), true, "Wrong order");
+
+    for (const auto& cb : cbs)
+    {
+        m_trace.DisconnectWithoutContext(cb);
+    }
+    NS_TEST_ASSERT_MSG_EQ(m_trace.IsEmpty(), true, "TracedCallback not empty");
+
+    //
+    // A Callback connected while the chain is invoked is invoked as well.
+    //
+    m_trace.ConnectWithoutContext(MakeCallback(&OrderTracedCallbackTestCase::ConnectMore, this));
+    m_calls.clear();
+    m_trace(0);
+    NS_TEST_ASSERT_MSG_EQ((m_calls == std::vector<int>{9, 5}), true, "Wrong order");
+}
+
 /**
  * \ingroup tracedcallback-tests
  *
@@ -148,6 +255,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite()
     : TestSuite("traced-callback", UNIT)
 {
     AddTestCase(new BasicTracedCallbackTestCase, TestCase::QUICK);
+    AddTestCase(new OrderTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite
@@ -0,0 +1,773 @@
+/*
+ * Copyright (c) 2026 PCDN tracker simulation project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <string>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+/** Timestamp used for an empty event queue or an infinite lookahead. */
+static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+thread_local MultithreadedSimulatorImpl::LogicalProcess* MultithreadedSimulatorImpl::g_currentLp =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "The maximum number of threads processing events, "
+                          "0 for the number of hardware threads.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+    m_lps.resize(1);
+    m_partitioned = false;
+    m_lookAhead = NEVER;
+    m_maxThreads = 0;
+    m_stop = false;
+    m_windowEnd = 0;
+    m_nextLp = 0;
+    m_window = 0;
+    m_busyWorkers = 0;
+    m_exitWorkers = false;
+    m_eventsWithContextEmpty = true;
+    m_mainThreadId = std::this_thread::get_id();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    StopWorkers();
+    ProcessRemoteEvents();
+
+    for (auto& lp : m_lps)
+    {
+        while (!lp.events->IsEmpty())
+        {
+            Scheduler::Event next = lp.events->RemoveNext();
+            next.impl->Unref();
+        }
+        lp.events = nullptr;
+    }
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+
+    for (auto& lp : m_lps)
+    {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        if (lp.events)
+        {
+            while (!lp.events->IsEmpty())
+            {
+                Scheduler::Event next = lp.events->RemoveNext();
+                scheduler->Insert(next);
+            }
+        }
+        lp.events = scheduler;
+    }
+}
+
+// All the threads belong to the same system
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+const MultithreadedSimulatorImpl::LogicalProcess&
+MultithreadedSimulatorImpl::CurrentLp() const
+{
+    return g_currentLp != nullptr ? *g_currentLp : m_lps[0];
+}
+
+uint32_t
+MultithreadedSimulatorImpl::LpIndex(uint32_t context) const
+{
+    return context < m_lpOfNode.size() ? m_lpOfNode[context] : 0;
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert(LogicalProcess& lp,
+                                   uint64_t ts,
+                                   uint32_t context,
+                                   EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = lp.uid;
+    lp.uid++;
+    lp.unscheduledEvents++;
+    lp.events->Insert(ev);
+    return ev.key;
+}
+
+void
+MultithreadedSimulatorImpl::Partition()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Union-find over the node ids: every channel but the point-to-point
+    // channels with a positive delay joins the nodes it connects.
+    uint32_t nNodes = NodeList::GetNNodes();
+    std::vector<uint32_t> parent(nNodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t i) {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    /** A point-to-point link which may separate two LPs. */
+    struct Link
+    {
+        uint32_t a;     //!< Node on one end
+        uint32_t b;     //!< Node on the other end
+        uint64_t delay; //!< Channel delay
+    };
+
+    std::vector<Link> links;
+    for (auto node = NodeList::Begin(); node != NodeList::End(); ++node)
+    {
+        uint32_t id = (*node)->GetId();
+        for (uint32_t i = 0; i < (*node)->GetNDevices(); ++i)
+        {
+            Ptr<NetDevice> device = (*node)->GetDevice(i);
+            Ptr<Channel> channel = device->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+            TimeValue delay;
+            bool cut = device->IsPointToPoint() && channel->GetAttributeFailSafe("Delay", delay) &&
+                       delay.Get().IsStrictlyPositive();
+            for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+            {
+                uint32_t peer = channel->GetDevice(j)->GetNode()->GetId();
+                if (peer == id)
+                {
+                    continue;
+                }
+                if (cut)
+                {
+                    links.push_back({id, peer, static_cast<uint64_t>(delay.Get().GetTimeStep())});
+                }
+                else
+                {
+                    parent[find(peer)] = find(id);
+                }
+            }
+        }
+    }
+
+    m_lookAhead = NEVER;
+    for (const auto& link : links)
+    {
+        if (find(link.a) != find(link.b))
+        {
+            m_lookAhead = std::min(m_lookAhead, link.delay);
+        }
+    }
+
+    // Number the LPs in the order of their smallest node id, so that the
+    // partition does not depend on the union-find internals.
+    const LogicalProcess system = std::move(m_lps[0]);
+    m_lps.clear();
+    m_lps.push_back(system);
+    std::vector<uint32_t> lpOfRoot(nNodes, 0);
+    m_lpOfNode.resize(nNodes);
+    for (uint32_t id = 0; id < nNodes; ++id)
+    {
+        uint32_t root = find(id);
+        if (lpOfRoot[root] == 0)
+        {
+            lpOfRoot[root] = m_lps.size();
+            LogicalProcess lp;
+            lp.events = m_schedulerFactory.Create<Scheduler>();
+            // Keep the uids increasing across the events moved below
+            lp.uid = system.uid;
+            lp.currentUid = system.currentUid;
+            lp.currentTs = system.currentTs;
+            lp.currentContext = system.currentContext;
+            // Give each LP its own range of packet uids and stream indices
+            lp.packetUid = static_cast<uint64_t>(m_lps.size()) << 32;
+            lp.streamIndex = static_cast<uint64_t>(m_lps.size()) << 32;
+            m_lps.push_back(std::move(lp));
+        }
+        m_lpOfNode[id] = lpOfRoot[root];
+    }
+
+    // Move the events scheduled so far to the LP of their context
+    std::vector<Scheduler::Event> events;
+    while (!m_lps[0].events->IsEmpty())
+    {
+        events.push_back(m_lps[0].events->RemoveNext());
+    }
+    for (const auto& ev : events)
+    {
+        LogicalProcess& lp = m_lps[LpIndex(ev.key.m_context)];
+        lp.events->Insert(ev);
+        lp.unscheduledEvents++;
+        m_lps[0].unscheduledEvents--;
+    }
+
+    NS_ABORT_MSG_IF(m_lps.size() >= (1U << 31), "too many logical processes");
+    m_partitioned = true;
+    NS_LOG_INFO("partitioned "
+                << nNodes << " nodes into " << m_lps.size() - 1 << " logical processes, lookahead "
+                << (m_lookAhead == NEVER ? "infinite" : std::to_string(m_lookAhead)));
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent(LogicalProcess& lp)
+{
+    Scheduler::Event next = lp.events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= lp.currentTs);
+    lp.unscheduledEvents--;
+    lp.eventCount++;
+
+    lp.currentTs = next.key.m_ts;
+    lp.currentContext = next.key.m_context;
+    lp.currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessRemoteEvents()
+{
+    if (!m_eventsWithContextEmpty)
+    {
+        EventsWithContext eventsWithContext;
+        {
+            std::unique_lock lock{m_eventsWithContextMutex};
+            m_eventsWithContext.swap(eventsWithContext);
+            m_eventsWithContextEmpty = true;
+        }
+        for (const auto& event : eventsWithContext)
+        {
+            LogicalProcess& lp = m_lps[LpIndex(event.context)];
+            Insert(lp, lp.currentTs + event.timestamp, event.context, event.event);
+        }
+    }
+
+    for (auto& lp : m_lps)
+    {
+        m_inbox.insert(m_inbox.end(), lp.outbox.begin(), lp.outbox.end());
+        lp.outbox.clear();
+    }
+    // Each outbox is sorted by sending time already; merge them in LP order
+    auto bySendingTime = [](const RemoteEvent& a, const RemoteEvent& b) {
+        return a.sentTs < b.sentTs;
+    };
+    std::stable_sort(m_inbox.begin(), m_inbox.end(), bySendingTime);
+    for (const auto& event : m_inbox)
+    {
+        Insert(m_lps[event.lp], event.timestamp, event.context, event.event);
+    }
+    m_inbox.clear();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    return std::all_of(m_lps.begin(), m_lps.end(), [](const LogicalProcess& lp) {
+        return lp.events->IsEmpty() && lp.outbox.empty();
+    });
+}
+
+void
+MultithreadedSimulatorImpl::ProcessLps()
+{
+    for (uint32_t i = m_nextLp.fetch_add(1, std::memory_order_relaxed); i < m_lps.size();
+         i = m_nextLp.fetch_add(1, std::memory_order_relaxed))
+    {
+        LogicalProcess& lp = m_lps[i];
+        g_currentLp = &lp;
+        Packet::SetThreadUidCounter(&lp.packetUid);
+        RngSeedManager::SetThreadStreamIndexCounter(&lp.streamIndex);
+        while (!lp.events->IsEmpty() && lp.events->PeekNext().key.m_ts < m_windowEnd)
+        {
+            ProcessOneEvent(lp);
+        }
+        Packet::SetThreadUidCounter(nullptr);
+        RngSeedManager::SetThreadStreamIndexCounter(nullptr);
+        g_currentLp = nullptr;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunWindow(uint64_t windowEnd)
+{
+    m_windowEnd = windowEnd;
+    m_nextLp.store(1, std::memory_order_relaxed);
+    if (!m_workers.empty())
+    {
+        m_busyWorkers.store(m_workers.size(), std::memory_order_relaxed);
+        m_window.fetch_add(1, std::memory_order_release);
+        m_window.notify_all();
+    }
+
+    ProcessLps();
+
+    for (uint32_t busy = m_busyWorkers.load(std::memory_order_acquire); busy != 0;
+         busy = m_busyWorkers.load(std::memory_order_acquire))
+    {
+        m_busyWorkers.wait(busy, std::memory_order_acquire);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::WorkerLoop(uint64_t window)
+{
+    while (true)
+    {
+        m_window.wait(window, std::memory_order_acquire);
+        window = m_window.load(std::memory_order_acquire);
+        if (m_exitWorkers.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        ProcessLps();
+        if (m_busyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            m_busyWorkers.notify_one();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::StartWorkers(uint32_t n)
+{
+    NS_LOG_FUNCTION(this << n);
+    uint64_t window = m_window.load();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_workers.emplace_back(&MultithreadedSimulatorImpl::WorkerLoop, this, window);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::StopWorkers()
+{
+    if (m_workers.empty())
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    m_exitWorkers.store(true, std::memory_order_release);
+    m_window.fetch_add(1, std::memory_order_release);
+    m_window.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+    m_exitWorkers = false;
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    // Set the current threadId as the main threadId
+    m_mainThreadId = std::this_thread::get_id();
+    if (!m_partitioned)
+    {
+        Partition();
+    }
+    ProcessRemoteEvents();
+    m_stop = false;
+
+    uint32_t nThreads = m_maxThreads;
+    if (nThreads == 0)
+    {
+        nThreads = std::thread::hardware_concurrency();
+    }
+    nThreads = std::max<uint32_t>(1, std::min<uint32_t>(nThreads, m_lps.size() - 1));
+    StartWorkers(nThreads - 1);
+
+    while (!m_stop)
+    {
+        uint64_t nodeNext = NEVER;
+        for (uint32_t i = 1; i < m_lps.size(); ++i)
+        {
+            if (!m_lps[i].events->IsEmpty())
+            {
+                nodeNext = std::min(nodeNext, m_lps[i].events->PeekNext().key.m_ts);
+            }
+        }
+        uint64_t systemNext =
+            m_lps[0].events->IsEmpty() ? NEVER : m_lps[0].events->PeekNext().key.m_ts;
+        if (nodeNext == NEVER && systemNext == NEVER)
+        {
+            break;
+        }
+
+        if (systemNext <= nodeNext)
+        {
+            ProcessOneEvent(m_lps[0]);
+        }
+        else
+        {
+            uint64_t windowEnd = nodeNext > NEVER - m_lookAhead ? NEVER : nodeNext + m_lookAhead;
+            RunWindow(std::min(windowEnd, systemNext));
+        }
+        ProcessRemoteEvents();
+    }
+
+    StopWorkers();
+
+    // Report the time of the last event from the main thread, as the
+    // sequential simulator does.
+    for (const auto& lp : m_lps)
+    {
+        if (lp.currentTs > m_lps[0].currentTs)
+        {
+            m_lps[0].currentTs = lp.currentTs;
+            m_lps[0].currentUid = EventId::UID::INVALID;
+        }
+    }
+
+    // If the simulator stopped naturally by lack of events, make a
+    // consistency test to check that we didn't lose any events along the way.
+    NS_ASSERT(m_stop || std::all_of(m_lps.begin(), m_lps.end(), [](const LogicalProcess& lp) {
+                  return lp.unscheduledEvents == 0;
+              }));
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = true;
+}
+
+EventId
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    return Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(g_currentLp != nullptr || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::Schedule Thread-unsafe invocation!");
+
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+    // An event keeps the context, hence the LP, of the event scheduling it
+    LogicalProcess& lp =
+        g_currentLp != nullptr ? *g_currentLp : m_lps[LpIndex(m_lps[0].currentContext)];
+    Time tAbsolute = delay + TimeStep(CurrentLp().currentTs);
+
+    Scheduler::EventKey key =
+        Insert(lp, tAbsolute.GetTimeStep(), CurrentLp().currentContext, event);
+    return EventId(event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+
+    if (g_currentLp != nullptr)
+    {
+        // Called from an event, within a window
+        LogicalProcess& lp = *g_currentLp;
+        Time tAbsolute = delay + TimeStep(lp.currentTs);
+        uint32_t index = LpIndex(context);
+        if (&m_lps[index] == &lp)
+        {
+            Insert(lp, tAbsolute.GetTimeStep(), context, event);
+        }
+        else
+        {
+            NS_ABORT_MSG_IF(static_cast<uint64_t>(tAbsolute.GetTimeStep()) < m_windowEnd,
+                            "MultithreadedSimulatorImpl::ScheduleWithContext(): event for context "
+                                << context << " at " << tAbsolute
+                                << " is earlier than the lookahead allows");
+            lp.outbox.push_back({index,
+                                 context,
+                                 static_cast<uint64_t>(tAbsolute.GetTimeStep()),
+                                 lp.currentTs,
+                                 event});
+        }
+    }
+    else if (m_mainThreadId == std::this_thread::get_id())
+    {
+        // Called between windows: all the LPs are idle
+        Time tAbsolute = delay + TimeStep(m_lps[0].currentTs);
+        Insert(m_lps[LpIndex(context)], tAbsolute.GetTimeStep(), context, event);
+    }
+    else
+    {
+        EventWithContext ev;
+        ev.context = context;
+        // Current time added in ProcessRemoteEvents()
+        ev.timestamp = delay.GetTimeStep();
+        ev.event = event;
+        {
+            std::unique_lock lock{m_eventsWithContextMutex};
+            m_eventsWithContext.push_back(ev);
+            m_eventsWithContextEmpty = false;
+        }
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    NS_ASSERT_MSG(g_currentLp != nullptr || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::ScheduleNow Thread-unsafe invocation!");
+
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    NS_ASSERT_MSG(g_currentLp == nullptr && m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+
+    EventId id(Ptr<EventImpl>(event, false), m_lps[0].currentTs, 0xffffffff, 2);
+    m_destroyEvents.push_back(id);
+    m_lps[0].uid++;
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(CurrentLp().currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - CurrentLp().currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    LogicalProcess& lp = m_lps[LpIndex(id.GetContext())];
+    NS_ABORT_MSG_IF(g_currentLp != nullptr && g_currentLp != &lp,
+                    "MultithreadedSimulatorImpl::Remove(): event of context "
+                        << id.GetContext() << " belongs to another logical process");
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    lp.events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    lp.unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Compare with the clock of the LP which owns the event.  The clock of
+    // another node LP changes while the current window runs.
+    const LogicalProcess& lp = m_lps[LpIndex(id.GetContext())];
+    NS_ABORT_MSG_IF(g_currentLp != nullptr && g_currentLp != &lp && &lp != &m_lps[0],
+                    "MultithreadedSimulatorImpl::IsExpired(): event of context "
+                        << id.GetContext() << " belongs to another logical process");
+    return id.PeekEventImpl() == nullptr || id.GetTs() < lp.currentTs ||
+           (id.GetTs() == lp.currentTs && id.GetUid() <= lp.currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return CurrentLp().currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = 0;
+    for (const auto& lp : m_lps)
+    {
+        count += lp.eventCount;
+    }
+    return count;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetLogicalProcessCount() const
+{
+    return m_lps.size();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead() const
+{
+    return m_lookAhead == NEVER ? GetMaximumSimulationTime() : TimeStep(m_lookAhead);
+}
+
+} // namespace ns3
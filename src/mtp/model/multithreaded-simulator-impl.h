@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2026 PCDN tracker simulation project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-id.h"
+#include "ns3/object-factory.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \defgroup mtp Multithreaded Parallel Simulation
+ */
+
+/**
+ * \ingroup mtp
+ * \ingroup simulator
+ *
+ * \brief Shared-memory parallel simulator implementation.
+ *
+ * At the first call to Run() the nodes of the NodeList are split into
+ * logical processes (LPs): nodes joined by a channel which is not a
+ * point-to-point channel with a positive "Delay" attribute end up in
+ * the same LP.  The lookahead is the smallest delay of the
+ * point-to-point channels which cross two LPs, as in
+ * DistributedSimulatorImpl.  Each LP owns an event queue, a clock and
+ * an event uid counter; events are assigned to an LP according to the
+ * node id found in their context.
+ *
+ * The simulation advances in windows: every LP processes, on any of
+ * the worker threads, its events which are earlier than the end of the
+ * window, that is the earliest pending event plus the lookahead.
+ * Events scheduled on another LP (typically a packet reception on the
+ * far end of a point-to-point link) are buffered by the sending LP and
+ * handed over, as they are, between two windows.
+ *
+ * Events without a node context (for instance Simulator::Stop or the
+ * events scheduled before the topology was partitioned) belong to a
+ * system LP which is processed by the main thread between two windows,
+ * before the node events with the same timestamp.
+ *
+ * The event order of each node is the one DefaultSimulatorImpl would
+ * produce, except for ties: an event received from another LP runs
+ * after the local events with the same timestamp scheduled during the
+ * same window, and events received from several LPs with the same
+ * timestamp are ordered by the time at which they were scheduled, then
+ * by LP.  The result does not depend on the number of threads: the
+ * packet uids and the stream indices automatically assigned while an LP
+ * runs are taken from counters owned by the LP, which start at the LP
+ * index shifted by 32 bits.
+ *
+ * The build must be configured with \c NS3_MTP enabled so that the
+ * reference counts of the objects shared by several threads are atomic.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Get the number of logical processes, including the system one.
+     *
+     * Only meaningful once Run() has been called.
+     * \returns The number of logical processes.
+     */
+    uint32_t GetLogicalProcessCount() const;
+
+    /**
+     * Get the lookahead used to size the synchronization windows.
+     *
+     * Only meaningful once Run() has been called.
+     * \returns The lookahead, GetMaximumSimulationTime() if no
+     *          point-to-point channel crosses two logical processes.
+     */
+    Time GetLookAhead() const;
+
+  private:
+    void DoDispose() override;
+
+    /** An event scheduled by an LP on another LP during a window. */
+    struct RemoteEvent
+    {
+        /** Index of the destination LP. */
+        uint32_t lp;
+        /** The event context. */
+        uint32_t context;
+        /** Absolute event timestamp. */
+        uint64_t timestamp;
+        /** Time at which the event was scheduled. */
+        uint64_t sentTs;
+        /** The event implementation. */
+        EventImpl* event;
+    };
+
+    /**
+     * The state of a logical process.
+     *
+     * Aligned on a cache line since several threads update adjacent LPs.
+     */
+    struct alignas(64) LogicalProcess
+    {
+        /** The event priority queue. */
+        Ptr<Scheduler> events;
+        /** Next event unique id. */
+        uint32_t uid{EventId::UID::VALID};
+        /** Unique id of the current event. */
+        uint32_t currentUid{EventId::UID::INVALID};
+        /** Timestamp of the current event. */
+        uint64_t currentTs{0};
+        /** Execution context of the current event. */
+        uint32_t currentContext{0xffffffff};
+        /** Number of events inserted but not yet processed. */
+        int unscheduledEvents{0};
+        /** The event count. */
+        uint64_t eventCount{0};
+        /** Next uid of the packets created by the LP. */
+        uint64_t packetUid{0};
+        /** Next stream index automatically assigned by the LP. */
+        uint64_t streamIndex{0};
+        /** Events scheduled on other LPs during the current window. */
+        std::vector<RemoteEvent> outbox;
+    };
+
+    /** Wrap an event scheduled from a thread the simulator does not own. */
+    struct EventWithContext
+    {
+        /** The event context. */
+        uint32_t context;
+        /** Event timestamp, relative to the time it is inserted. */
+        uint64_t timestamp;
+        /** The event implementation. */
+        EventImpl* event;
+    };
+
+    /**
+     * Get the LP of the calling thread.
+     * \returns The LP the current event belongs to, or the system LP
+     *          outside of a window.
+     */
+    const LogicalProcess& CurrentLp() const;
+    /**
+     * Get the LP which owns a context.
+     * \param [in] context The event context.
+     * \returns The LP index.
+     */
+    uint32_t LpIndex(uint32_t context) const;
+    /**
+     * Insert an event in the queue of an LP.
+     * \param [in] lp The LP.
+     * \param [in] ts The absolute event timestamp.
+     * \param [in] context The event context.
+     * \param [in] event The event implementation.
+     * \returns The scheduler key of the new event.
+     */
+    Scheduler::EventKey Insert(LogicalProcess& lp, uint64_t ts, uint32_t context, EventImpl* event);
+    /**
+     * Split the nodes into LPs, compute the lookahead and move the
+     * events scheduled so far to the LP which owns them.
+     */
+    void Partition();
+    /** Insert the events buffered since the last window in their LP. */
+    void ProcessRemoteEvents();
+    /**
+     * Process the next event of an LP.
+     * \param [in] lp The LP.
+     */
+    void ProcessOneEvent(LogicalProcess& lp);
+    /**
+     * Process all the events of the node LPs earlier than \p windowEnd.
+     * \param [in] windowEnd The end of the window.
+     */
+    void RunWindow(uint64_t windowEnd);
+    /** Process LPs of the current window until none is left. */
+    void ProcessLps();
+    /**
+     * Body of the worker threads.
+     * \param [in] window The value of m_window when the thread was started.
+     */
+    void WorkerLoop(uint64_t window);
+    /**
+     * Start the worker threads.
+     * \param [in] n The number of worker threads.
+     */
+    void StartWorkers(uint32_t n);
+    /** Stop and join the worker threads. */
+    void StopWorkers();
+
+    /** The LP processed by the calling thread, \c nullptr outside of a window. */
+    static thread_local LogicalProcess* g_currentLp;
+
+    /** The logical processes; index 0 is the system LP. */
+    std::vector<LogicalProcess> m_lps;
+    /** The LP index of each node, indexed by node id. */
+    std::vector<uint32_t> m_lpOfNode;
+    /** Flag \c true once the nodes have been partitioned. */
+    bool m_partitioned;
+    /** The lookahead, in time steps. */
+    uint64_t m_lookAhead;
+    /** Maximum number of threads, 0 for the hardware concurrency. */
+    uint32_t m_maxThreads;
+    /** The scheduler factory used to create the event queue of each LP. */
+    ObjectFactory m_schedulerFactory;
+
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+    /** End of the current window (exclusive). */
+    uint64_t m_windowEnd;
+    /** Next LP to be claimed by a thread in the current window. */
+    std::atomic<uint32_t> m_nextLp;
+    /** Window counter, used to wake up the worker threads. */
+    std::atomic<uint64_t> m_window;
+    /** Events handed over between two windows, sorted before insertion. */
+    std::vector<RemoteEvent> m_inbox;
+    /** Number of worker threads still busy with the current window. */
+    std::atomic<uint32_t> m_busyWorkers;
+    /** Flag asking the worker threads to exit. */
+    std::atomic<bool> m_exitWorkers;
+    /** The worker threads. */
+    std::vector<std::thread> m_workers;
+
+    /** Container type for the events scheduled from foreign threads. */
+    typedef std::list<EventWithContext> EventsWithContext;
+    /** The events scheduled from foreign threads. */
+    EventsWithContext m_eventsWithContext;
+    /** Flag \c true if m_eventsWithContext is empty. */
+    std::atomic<bool> m_eventsWithContextEmpty;
+    /** Mutex to control access to m_eventsWithContext. */
+    std::mutex m_eventsWithContextMutex;
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Main execution thread. */
+    std::thread::id m_mainThreadId;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2026 PCDN tracker simulation project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/global-value.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <tuple>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite.
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests mtp module tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Check that MultithreadedSimulatorImpl delivers the same packets at
+ * the same times as DefaultSimulatorImpl, whatever the number of threads,
+ * and that the packet uids and stream indices it assigns do not depend
+ * on the number of threads.
+ *
+ * Eight nodes form a ring of point-to-point links with different delays,
+ * plus a zero-delay chord which must keep its two nodes in the same
+ * logical process.  Every node sends packets of random sizes on random
+ * links and forwards the packets it receives a few times.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+  public:
+    MultithreadedSimulatorTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** A packet reception. */
+    struct Record
+    {
+        int64_t time;    //!< Reception time
+        uint32_t size;   //!< Packet size
+        uint8_t origin;  //!< Node which created the packet
+        uint32_t seq;    //!< Sequence number on the origin node
+        uint8_t hops;    //!< Number of links crossed
+        uint32_t device; //!< Receiving device index
+        uint64_t uid;    //!< Packet uid, which depends on the implementation
+
+        /**
+         * Compare two records, except for the packet uid.
+         * \param [in] o The other record.
+         * \returns \c true if both records are identical.
+         */
+        bool operator==(const Record& o) const
+        {
+            return std::tie(time, size, origin, seq, hops, device) ==
+                   std::tie(o.time, o.size, o.origin, o.seq, o.hops, o.device);
+        }
+    };
+
+    /** The receptions of each node. */
+    typedef std::vector<std::vector<Record>> Log;
+    /** The stream indices assigned by each node. */
+    typedef std::vector<std::vector<uint64_t>> Streams;
+
+    /**
+     * Run the scenario.
+     * \param [in] impl The simulator implementation TypeId name.
+     * \param [in] threads The value of the MaxThreads attribute.
+     * \param [out] streams The stream indices assigned by each node.
+     * \returns The receptions of each node.
+     */
+    Log RunScenario(const std::string& impl, uint32_t threads, Streams& streams);
+    /**
+     * Send a new packet and schedule the next one.
+     * \param [in] node The node index.
+     */
+    void Send(uint32_t node);
+    /**
+     * Send a packet on a random device of a node.
+     * \param [in] node The node index.
+     * \param [in] payload The packet payload.
+     */
+    void Transmit(uint32_t node, std::vector<uint8_t> payload);
+    /**
+     * Record a packet reception and maybe forward the packet.
+     * \param [in] device The receiving device.
+     * \param [in] packet The received packet.
+     * \param [in] protocol The protocol number.
+     * \param [in] from The sender address.
+     * \returns \c true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    NodeContainer m_nodes;                          //!< The nodes
+    std::vector<Ptr<UniformRandomVariable>> m_rngs; //!< Random stream of each node
+    std::vector<uint32_t> m_seq;                    //!< Next sequence number of each node
+    Log m_log;                                      //!< Receptions of each node
+    Streams m_streams;                              //!< Stream indices of each node
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase()
+    : TestCase("Check that MultithreadedSimulatorImpl matches DefaultSimulatorImpl")
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Send(uint32_t node)
+{
+    std::vector<uint8_t> payload(m_rngs[node]->GetInteger(100, 1000), 0);
+    uint32_t seq = m_seq[node]++;
+    payload[0] = node;
+    payload[1] = seq >> 24;
+    payload[2] = seq >> 16;
+    payload[3] = seq >> 8;
+    payload[4] = seq;
+    payload[5] = 0;
+    m_streams[node].push_back(RngSeedManager::GetNextStreamIndex());
+    Transmit(node, payload);
+    Simulator::Schedule(MicroSeconds(m_rngs[node]->GetInteger(20, 400)),
+                        &MultithreadedSimulatorTestCase::Send,
+                        this,
+                        node);
+}
+
+void
+MultithreadedSimulatorTestCase::Transmit(uint32_t node, std::vector<uint8_t> payload)
+{
+    Ptr<Node> n = m_nodes.Get(node);
+    Ptr<NetDevice> device = n->GetDevice(m_rngs[node]->GetInteger(0, n->GetNDevices() - 1));
+    device->Send(Create<Packet>(payload.data(), payload.size()), device->GetBroadcast(), 0x800);
+}
+
+bool
+MultithreadedSimulatorTestCase::Receive(Ptr<NetDevice> device,
+                                        Ptr<const Packet> packet,
+                                        uint16_t protocol,
+                                        const Address& from)
+{
+    uint32_t node = device->GetNode()->GetId();
+    std::vector<uint8_t> payload(packet->GetSize());
+    packet->CopyData(payload.data(), payload.size());
+    Record record;
+    record.time = Simulator::Now().GetTimeStep();
+    record.size = payload.size();
+    record.origin = payload[0];
+    record.seq = payload[1] << 24 | payload[2] << 16 | payload[3] << 8 | payload[4];
+    record.hops = payload[5];
+    record.device = device->GetIfIndex();
+    record.uid = packet->GetUid();
+    m_log[node].push_back(record);
+
+    if (payload[5] < 3)
+    {
+        payload[5]++;
+        Simulator::Schedule(MicroSeconds(m_rngs[node]->GetInteger(1, 50)),
+                            &MultithreadedSimulatorTestCase::Transmit,
+                            this,
+                            node,
+                            payload);
+    }
+    return true;
+}
+
+MultithreadedSimulatorTestCase::Log
+MultithreadedSimulatorTestCase::RunScenario(const std::string& impl,
+                                            uint32_t threads,
+                                            Streams& streams)
+{
+    const uint32_t nNodes = 8;
+    GlobalValue::Bind("SimulatorImplementationType", StringValue(impl));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(threads));
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    m_nodes = NodeContainer(nNodes);
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        p2p.SetChannelAttribute("Delay", TimeValue(MicroSeconds(1000 + 310 * i)));
+        p2p.Install(m_nodes.Get(i), m_nodes.Get((i + 1) % nNodes));
+    }
+    p2p.SetChannelAttribute("Delay", TimeValue(Seconds(0)));
+    p2p.Install(m_nodes.Get(0), m_nodes.Get(nNodes / 2));
+
+    m_rngs.clear();
+    m_seq.assign(nNodes, 0);
+    m_log.assign(nNodes, {});
+    m_streams.assign(nNodes, {});
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+        rng->SetStream(i);
+        m_rngs.push_back(rng);
+        for (uint32_t j = 0; j < m_nodes.Get(i)->GetNDevices(); ++j)
+        {
+            m_nodes.Get(i)->GetDevice(j)->SetReceiveCallback(
+                MakeCallback(&MultithreadedSimulatorTestCase::Receive, this));
+        }
+        Simulator::ScheduleWithContext(i,
+                                       MicroSeconds(m_rngs[i]->GetInteger(0, 1000)),
+                                       &MultithreadedSimulatorTestCase::Send,
+                                       this,
+                                       i);
+    }
+
+    Simulator::Stop(MilliSeconds(100));
+    Simulator::Run();
+
+    Ptr<MultithreadedSimulatorImpl> mt =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    if (mt)
+    {
+        // the system LP, plus one LP per node except for the chord ends
+        NS_TEST_EXPECT_MSG_EQ(mt->GetLogicalProcessCount(), nNodes, "unexpected partition");
+        NS_TEST_EXPECT_MSG_EQ(mt->GetLookAhead(), MicroSeconds(1000), "unexpected lookahead");
+    }
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MilliSeconds(100), "unexpected stop time");
+
+    Simulator::Destroy();
+    m_nodes = NodeContainer();
+    m_rngs.clear();
+    streams.swap(m_streams);
+    Log log;
+    log.swap(m_log);
+    return log;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun()
+{
+    Simulator::Destroy();
+    Streams streams;
+    Log reference = RunScenario("ns3::DefaultSimulatorImpl", 0, streams);
+    std::size_t total = 0;
+    for (const auto& node : reference)
+    {
+        total += node.size();
+    }
+    NS_TEST_ASSERT_MSG_GT(total, 1000, "not enough traffic to compare the implementations");
+
+    Log first;
+    Streams firstStreams;
+    for (uint32_t threads : {1, 2, 4})
+    {
+        Log log = RunScenario("ns3::MultithreadedSimulatorImpl", threads, streams);
+        for (std::size_t node = 0; node < reference.size(); ++node)
+        {
+            NS_TEST_ASSERT_MSG_EQ(log[node].size(),
+                                  reference[node].size(),
+                                  "node " << node << ", " << threads << " threads");
+            for (std::size_t i = 0; i < reference[node].size(); ++i)
+            {
+                NS_TEST_ASSERT_MSG_EQ((log[node][i] == reference[node][i]),
+                                      true,
+                                      "node " << node << ", reception " << i << ", " << threads
+                                              << " threads");
+                if (!first.empty())
+                {
+                    NS_TEST_ASSERT_MSG_EQ(log[node][i].uid,
+                                          first[node][i].uid,
+                                          "node " << node << ", reception " << i << ", "
+                                                  << threads << " threads");
+                }
+            }
+        }
+        if (first.empty())
+        {
+            first = log;
+            firstStreams = streams;
+        }
+        else
+        {
+            NS_TEST_ASSERT_MSG_EQ((streams == firstStreams),
+                                  true,
+                                  "stream indices differ with " << threads << " threads");
+        }
+    }
+
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(0));
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * MultithreadedSimulatorImpl test suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite();
+};
+
+MtpTestSuite::MtpTestSuite()
+    : TestSuite("mtp", UNIT)
+{
+    AddTestCase(new MultithreadedSimulatorTestCase, TestCase::QUICK);
+}
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
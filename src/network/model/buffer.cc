@@ -20,6 +20,10 @@
 
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
+
+#include <algorithm>
+#include <cstddef>
 
 #define LOG_INTERNAL_STATE(y)                                                                      \
     NS_LOG_LOGIC(y << "start=" << m_start << ", end=" << m_end                                     \
@@ -54,7 +58,181 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
+/**
+ * \ingroup packet
+ * The MemoryAccounting category of the allocated Buffer::Data, in use or
+ * in the free list.
+ */
+static const uint32_t g_bufferMemory = MemoryAccounting::RegisterCategory("Buffer::Data");
+
+/**
+ * \ingroup packet
+ * The MemoryAccounting category of the chains of the scatter-gather buffers.
+ */
+static const uint32_t g_bufferChainMemory = MemoryAccounting::RegisterCategory("Buffer::Chain");
+
+/**
+ * \ingroup packet
+ * The size below which the scatter-gather mode copies the bytes rather
+ * than chaining them, as the chain costs more than the copy, unless they
+ * are appended to a buffer which is already a chain.
+ */
+constexpr uint32_t SCATTER_GATHER_MIN_SIZE = 256;
+
+#ifdef NS3_MTP
+thread_local uint32_t Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
+bool Buffer::g_scatterGather = false;
+
+/**
+ * The segments are slices of other buffers, which share their data: the
+ * chain is never modified once it is shared, except by appending segments
+ * while a single buffer references it.  The segments are never views of a
+ * whole chain themselves, whose segments are appended instead.
+ */
+struct Buffer::Chain
+{
+    /**
+     * The reference count: each Buffer::Data which references the chain
+     * holds a count.
+     */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> m_count{1};
+#else
+    uint32_t m_count{1};
+#endif
+    std::vector<Buffer> m_segments; //!< the segments, in order
+    std::vector<uint32_t> m_ends;   //!< the offset of the end of each segment in the chain
+
+    /**
+     * \returns the number of bytes of the chain.
+     */
+    uint32_t GetSize() const
+    {
+        return m_ends.empty() ? 0 : m_ends.back();
+    }
+
+    /**
+     * \param offset an offset in the chain
+     * \returns the index of the segment which holds the byte at this offset
+     */
+    std::size_t FindSegment(uint32_t offset) const
+    {
+        return std::upper_bound(m_ends.begin(), m_ends.end(), offset) - m_ends.begin();
+    }
+
+    /**
+     * \param i the index of a segment
+     * \returns the offset of the start of the segment in the chain
+     */
+    uint32_t GetSegmentStart(std::size_t i) const
+    {
+        return i == 0 ? 0 : m_ends[i - 1];
+    }
+
+    /**
+     * Append the bytes of a buffer, which are shared rather than copied.
+     * \param segment the buffer to append
+     */
+    void Append(const Buffer& segment)
+    {
+        if (segment.GetSize() == 0)
+        {
+            return;
+        }
+        const Chain* chain = segment.m_data->m_chain;
+        if (chain != nullptr && segment.m_start == segment.m_zeroAreaStart &&
+            segment.m_end == segment.m_zeroAreaEnd)
+        {
+            // a view of another chain: append the segments it references
+            uint32_t start = segment.m_payloadOffset;
+            uint32_t end = start + segment.GetSize();
+            for (std::size_t i = chain->FindSegment(start);
+                 i < chain->m_ends.size() && chain->GetSegmentStart(i) < end;
+                 i++)
+            {
+                uint32_t segmentStart = chain->GetSegmentStart(i);
+                uint32_t from = std::max(start, segmentStart) - segmentStart;
+                uint32_t to = std::min(end, chain->m_ends[i]) - segmentStart;
+                Append(chain->m_segments[i].Slice(from, to - from));
+            }
+            return;
+        }
+        m_segments.push_back(segment);
+        m_ends.push_back(GetSize() + segment.GetSize());
+    }
+
+    /**
+     * Copy bytes of the chain.
+     * \param buffer the buffer to fill
+     * \param offset the offset of the first byte in the chain
+     * \param size the number of bytes to copy
+     */
+    void Read(uint8_t* buffer, uint32_t offset, uint32_t size) const
+    {
+        NS_ASSERT(offset + size <= GetSize());
+        for (std::size_t i = FindSegment(offset); size > 0; i++)
+        {
+            uint32_t n = std::min(size, m_ends[i] - offset);
+            m_segments[i].ReadAt(buffer, offset - GetSegmentStart(i), n);
+            buffer += n;
+            offset += n;
+            size -= n;
+        }
+    }
+};
+
+void
+Buffer::EnableScatterGather(bool enable)
+{
+    NS_LOG_FUNCTION(enable);
+    g_scatterGather = enable;
+}
+
+bool
+Buffer::IsScatterGatherEnabled()
+{
+    return g_scatterGather;
+}
+
+void
+Buffer::ReleaseChain(Chain* chain)
+{
+    NS_LOG_FUNCTION(chain);
+    if (--chain->m_count == 0)
+    {
+        MemoryAccounting::Released(g_bufferChainMemory, sizeof(Chain));
+        delete chain;
+    }
+}
+
+void
+Buffer::CopyPayloadSource(Buffer::Data* to, const Buffer::Data* from)
+{
+    NS_LOG_FUNCTION(to << from);
+    if (from->m_chain != nullptr)
+    {
+        from->m_chain->m_count++;
+    }
+    if (to->m_chain != nullptr)
+    {
+        ReleaseChain(to->m_chain);
+    }
+    to->m_generator = from->m_generator;
+    to->m_chain = from->m_chain;
+}
+
+Buffer
+Buffer::CreateChainView(Chain* chain)
+{
+    NS_LOG_FUNCTION(chain);
+    MemoryAccounting::Allocated(g_bufferChainMemory, sizeof(Chain));
+    Buffer view(chain->GetSize());
+    view.m_data->m_chain = chain;
+    return view;
+}
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -79,6 +257,12 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED(x) && !IS_DESTROYED(x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
+/**
+ * \ingroup packet
+ * The MemoryAccounting category of the Buffer::Data in the free list.
+ */
+static const uint32_t g_bufferFreeListMemory =
+    MemoryAccounting::RegisterCategory("Buffer::Data (free list)");
 uint32_t Buffer::g_maxSize = 0;
 Buffer::FreeList* Buffer::g_freeList = nullptr;
 Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
@@ -103,6 +287,11 @@ Buffer::Recycle(Buffer::Data* data)
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
     NS_ASSERT(!IS_UNINITIALIZED(g_freeList));
+    if (data->m_chain != nullptr)
+    {
+        ReleaseChain(data->m_chain);
+        data->m_chain = nullptr;
+    }
     g_maxSize = std::max(g_maxSize, data->m_size);
     /* feed into free list */
     if (data->m_size < g_maxSize || IS_DESTROYED(g_freeList) || g_freeList->size() > 1000)
@@ -113,6 +302,7 @@ Buffer::Recycle(Buffer::Data* data)
     {
         NS_ASSERT(IS_INITIALIZED(g_freeList));
         g_freeList->push_back(data);
+        MemoryAccounting::Allocated(g_bufferFreeListMemory, data->m_size - 1 + sizeof(Data));
     }
 }
 
@@ -131,9 +321,12 @@ Buffer::Create(uint32_t dataSize)
         {
             Buffer::Data* data = g_freeList->back();
             g_freeList->pop_back();
+            MemoryAccounting::Released(g_bufferFreeListMemory, data->m_size - 1 + sizeof(Data));
             if (data->m_size >= dataSize)
             {
                 data->m_count = 1;
+                data->m_generator = nullptr;
+                data->m_chain = nullptr;
                 return data;
             }
             Buffer::Deallocate(data);
@@ -149,6 +342,10 @@ Buffer::Recycle(Buffer::Data* data)
 {
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
+    if (data->m_chain != nullptr)
+    {
+        ReleaseChain(data->m_chain);
+    }
     Deallocate(data);
 }
 
@@ -177,6 +374,9 @@ Buffer::Allocate(uint32_t reqSize)
     auto data = reinterpret_cast<Buffer::Data*>(b);
     data->m_size = reqSize;
     data->m_count = 1;
+    data->m_generator = nullptr;
+    data->m_chain = nullptr;
+    MemoryAccounting::Allocated(g_bufferMemory, size);
     return data;
 }
 
@@ -185,6 +385,7 @@ Buffer::Deallocate(Buffer::Data* data)
 {
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
+    MemoryAccounting::Released(g_bufferMemory, data->m_size - 1 + sizeof(Buffer::Data));
     auto buf = reinterpret_cast<uint8_t*>(data);
     delete[] buf;
 }
@@ -210,6 +411,13 @@ Buffer::Buffer(uint32_t dataSize, bool initialize)
     }
 }
 
+Buffer::Buffer(uint32_t dataSize, PayloadGenerator generator)
+{
+    NS_LOG_FUNCTION(this << dataSize << generator);
+    Initialize(dataSize);
+    m_data->m_generator = generator;
+}
+
 bool
 Buffer::CheckInternalState() const
 {
@@ -254,6 +462,7 @@ Buffer::Initialize(uint32_t zeroSize)
     m_zeroAreaStart = m_start;
     m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
     m_end = m_zeroAreaEnd;
+    m_payloadOffset = 0;
     m_data->m_dirtyStart = m_start;
     m_data->m_dirtyEnd = m_end;
     NS_ASSERT(CheckInternalState());
@@ -266,8 +475,7 @@ Buffer::operator=(const Buffer& o)
     if (m_data != o.m_data)
     {
         // not assignment to self.
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Recycle(m_data);
         }
@@ -280,6 +488,7 @@ Buffer::operator=(const Buffer& o)
     m_zeroAreaEnd = o.m_zeroAreaEnd;
     m_start = o.m_start;
     m_end = o.m_end;
+    m_payloadOffset = o.m_payloadOffset;
     NS_ASSERT(CheckInternalState());
     return *this;
 }
@@ -289,8 +498,7 @@ Buffer::~Buffer()
     NS_LOG_FUNCTION(this);
     NS_ASSERT(CheckInternalState());
     g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         Recycle(m_data);
     }
@@ -315,7 +523,12 @@ Buffer::AddAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
     NS_ASSERT(CheckInternalState());
+#ifdef NS3_MTP
+    // another thread may be writing to the shared data: never write in place
+    bool isDirty = m_data->m_count > 1;
+#else
     bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+#endif
     if (m_start >= start && !isDirty)
     {
         /* enough space in the buffer and not dirty.
@@ -333,8 +546,8 @@ Buffer::AddAtStart(uint32_t start)
         uint32_t newSize = GetInternalSize() + start;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data + start, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        CopyPayloadSource(newData, m_data);
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -361,7 +574,12 @@ Buffer::AddAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
     NS_ASSERT(CheckInternalState());
+#ifdef NS3_MTP
+    // another thread may be writing to the shared data: never write in place
+    bool isDirty = m_data->m_count > 1;
+#else
     bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+#endif
     if (GetInternalEnd() + end <= m_data->m_size && !isDirty)
     {
         /* enough space in buffer and not dirty
@@ -379,8 +597,8 @@ Buffer::AddAtEnd(uint32_t end)
         uint32_t newSize = GetInternalSize() + end;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        CopyPayloadSource(newData, m_data);
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -407,9 +625,48 @@ Buffer::AddAtEnd(const Buffer& o)
 {
     NS_LOG_FUNCTION(this << &o);
 
-    if (m_data->m_count == 1 && (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
-        m_end == m_data->m_dirtyEnd && o.m_start == o.m_zeroAreaStart &&
-        o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+    bool zeroAreasAdjacent = (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
+                             o.m_start == o.m_zeroAreaStart &&
+                             o.m_zeroAreaEnd - o.m_zeroAreaStart > 0;
+    if (zeroAreasAdjacent && m_zeroAreaStart != m_zeroAreaEnd)
+    {
+        // the two zero areas can be merged only if they hold the same payload
+        bool zeroes = m_data->m_generator == nullptr && m_data->m_chain == nullptr;
+        zeroAreasAdjacent = m_data->m_generator == o.m_data->m_generator &&
+                            m_data->m_chain == o.m_data->m_chain &&
+                            (zeroes || m_payloadOffset + (m_zeroAreaEnd - m_zeroAreaStart) ==
+                                           o.m_payloadOffset);
+    }
+    if (zeroAreasAdjacent && m_data->m_count > 1 && m_end == m_zeroAreaEnd)
+    {
+        /**
+         * This buffer is shared with other buffers, typically a fragment
+         * of a virtual payload: rather than copying the whole payload
+         * below, move it to a data of its own, which holds only the bytes
+         * before the zero area.
+         */
+        uint32_t dataStart = m_zeroAreaStart - m_start;
+        uint32_t zeroSize = m_zeroAreaEnd - m_zeroAreaStart;
+        Buffer::Data* newData = Buffer::Create(dataStart);
+        CopyPayloadSource(newData, m_data);
+        uint32_t newZeroAreaStart =
+            std::max(dataStart, std::min(newData->m_size, g_recommendedStart));
+        memcpy(newData->m_data + newZeroAreaStart - dataStart,
+               m_data->m_data + m_start,
+               dataStart);
+        if (--m_data->m_count == 0)
+        {
+            Buffer::Recycle(m_data);
+        }
+        m_data = newData;
+        m_start = newZeroAreaStart - dataStart;
+        m_zeroAreaStart = newZeroAreaStart;
+        m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
+        m_end = m_zeroAreaEnd;
+        m_data->m_dirtyStart = m_start;
+        m_data->m_dirtyEnd = m_end;
+    }
+    if (zeroAreasAdjacent && m_data->m_count == 1 && m_end == m_data->m_dirtyEnd)
     {
         /**
          * This is an optimization which kicks in when
@@ -419,6 +676,8 @@ Buffer::AddAtEnd(const Buffer& o)
         if (m_zeroAreaStart == m_zeroAreaEnd)
         {
             m_zeroAreaStart = m_end;
+            m_payloadOffset = o.m_payloadOffset;
+            CopyPayloadSource(m_data, o.m_data);
         }
         uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
         m_zeroAreaEnd = m_end + zeroSize;
@@ -435,6 +694,13 @@ Buffer::AddAtEnd(const Buffer& o)
         return;
     }
 
+    // Copying a short buffer after a chain would copy the whole chain
+    if ((g_scatterGather && o.GetSize() >= SCATTER_GATHER_MIN_SIZE) || m_data->m_chain != nullptr)
+    {
+        AppendToChain(o);
+        return;
+    }
+
     *this = CreateFullCopy();
     AddAtEnd(o.GetSize());
     Buffer::Iterator destStart = End();
@@ -463,6 +729,7 @@ Buffer::RemoveAtStart(uint32_t start)
         m_start = m_zeroAreaStart;
         m_zeroAreaEnd -= delta;
         m_end -= delta;
+        m_payloadOffset += delta;
     }
     else if (newStart <= m_end)
     {
@@ -525,8 +792,40 @@ Buffer::RemoveAtEnd(uint32_t end)
     NS_ASSERT(CheckInternalState());
 }
 
+void
+Buffer::AppendToChain(const Buffer& o)
+{
+    NS_LOG_FUNCTION(this << &o);
+    NS_ASSERT(CheckInternalState());
+    Buffer segment = o;
+    Chain* chain = m_data->m_chain;
+    uint32_t zeroSize = m_zeroAreaEnd - m_zeroAreaStart;
+    if (chain != nullptr && zeroSize != 0 && m_end == m_zeroAreaEnd && m_data->m_count == 1 &&
+        chain->m_count == 1 && m_payloadOffset + zeroSize == chain->GetSize())
+    {
+        /**
+         * This buffer ends with the end of a chain which no other buffer
+         * references: extend the chain in place.
+         */
+        uint32_t size = chain->GetSize();
+        chain->Append(segment);
+        m_zeroAreaEnd += chain->GetSize() - size;
+        m_end = m_zeroAreaEnd;
+        m_data->m_dirtyEnd = m_end;
+    }
+    else
+    {
+        chain = new Chain;
+        chain->Append(*this);
+        chain->Append(segment);
+        *this = CreateChainView(chain);
+    }
+    LOG_INTERNAL_STATE("chain " << o.GetSize() << ", ");
+    NS_ASSERT(CheckInternalState());
+}
+
 Buffer
-Buffer::CreateFragment(uint32_t start, uint32_t length) const
+Buffer::Slice(uint32_t start, uint32_t length) const
 {
     NS_LOG_FUNCTION(this << start << length);
     NS_ASSERT(CheckInternalState());
@@ -537,6 +836,25 @@ Buffer::CreateFragment(uint32_t start, uint32_t length) const
     return tmp;
 }
 
+Buffer
+Buffer::CreateFragment(uint32_t start, uint32_t length) const
+{
+    NS_LOG_FUNCTION(this << start << length);
+    Buffer fragment = Slice(start, length);
+    if (g_scatterGather && fragment.GetInternalSize() >= SCATTER_GATHER_MIN_SIZE)
+    {
+        /**
+         * The fragment shares the data of this buffer, so that adding a
+         * header to it would copy its bytes: reference them from a chain
+         * instead, leaving the data of the fragment free for the headers.
+         */
+        auto chain = new Chain;
+        chain->Append(fragment);
+        return CreateChainView(chain);
+    }
+    return fragment;
+}
+
 Buffer
 Buffer::CreateFullCopy() const
 {
@@ -546,7 +864,7 @@ Buffer::CreateFullCopy() const
     {
         Buffer tmp;
         tmp.AddAtStart(m_zeroAreaEnd - m_zeroAreaStart);
-        tmp.Begin().WriteU8(0, m_zeroAreaEnd - m_zeroAreaStart);
+        ReadVirtual(tmp.m_data->m_data + tmp.m_start, 0, m_zeroAreaEnd - m_zeroAreaStart);
         uint32_t dataStart = m_zeroAreaStart - m_start;
         tmp.AddAtStart(dataStart);
         tmp.Begin().Write(m_data->m_data + m_start, dataStart);
@@ -566,6 +884,11 @@ uint32_t
 Buffer::GetSerializedSize() const
 {
     NS_LOG_FUNCTION(this);
+    if (HasGeneratedPayload())
+    {
+        // the generator cannot be serialized: serialize its bytes
+        return CreateFullCopy().GetSerializedSize();
+    }
     uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
     uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -582,6 +905,10 @@ uint32_t
 Buffer::Serialize(uint8_t* buffer, uint32_t maxSize) const
 {
     NS_LOG_FUNCTION(this << &buffer << maxSize);
+    if (HasGeneratedPayload())
+    {
+        return CreateFullCopy().Serialize(buffer, maxSize);
+    }
     auto p = reinterpret_cast<uint32_t*>(buffer);
     uint32_t size = 0;
 
@@ -689,6 +1016,86 @@ Buffer::Deserialize(const uint8_t* buffer, uint32_t size)
     return (sizeCheck != 0) ? 0 : 1;
 }
 
+bool
+Buffer::HasGeneratedPayload() const
+{
+    return (m_data->m_generator != nullptr || m_data->m_chain != nullptr) &&
+           m_zeroAreaEnd != m_zeroAreaStart;
+}
+
+uint32_t
+Buffer::GetChainedVirtualPayloadSize() const
+{
+    NS_LOG_FUNCTION(this);
+    const Chain* chain = m_data->m_chain;
+    uint32_t start = m_payloadOffset;
+    uint32_t end = start + m_zeroAreaEnd - m_zeroAreaStart;
+    uint32_t size = 0;
+    for (std::size_t i = chain->FindSegment(start);
+         i < chain->m_ends.size() && chain->GetSegmentStart(i) < end;
+         i++)
+    {
+        uint32_t segmentStart = chain->GetSegmentStart(i);
+        uint32_t from = std::max(start, segmentStart) - segmentStart;
+        uint32_t to = std::min(end, chain->m_ends[i]) - segmentStart;
+        size += chain->m_segments[i].Slice(from, to - from).GetVirtualPayloadSize();
+    }
+    return size;
+}
+
+void
+Buffer::ReadVirtual(uint8_t* buffer, uint32_t offset, uint32_t size) const
+{
+    NS_LOG_FUNCTION(this << &buffer << offset << size);
+    NS_ASSERT(offset + size <= m_zeroAreaEnd - m_zeroAreaStart);
+    if (size == 0)
+    {
+        return;
+    }
+    if (m_data->m_chain != nullptr)
+    {
+        m_data->m_chain->Read(buffer, m_payloadOffset + offset, size);
+    }
+    else if (m_data->m_generator == nullptr)
+    {
+        memset(buffer, 0, size);
+    }
+    else
+    {
+        m_data->m_generator(buffer, m_payloadOffset + offset, size);
+    }
+}
+
+void
+Buffer::ReadAt(uint8_t* buffer, uint32_t offset, uint32_t size) const
+{
+    NS_LOG_FUNCTION(this << &buffer << offset << size);
+    NS_ASSERT(offset + size <= GetSize());
+    uint32_t dataStart = m_zeroAreaStart - m_start;
+    uint32_t zeroEnd = m_zeroAreaEnd - m_start;
+    if (offset < dataStart)
+    {
+        uint32_t n = std::min(size, dataStart - offset);
+        memcpy(buffer, m_data->m_data + m_start + offset, n);
+        buffer += n;
+        offset += n;
+        size -= n;
+    }
+    if (size > 0 && offset < zeroEnd)
+    {
+        uint32_t n = std::min(size, zeroEnd - offset);
+        ReadVirtual(buffer, offset - dataStart, n);
+        buffer += n;
+        offset += n;
+        size -= n;
+    }
+    if (size > 0)
+    {
+        // the bytes after the zero area follow those before it in memory
+        memcpy(buffer, m_data->m_data + m_start + offset - (zeroEnd - dataStart), size);
+    }
+}
+
 void
 Buffer::TransformIntoRealBuffer() const
 {
@@ -722,11 +1129,24 @@ Buffer::CopyData(std::ostream* os, uint32_t size) const
             size -= m_zeroAreaStart - m_start;
             tmpsize = std::min(m_zeroAreaEnd - m_zeroAreaStart, size);
             uint32_t left = tmpsize;
-            while (left > 0)
+            if (m_data->m_generator == nullptr && m_data->m_chain == nullptr)
+            {
+                while (left > 0)
+                {
+                    uint32_t toWrite = std::min(left, g_zeroes.size);
+                    os->write(g_zeroes.buffer, toWrite);
+                    left -= toWrite;
+                }
+            }
+            else
             {
-                uint32_t toWrite = std::min(left, g_zeroes.size);
-                os->write(g_zeroes.buffer, toWrite);
-                left -= toWrite;
+                uint8_t generated[1024];
+                for (uint32_t offset = 0; offset < tmpsize; offset += sizeof(generated))
+                {
+                    uint32_t toWrite = std::min<uint32_t>(tmpsize - offset, sizeof(generated));
+                    ReadVirtual(generated, offset, toWrite);
+                    os->write(reinterpret_cast<const char*>(generated), toWrite);
+                }
             }
             if (size > tmpsize)
             {
@@ -742,40 +1162,40 @@ uint32_t
 Buffer::CopyData(uint8_t* buffer, uint32_t size) const
 {
     NS_LOG_FUNCTION(this << &buffer << size);
-    uint32_t originalSize = size;
-    if (size > 0)
-    {
-        uint32_t tmpsize = std::min(m_zeroAreaStart - m_start, size);
-        memcpy(buffer, (const char*)(m_data->m_data + m_start), tmpsize);
-        buffer += tmpsize;
-        size -= tmpsize;
-        if (size > 0)
-        {
-            tmpsize = std::min(m_zeroAreaEnd - m_zeroAreaStart, size);
-            uint32_t left = tmpsize;
-            while (left > 0)
-            {
-                uint32_t toWrite = std::min(left, g_zeroes.size);
-                memcpy(buffer, g_zeroes.buffer, toWrite);
-                left -= toWrite;
-                buffer += toWrite;
-            }
-            size -= tmpsize;
-            if (size > 0)
-            {
-                tmpsize = std::min(m_end - m_zeroAreaEnd, size);
-                memcpy(buffer, (const char*)(m_data->m_data + m_zeroAreaStart), tmpsize);
-                size -= tmpsize;
-            }
-        }
-    }
-    return originalSize - size;
+    size = std::min(size, GetSize());
+    ReadAt(buffer, 0, size);
+    return size;
 }
 
 /******************************************************
  *            The buffer iterator below.
  ******************************************************/
 
+void
+Buffer::Iterator::ReadVirtual(uint8_t* buffer, uint32_t size) const
+{
+    NS_LOG_FUNCTION(this << &buffer << size);
+    if (size == 0)
+    {
+        return;
+    }
+    NS_ASSERT(m_current >= m_zeroStart && m_current + size <= m_zeroEnd);
+    // m_data is the byte array of a Buffer::Data, which holds the generator
+    auto data = reinterpret_cast<const Buffer::Data*>(m_data - offsetof(Buffer::Data, m_data));
+    if (data->m_chain != nullptr)
+    {
+        data->m_chain->Read(buffer, m_payloadOffset + m_current - m_zeroStart, size);
+    }
+    else if (data->m_generator == nullptr)
+    {
+        memset(buffer, 0, size);
+    }
+    else
+    {
+        data->m_generator(buffer, m_payloadOffset + m_current - m_zeroStart, size);
+    }
+}
+
 uint32_t
 Buffer::Iterator::GetDistanceFrom(const Iterator& o) const
 {
@@ -843,7 +1263,7 @@ Buffer::Iterator::Write(Iterator start, Iterator end)
     if (start.m_current <= start.m_zeroEnd)
     {
         uint32_t toCopy = std::min(size, start.m_zeroEnd - start.m_current);
-        memset(&m_data[m_current], 0, toCopy);
+        start.ReadVirtual(&m_data[m_current], toCopy);
         start.m_current += toCopy;
         m_current += toCopy;
         size -= toCopy;
@@ -1125,9 +1545,31 @@ void
 Buffer::Iterator::Read(uint8_t* buffer, uint32_t size)
 {
     NS_LOG_FUNCTION(this << &buffer << size);
-    for (uint32_t i = 0; i < size; i++)
+    NS_ASSERT_MSG(m_current >= m_dataStart && m_current + size <= m_dataEnd,
+                  GetReadErrorMessage());
+    // copy each area at once, so that the chain of a scatter-gather buffer
+    // is walked once rather than for each byte
+    while (size > 0)
     {
-        buffer[i] = ReadU8();
+        uint32_t n;
+        if (m_current < m_zeroStart)
+        {
+            n = std::min(size, m_zeroStart - m_current);
+            memcpy(buffer, m_data + m_current, n);
+        }
+        else if (m_current < m_zeroEnd)
+        {
+            n = std::min(size, m_zeroEnd - m_current);
+            ReadVirtual(buffer, n);
+        }
+        else
+        {
+            n = size;
+            memcpy(buffer, m_data + m_current - (m_zeroEnd - m_zeroStart), n);
+        }
+        m_current += n;
+        buffer += n;
+        size -= n;
     }
 }
 
@@ -1138,21 +1580,70 @@ Buffer::Iterator::CalculateIpChecksum(uint16_t size)
     return CalculateIpChecksum(size, 0);
 }
 
+/**
+ * Add bytes to an Internet checksum, as 16-bit words read with
+ * Buffer::Iterator::ReadU16().
+ * \param [in,out] sum The sum of the words.
+ * \param [in,out] odd Whether the first byte is the second one of a word.
+ * \param [in] data The bytes.
+ * \param [in] size The number of bytes.
+ */
+static void
+AddToChecksum(uint64_t& sum, bool& odd, const uint8_t* data, uint32_t size)
+{
+    if (odd && size > 0)
+    {
+        sum += static_cast<uint32_t>(*data) << 8;
+        data++;
+        size--;
+        odd = false;
+    }
+    for (; size >= 2; size -= 2, data += 2)
+    {
+        sum += data[0] | (static_cast<uint32_t>(data[1]) << 8);
+    }
+    if (size > 0)
+    {
+        sum += *data;
+        odd = true;
+    }
+}
+
 uint16_t
 Buffer::Iterator::CalculateIpChecksum(uint16_t size, uint32_t initialChecksum)
 {
     NS_LOG_FUNCTION(this << size << initialChecksum);
+    NS_ASSERT_MSG(m_current >= m_dataStart && m_current + size <= m_dataEnd,
+                  GetReadErrorMessage());
     /* see RFC 1071 to understand this code. */
-    uint32_t sum = initialChecksum;
-
-    for (int j = 0; j < size / 2; j++)
-    {
-        sum += ReadU16();
-    }
+    uint64_t sum = initialChecksum;
+    bool odd = false;
 
-    if (size & 1)
+    // sum each area at once, and the virtual bytes by chunks, so that the
+    // generator or the chain of a buffer is not called for each byte
+    uint32_t remaining = size;
+    while (remaining > 0)
     {
-        sum += ReadU8();
+        uint32_t n;
+        if (m_current < m_zeroStart)
+        {
+            n = std::min(remaining, m_zeroStart - m_current);
+            AddToChecksum(sum, odd, m_data + m_current, n);
+        }
+        else if (m_current < m_zeroEnd)
+        {
+            uint8_t chunk[2048];
+            n = std::min({remaining, m_zeroEnd - m_current, uint32_t(sizeof(chunk))});
+            ReadVirtual(chunk, n);
+            AddToChecksum(sum, odd, chunk, n);
+        }
+        else
+        {
+            n = remaining;
+            AddToChecksum(sum, odd, m_data + m_current - (m_zeroEnd - m_zeroStart), n);
+        }
+        m_current += n;
+        remaining -= n;
     }
 
     while (sum >> 16)
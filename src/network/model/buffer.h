@@ -25,7 +25,13 @@
 #include <stdint.h>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#else
+// The free list is shared by every thread; it is disabled when packets
+// may be created and destroyed by several simulation threads.
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3
 {
@@ -89,6 +95,23 @@ namespace ns3
  * \endverbatim
  *
  * A simple state invariant is that m_start <= m_zeroStart <= m_zeroEnd <= m_end
+ *
+ * The virtual zero area may also hold a virtual payload which is not made
+ * of zeroes: a PayloadGenerator, shared by all the Buffer instances which
+ * reference the same BufferData, then computes its bytes whenever they are
+ * read, copied with CopyData or serialized.  Each Buffer records the offset
+ * of its zero area in the generated payload, so that fragments and
+ * concatenations of virtual payloads keep their content without
+ * allocating it.
+ *
+ * In the scatter-gather mode, enabled by EnableScatterGather(), the virtual
+ * zero area may also reference a chain of slices of other buffers, shared by
+ * reference rather than copied: AddAtEnd(const Buffer&) then chains the
+ * bytes of the appended buffer, and CreateFragment() returns a fragment
+ * which references the bytes of this buffer, so that the headers later
+ * added to the fragment do not copy its payload.  The iterators walk the
+ * segments of the chain transparently, and the chain is linearized only
+ * when a contiguous copy is needed, by PeekData() or the serialization.
  */
 class Buffer
 {
@@ -452,6 +475,14 @@ class Buffer
          * \returns the error message
          */
         std::string GetWriteErrorMessage() const;
+        /**
+         * \brief Read bytes of the "virtual zero area" without moving the
+         * Iterator.
+         *
+         * \param buffer the buffer to fill
+         * \param size the number of bytes to read, all of them in the zero area
+         */
+        void ReadVirtual(uint8_t* buffer, uint32_t size) const;
 
         /**
          * offset in virtual bytes from the start of the data buffer to the
@@ -478,6 +509,11 @@ class Buffer
          * current position represented by this iterator.
          */
         uint32_t m_current;
+        /**
+         * offset of the start of the "virtual zero area" in the payload
+         * generated by the PayloadGenerator of the buffer, or in its chain.
+         */
+        uint32_t m_payloadOffset;
         /**
          * a pointer to the underlying byte buffer. All offsets are relative
          * to this pointer.
@@ -485,11 +521,44 @@ class Buffer
         uint8_t* m_data;
     };
 
+    /**
+     * \brief Generate the bytes of a virtual payload.
+     *
+     * \param buffer the bytes to fill
+     * \param offset the offset in the payload of the first byte to fill
+     * \param size the number of bytes to fill
+     */
+    typedef void (*PayloadGenerator)(uint8_t* buffer, uint32_t offset, uint32_t size);
+
     /**
      * \return the number of bytes stored in this buffer.
      */
     inline uint32_t GetSize() const;
 
+    /**
+     * \return the number of bytes of the virtual payload of this buffer,
+     * which are not stored in memory.
+     */
+    inline uint32_t GetVirtualPayloadSize() const;
+
+    /**
+     * \brief Enable or disable the scatter-gather mode of the buffers.
+     *
+     * In this mode, the buffers concatenated with AddAtEnd(const Buffer&)
+     * and the fragments built by CreateFragment() reference the bytes of
+     * their source rather than copying them, unless they are smaller than
+     * a few hundred bytes and appended to a buffer which is not a chain.
+     * The mode is disabled by default, and changing it does not affect the
+     * existing buffers.
+     *
+     * \param enable true to enable the scatter-gather mode
+     */
+    static void EnableScatterGather(bool enable = true);
+    /**
+     * \returns true if the scatter-gather mode is enabled.
+     */
+    static bool IsScatterGatherEnabled();
+
     /**
      * \return a pointer to the start of the internal
      * byte buffer.
@@ -642,9 +711,25 @@ class Buffer
      * \param initialize initialize the buffer with zeroes.
      */
     Buffer(uint32_t dataSize, bool initialize);
+    /**
+     * \brief Constructor
+     *
+     * The buffer holds a virtual payload of its size, whose bytes are
+     * computed by the generator when they are read, copied or serialized.
+     *
+     * \param dataSize the buffer size
+     * \param generator the generator of the payload
+     */
+    Buffer(uint32_t dataSize, PayloadGenerator generator);
     ~Buffer();
 
   private:
+    /**
+     * The chain of buffer slices which holds the bytes of the virtual zero
+     * area of the buffers in the scatter-gather mode.
+     */
+    struct Chain;
+
     /**
      * This data structure is variable-sized through its last member whose size
      * is determined at allocation time and stored in the m_size field.
@@ -665,7 +750,11 @@ class Buffer
          * The reference count of an instance of this data structure.
          * Each buffer which references an instance holds a count.
          */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /**
          * the size of the m_data field below.
          */
@@ -680,6 +769,16 @@ class Buffer
          * end of the area in which user bytes were written.
          */
         uint32_t m_dirtyEnd;
+        /**
+         * the generator of the virtual zero area of the buffers which
+         * reference this data, or nullptr for zeroes.
+         */
+        PayloadGenerator m_generator;
+        /**
+         * the chain which holds the bytes of the virtual zero area of the
+         * buffers which reference this data, or nullptr.
+         */
+        Chain* m_chain;
         /**
          * The real data buffer holds _at least_ one byte.
          * Its real size is stored in the m_size field.
@@ -699,6 +798,69 @@ class Buffer
      * \brief Transform a "Virtual byte buffer" into a "Real byte buffer"
      */
     void TransformIntoRealBuffer() const;
+    /**
+     * \brief Create a fragment which shares the data of this buffer.
+     *
+     * \param start offset from the start of the buffer
+     * \param length the size of the fragment
+     * \returns the fragment
+     */
+    Buffer Slice(uint32_t start, uint32_t length) const;
+    /**
+     * \brief Append the bytes of a buffer to the chain of this buffer,
+     * creating the chain if needed.
+     *
+     * \param o the buffer to append
+     */
+    void AppendToChain(const Buffer& o);
+    /**
+     * \brief Create a buffer whose virtual zero area holds all the bytes of
+     * a chain.
+     *
+     * \param chain the chain, whose reference is taken by the buffer
+     * \returns the buffer
+     */
+    static Buffer CreateChainView(Chain* chain);
+    /**
+     * \brief Make a data use the payload generator and chain of another.
+     *
+     * \param to the data to update
+     * \param from the data to copy from
+     */
+    static void CopyPayloadSource(Buffer::Data* to, const Buffer::Data* from);
+    /**
+     * \brief Release a reference to a chain.
+     * \param chain the chain
+     */
+    static void ReleaseChain(Chain* chain);
+    /**
+     * \returns the number of bytes of the chained virtual zero area which
+     * are not stored in memory by the segments of the chain.
+     */
+    uint32_t GetChainedVirtualPayloadSize() const;
+    /**
+     * \brief Copy bytes of the buffer.
+     *
+     * \param buffer the buffer to fill
+     * \param offset the offset of the first byte from the start of this buffer
+     * \param size the number of bytes to copy, all of them in this buffer
+     */
+    void ReadAt(uint8_t* buffer, uint32_t offset, uint32_t size) const;
+    /**
+     * \brief Check if the virtual zero area holds a generated or chained
+     * payload.
+     * \returns true if the zero area is not empty and has a generator or a
+     * chain.
+     */
+    bool HasGeneratedPayload() const;
+    /**
+     * \brief Fill a buffer with bytes of the virtual zero area.
+     *
+     * \param buffer the buffer to fill
+     * \param offset the offset of the first byte from the start of the zero area
+     * \param size the number of bytes to fill
+     */
+    void ReadVirtual(uint8_t* buffer, uint32_t offset, uint32_t size) const;
     /**
      * \brief Checks the internal buffer structures consistency
      *
@@ -769,7 +931,13 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
+#ifdef NS3_MTP
+    static thread_local uint32_t g_recommendedStart;
+#else
     static uint32_t g_recommendedStart;
+#endif
+    /// Whether the scatter-gather mode is enabled
+    static bool g_scatterGather;
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -791,6 +959,11 @@ class Buffer
      * instance from the start of m_data->m_data
      */
     uint32_t m_end;
+    /**
+     * offset of the start of the virtual zero area in the payload
+     * generated by m_data->m_generator, or in m_data->m_chain
+     */
+    uint32_t m_payloadOffset;
 
 #ifdef BUFFER_FREE_LIST
     /// Container for buffer data
@@ -823,6 +996,7 @@ Buffer::Iterator::Iterator()
       m_dataStart(0),
       m_dataEnd(0),
       m_current(0),
+      m_payloadOffset(0),
       m_data(nullptr)
 {
 }
@@ -846,6 +1020,7 @@ Buffer::Iterator::Construct(const Buffer* buffer)
     m_zeroEnd = buffer->m_zeroAreaEnd;
     m_dataStart = buffer->m_start;
     m_dataEnd = buffer->m_end;
+    m_payloadOffset = buffer->m_payloadOffset;
     m_data = buffer->m_data->m_data;
 }
 
@@ -1014,7 +1189,9 @@ Buffer::Iterator::PeekU8()
     }
     else if (m_current < m_zeroEnd)
     {
-        return 0;
+        uint8_t data;
+        ReadVirtual(&data, 1);
+        return data;
     }
     else
     {
@@ -1058,7 +1235,8 @@ Buffer::Buffer(const Buffer& o)
       m_zeroAreaStart(o.m_zeroAreaStart),
       m_zeroAreaEnd(o.m_zeroAreaEnd),
       m_start(o.m_start),
-      m_end(o.m_end)
+      m_end(o.m_end),
+      m_payloadOffset(o.m_payloadOffset)
 {
     m_data->m_count++;
     NS_ASSERT(CheckInternalState());
@@ -1070,6 +1248,16 @@ Buffer::GetSize() const
     return m_end - m_start;
 }
 
+uint32_t
+Buffer::GetVirtualPayloadSize() const
+{
+    if (m_data->m_chain != nullptr)
+    {
+        return GetChainedVirtualPayloadSize();
+    }
+    return m_zeroAreaEnd - m_zeroAreaStart;
+}
+
 Buffer::Iterator
 Buffer::Begin() const
 {
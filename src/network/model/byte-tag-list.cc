@@ -24,7 +24,12 @@
 #include <limits>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#else
+// Disabled in multithreaded builds, as BUFFER_FREE_LIST (see buffer.h)
 #define USE_FREE_LIST 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max())
 
@@ -43,7 +48,11 @@ NS_LOG_COMPONENT_DEFINE("ByteTagList");
 struct ByteTagListData
 {
     uint32_t size;   //!< size of the data
+#ifdef NS3_MTP
+    std::atomic<uint32_t> count; //!< use counter (for smart deallocation)
+#else
     uint32_t count;  //!< use counter (for smart deallocation)
+#endif
     uint32_t dirty;  //!< number of bytes actually in use
     uint8_t data[4]; //!< data
 };
@@ -169,6 +178,10 @@ ByteTagList::ByteTagList(const ByteTagList& o)
     {
         m_data->count++;
     }
+    else
+    {
+        std::memcpy(m_inline, o.m_inline, m_used);
+    }
 }
 
 ByteTagList&
@@ -189,6 +202,10 @@ ByteTagList::operator=(const ByteTagList& o)
     {
         m_data->count++;
     }
+    else
+    {
+        std::memcpy(m_inline, o.m_inline, m_used);
+    }
     return *this;
 }
 
@@ -208,17 +225,27 @@ ByteTagList::Add(TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
     NS_ASSERT(m_used <= spaceNeeded);
     if (m_data == nullptr)
     {
-        m_data = Allocate(spaceNeeded);
-        m_used = 0;
+        if (spaceNeeded > INLINE_SIZE)
+        {
+            // the tags do not fit inline anymore
+            m_data = Allocate(spaceNeeded);
+            std::memcpy(&m_data->data, m_inline, m_used);
+        }
     }
+#ifdef NS3_MTP
+    // data shared with another list may be in use by another thread
+    else if (m_data->size < spaceNeeded || m_data->count != 1)
+#else
     else if (m_data->size < spaceNeeded || (m_data->count != 1 && m_data->dirty != m_used))
+#endif
     {
         ByteTagListData* newData = Allocate(spaceNeeded);
         std::memcpy(&newData->data, &m_data->data, m_used);
         Deallocate(m_data);
         m_data = newData;
     }
-    TagBuffer tag = TagBuffer(&m_data->data[m_used], &m_data->data[spaceNeeded]);
+    uint8_t* storage = GetStorage();
+    TagBuffer tag = TagBuffer(&storage[m_used], &storage[spaceNeeded]);
     tag.WriteU32(tid.GetUid());
     tag.WriteU32(bufferSize);
     tag.WriteU32(start - m_adjustment);
@@ -232,7 +259,10 @@ ByteTagList::Add(TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
         m_maxEnd = end - m_adjustment;
     }
     m_used = spaceNeeded;
-    m_data->dirty = m_used;
+    if (m_data != nullptr)
+    {
+        m_data->dirty = m_used;
+    }
     return tag;
 }
 
@@ -274,14 +304,14 @@ ByteTagList::Iterator
 ByteTagList::Begin(int32_t offsetStart, int32_t offsetEnd) const
 {
     NS_LOG_FUNCTION(this << offsetStart << offsetEnd);
-    if (m_data == nullptr)
-    {
-        return Iterator(nullptr, nullptr, offsetStart, offsetEnd, 0);
-    }
-    else
-    {
-        return Iterator(m_data->data, &m_data->data[m_used], offsetStart, offsetEnd, m_adjustment);
-    }
+    uint8_t* storage = GetStorage();
+    return Iterator(storage, &storage[m_used], offsetStart, offsetEnd, m_adjustment);
+}
+
+uint8_t*
+ByteTagList::GetStorage() const
+{
+    return m_data != nullptr ? m_data->data : const_cast<uint8_t*>(m_inline);
 }
 
 void
@@ -386,8 +416,7 @@ ByteTagList::Deallocate(ByteTagListData* data)
         return;
     }
     g_maxSize = std::max(g_maxSize, data->size);
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         if (g_freeList.size() > FREE_LIST_SIZE || data->size < g_maxSize)
         {
@@ -423,8 +452,7 @@ ByteTagList::Deallocate(ByteTagListData* data)
     {
         return;
     }
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         uint8_t* buffer = (uint8_t*)data;
         delete[] buffer;
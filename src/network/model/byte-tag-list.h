@@ -47,9 +47,14 @@ struct ByteTagListData;
  *     as 4 32bit integers (TypeId, tag data size, start, end) followed
  *     by the tag data as generated by Tag::Serialize.
  *
- *   - The struct ByteTagListData structure which contains the tag byte buffer
- *     is shared and, thus, reference-counted. This data structure is unshared
- *     as-needed to emulate COW semantics.
+ *   - The first #INLINE_SIZE bytes of the buffer are stored in the
+ *     ByteTagList itself, and thus in the Packet: adding the first tags
+ *     does not allocate.  Copies copy these bytes.
+ *
+ *   - When the tags do not fit inline, they are moved to a
+ *     struct ByteTagListData structure, which contains the tag byte buffer
+ *     and is shared and, thus, reference-counted. This data structure is
+ *     unshared as-needed to emulate COW semantics.
  *
  *   - Each tag tags a unique set of bytes identified by the pair of offsets
  *     (start,end). These offsets are relative to the start of the packet
@@ -65,6 +70,9 @@ struct ByteTagListData;
 class ByteTagList
 {
   public:
+    /** The number of bytes of tags stored inline. */
+    static constexpr uint32_t INLINE_SIZE = 48;
+
     /**
      * \brief An iterator for iterating through a byte tag list
      *
@@ -283,11 +291,18 @@ class ByteTagList
      */
     void Deallocate(ByteTagListData* data);
 
-    int32_t m_minStart;      //!< minimal start offset
-    int32_t m_maxEnd;        //!< maximal end offset
-    int32_t m_adjustment;    //!< adjustment to byte tag offsets
-    uint32_t m_used;         //!< the number of used bytes in the buffer
-    ByteTagListData* m_data; //!< the ByteTagListData structure
+    /**
+     * \brief Get the byte buffer of the tags
+     * \returns the ByteTagListData buffer, or the inline buffer if there is none
+     */
+    uint8_t* GetStorage() const;
+
+    int32_t m_minStart;            //!< minimal start offset
+    int32_t m_maxEnd;              //!< maximal end offset
+    int32_t m_adjustment;          //!< adjustment to byte tag offsets
+    uint32_t m_used;               //!< the number of used bytes in the buffer
+    ByteTagListData* m_data;       //!< the ByteTagListData structure, if any
+    uint8_t m_inline[INLINE_SIZE]; //!< the buffer of the tags which fit inline
 };
 
 void
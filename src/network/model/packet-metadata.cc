@@ -23,9 +23,13 @@
 #include "trailer.h"
 
 #include "ns3/assert.h"
+#include "ns3/enum.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
 
+#include <algorithm>
 #include <list>
 #include <utility>
 
@@ -36,10 +40,53 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
+PacketMetadata::Engine PacketMetadata::m_engine = PacketMetadata::LIST;
+#ifdef NS3_MTP
+thread_local bool PacketMetadata::m_metadataSkipped = false;
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+std::atomic<uint16_t> PacketMetadata::m_chunkUid = 0;
+#else
 bool PacketMetadata::m_metadataSkipped = false;
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
+#endif
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+PacketMetadata::NodeArena PacketMetadata::m_arena;
+
+/**
+ * \ingroup packet
+ * \anchor GlobalValuePacketMetadataEngine
+ * The representation of the packet metadata.
+ *
+ * This is read by PacketMetadata::Enable().
+ */
+static GlobalValue g_packetMetadataEngine(
+    "PacketMetadataEngine",
+    "The representation of the packet metadata: a copy-on-write list of items, "
+    "or a tree of items shared by the copies of the packets",
+    EnumValue(PacketMetadata::LIST),
+    MakeEnumChecker(PacketMetadata::LIST, "List", PacketMetadata::ARENA, "Arena"));
+
+/** The number of nodes allocated at once by the arena of the ARENA engine. */
+static constexpr uint32_t NODES_PER_BLOCK = 512;
+
+/**
+ * \ingroup packet
+ * The MemoryAccounting category of the allocated PacketMetadata::Data, in
+ * use or in the free list.
+ */
+static const uint32_t g_metadataMemory = MemoryAccounting::RegisterCategory("PacketMetadata::Data");
+/**
+ * \ingroup packet
+ * The MemoryAccounting category of the PacketMetadata::Data in the free list.
+ */
+static const uint32_t g_metadataFreeListMemory =
+    MemoryAccounting::RegisterCategory("PacketMetadata::Data (free list)");
+/**
+ * \ingroup packet
+ * The MemoryAccounting category of the PacketMetadata::Node in use.
+ */
+static const uint32_t g_nodeMemory = MemoryAccounting::RegisterCategory("PacketMetadata::Node");
 
 PacketMetadata::DataFreeList::~DataFreeList()
 {
@@ -51,10 +98,26 @@ PacketMetadata::DataFreeList::~DataFreeList()
     PacketMetadata::m_enable = false;
 }
 
+PacketMetadata::NodeArena::~NodeArena()
+{
+    NS_LOG_FUNCTION(this);
+    // the nodes still referenced by static packets are leaked with their block
+    if (m_live == 0)
+    {
+        for (auto block : m_blocks)
+        {
+            delete[] block;
+        }
+    }
+}
+
 void
 PacketMetadata::Enable()
 {
     NS_LOG_FUNCTION_NOARGS();
+    EnumValue<Engine> engine;
+    g_packetMetadataEngine.GetValue(engine);
+    m_engine = engine.Get();
     NS_ASSERT_MSG(!m_metadataSkipped,
                   "Error: attempting to enable the packet metadata "
                   "subsystem too late in the simulation, which is not allowed.\n"
@@ -73,6 +136,26 @@ PacketMetadata::EnableChecking()
     m_enableChecking = true;
 }
 
+void
+PacketMetadata::SetEngine(Engine engine)
+{
+    NS_LOG_FUNCTION(engine);
+    g_packetMetadataEngine.SetValue(EnumValue(engine));
+    m_engine = engine;
+}
+
+PacketMetadata::Engine
+PacketMetadata::GetEngine()
+{
+    return m_engine;
+}
+
+uint64_t
+PacketMetadata::GetArenaNodes()
+{
+    return m_arena.m_live;
+}
+
 void
 PacketMetadata::ReserveCopy(uint32_t size)
 {
@@ -80,8 +163,7 @@ PacketMetadata::ReserveCopy(uint32_t size)
     PacketMetadata::Data* newData = PacketMetadata::Create(m_used + size);
     memcpy(newData->m_data, m_data->m_data, m_used);
     newData->m_dirtyEnd = m_used;
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
@@ -104,8 +186,13 @@ PacketMetadata::Reserve(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
     NS_ASSERT(m_data != nullptr);
+#ifdef NS3_MTP
+    // data shared with another packet may be in use by another thread
+    if (m_data->m_size >= m_used + size && (m_head == 0xffff || m_data->m_count == 1))
+#else
     if (m_data->m_size >= m_used + size &&
         (m_head == 0xffff || m_data->m_count == 1 || m_data->m_dirtyEnd == m_used))
+#endif
     {
         /* enough room, not dirty. */
     }
@@ -132,10 +219,42 @@ PacketMetadata::IsPointerOk(uint16_t pointer) const
     return ok;
 }
 
+bool
+PacketMetadata::IsNodeOk(const Node* node)
+{
+    if (node == nullptr)
+    {
+        return true;
+    }
+    if (node->m_count == 0)
+    {
+        return false;
+    }
+    if (node->m_left == nullptr)
+    {
+        return node->m_right == nullptr && node->m_items == 1 && node->m_height == 0 &&
+               (node->m_item.typeUid & 0x1) == 0 &&
+               node->m_extraItem.fragmentStart <= node->m_extraItem.fragmentEnd &&
+               node->m_extraItem.fragmentEnd <= node->m_item.size &&
+               node->m_size == node->m_extraItem.fragmentEnd - node->m_extraItem.fragmentStart;
+    }
+    const Node* left = node->m_left;
+    const Node* right = node->m_right;
+    return right != nullptr && node->m_size == left->m_size + right->m_size &&
+           node->m_items == left->m_items + right->m_items &&
+           node->m_height == std::max(left->m_height, right->m_height) + 1 &&
+           GetHeight(left) - GetHeight(right) <= 1 && GetHeight(right) - GetHeight(left) <= 1 &&
+           IsNodeOk(left) && IsNodeOk(right);
+}
+
 bool
 PacketMetadata::IsStateOk() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_data == nullptr)
+    {
+        return IsNodeOk(m_root);
+    }
     bool ok = m_used <= m_data->m_size;
     ok &= IsPointerOk(m_head);
     ok &= IsPointerOk(m_tail);
@@ -384,8 +503,12 @@ PacketMetadata::AddSmall(const PacketMetadata::SmallItem* item)
     uint32_t typeUidSize = GetUleb128Size(item->typeUid);
     uint32_t sizeSize = GetUleb128Size(item->size);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2;
+#ifdef NS3_MTP
+    if (m_used + n > m_data->m_size || (m_head != 0xffff && m_data->m_count != 1))
+#else
     if (m_used + n > m_data->m_size ||
         (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
+#endif
     {
         ReserveCopy(n);
     }
@@ -421,8 +544,12 @@ PacketMetadata::AddBig(uint32_t next,
     uint32_t fragEndSize = GetUleb128Size(extraItem->fragmentEnd);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
 
+#ifdef NS3_MTP
+    if (m_used + n > m_data->m_size || (m_head != 0xffff && m_data->m_count != 1))
+#else
     if (m_used + n > m_data->m_size ||
         (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
+#endif
     {
         ReserveCopy(n);
     }
@@ -572,10 +699,13 @@ PacketMetadata::Create(uint32_t size)
     {
         m_maxSize = size;
     }
+#ifndef NS3_MTP
+    // the free list is shared by all threads: it is not used in multithreaded builds
     while (!m_freeList.empty())
     {
         PacketMetadata::Data* data = m_freeList.back();
         m_freeList.pop_back();
+        MemoryAccounting::Released(g_metadataFreeListMemory, GetAllocationSize(data->m_size));
         if (data->m_size >= size)
         {
             NS_LOG_LOGIC("create found size=" << data->m_size);
@@ -585,6 +715,7 @@ PacketMetadata::Create(uint32_t size)
         NS_LOG_LOGIC("create dealloc size=" << data->m_size);
         PacketMetadata::Deallocate(data);
     }
+#endif
     NS_LOG_LOGIC("create alloc size=" << m_maxSize);
     return PacketMetadata::Allocate(m_maxSize);
 }
@@ -593,6 +724,10 @@ void
 PacketMetadata::Recycle(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
+#ifdef NS3_MTP
+    // the free list is shared by all threads: it is not used in multithreaded builds
+    PacketMetadata::Deallocate(data);
+#else
     if (!m_enable)
     {
         PacketMetadata::Deallocate(data);
@@ -607,24 +742,26 @@ PacketMetadata::Recycle(PacketMetadata::Data* data)
     else
     {
         m_freeList.push_back(data);
+        MemoryAccounting::Allocated(g_metadataFreeListMemory, GetAllocationSize(data->m_size));
     }
+#endif
 }
 
 PacketMetadata::Data*
 PacketMetadata::Allocate(uint32_t n)
 {
     NS_LOG_FUNCTION(n);
-    uint32_t size = sizeof(Data);
     if (n <= PACKET_METADATA_DATA_M_DATA_SIZE)
     {
         n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
-    size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
+    uint32_t size = GetAllocationSize(n);
     auto buf = new uint8_t[size];
     auto data = (PacketMetadata::Data*)buf;
     data->m_size = n;
     data->m_count = 1;
     data->m_dirtyEnd = 0;
+    MemoryAccounting::Allocated(g_metadataMemory, size);
     return data;
 }
 
@@ -632,10 +769,392 @@ void
 PacketMetadata::Deallocate(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
+    MemoryAccounting::Released(g_metadataMemory, GetAllocationSize(data->m_size));
     auto buf = (uint8_t*)data;
     delete[] buf;
 }
 
+uint32_t
+PacketMetadata::GetAllocationSize(uint32_t n)
+{
+    return sizeof(Data) + n - PACKET_METADATA_DATA_M_DATA_SIZE;
+}
+
+PacketMetadata::Node*
+PacketMetadata::AllocateNode()
+{
+    MemoryAccounting::Allocated(g_nodeMemory, sizeof(Node));
+#ifdef NS3_MTP
+    // the arena is shared by all threads: it is not used in multithreaded builds
+    m_arena.m_live.fetch_add(1, std::memory_order_relaxed);
+    return new Node;
+#else
+    if (m_arena.m_free == nullptr)
+    {
+        NS_LOG_LOGIC("allocate a block of " << NODES_PER_BLOCK << " nodes");
+        auto block = new Node[NODES_PER_BLOCK];
+        m_arena.m_blocks.push_back(block);
+        for (uint32_t i = 0; i < NODES_PER_BLOCK; ++i)
+        {
+            block[i].m_right = m_arena.m_free;
+            m_arena.m_free = &block[i];
+        }
+    }
+    Node* node = m_arena.m_free;
+    m_arena.m_free = node->m_right;
+    m_arena.m_live++;
+    return node;
+#endif
+}
+
+void
+PacketMetadata::DestroyNode(Node* node)
+{
+    NS_ASSERT(node->m_count == 0);
+    Unref(node->m_left);
+    Unref(node->m_right);
+    MemoryAccounting::Released(g_nodeMemory, sizeof(Node));
+#ifdef NS3_MTP
+    m_arena.m_live.fetch_sub(1, std::memory_order_relaxed);
+    delete node;
+#else
+    node->m_right = m_arena.m_free;
+    m_arena.m_free = node;
+    m_arena.m_live--;
+#endif
+}
+
+PacketMetadata::Node*
+PacketMetadata::CreateItemNode(const PacketMetadata::SmallItem* item,
+                               const PacketMetadata::ExtraItem* extraItem)
+{
+    Node* node = AllocateNode();
+    node->m_count = 1;
+    node->m_size = extraItem->fragmentEnd - extraItem->fragmentStart;
+    node->m_items = 1;
+    node->m_height = 0;
+    node->m_left = nullptr;
+    node->m_right = nullptr;
+    node->m_item = *item;
+    node->m_item.next = 0xffff;
+    node->m_item.prev = 0xffff;
+    // the fragment and packet uid are always stored
+    node->m_item.typeUid &= 0xfffffffe;
+    node->m_extraItem = *extraItem;
+    return node;
+}
+
+PacketMetadata::Node*
+PacketMetadata::CreateConcatNode(Node* left, Node* right)
+{
+    Node* node = AllocateNode();
+    node->m_count = 1;
+    node->m_size = left->m_size + right->m_size;
+    node->m_items = left->m_items + right->m_items;
+    node->m_height = std::max(left->m_height, right->m_height) + 1;
+    node->m_left = left;
+    node->m_right = right;
+    return node;
+}
+
+PacketMetadata::Node*
+PacketMetadata::Join(Node* left, Node* right)
+{
+    if (left == nullptr)
+    {
+        return right;
+    }
+    if (right == nullptr)
+    {
+        return left;
+    }
+    if (GetHeight(left) > GetHeight(right) + 1)
+    {
+        // join along the right spine of the left tree, then rebalance
+        Node* leftLeft = Ref(left->m_left);
+        Node* joined = Join(Ref(left->m_right), right);
+        Unref(left);
+        if (GetHeight(joined) <= GetHeight(leftLeft) + 1)
+        {
+            return CreateConcatNode(leftLeft, joined);
+        }
+        Node* joinedLeft = Ref(joined->m_left);
+        Node* joinedRight = Ref(joined->m_right);
+        Unref(joined);
+        if (GetHeight(joinedLeft) <= GetHeight(joinedRight))
+        {
+            return CreateConcatNode(CreateConcatNode(leftLeft, joinedLeft), joinedRight);
+        }
+        Node* innerLeft = Ref(joinedLeft->m_left);
+        Node* innerRight = Ref(joinedLeft->m_right);
+        Unref(joinedLeft);
+        return CreateConcatNode(CreateConcatNode(leftLeft, innerLeft),
+                                CreateConcatNode(innerRight, joinedRight));
+    }
+    if (GetHeight(right) > GetHeight(left) + 1)
+    {
+        // join along the left spine of the right tree, then rebalance
+        Node* rightRight = Ref(right->m_right);
+        Node* joined = Join(left, Ref(right->m_left));
+        Unref(right);
+        if (GetHeight(joined) <= GetHeight(rightRight) + 1)
+        {
+            return CreateConcatNode(joined, rightRight);
+        }
+        Node* joinedLeft = Ref(joined->m_left);
+        Node* joinedRight = Ref(joined->m_right);
+        Unref(joined);
+        if (GetHeight(joinedRight) <= GetHeight(joinedLeft))
+        {
+            return CreateConcatNode(joinedLeft, CreateConcatNode(joinedRight, rightRight));
+        }
+        Node* innerLeft = Ref(joinedRight->m_left);
+        Node* innerRight = Ref(joinedRight->m_right);
+        Unref(joinedRight);
+        return CreateConcatNode(CreateConcatNode(joinedLeft, innerLeft),
+                                CreateConcatNode(innerRight, rightRight));
+    }
+    return CreateConcatNode(left, right);
+}
+
+std::pair<PacketMetadata::Node*, PacketMetadata::Node*>
+PacketMetadata::Split(Node* node, uint32_t items)
+{
+    if (items == 0)
+    {
+        return {nullptr, node == nullptr ? nullptr : Ref(node)};
+    }
+    NS_ASSERT(items <= node->m_items);
+    if (items == node->m_items)
+    {
+        return {Ref(node), nullptr};
+    }
+    uint32_t leftItems = node->m_left->m_items;
+    if (items == leftItems)
+    {
+        return {Ref(node->m_left), Ref(node->m_right)};
+    }
+    if (items < leftItems)
+    {
+        auto [left, right] = Split(node->m_left, items);
+        return {left, Join(right, Ref(node->m_right))};
+    }
+    auto [left, right] = Split(node->m_right, items - leftItems);
+    return {Join(Ref(node->m_left), left), right};
+}
+
+const PacketMetadata::Node*
+PacketMetadata::GetNodeItem(uint32_t index) const
+{
+    NS_ASSERT(m_root != nullptr && index < m_root->m_items);
+    const Node* node = m_root;
+    while (node->m_left != nullptr)
+    {
+        if (index < node->m_left->m_items)
+        {
+            node = node->m_left;
+        }
+        else
+        {
+            index -= node->m_left->m_items;
+            node = node->m_right;
+        }
+    }
+    return node;
+}
+
+void
+PacketMetadata::RemoveNodeBytes(uint32_t size, bool fromStart)
+{
+    NS_LOG_FUNCTION(this << size << fromStart);
+    if (size == 0)
+    {
+        return;
+    }
+    NS_ASSERT(m_root != nullptr && size <= m_root->m_size);
+    if (m_root == nullptr || size > m_root->m_size)
+    {
+        Unref(m_root);
+        m_root = nullptr;
+        return;
+    }
+    // Find the item in which the cut falls, and the number of items
+    // before it, all of which are removed.
+    const Node* node = m_root;
+    uint32_t leftToRemove = size;
+    uint32_t removed = 0;
+    while (node->m_left != nullptr)
+    {
+        const Node* near = fromStart ? node->m_left : node->m_right;
+        if (near->m_size >= leftToRemove)
+        {
+            node = near;
+        }
+        else
+        {
+            leftToRemove -= near->m_size;
+            removed += near->m_items;
+            node = fromStart ? node->m_right : node->m_left;
+        }
+    }
+    if (node->m_size == leftToRemove)
+    {
+        removed++;
+        leftToRemove = 0;
+    }
+    uint32_t items = m_root->m_items;
+    auto [left, right] = Split(m_root, fromStart ? removed : items - removed);
+    Node* kept = fromStart ? right : left;
+    Unref(fromStart ? left : right);
+    if (leftToRemove > 0)
+    {
+        // fragment the item in which the cut falls
+        auto [keptLeft, keptRight] = Split(kept, fromStart ? 1 : kept->m_items - 1);
+        Node* item = fromStart ? keptLeft : keptRight;
+        PacketMetadata::ExtraItem extraItem = item->m_extraItem;
+        if (fromStart)
+        {
+            extraItem.fragmentStart += leftToRemove;
+        }
+        else
+        {
+            extraItem.fragmentEnd -= leftToRemove;
+        }
+        Node* fragment = CreateItemNode(&item->m_item, &extraItem);
+        Unref(item);
+        Unref(kept);
+        kept = fromStart ? Join(fragment, keptRight) : Join(keptLeft, fragment);
+    }
+    Unref(m_root);
+    m_root = kept;
+    NS_ASSERT(IsStateOk());
+}
+
+void
+PacketMetadata::RemoveNodeChunk(uint32_t uid, uint32_t size, bool isHeader)
+{
+    NS_LOG_FUNCTION(this << uid << size << isHeader);
+    const Node* item = nullptr;
+    if (m_root != nullptr)
+    {
+        item = GetNodeItem(isHeader ? 0 : m_root->m_items - 1);
+    }
+    if (item == nullptr || item->m_item.typeUid != uid || item->m_item.size != size)
+    {
+        if (m_enableChecking)
+        {
+            NS_FATAL_ERROR("Removing unexpected " << (isHeader ? "header." : "trailer."));
+        }
+        return;
+    }
+    else if (item->m_extraItem.fragmentStart != 0 || item->m_extraItem.fragmentEnd != size)
+    {
+        if (m_enableChecking)
+        {
+            NS_FATAL_ERROR("Removing incomplete " << (isHeader ? "header." : "trailer."));
+        }
+        return;
+    }
+    auto [left, right] = Split(m_root, isHeader ? 1 : m_root->m_items - 1);
+    Unref(m_root);
+    m_root = isHeader ? right : left;
+    Unref(isHeader ? left : right);
+    NS_ASSERT(IsStateOk());
+}
+
+void
+PacketMetadata::AddNodesAtEnd(const PacketMetadata& o)
+{
+    NS_LOG_FUNCTION(this << &o);
+    if (o.m_root == nullptr)
+    {
+        // we have nothing to append.
+        return;
+    }
+    if (m_root == nullptr)
+    {
+        // We have no items so 'AddAtEnd' is
+        // equivalent to self-assignment.
+        *this = o;
+        return;
+    }
+    const Node* tail = GetNodeItem(m_root->m_items - 1);
+    const Node* head = o.GetNodeItem(0);
+    Node* root;
+    if (head->m_extraItem.packetUid == tail->m_extraItem.packetUid &&
+        head->m_item.typeUid == tail->m_item.typeUid &&
+        head->m_item.chunkUid == tail->m_item.chunkUid &&
+        head->m_item.size == tail->m_item.size &&
+        head->m_extraItem.fragmentStart == tail->m_extraItem.fragmentEnd)
+    {
+        /* If the previous tail came from the same header as
+         * the head of the next packet, we merge them.
+         */
+        PacketMetadata::ExtraItem extraItem = tail->m_extraItem;
+        extraItem.fragmentEnd = head->m_extraItem.fragmentEnd;
+        Node* merged = CreateItemNode(&tail->m_item, &extraItem);
+        auto [left, oldTail] = Split(m_root, m_root->m_items - 1);
+        auto [oldHead, right] = Split(o.m_root, 1);
+        Unref(oldTail);
+        Unref(oldHead);
+        root = Join(Join(left, merged), right);
+    }
+    else
+    {
+        root = Join(Ref(m_root), Ref(o.m_root));
+    }
+    Unref(m_root);
+    m_root = root;
+    NS_ASSERT(IsStateOk());
+}
+
+void
+PacketMetadata::AppendItem(const PacketMetadata::SmallItem* item,
+                           const PacketMetadata::ExtraItem* extraItem)
+{
+    NS_LOG_FUNCTION(this << item->typeUid << item->size << item->chunkUid
+                         << extraItem->fragmentStart << extraItem->fragmentEnd
+                         << extraItem->packetUid);
+    if (m_data == nullptr)
+    {
+        m_root = Join(m_root, CreateItemNode(item, extraItem));
+        return;
+    }
+    uint16_t written = AddBig(0xffff, m_tail, item, extraItem);
+    UpdateTail(written);
+}
+
+PacketMetadata
+PacketMetadata::ConvertTo(Engine engine) const
+{
+    NS_LOG_FUNCTION(this << engine);
+    PacketMetadata copy(m_packetUid, engine);
+    if (m_data == nullptr)
+    {
+        uint32_t items = m_root == nullptr ? 0 : m_root->m_items;
+        for (uint32_t i = 0; i < items; ++i)
+        {
+            const Node* node = GetNodeItem(i);
+            copy.AppendItem(&node->m_item, &node->m_extraItem);
+        }
+        return copy;
+    }
+    uint16_t current = m_head;
+    while (current != 0xffff)
+    {
+        PacketMetadata::SmallItem item;
+        PacketMetadata::ExtraItem extraItem;
+        ReadItems(current, &item, &extraItem);
+        copy.AppendItem(&item, &extraItem);
+        if (current == m_tail)
+        {
+            break;
+        }
+        current = item.next;
+    }
+    return copy;
+}
+
 PacketMetadata
 PacketMetadata::CreateFragment(uint32_t start, uint32_t end) const
 {
@@ -670,8 +1189,13 @@ PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
     item.prev = 0xffff;
     item.typeUid = uid;
     item.size = size;
-    item.chunkUid = m_chunkUid;
-    m_chunkUid++;
+    item.chunkUid = m_chunkUid++;
+    if (m_data == nullptr)
+    {
+        PacketMetadata::ExtraItem extraItem = {0, size, m_packetUid};
+        m_root = Join(CreateItemNode(&item, &extraItem), m_root);
+        return;
+    }
     uint16_t written = AddSmall(&item);
     UpdateHead(written);
 }
@@ -686,6 +1210,11 @@ PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
         m_metadataSkipped = true;
         return;
     }
+    if (m_data == nullptr)
+    {
+        RemoveNodeChunk(uid, size, true);
+        return;
+    }
     PacketMetadata::SmallItem item;
     PacketMetadata::ExtraItem extraItem;
     uint32_t read = ReadItems(m_head, &item, &extraItem);
@@ -736,8 +1265,14 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
     item.prev = m_tail;
     item.typeUid = uid;
     item.size = size;
-    item.chunkUid = m_chunkUid;
-    m_chunkUid++;
+    item.chunkUid = m_chunkUid++;
+    if (m_data == nullptr)
+    {
+        PacketMetadata::ExtraItem extraItem = {0, size, m_packetUid};
+        m_root = Join(m_root, CreateItemNode(&item, &extraItem));
+        NS_ASSERT(IsStateOk());
+        return;
+    }
     uint16_t written = AddSmall(&item);
     UpdateTail(written);
     NS_ASSERT(IsStateOk());
@@ -753,6 +1288,11 @@ PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
         m_metadataSkipped = true;
         return;
     }
+    if (m_data == nullptr)
+    {
+        RemoveNodeChunk(uid, size, false);
+        return;
+    }
     PacketMetadata::SmallItem item;
     PacketMetadata::ExtraItem extraItem;
     uint32_t read = ReadItems(m_tail, &item, &extraItem);
@@ -797,6 +1337,17 @@ PacketMetadata::AddAtEnd(const PacketMetadata& o)
         m_metadataSkipped = true;
         return;
     }
+    if ((m_data == nullptr) != (o.m_data == nullptr))
+    {
+        // the packets were created with different engines
+        AddAtEnd(o.ConvertTo(m_data == nullptr ? ARENA : LIST));
+        return;
+    }
+    if (m_data == nullptr)
+    {
+        AddNodesAtEnd(o);
+        return;
+    }
     if (m_tail == 0xffff)
     {
         // We have no items so 'AddAtEnd' is
@@ -884,7 +1435,11 @@ PacketMetadata::RemoveAtStart(uint32_t start)
         m_metadataSkipped = true;
         return;
     }
-    NS_ASSERT(m_data != nullptr);
+    if (m_data == nullptr)
+    {
+        RemoveNodeBytes(start, true);
+        return;
+    }
     uint32_t leftToRemove = start;
     uint16_t current = m_head;
     while (current != 0xffff && leftToRemove > 0)
@@ -945,7 +1500,11 @@ PacketMetadata::RemoveAtEnd(uint32_t end)
         m_metadataSkipped = true;
         return;
     }
-    NS_ASSERT(m_data != nullptr);
+    if (m_data == nullptr)
+    {
+        RemoveNodeBytes(end, false);
+        return;
+    }
 
     uint32_t leftToRemove = end;
     uint16_t current = m_tail;
@@ -1041,7 +1600,8 @@ PacketMetadata::ItemIterator::ItemIterator(const PacketMetadata* metadata, Buffe
       m_buffer(buffer),
       m_current(metadata->m_head),
       m_offset(0),
-      m_hasReadTail(false)
+      m_hasReadTail(false),
+      m_index(0)
 {
     NS_LOG_FUNCTION(this << metadata << &buffer);
 }
@@ -1050,6 +1610,10 @@ bool
 PacketMetadata::ItemIterator::HasNext() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_metadata->m_data == nullptr)
+    {
+        return m_metadata->m_root != nullptr && m_index < m_metadata->m_root->m_items;
+    }
     if (m_current == 0xffff)
     {
         return false;
@@ -1068,12 +1632,21 @@ PacketMetadata::ItemIterator::Next()
     PacketMetadata::Item item;
     PacketMetadata::SmallItem smallItem;
     PacketMetadata::ExtraItem extraItem;
-    m_metadata->ReadItems(m_current, &smallItem, &extraItem);
-    if (m_current == m_metadata->m_tail)
+    if (m_metadata->m_data == nullptr)
+    {
+        const PacketMetadata::Node* node = m_metadata->GetNodeItem(m_index++);
+        smallItem = node->m_item;
+        extraItem = node->m_extraItem;
+    }
+    else
     {
-        m_hasReadTail = true;
+        m_metadata->ReadItems(m_current, &smallItem, &extraItem);
+        if (m_current == m_metadata->m_tail)
+        {
+            m_hasReadTail = true;
+        }
+        m_current = smallItem.next;
     }
-    m_current = smallItem.next;
     uint32_t uid = (smallItem.typeUid & 0xfffffffe) >> 1;
     item.tid.SetUid(uid);
     item.currentTrimmedFromStart = extraItem.fragmentStart;
@@ -1129,24 +1702,23 @@ PacketMetadata::GetSerializedSize() const
         return totalSize;
     }
 
+    if (m_data == nullptr)
+    {
+        uint32_t items = m_root == nullptr ? 0 : m_root->m_items;
+        for (uint32_t i = 0; i < items; ++i)
+        {
+            totalSize += GetItemSerializedSize(&GetNodeItem(i)->m_item);
+        }
+        return totalSize;
+    }
+
     PacketMetadata::SmallItem item;
     PacketMetadata::ExtraItem extraItem;
     uint32_t current = m_head;
     while (current != 0xffff)
     {
         ReadItems(current, &item, &extraItem);
-        uint32_t uid = (item.typeUid & 0xfffffffe) >> 1;
-        if (uid == 0)
-        {
-            totalSize += 4;
-        }
-        else
-        {
-            TypeId tid;
-            tid.SetUid(uid);
-            totalSize += 4 + tid.GetName().size();
-        }
-        totalSize += 1 + 4 + 2 + 4 + 4 + 8;
+        totalSize += GetItemSerializedSize(&item);
         if (current == m_tail)
         {
             break;
@@ -1169,98 +1741,148 @@ PacketMetadata::Serialize(uint8_t* buffer, uint32_t maxSize) const
         return 0;
     }
 
-    PacketMetadata::SmallItem item;
-    PacketMetadata::ExtraItem extraItem;
-    uint32_t current = m_head;
-    while (current != 0xffff)
+    if (m_data == nullptr)
     {
-        ReadItems(current, &item, &extraItem);
-        NS_LOG_LOGIC("bytesWritten=" << static_cast<uint32_t>(buffer - start)
-                                     << ", typeUid=" << item.typeUid << ", size=" << item.size
-                                     << ", chunkUid=" << item.chunkUid
-                                     << ", fragmentStart=" << extraItem.fragmentStart
-                                     << ", fragmentEnd=" << extraItem.fragmentEnd
-                                     << ", packetUid=" << extraItem.packetUid);
-
-        uint32_t uid = (item.typeUid & 0xfffffffe) >> 1;
-        if (uid != 0)
+        uint32_t items = m_root == nullptr ? 0 : m_root->m_items;
+        for (uint32_t i = 0; i < items; ++i)
         {
-            TypeId tid;
-            tid.SetUid(uid);
-            std::string uidString = tid.GetName();
-            uint32_t uidStringSize = uidString.size();
-            buffer = AddToRawU32(uidStringSize, start, buffer, maxSize);
-            if (buffer == nullptr)
-            {
-                return 0;
-            }
-            buffer = AddToRaw(reinterpret_cast<const uint8_t*>(uidString.c_str()),
-                              uidStringSize,
-                              start,
-                              buffer,
-                              maxSize);
-            if (buffer == nullptr)
-            {
-                return 0;
-            }
-        }
-        else
-        {
-            buffer = AddToRawU32(0, start, buffer, maxSize);
+            const Node* node = GetNodeItem(i);
+            // The nodes have no short form: the isBig flag is always clear
+            buffer = SerializeItem(&node->m_item, &node->m_extraItem, start, buffer, maxSize);
             if (buffer == nullptr)
             {
                 return 0;
             }
         }
+    }
 
-        uint8_t isBig = item.typeUid & 0x1;
-        buffer = AddToRawU8(isBig, start, buffer, maxSize);
+    PacketMetadata::SmallItem item;
+    PacketMetadata::ExtraItem extraItem;
+    uint32_t current = m_head;
+    while (current != 0xffff)
+    {
+        ReadItems(current, &item, &extraItem);
+        buffer = SerializeItem(&item, &extraItem, start, buffer, maxSize);
         if (buffer == nullptr)
         {
             return 0;
         }
 
-        buffer = AddToRawU32(item.size, start, buffer, maxSize);
-        if (buffer == nullptr)
+        if (current == m_tail)
         {
-            return 0;
+            break;
         }
 
-        buffer = AddToRawU16(item.chunkUid, start, buffer, maxSize);
-        if (buffer == nullptr)
-        {
-            return 0;
-        }
+        NS_ASSERT(current != item.next);
+        current = item.next;
+    }
+
+    NS_ASSERT(static_cast<uint32_t>(buffer - start) == maxSize);
+    return 1;
+}
 
-        buffer = AddToRawU32(extraItem.fragmentStart, start, buffer, maxSize);
+uint32_t
+PacketMetadata::GetItemSerializedSize(const PacketMetadata::SmallItem* item)
+{
+    uint32_t size = 0;
+    uint32_t uid = (item->typeUid & 0xfffffffe) >> 1;
+    if (uid == 0)
+    {
+        size += 4;
+    }
+    else
+    {
+        TypeId tid;
+        tid.SetUid(uid);
+        size += 4 + tid.GetName().size();
+    }
+    size += 1 + 4 + 2 + 4 + 4 + 8;
+    return size;
+}
+
+uint8_t*
+PacketMetadata::SerializeItem(const PacketMetadata::SmallItem* item,
+                              const PacketMetadata::ExtraItem* extraItem,
+                              uint8_t* start,
+                              uint8_t* buffer,
+                              uint32_t maxSize)
+{
+    NS_LOG_LOGIC("bytesWritten=" << static_cast<uint32_t>(buffer - start)
+                                 << ", typeUid=" << item->typeUid << ", size=" << item->size
+                                 << ", chunkUid=" << item->chunkUid
+                                 << ", fragmentStart=" << extraItem->fragmentStart
+                                 << ", fragmentEnd=" << extraItem->fragmentEnd
+                                 << ", packetUid=" << extraItem->packetUid);
+
+    uint32_t uid = (item->typeUid & 0xfffffffe) >> 1;
+    if (uid != 0)
+    {
+        TypeId tid;
+        tid.SetUid(uid);
+        std::string uidString = tid.GetName();
+        uint32_t uidStringSize = uidString.size();
+        buffer = AddToRawU32(uidStringSize, start, buffer, maxSize);
         if (buffer == nullptr)
         {
-            return 0;
+            return nullptr;
         }
-
-        buffer = AddToRawU32(extraItem.fragmentEnd, start, buffer, maxSize);
+        buffer = AddToRaw(reinterpret_cast<const uint8_t*>(uidString.c_str()),
+                          uidStringSize,
+                          start,
+                          buffer,
+                          maxSize);
         if (buffer == nullptr)
         {
-            return 0;
+            return nullptr;
         }
-
-        buffer = AddToRawU64(extraItem.packetUid, start, buffer, maxSize);
+    }
+    else
+    {
+        buffer = AddToRawU32(0, start, buffer, maxSize);
         if (buffer == nullptr)
         {
-            return 0;
+            return nullptr;
         }
+    }
 
-        if (current == m_tail)
-        {
-            break;
-        }
+    uint8_t isBig = item->typeUid & 0x1;
+    buffer = AddToRawU8(isBig, start, buffer, maxSize);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
 
-        NS_ASSERT(current != item.next);
-        current = item.next;
+    buffer = AddToRawU32(item->size, start, buffer, maxSize);
+    if (buffer == nullptr)
+    {
+        return nullptr;
     }
 
-    NS_ASSERT(static_cast<uint32_t>(buffer - start) == maxSize);
-    return 1;
+    buffer = AddToRawU16(item->chunkUid, start, buffer, maxSize);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+
+    buffer = AddToRawU32(extraItem->fragmentStart, start, buffer, maxSize);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+
+    buffer = AddToRawU32(extraItem->fragmentEnd, start, buffer, maxSize);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+
+    buffer = AddToRawU64(extraItem->packetUid, start, buffer, maxSize);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+
+    return buffer;
 }
 
 uint32_t
@@ -1317,8 +1939,7 @@ PacketMetadata::Deserialize(const uint8_t* buffer, uint32_t size)
                              << ", chunkUid=" << item.chunkUid << ", fragmentStart="
                              << extraItem.fragmentStart << ", fragmentEnd=" << extraItem.fragmentEnd
                              << ", packetUid=" << extraItem.packetUid);
-        uint32_t tmp = AddBig(0xffff, m_tail, &item, &extraItem);
-        UpdateTail(tmp);
+        AppendItem(&item, &extraItem);
     }
     NS_ASSERT(desSize == 0);
     return (desSize != 0) ? 0 : 1;
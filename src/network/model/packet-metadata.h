@@ -27,8 +27,13 @@
 
 #include <limits>
 #include <stdint.h>
+#include <utility>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -76,10 +81,34 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * This linked list is copied whenever a packet which shares it with
+ * other packets is modified.  The alternative ARENA engine, selected
+ * with SetEngine() or the \c PacketMetadataEngine global value, rather
+ * stores each item in an immutable node allocated from a process-wide
+ * arena of fixed size nodes.  The items of a packet are the leaves of a
+ * height-balanced binary tree of such nodes, which the copies of a packet
+ * share: adding or removing a header, a trailer or a fragment only creates
+ * the nodes of the path to the modified end of the tree, and concatenating
+ * two packets shares the trees of both.  Both engines serialize the same
+ * items in the same layout, except for the flag telling whether the LIST
+ * engine stored an item in its long form, which the ARENA engine always
+ * clears; Deserialize() yields the same items whatever the flag.  In
+ * builds with \c NS3_MTP, the ARENA engine allocates each node with new
+ * and delete rather than from the arena, which is not thread-safe.
  */
 class PacketMetadata
 {
   public:
+    /**
+     * \brief The representations of the items.
+     */
+    enum Engine
+    {
+        LIST, //!< Linked list of items in a copy-on-write byte buffer (default)
+        ARENA //!< Persistent tree of items allocated from an arena
+    };
+
     /**
      * \brief structure describing a packet metadata item
      */
@@ -159,16 +188,41 @@ class PacketMetadata
         uint16_t m_current;               //!< current position
         uint32_t m_offset;                //!< offset
         bool m_hasReadTail;               //!< true if the metadata tail has been read
+        uint32_t m_index;                 //!< index of the next item of the ARENA engine
     };
 
     /**
      * \brief Enable the packet metadata
+     *
+     * The engine is set from the \c PacketMetadataEngine global value.
      */
     static void Enable();
     /**
      * \brief Enable the packet metadata checking
      */
     static void EnableChecking();
+    /**
+     * \brief Select the representation of the metadata of the packets
+     * created from now on.
+     *
+     * This also sets the \c PacketMetadataEngine global value.  The
+     * packets created before keep their representation: they can still be
+     * concatenated with the new ones, at the cost of a conversion.
+     *
+     * \param engine the engine
+     */
+    static void SetEngine(Engine engine);
+    /**
+     * \brief Get the representation of the metadata of new packets
+     * \returns the engine
+     */
+    static Engine GetEngine();
+    /**
+     * \brief Get the number of nodes of the ARENA engine in use, by all
+     * the packets
+     * \returns the number of nodes
+     */
+    static uint64_t GetArenaNodes();
 
     /**
      * \brief Constructor
@@ -426,7 +480,11 @@ class PacketMetadata
     struct Data
     {
         /** number of references to this struct Data instance. */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /** size (in bytes) of m_data buffer below */
         uint32_t m_size;
         /** max of the m_used field over all objects which reference this struct Data instance */
@@ -509,6 +567,37 @@ class PacketMetadata
         uint64_t packetUid;
     };
 
+    /**
+     * \brief A node of the tree of items of the ARENA engine.
+     *
+     * A node is either an item, or the concatenation of the items of its
+     * two children.  Nodes are immutable once built, and shared by all
+     * the trees which reference them.
+     */
+    struct Node
+    {
+        /** number of references to this node, from packets and parent nodes. */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
+        uint32_t m_count;
+#endif
+        /** number of bytes of the items of this subtree */
+        uint32_t m_size;
+        /** number of items of this subtree */
+        uint32_t m_items;
+        /** height of this subtree, zero for an item */
+        uint32_t m_height;
+        /** left child, or nullptr for an item */
+        Node* m_left;
+        /** right child, or nullptr for an item; the next free node in the arena */
+        Node* m_right;
+        /** the item, if this node is one; next and prev are not used */
+        SmallItem m_item;
+        /** the fragment and the packet uid of the item, if this node is one */
+        ExtraItem m_extraItem;
+    };
+
     /**
      * \brief Class to hold all the metadata
      */
@@ -518,6 +607,23 @@ class PacketMetadata
         ~DataFreeList();
     };
 
+    /**
+     * \brief The blocks of nodes of the ARENA engine, and its free nodes
+     */
+    class NodeArena
+    {
+      public:
+        ~NodeArena();
+
+        Node* m_free{nullptr};      //!< The free nodes, linked by m_right
+        std::vector<Node*> m_blocks; //!< The blocks of nodes
+#ifdef NS3_MTP
+        std::atomic<uint64_t> m_live{0}; //!< The number of nodes in use
+#else
+        uint64_t m_live{0}; //!< The number of nodes in use
+#endif
+    };
+
     friend DataFreeList::~DataFreeList();
     /// Friend class
     friend class ItemIterator;
@@ -634,6 +740,131 @@ class PacketMetadata
      * \param size header serialized size
      */
     void DoAddHeader(uint32_t uid, uint32_t size);
+    /**
+     * \brief Append an item
+     * \param item the item to append
+     * \param extraItem the fragment and packet uid of the item
+     */
+    void AppendItem(const PacketMetadata::SmallItem* item,
+                    const PacketMetadata::ExtraItem* extraItem);
+    /**
+     * \brief Copy the metadata into the representation of another engine
+     * \param engine the engine of the copy
+     * \returns the copy
+     */
+    PacketMetadata ConvertTo(Engine engine) const;
+    /**
+     * \brief Get the serialized size of an item
+     * \param item the item
+     * \returns the number of bytes written by SerializeItem()
+     */
+    static uint32_t GetItemSerializedSize(const PacketMetadata::SmallItem* item);
+    /**
+     * \brief Serialize an item to raw uint8_t*
+     * \param item the item
+     * \param extraItem the fragment and packet uid of the item
+     * \param start start of the buffer
+     * \param current where to write the item
+     * \param maxSize the size of the buffer
+     * \returns the end of the item, or nullptr if it does not fit
+     */
+    static uint8_t* SerializeItem(const PacketMetadata::SmallItem* item,
+                                  const PacketMetadata::ExtraItem* extraItem,
+                                  uint8_t* start,
+                                  uint8_t* current,
+                                  uint32_t maxSize);
+
+    /**
+     * \brief Get an item of the ARENA engine
+     * \param index the index of the item
+     * \returns the item node
+     */
+    const Node* GetNodeItem(uint32_t index) const;
+    /**
+     * \brief Remove items at the start or at the end, with the ARENA engine
+     * \param size the number of bytes to remove
+     * \param fromStart true to remove them at the start
+     */
+    void RemoveNodeBytes(uint32_t size, bool fromStart);
+    /**
+     * \brief Remove a header or a trailer, with the ARENA engine
+     * \param uid the type uid of the header or trailer
+     * \param size its serialized size
+     * \param isHeader true for a header, false for a trailer
+     */
+    void RemoveNodeChunk(uint32_t uid, uint32_t size, bool isHeader);
+    /**
+     * \brief Add the items of another metadata at the end, with the ARENA engine
+     * \param o the other metadata
+     */
+    void AddNodesAtEnd(const PacketMetadata& o);
+
+    /**
+     * \brief Build an item node
+     * \param item the item
+     * \param extraItem the fragment and packet uid of the item
+     * \returns the new node, with one reference
+     */
+    static Node* CreateItemNode(const PacketMetadata::SmallItem* item,
+                                const PacketMetadata::ExtraItem* extraItem);
+    /**
+     * \brief Build the concatenation of two trees of similar heights
+     * \param left the left tree, whose reference is taken over
+     * \param right the right tree, whose reference is taken over
+     * \returns the new node, with one reference
+     */
+    static Node* CreateConcatNode(Node* left, Node* right);
+    /**
+     * \brief Concatenate two trees, keeping the result balanced
+     * \param left the left tree, whose reference is taken over, or nullptr
+     * \param right the right tree, whose reference is taken over, or nullptr
+     * \returns the concatenation, with one reference
+     */
+    static Node* Join(Node* left, Node* right);
+    /**
+     * \brief Split a tree in two
+     * \param node the tree, which keeps its reference
+     * \param items the number of items of the left part
+     * \returns the left and right parts, each with one reference, or nullptr
+     *          if empty
+     */
+    static std::pair<Node*, Node*> Split(Node* node, uint32_t items);
+    /**
+     * \brief Get the height of a tree
+     * \param node the tree, or nullptr
+     * \returns the height
+     */
+    static inline int64_t GetHeight(const Node* node);
+    /**
+     * \brief Add a reference to a node
+     * \param node the node
+     * \returns the node
+     */
+    static inline Node* Ref(Node* node);
+    /**
+     * \brief Release a reference to a node
+     * \param node the node, or nullptr
+     */
+    static inline void Unref(Node* node);
+    /**
+     * \brief Return a node whose last reference was released to the arena,
+     *        releasing its children.
+     * \param node the node
+     */
+    static void DestroyNode(Node* node);
+    /**
+     * \brief Allocate a node from the arena
+     * \returns the node
+     */
+    static Node* AllocateNode();
+
+    /**
+     * \brief Check the consistency of a tree of items
+     * \param node the tree, or nullptr
+     * \returns true if the tree is consistent and balanced
+     */
+    static bool IsNodeOk(const Node* node);
+
     /**
      * \brief Check if the metadata state is ok
      * \returns true if the internal state is ok
@@ -674,22 +905,47 @@ class PacketMetadata
      * \param data the buffer data storage
      */
     static void Deallocate(PacketMetadata::Data* data);
+    /**
+     * \brief Get the size of the allocation of a buffer data storage
+     * \param n the storage size
+     * \returns the number of bytes allocated
+     */
+    static uint32_t GetAllocationSize(uint32_t n);
 
     static DataFreeList m_freeList; //!< the metadata data storage
+    static NodeArena m_arena;       //!< the nodes of the ARENA engine
     static bool m_enable;           //!< Enable the packet metadata
     static bool m_enableChecking;   //!< Enable the packet metadata checking
+    static Engine m_engine;         //!< The engine of new packets
 
     /**
      * Set to true when adding metadata to a packet is skipped because
      * m_enable is false; used to detect enabling of metadata in the
      * middle of a simulation, which isn't allowed.
      */
+#ifdef NS3_MTP
+    static thread_local bool m_metadataSkipped;
+#else
     static bool m_metadataSkipped;
+#endif
 
+#ifdef NS3_MTP
+    static thread_local uint32_t m_maxSize;    //!< maximum metadata size
+    static std::atomic<uint16_t> m_chunkUid; //!< Chunk Uid
+#else
     static uint32_t m_maxSize;  //!< maximum metadata size
     static uint16_t m_chunkUid; //!< Chunk Uid
+#endif
 
-    Data* m_data; //!< Metadata storage
+    /**
+     * \brief Constructor of an empty metadata
+     * \param uid packet uid
+     * \param engine the representation of the metadata
+     */
+    inline PacketMetadata(uint64_t uid, Engine engine);
+
+    Data* m_data; //!< Metadata storage of the LIST engine, nullptr with the ARENA engine
+    Node* m_root; //!< Tree of items of the ARENA engine, nullptr if empty
     /*
        head -(next)-> tail
          ^             |
@@ -706,14 +962,23 @@ class PacketMetadata
 namespace ns3
 {
 
-PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
-    : m_data(PacketMetadata::Create(10)),
+PacketMetadata::PacketMetadata(uint64_t uid, Engine engine)
+    : m_data(engine == LIST ? PacketMetadata::Create(10) : nullptr),
+      m_root(nullptr),
       m_head(0xffff),
       m_tail(0xffff),
       m_used(0),
       m_packetUid(uid)
 {
-    memset(m_data->m_data, 0xff, 4);
+    if (m_data != nullptr)
+    {
+        memset(m_data->m_data, 0xff, 4);
+    }
+}
+
+PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
+    : PacketMetadata(uid, m_engine)
+{
     if (size > 0)
     {
         DoAddHeader(0, size);
@@ -722,14 +987,21 @@ PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
 
 PacketMetadata::PacketMetadata(const PacketMetadata& o)
     : m_data(o.m_data),
+      m_root(o.m_root),
       m_head(o.m_head),
       m_tail(o.m_tail),
       m_used(o.m_used),
       m_packetUid(o.m_packetUid)
 {
-    NS_ASSERT(m_data != nullptr);
-    NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
-    m_data->m_count++;
+    if (m_data != nullptr)
+    {
+        NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
+        m_data->m_count++;
+    }
+    else if (m_root != nullptr)
+    {
+        Ref(m_root);
+    }
 }
 
 PacketMetadata&
@@ -738,15 +1010,24 @@ PacketMetadata::operator=(const PacketMetadata& o)
     if (m_data != o.m_data)
     {
         // not self assignment
-        NS_ASSERT(m_data != nullptr);
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (m_data != nullptr && --m_data->m_count == 0)
         {
             PacketMetadata::Recycle(m_data);
         }
         m_data = o.m_data;
-        NS_ASSERT(m_data != nullptr);
-        m_data->m_count++;
+        if (m_data != nullptr)
+        {
+            m_data->m_count++;
+        }
+    }
+    if (m_root != o.m_root)
+    {
+        if (o.m_root != nullptr)
+        {
+            Ref(o.m_root);
+        }
+        Unref(m_root);
+        m_root = o.m_root;
     }
     m_head = o.m_head;
     m_tail = o.m_tail;
@@ -757,12 +1038,34 @@ PacketMetadata::operator=(const PacketMetadata& o)
 
 PacketMetadata::~PacketMetadata()
 {
-    NS_ASSERT(m_data != nullptr);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (m_data != nullptr && --m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
+    Unref(m_root);
+}
+
+int64_t
+PacketMetadata::GetHeight(const Node* node)
+{
+    return node == nullptr ? -1 : node->m_height;
+}
+
+PacketMetadata::Node*
+PacketMetadata::Ref(Node* node)
+{
+    NS_ASSERT(node->m_count < std::numeric_limits<uint32_t>::max());
+    node->m_count++;
+    return node;
+}
+
+void
+PacketMetadata::Unref(Node* node)
+{
+    if (node != nullptr && --node->m_count == 0)
+    {
+        DestroyNode(node);
+    }
 }
 
 } // namespace ns3
@@ -19,7 +19,7 @@
 
 /**
 \file   packet-tag-list.cc
-\brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+\brief  Implements a flat list of Packet tags, including copy-on-write semantics.
 */
 
 #include "packet-tag-list.h"
@@ -30,277 +30,185 @@
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <new>
 
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("PacketTagList");
 
-PacketTagList::TagData*
-PacketTagList::CreateTagData(size_t dataSize)
+uint32_t
+PacketTagList::GetEntrySize(uint32_t dataSize)
 {
-    NS_ASSERT_MSG(dataSize < std::numeric_limits<decltype(TagData::size)>::max(),
-                  "Requested TagData size " << dataSize << " exceeds maximum "
-                                            << std::numeric_limits<decltype(TagData::size)>::max());
-
-    void* p = std::malloc(sizeof(TagData) + dataSize - 1);
-    // The matching frees are in RemoveAll and RemoveWriter
-
-    auto tag = new (p) TagData;
-    tag->size = dataSize;
-    return tag;
+    NS_ASSERT_MSG(dataSize < std::numeric_limits<uint32_t>::max() - sizeof(TagData) - 3,
+                  "Requested TagData size " << dataSize << " is too large");
+    return sizeof(TagData) + ((dataSize + 3) & (~3));
 }
 
-bool
-PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
+uint32_t
+PacketTagList::GetFilterBit(TypeId tid)
 {
-    TypeId tid = tag.GetInstanceTypeId();
-    NS_LOG_FUNCTION(this << tid);
-    NS_LOG_INFO("looking for " << tid);
+    return 1U << (tid.GetUid() % 32);
+}
 
-    // trivial case when list is empty
-    if (m_next == nullptr)
+const PacketTagList::TagData*
+PacketTagList::Find(TypeId tid) const
+{
+    if ((m_filter & GetFilterBit(tid)) == 0)
     {
-        return false;
+        return nullptr;
     }
-
-    bool found = false;
-
-    TagData** prevNext = &m_next; // previous node's next pointer
-    TagData* cur = m_next;        // cursor to current node
-    TagData* it = nullptr;        // utility
-
-    // Search from the head of the list until we find tid or a merge
-    while (cur != nullptr)
+    for (const TagData* cur = Begin(); cur != End(); cur = cur->GetNext())
     {
-        if (cur->count > 1)
-        {
-            // found merge
-            NS_LOG_INFO("found initial merge before tid");
-            break;
-        }
-        else if (cur->tid == tid)
-        {
-            NS_LOG_INFO("found tid before initial merge, calling writer");
-            found = (this->*Writer)(tag, true, cur, prevNext);
-            break;
-        }
-        else
+        if (cur->tid == tid)
         {
-            // no merge or tid found yet, move on
-            prevNext = &cur->next;
-            cur = cur->next;
+            return cur;
         }
-    } // while !found && !cow
+    }
+    return nullptr;
+}
 
-    // did we find it or run out of tags?
-    if (cur == nullptr || found)
+void
+PacketTagList::Reserve(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    if (m_data == nullptr ? size <= INLINE_SIZE : (m_data->count == 1 && m_data->size >= size))
     {
-        NS_LOG_INFO("returning after header with found: " << found);
-        return found;
+        return;
     }
-
-    // From here on out, we have to copy the list
-    // until we find tid, then link past it
-
-    // Before we do all that work, let's make sure tid really exists
-    for (it = cur; it != nullptr; it = it->next)
+    // Move the tags to an unshared storage: back inline if they fit,
+    // otherwise to a new block.  A block which is too small is replaced by
+    // one twice as large, so that adding tags one by one copies them a
+    // constant number of times on average.
+    Data* data = nullptr;
+    uint8_t* storage = m_inline;
+    if (size > INLINE_SIZE)
     {
-        if (it->tid == tid)
+        uint32_t dataSize = std::max(size, 2 * INLINE_SIZE);
+        if (m_data != nullptr)
         {
-            break;
+            dataSize = std::max(dataSize, size > m_data->size ? 2 * m_data->size : m_data->size);
         }
+        void* p = std::malloc(sizeof(Data) - sizeof(Data::data) + dataSize);
+        // The matching free is in Release
+        data = new (p) Data;
+        data->count = 1;
+        data->size = dataSize;
+        storage = data->data;
     }
-    if (it == nullptr)
+    if (m_data != nullptr)
     {
-        // got to end of list without finding tid
-        NS_LOG_INFO("tid not found after first merge");
-        return found;
+        std::memcpy(storage, m_data->data, m_used);
+        Release(m_data);
     }
-
-    // At this point cur is a merge, but untested for tid
-    NS_ASSERT(cur != nullptr);
-    NS_ASSERT(cur->count > 1);
-
-    /*
-       Walk the remainder of the list, copying, until we find tid
-       As we put a copy of the cur node onto our list,
-       we move the merge point down the list.
-
-       Starting position                  End position
-         T1 is a merge                     T1.count decremented
-                                           T2 is a merge
-                                           T1' is a copy of T1
-
-            other                             other
-                 \                                 \
-        Prev  ->  T1  ->  T2  -> ...                T1  ->  T2  -> ...
-             /   /                                         /|
-        pNext cur                         Prev  ->  T1' --/ |
-                                                       /    |
-                                                  pNext   cur
-
-       When we reach tid, we link past it, decrement count, and we're done.
-    */
-
-    // Should normally check for null cur pointer,
-    // but since we know tid exists, we'll skip this test
-    while (/* cur && */ cur->tid != tid)
+    else
     {
-        NS_ASSERT(cur != nullptr);
-        NS_ASSERT(cur->count > 1);
-        cur->count--; // unmerge cur
-        TagData* copy = CreateTagData(cur->size);
-        copy->tid = cur->tid;
-        copy->count = 1;
-        copy->size = cur->size;
-        memcpy(copy->data, cur->data, copy->size);
-        copy->next = cur->next; // merge into tail
-        copy->next->count++;    // mark new merge
-        *prevNext = copy;       // point prior list at copy
-        prevNext = &copy->next; // advance
-        cur = copy->next;
+        std::memcpy(storage, m_inline, m_used);
     }
-    // Sanity check:
-    NS_ASSERT(cur != nullptr);  // cur should be non-zero
-    NS_ASSERT(cur->tid == tid); // cur->tid should be tid
-    NS_ASSERT(cur->count > 1);  // cur should be a merge
-
-    // link around tid, removing it from our list
-    found = (this->*Writer)(tag, false, cur, prevNext);
-    return found;
+    m_data = data;
 }
 
-bool
-PacketTagList::Remove(Tag& tag)
+void
+PacketTagList::RemoveEntry(uint32_t offset)
 {
-    return COWTraverse(tag, &PacketTagList::RemoveWriter);
+    NS_LOG_FUNCTION(this << offset);
+    uint8_t* storage = GetStorage();
+    uint32_t size = GetEntrySize(reinterpret_cast<TagData*>(storage + offset)->size);
+    std::memmove(storage + offset, storage + offset + size, m_used - offset - size);
+    m_used -= size;
+    m_filter = 0;
+    for (const TagData* cur = Begin(); cur != End(); cur = cur->GetNext())
+    {
+        m_filter |= GetFilterBit(cur->tid);
+    }
 }
 
-// COWWriter implementing Remove
 bool
-PacketTagList::RemoveWriter(Tag& tag,
-                            bool preMerge,
-                            PacketTagList::TagData* cur,
-                            PacketTagList::TagData** prevNext)
+PacketTagList::Remove(Tag& tag)
 {
-    NS_LOG_FUNCTION_NOARGS();
-
-    // found tid
-    bool found = true;
-    tag.Deserialize(TagBuffer(cur->data, cur->data + cur->size));
-    *prevNext = cur->next; // link around cur
-
-    if (preMerge)
-    {
-        // found tid before first merge, so delete cur
-        cur->~TagData();
-        std::free(cur);
-    }
-    else
+    TypeId tid = tag.GetInstanceTypeId();
+    NS_LOG_FUNCTION(this << tid);
+    const TagData* cur = Find(tid);
+    if (cur == nullptr)
     {
-        // cur is always a merge at this point
-        // unmerge cur, since we linked around it already
-        cur->count--;
-        if (cur->next != nullptr)
-        {
-            // there's a next, so make it a merge
-            cur->next->count++;
-        }
+        return false;
     }
-    return found;
+    tag.Deserialize(TagBuffer(const_cast<uint8_t*>(cur->GetData()),
+                              const_cast<uint8_t*>(cur->GetData()) + cur->size));
+    uint32_t offset = reinterpret_cast<const uint8_t*>(cur) - GetStorage();
+    Reserve(m_used);
+    RemoveEntry(offset);
+    return true;
 }
 
 bool
 PacketTagList::Replace(Tag& tag)
 {
-    bool found = COWTraverse(tag, &PacketTagList::ReplaceWriter);
-    if (!found)
+    TypeId tid = tag.GetInstanceTypeId();
+    NS_LOG_FUNCTION(this << tid);
+    const TagData* cur = Find(tid);
+    if (cur == nullptr)
     {
         Add(tag);
+        return false;
     }
-    return found;
-}
-
-// COWWriter implementing Replace
-bool
-PacketTagList::ReplaceWriter(Tag& tag,
-                             bool preMerge,
-                             PacketTagList::TagData* cur,
-                             PacketTagList::TagData** prevNext)
-{
-    NS_LOG_FUNCTION_NOARGS();
-
-    // found tid
-    bool found = true;
-    if (preMerge)
+    uint32_t offset = reinterpret_cast<const uint8_t*>(cur) - GetStorage();
+    Reserve(m_used);
+    auto data = reinterpret_cast<TagData*>(GetStorage() + offset);
+    if (data->size == tag.GetSerializedSize())
     {
-        // found tid before first merge, so just rewrite
-        tag.Serialize(TagBuffer(cur->data, cur->data + cur->size));
+        // rewrite in place
+        tag.Serialize(TagBuffer(data->GetData(), data->GetData() + data->size));
     }
     else
     {
-        // cur is always a merge at this point
-        // need to copy, replace, and link past cur
-        cur->count--; // unmerge cur
-        TagData* copy = CreateTagData(tag.GetSerializedSize());
-        copy->tid = tag.GetInstanceTypeId();
-        copy->count = 1;
-        tag.Serialize(TagBuffer(copy->data, copy->data + copy->size));
-        copy->next = cur->next; // merge into tail
-        if (copy->next != nullptr)
-        {
-            copy->next->count++; // mark new merge
-        }
-        *prevNext = copy; // point prior list at copy
+        RemoveEntry(offset);
+        Add(tag);
     }
-    return found;
+    return true;
 }
 
 void
 PacketTagList::Add(const Tag& tag) const
 {
-    NS_LOG_FUNCTION(this << tag.GetInstanceTypeId());
+    TypeId tid = tag.GetInstanceTypeId();
+    NS_LOG_FUNCTION(this << tid);
     // ensure this id was not yet added
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
-    {
-        NS_ASSERT_MSG(cur->tid != tag.GetInstanceTypeId(),
-                      "Error: cannot add the same kind of tag twice. The tag type is "
-                          << tag.GetInstanceTypeId().GetName());
-    }
-    TagData* head = CreateTagData(tag.GetSerializedSize());
-    head->count = 1;
-    head->next = nullptr;
-    head->tid = tag.GetInstanceTypeId();
-    head->next = m_next;
-    tag.Serialize(TagBuffer(head->data, head->data + head->size));
-
-    const_cast<PacketTagList*>(this)->m_next = head;
+    NS_ASSERT_MSG(Find(tid) == nullptr,
+                  "Error: cannot add the same kind of tag twice. The tag type is "
+                      << tid.GetName());
+    auto self = const_cast<PacketTagList*>(this);
+    uint32_t dataSize = tag.GetSerializedSize();
+    uint32_t size = GetEntrySize(dataSize);
+    self->Reserve(m_used + size);
+    // the most recent tag comes first
+    uint8_t* storage = GetStorage();
+    std::memmove(storage + size, storage, m_used);
+    auto head = new (storage) TagData;
+    head->tid = tid;
+    head->size = dataSize;
+    tag.Serialize(TagBuffer(head->GetData(), head->GetData() + dataSize));
+    self->m_used += size;
+    self->m_filter |= GetFilterBit(tid);
 }
 
 bool
 PacketTagList::Peek(Tag& tag) const
 {
     NS_LOG_FUNCTION(this << tag.GetInstanceTypeId());
-    TypeId tid = tag.GetInstanceTypeId();
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    const TagData* cur = Find(tag.GetInstanceTypeId());
+    if (cur == nullptr)
     {
-        if (cur->tid == tid)
-        {
-            /* found tag */
-            tag.Deserialize(TagBuffer(cur->data, cur->data + cur->size));
-            return true;
-        }
+        /* no tag found */
+        return false;
     }
-    /* no tag found */
-    return false;
-}
-
-const PacketTagList::TagData*
-PacketTagList::Head() const
-{
-    return m_next;
+    /* found tag */
+    tag.Deserialize(TagBuffer(const_cast<uint8_t*>(cur->GetData()),
+                              const_cast<uint8_t*>(cur->GetData()) + cur->size));
+    return true;
 }
 
 uint32_t
@@ -312,7 +220,7 @@ PacketTagList::GetSerializedSize() const
 
     size = 4; // numberOfTags
 
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    for (const TagData* cur = Begin(); cur != End(); cur = cur->GetNext())
     {
         size += 4; // TagData -> size
 
@@ -346,7 +254,7 @@ PacketTagList::Serialize(uint32_t* buffer, uint32_t maxSize) const
     uint32_t* numberOfTags = p;
     *p++ = 0;
 
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    for (const TagData* cur = Begin(); cur != End(); cur = cur->GetNext())
     {
         size += 4;
 
@@ -381,7 +289,7 @@ PacketTagList::Serialize(uint32_t* buffer, uint32_t maxSize) const
             return 0;
         }
 
-        memcpy(p, cur->data, cur->size);
+        memcpy(p, cur->GetData(), cur->size);
         p += tagWordSize / 4;
 
         (*numberOfTags)++;
@@ -404,7 +312,6 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
 
     NS_LOG_INFO("Deserializing number of tags " << numberOfTags);
 
-    TagData* prevTag = nullptr;
     for (uint32_t i = 0; i < numberOfTags; ++i)
     {
         NS_ASSERT(sizeCheck >= 4);
@@ -422,30 +329,22 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
 
         NS_LOG_INFO("Deserializing tag of type " << tid);
 
-        TagData* newTag = CreateTagData(tagSize);
-        newTag->count = 1;
-        newTag->next = nullptr;
+        // Append the tag, keeping the serialized order.
+        uint32_t entrySize = GetEntrySize(tagSize);
+        Reserve(m_used + entrySize);
+        auto newTag = new (GetStorage() + m_used) TagData;
         newTag->tid = tid;
+        newTag->size = tagSize;
+        m_used += entrySize;
+        m_filter |= GetFilterBit(tid);
 
         NS_ASSERT(sizeCheck >= tagSize);
-        memcpy(newTag->data, p, tagSize);
+        memcpy(newTag->GetData(), p, tagSize);
 
         // ensure 4 byte boundary
         uint32_t tagWordSize = (tagSize + 3) & (~3);
         p += tagWordSize / 4;
         sizeCheck -= tagWordSize;
-
-        // Set link list pointers.
-        if (i == 0)
-        {
-            m_next = newTag;
-        }
-        else
-        {
-            prevTag->next = newTag;
-        }
-
-        prevTag = newTag;
     }
 
     NS_ASSERT(sizeCheck == 0);
@@ -21,14 +21,20 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines a flat list of Packet tags, including copy-on-write semantics.
 */
 
 #include "ns3/type-id.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <ostream>
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -44,88 +50,40 @@ class Tag;
  *
  * \internal
  *
- * The implementation of this class is a bit tricky.  Refer to this
- * diagram in the discussion that follows.
- *
- * \dot
- *    digraph {
- *        rankdir = "LR";
- *        clusterrank = local;
- *        node [ shape = record, fontname="FreeSans", fontsize="10" ];
- *        oth  [ label="<l> Other branch | <n> next | <c> ..." ];
- *        PTL1 [ label="<l> PacketTagList A | <n> m_next" , shape=Mrecord];
- *        PTL2 [ label="<l> PacketTagList B | <n> m_next" , shape=Mrecord];
- *        oth:n  -> T7:l ;
- *        PTL2:n -> T6:l ;
- *        PTL1:n -> T5:l ;
- *        T1   [ label="<l> T1  | <n> next | <c> count = 1" ];
- *        T2   [ label="<l> T2  | <n> next | <c> count = 1" ];
- *        T3   [ label="<l> T3  | <n> next | <c> count = 2" ];
- *        T4   [ label="<l> T4  | <n> next | <c> count = 1" ];
- *        T5   [ label="<l> T5  | <n> next | <c> count = 2" ];
- *        T6   [ label="<l> T6  | <n> next | <c> count = 1" ];
- *        T7   [ label="<l> T7  | <n> next | <c> count = 1" ];
- *        NULL [ label="0", shape = ellipse ];
- *        subgraph cluster_list {
- *          penwidth = 0;
- *          T6:n -> T5:l ;
- *          T5:n -> T4:l ;
- *          T4:n -> T3:l ;
- *          T7:n -> T3:l ;
- *          T3:n -> T2:l ;
- *          T2:n -> T1:l ;
- *          T1:n -> NULL ;
- *        };
- *      }
- * \enddot
- *
- *   - Tags are stored in serialized form in a tree of TagData
- *     structures. (<tt>T1-T7</tt> in the diagram)
- *
- *   - Each TagData points (\c next pointers in the diagram)
- *     toward the root of the tree, which is a null pointer.
- *
- *   - \c count is the number of incoming pointers to this
- *     TagData.  Branch points, where branches merge or join, have
- *     <tt>count \> 1</tt> (\c T3, \c T5); successive links along
- *     a branch have <tt>count = 1</tt> (\c T1, \c T2, \c T4, \c T6, \c T7).
- *
- *   - Each PacketTagList points to a specific TagData,
- *     which is the most recent Tag added to the packet. (<tt>T5-T7</tt>)
- *
- *   - Conceptually, therefore, each Packet has a PacketTagList which
- *     points to a singly-linked list of TagData.
+ * The tags are stored in serialized form, one after the other, each one
+ * preceded by a TagData header with its TypeId and size, the most recent
+ * tag first.  As a packet usually carries a few small tags, such as the
+ * flow monitor, timestamp and socket priority tags, the first
+ * #INLINE_SIZE bytes of tags are stored in the PacketTagList itself, and
+ * thus in the Packet: adding them does not allocate.
  *
  * \par <b> Copy-on-write </b> is implemented as follows:
  *
- *   - #Add prepends the new tag to the list (growing that branch of the tree,
- *     as \c T6). This is a constant time operation, and does not affect
- *     any other #PacketTagList's, hence this is a \c const function.
+ *   - The tags which do not fit in the PacketTagList are all moved to a
+ *     reference counted block on the heap.
  *
  *   - Copy constructor (PacketTagList(const PacketTagList & o))
  *     and assignment (#operator=(const PacketTagList & o))
- *     simply join the tree at the same place as the original
- *     PacketTagList \c o, incrementing the \c count.
- *     For assignment, the old branch is deleted, up to
- *     the first branch point, which has its \c count decremented.
- *     (PacketTagList \c B started as a copy of PacketTagList \c A,
- *     before \c T6 was added to \c B).
+ *     copy the inline tags, or share the block, incrementing its count.
  *
- *   - #Remove and #Replace are a little tricky, depending on where the
- *     target tag is found relative to the first branch point:
- *     - \e Target before <em> the first branch point: </em> \n
- *       The target is just dealt with in place (linked around and deleted,
- *       in the case of #Remove; rewritten in the case of #Replace).
- *     - \e Target at or after <em> the first branch point: </em> \n
- *       The portion of the list between the first branch and the target is
- *       shared. This portion is copied before the #Remove or #Replace is
- *       performed.
+ *   - #Add, #Remove and #Replace copy a shared block before modifying it,
+ *     back into the PacketTagList if the tags fit there.
+ *
+ * \par <b> Lookups </b>
+ *
+ * A 32-bit filter records the TypeIds of the tags present, one bit per
+ * TypeId uid modulo 32, so that looking for a tag which is not in the list,
+ * the most common case, takes constant time.  The tags present are found
+ * by a scan of the few bytes of tags.
  */
 class PacketTagList
 {
   public:
+    /** The number of bytes of tags, with their headers, stored inline. */
+    static constexpr uint32_t INLINE_SIZE = 64;
+
     /**
-     * Tree node for sharing serialized tags.
+     * Header of a serialized tag.
      *
      * See PacketTagList for a discussion of the data structure.
      *
@@ -134,18 +92,24 @@ class PacketTagList
      * PacketTagIterator::Item::GetTag() needs the data and size values.
      * The Item nested class can't be forward declared, so friending isn't
      * possible.
-     *
-     * We use placement new so we can allocate enough room for the Tag
-     * type which will be serialized into data.  See Object::Aggregates
-     * for a similar construction.
      */
     struct TagData
     {
-        TagData* next;   //!< Pointer to next in list
-        uint32_t count;  //!< Number of incoming links
-        TypeId tid;      //!< Type of the tag serialized into #data
-        uint32_t size;   //!< Size of the \c data buffer
-        uint8_t data[1]; //!< Serialization buffer
+        TypeId tid;    //!< Type of the tag serialized after this header
+        uint32_t size; //!< Size of the serialized tag
+
+        /**
+         * \returns The serialized tag, which follows this header.
+         */
+        inline const uint8_t* GetData() const;
+        /**
+         * \returns The serialized tag, which follows this header.
+         */
+        inline uint8_t* GetData();
+        /**
+         * \returns The header of the next tag in the list.
+         */
+        inline const TagData* GetNext() const;
     };
 
     /**
@@ -157,8 +121,7 @@ class PacketTagList
      *
      * \param [in] o The PacketTagList to copy.
      *
-     * This makes a light-weight copy by #RemoveAll, then
-     * pointing to the same \ref TagData as \pname{o}.
+     * This copies the inline tags of \pname{o}, or shares its block.
      */
     inline PacketTagList(const PacketTagList& o);
     /**
@@ -167,19 +130,19 @@ class PacketTagList
      * \param [in] o The PacketTagList to copy.
      * \returns the copied object
      *
-     * This makes a light-weight copy by #RemoveAll, then
-     * pointing to the same \ref TagData as \pname{o}.
+     * This makes a light-weight copy by #RemoveAll, then copying the
+     * inline tags of \pname{o}, or sharing its block.
      */
     inline PacketTagList& operator=(const PacketTagList& o);
     /**
      * Destructor
      *
-     * #RemoveAll's the tags up to the first merge.
+     * Releases the block, if any.
      */
     inline ~PacketTagList();
 
     /**
-     * Add a tag to the head of this branch.
+     * Add a tag to the head of this list.
      *
      * \param [in] tag The tag to add
      */
@@ -211,13 +174,17 @@ class PacketTagList
      */
     bool Peek(Tag& tag) const;
     /**
-     * Remove all tags from this list (up to the first merge).
+     * Remove all tags from this list.
      */
     inline void RemoveAll();
     /**
-     * \returns pointer to head of tag list
+     * \returns pointer to the first tag of the list
+     */
+    inline const PacketTagList::TagData* Begin() const;
+    /**
+     * \returns pointer past the last tag of the list
      */
-    const PacketTagList::TagData* Head() const;
+    inline const PacketTagList::TagData* End() const;
     /**
      * Returns number of bytes required for packet serialization.
      *
@@ -244,67 +211,68 @@ class PacketTagList
     uint32_t Deserialize(const uint32_t* buffer, uint32_t size);
 
   private:
+    /** The block holding the tags which do not fit inline. */
+    struct Data
+    {
+#ifdef NS3_MTP
+        std::atomic<uint32_t> count; //!< Number of lists sharing the block
+#else
+        uint32_t count; //!< Number of lists sharing the block
+#endif
+        uint32_t size; //!< Size of the \c data buffer
+        alignas(TagData) uint8_t data[sizeof(TagData)]; //!< The tags
+    };
+
     /**
-     * Allocate and construct a TagData struct, sizing the data area
-     * large enough to serialize dataSize bytes from a Tag.
+     * Get the number of bytes used by a tag and its header.
      *
-     * \param [in] dataSize The serialized size of the Tag.
-     * \returns The newly constructed TagData object.
+     * \param [in] dataSize The serialized size of the tag.
+     * \returns The number of bytes.
      */
-    static TagData* CreateTagData(size_t dataSize);
-
+    static uint32_t GetEntrySize(uint32_t dataSize);
     /**
-     * Typedef of method function pointer for copy-on-write operations
+     * Get the bit of the filter of a TypeId.
      *
-     * \param [in] tag The tag type to operate on.
-     * \param [in] preMerge True if \pname{tag} was found before the first merge,
-     *             false otherwise.
-     * \param [in] cur Pointer to the tag.
-     * \param [in] prevNext Pointer to the struct TagData.next pointer
-     *          pointing to \pname{cur}.
-     * \returns True if operation successful, false otherwise
+     * \param [in] tid The TypeId.
+     * \returns The bit.
      */
-    typedef bool (PacketTagList::*COWWriter)(Tag& tag,
-                                             bool preMerge,
-                                             TagData* cur,
-                                             TagData** prevNext);
+    static uint32_t GetFilterBit(TypeId tid);
     /**
-     * Traverse the list implementing copy-on-write, using \pname{Writer}.
+     * Release a block, deleting it if it is not shared anymore.
      *
-     * \param [in] tag The tag type to operate on.
-     * \param [in] Writer The copy-on-write function to use.
-     * \returns True if \pname{tag} found, false otherwise.
+     * \param [in] data The block.
      */
-    bool COWTraverse(Tag& tag, PacketTagList::COWWriter Writer);
+    static inline void Release(Data* data);
+
     /**
-     * Copy-on-write implementing Remove.
+     * \returns The storage of the tags.
+     */
+    inline uint8_t* GetStorage() const;
+    /**
+     * Find a tag.
      *
-     * \param [in] tag The target tag type to remove.
-     * \param [in] preMerge True if \pname{tag} was found before the first merge,
-     *             false otherwise.
-     * \param [in] cur Pointer to the tag.
-     * \param [in] prevNext Pointer to the struct TagData.next pointer
-     *          pointing to \pname{cur}.
-     * \returns True, since tag will definitely be removed.
+     * \param [in] tid The TypeId of the tag.
+     * \returns The tag, or \c nullptr if it is not in the list.
      */
-    bool RemoveWriter(Tag& tag, bool preMerge, TagData* cur, TagData** prevNext);
+    const TagData* Find(TypeId tid) const;
     /**
-     * Copy-on-write implementing Replace
+     * Make sure that the storage of the tags is not shared and can hold
+     * \pname{size} bytes of tags, moving the tags if needed.
      *
-     * \param [in] tag The target tag type to replace
-     * \param [in] preMerge True if \pname{tag} was found before the first merge,
-     *          false otherwise.
-     * \param [in] cur Pointer to the tag
-     * \param [in] prevNext Pointer to the struct TagData.next pointer
-     *          pointing to \pname{cur}.
-     * \returns True, since tag value will definitely be replaced.
+     * \param [in] size The number of bytes of tags.
      */
-    bool ReplaceWriter(Tag& tag, bool preMerge, TagData* cur, TagData** prevNext);
-
+    void Reserve(uint32_t size);
     /**
-     * Pointer to first \ref TagData on the list
+     * Remove a tag from the list, which must not be shared.
+     *
+     * \param [in] offset The offset of the tag in the storage.
      */
-    TagData* m_next;
+    void RemoveEntry(uint32_t offset);
+
+    uint32_t m_used;   //!< The number of bytes of tags
+    uint32_t m_filter; //!< The filter of the TypeIds of the tags
+    Data* m_data;      //!< The block holding the tags, \c nullptr if they are inline
+    alignas(TagData) uint8_t m_inline[INLINE_SIZE]; //!< The tags stored inline
 };
 
 } // namespace ns3
@@ -316,33 +284,64 @@ class PacketTagList
 namespace ns3
 {
 
+const uint8_t*
+PacketTagList::TagData::GetData() const
+{
+    return reinterpret_cast<const uint8_t*>(this + 1);
+}
+
+uint8_t*
+PacketTagList::TagData::GetData()
+{
+    return reinterpret_cast<uint8_t*>(this + 1);
+}
+
+const PacketTagList::TagData*
+PacketTagList::TagData::GetNext() const
+{
+    return reinterpret_cast<const TagData*>(GetData() + ((size + 3) & (~3)));
+}
+
 PacketTagList::PacketTagList()
-    : m_next()
+    : m_used(0),
+      m_filter(0),
+      m_data(nullptr)
 {
 }
 
 PacketTagList::PacketTagList(const PacketTagList& o)
-    : m_next(o.m_next)
+    : m_used(o.m_used),
+      m_filter(o.m_filter),
+      m_data(o.m_data)
 {
-    if (m_next != nullptr)
+    if (m_data != nullptr)
     {
-        m_next->count++;
+        m_data->count++;
+    }
+    else
+    {
+        std::memcpy(m_inline, o.m_inline, m_used);
     }
 }
 
 PacketTagList&
 PacketTagList::operator=(const PacketTagList& o)
 {
-    // self assignment
-    if (m_next == o.m_next)
+    if (this == &o)
     {
         return *this;
     }
     RemoveAll();
-    m_next = o.m_next;
-    if (m_next != nullptr)
+    m_used = o.m_used;
+    m_filter = o.m_filter;
+    m_data = o.m_data;
+    if (m_data != nullptr)
+    {
+        m_data->count++;
+    }
+    else
     {
-        m_next->count++;
+        std::memcpy(m_inline, o.m_inline, m_used);
     }
     return *this;
 }
@@ -353,29 +352,43 @@ PacketTagList::~PacketTagList()
 }
 
 void
-PacketTagList::RemoveAll()
+PacketTagList::Release(Data* data)
 {
-    TagData* prev = nullptr;
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    if (--data->count == 0)
     {
-        cur->count--;
-        if (cur->count > 0)
-        {
-            break;
-        }
-        if (prev != nullptr)
-        {
-            prev->~TagData();
-            std::free(prev);
-        }
-        prev = cur;
+        data->~Data();
+        std::free(data);
     }
-    if (prev != nullptr)
+}
+
+void
+PacketTagList::RemoveAll()
+{
+    if (m_data != nullptr)
     {
-        prev->~TagData();
-        std::free(prev);
+        Release(m_data);
+        m_data = nullptr;
     }
-    m_next = nullptr;
+    m_used = 0;
+    m_filter = 0;
+}
+
+uint8_t*
+PacketTagList::GetStorage() const
+{
+    return m_data != nullptr ? m_data->data : const_cast<uint8_t*>(m_inline);
+}
+
+const PacketTagList::TagData*
+PacketTagList::Begin() const
+{
+    return reinterpret_cast<const TagData*>(GetStorage());
+}
+
+const PacketTagList::TagData*
+PacketTagList::End() const
+{
+    return reinterpret_cast<const TagData*>(GetStorage() + m_used);
 }
 
 } // namespace ns3
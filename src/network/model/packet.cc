@@ -20,6 +20,7 @@
 
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
 #include "ns3/simulator.h"
 
 #include <cstdarg>
@@ -30,7 +31,40 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Packet::m_globalUid = 0;
+#else
 uint32_t Packet::m_globalUid = 0;
+#endif
+
+#ifdef NS3_MTP
+/// The uid counter of the calling thread, if any
+static thread_local uint64_t* g_threadUid = nullptr;
+
+void
+Packet::SetThreadUidCounter(uint64_t* counter)
+{
+    g_threadUid = counter;
+}
+#endif
+
+uint64_t
+Packet::AllocateUid()
+{
+#ifdef NS3_MTP
+    if (g_threadUid != nullptr)
+    {
+        return (*g_threadUid)++;
+    }
+#endif
+    return static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++;
+}
+
+/**
+ * \ingroup packet
+ * The MemoryAccounting category of the Packet instances.
+ */
+static const uint32_t g_packetMemory = MemoryAccounting::RegisterCategory("Packet");
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -89,15 +123,17 @@ ByteTagIterator::ByteTagIterator(ByteTagList::Iterator i)
 {
 }
 
-PacketTagIterator::PacketTagIterator(const PacketTagList::TagData* head)
-    : m_current(head)
+PacketTagIterator::PacketTagIterator(const PacketTagList::TagData* head,
+                                     const PacketTagList::TagData* end)
+    : m_current(head),
+      m_end(end)
 {
 }
 
 bool
 PacketTagIterator::HasNext() const
 {
-    return m_current != nullptr;
+    return m_current != m_end;
 }
 
 PacketTagIterator::Item
@@ -105,7 +141,7 @@ PacketTagIterator::Next()
 {
     NS_ASSERT(HasNext());
     const PacketTagList::TagData* prev = m_current;
-    m_current = m_current->next;
+    m_current = m_current->GetNext();
     return PacketTagIterator::Item(prev);
 }
 
@@ -124,7 +160,8 @@ void
 PacketTagIterator::Item::GetTag(Tag& tag) const
 {
     NS_ASSERT(tag.GetInstanceTypeId() == m_data->tid);
-    tag.Deserialize(TagBuffer((uint8_t*)m_data->data, (uint8_t*)m_data->data + m_data->size));
+    auto data = const_cast<uint8_t*>(m_data->GetData());
+    tag.Deserialize(TagBuffer(data, data + m_data->size));
 }
 
 Ptr<Packet>
@@ -146,10 +183,10 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(AllocateUid(), 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
+    MemoryAccounting::Allocated(g_packetMemory, sizeof(Packet));
 }
 
 Packet::Packet(const Packet& o)
@@ -158,6 +195,7 @@ Packet::Packet(const Packet& o)
       m_packetTagList(o.m_packetTagList),
       m_metadata(o.m_metadata)
 {
+    MemoryAccounting::Allocated(g_packetMemory, sizeof(Packet));
     o.m_nixVector ? m_nixVector = o.m_nixVector->Copy() : m_nixVector = nullptr;
 }
 
@@ -186,10 +224,20 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(AllocateUid(), size),
+      m_nixVector(nullptr)
+{
+    MemoryAccounting::Allocated(g_packetMemory, sizeof(Packet));
+}
+
+Packet::Packet(uint32_t size, Buffer::PayloadGenerator generator)
+    : m_buffer(size, generator),
+      m_byteTagList(),
+      m_packetTagList(),
+      m_metadata(AllocateUid(), size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
+    MemoryAccounting::Allocated(g_packetMemory, sizeof(Packet));
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -199,6 +247,7 @@ Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
       m_metadata(0, 0),
       m_nixVector(nullptr)
 {
+    MemoryAccounting::Allocated(g_packetMemory, sizeof(Packet));
     NS_ASSERT(magic);
     Deserialize(buffer, size);
 }
@@ -213,10 +262,10 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(AllocateUid(), size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
+    MemoryAccounting::Allocated(g_packetMemory, sizeof(Packet));
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -232,6 +281,12 @@ Packet::Packet(const Buffer& buffer,
       m_metadata(metadata),
       m_nixVector(nullptr)
 {
+    MemoryAccounting::Allocated(g_packetMemory, sizeof(Packet));
+}
+
+Packet::~Packet()
+{
+    MemoryAccounting::Released(g_packetMemory, sizeof(Packet));
 }
 
 Ptr<Packet>
@@ -408,6 +463,12 @@ Packet::CopyData(std::ostream* os, uint32_t size) const
     return m_buffer.CopyData(os, size);
 }
 
+uint32_t
+Packet::GetVirtualPayloadSize() const
+{
+    return m_buffer.GetVirtualPayloadSize();
+}
+
 uint64_t
 Packet::GetUid() const
 {
@@ -1019,7 +1080,7 @@ Packet::PrintPacketTags(std::ostream& os) const
 PacketTagIterator
 Packet::GetPacketTagIterator() const
 {
-    return PacketTagIterator(m_packetTagList.Head());
+    return PacketTagIterator(m_packetTagList.Begin(), m_packetTagList.End());
 }
 
 std::ostream&
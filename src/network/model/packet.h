@@ -35,6 +35,10 @@
 
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -130,7 +134,8 @@ class ByteTagIterator
  * \ingroup packet
  * \brief Iterator over the set of packet tags in a packet
  *
- * This is a java-style iterator.
+ * This is a java-style iterator.  It is invalidated when the packet tags
+ * of the packet are modified.
  */
 class PacketTagIterator
 {
@@ -181,9 +186,11 @@ class PacketTagIterator
     /**
      * Constructor
      * \param head head of the items
+     * \param end end of the items
      */
-    PacketTagIterator(const PacketTagList::TagData* head);
+    PacketTagIterator(const PacketTagList::TagData* head, const PacketTagList::TagData* end);
     const PacketTagList::TagData* m_current; //!< actual position over the set of tags in a packet
+    const PacketTagList::TagData* m_end;     //!< end of the set of tags in a packet
 };
 
 /**
@@ -254,6 +261,10 @@ class Packet : public SimpleRefCount<Packet>
      * \return the copied object
      */
     Packet& operator=(const Packet& o);
+    /**
+     * \brief Destructor
+     */
+    ~Packet();
     /**
      * \brief Create a packet with a zero-filled payload.
      *
@@ -266,6 +277,21 @@ class Packet : public SimpleRefCount<Packet>
      * \param size the size of the zero-filled payload
      */
     Packet(uint32_t size);
+    /**
+     * \brief Create a packet with a virtual payload.
+     *
+     * As with a zero-filled payload, no memory is allocated for the
+     * payload, which stays virtual through fragmentation, concatenation
+     * with other virtual payloads, and the addition and removal of
+     * headers and trailers.  Its bytes are computed by the generator
+     * only when they are accessed: by CopyData(), by Serialize(), for
+     * instance to write a pcap trace or to send the packet to another MPI
+     * rank, or by a Header or Trailer which reads them.
+     *
+     * \param size the size of the payload
+     * \param generator the function which computes the payload bytes
+     */
+    Packet(uint32_t size, Buffer::PayloadGenerator generator);
     /**
      * \brief Create a new packet from the serialized buffer.
      *
@@ -308,6 +334,16 @@ class Packet : public SimpleRefCount<Packet>
      * \returns the size in bytes of the packet
      */
     inline uint32_t GetSize() const;
+
+    /**
+     * \brief Returns the size of the virtual payload of the packet.
+     *
+     * This is the number of zero-filled or generated payload bytes which
+     * are not stored in memory.
+     *
+     * \returns the size in bytes of the virtual payload
+     */
+    uint32_t GetVirtualPayloadSize() const;
     /**
      * \brief Add header to this packet.
      *
@@ -537,6 +573,21 @@ class Packet : public SimpleRefCount<Packet>
      */
     static void EnableChecking();
 
+#ifdef NS3_MTP
+    /**
+     * \brief Set the counter the packets created by the calling thread
+     * take their uid from.
+     *
+     * Parallel simulator implementations give each logical process its
+     * own counter, starting at a base which depends on the logical
+     * process only, so that the packet uids do not depend on the
+     * interleaving of the threads.
+     *
+     * \param [in] counter The counter, or \c nullptr to use the global one.
+     */
+    static void SetThreadUidCounter(uint64_t* counter);
+#endif
+
     /**
      * \brief Returns number of bytes required for packet
      * serialization.
@@ -787,6 +838,14 @@ class Packet : public SimpleRefCount<Packet>
      */
     uint32_t Deserialize(const uint8_t* buffer, uint32_t size);
 
+    /**
+     * \brief Allocate the uid of a new packet.
+     * \returns the system id in the upper 32 bits and the value of the
+     * global counter in the lower 32 bits, or the value of the counter of
+     * the calling thread if one was set.
+     */
+    static uint64_t AllocateUid();
+
     Buffer m_buffer;               //!< the packet buffer (it's actual contents)
     ByteTagList m_byteTagList;     //!< the ByteTag list
     PacketTagList m_packetTagList; //!< the packet's Tag list
@@ -795,7 +854,11 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
     static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
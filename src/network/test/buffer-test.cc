@@ -19,9 +19,15 @@
 
 #include "ns3/buffer.h"
 #include "ns3/double.h"
+#include "ns3/memory-accounting.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -29,6 +35,32 @@ using namespace ns3;
  * \defgroup network-test Network module unit tests
  */
 
+/**
+ * Compute the Internet checksum of bytes, one word at a time, as
+ * Buffer::Iterator::CalculateIpChecksum() does.
+ * \param data The bytes
+ * \param size The number of bytes
+ * \returns The checksum
+ */
+static uint16_t
+Checksum(const uint8_t* data, uint32_t size)
+{
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i + 1 < size; i += 2)
+    {
+        sum += data[i] | (data[i + 1] << 8);
+    }
+    if (size & 1)
+    {
+        sum += data[size - 1];
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return ~sum;
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -395,6 +427,372 @@ BufferTest::DoRun()
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer virtual payload unit tests.
+ */
+class BufferVirtualPayloadTest : public TestCase
+{
+  public:
+    BufferVirtualPayloadTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Generate the payload bytes from their offset.
+     * \param buffer The bytes to fill
+     * \param offset The offset of the first byte in the payload
+     * \param size The number of bytes
+     */
+    static void Generate(uint8_t* buffer, uint32_t offset, uint32_t size);
+
+    /**
+     * Check that the bytes of a buffer are those of the payload.
+     * \param b The buffer to check
+     * \param offset The offset in the payload of the first byte of the buffer
+     * \param msg The message printed on failure
+     */
+    void CheckPayload(const Buffer& b, uint32_t offset, const std::string& msg);
+};
+
+BufferVirtualPayloadTest::BufferVirtualPayloadTest()
+    : TestCase("Buffer virtual payload")
+{
+}
+
+void
+BufferVirtualPayloadTest::Generate(uint8_t* buffer, uint32_t offset, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        buffer[i] = static_cast<uint8_t>((offset + i) * 7);
+    }
+}
+
+void
+BufferVirtualPayloadTest::CheckPayload(const Buffer& b, uint32_t offset, const std::string& msg)
+{
+    std::vector<uint8_t> bytes(b.GetSize());
+    b.CopyData(bytes.data(), bytes.size());
+    Buffer::Iterator it = b.Begin();
+    for (uint32_t i = 0; i < bytes.size(); ++i)
+    {
+        uint8_t expected = static_cast<uint8_t>((offset + i) * 7);
+        NS_TEST_ASSERT_MSG_EQ(bytes[i], expected, msg << ": bad copied byte " << i);
+        NS_TEST_ASSERT_MSG_EQ(it.ReadU8(), expected, msg << ": bad read byte " << i);
+    }
+    for (uint32_t start : {0, 1})
+    {
+        it = b.Begin();
+        it.Next(start);
+        uint32_t n = bytes.size() - start;
+        NS_TEST_EXPECT_MSG_EQ(it.CalculateIpChecksum(n),
+                              Checksum(bytes.data() + start, n),
+                              msg << ": bad checksum from byte " << start);
+    }
+}
+
+void
+BufferVirtualPayloadTest::DoRun()
+{
+    const uint32_t size = 3000;
+    Buffer payload(size, &Generate);
+    NS_TEST_EXPECT_MSG_EQ(payload.GetSize(), size, "Bad size");
+    NS_TEST_EXPECT_MSG_EQ(payload.GetVirtualPayloadSize(), size, "Payload not virtual");
+    CheckPayload(payload, 0, "Whole payload");
+
+    // Fragments keep their offset in the payload
+    Buffer first = payload.CreateFragment(0, 1000);
+    Buffer second = payload.CreateFragment(1000, 1500);
+    Buffer third = payload.CreateFragment(2500, 500);
+    NS_TEST_EXPECT_MSG_EQ(second.GetVirtualPayloadSize(), 1500, "Fragment not virtual");
+    CheckPayload(second, 1000, "Fragment");
+
+    // Removing the start of the payload moves its offset
+    Buffer removed = payload;
+    removed.RemoveAtStart(10);
+    removed.RemoveAtEnd(10);
+    NS_TEST_EXPECT_MSG_EQ(removed.GetVirtualPayloadSize(), size - 20, "Removal materialized");
+    CheckPayload(removed, 10, "Removal");
+
+    // Contiguous fragments are reassembled without being materialized
+    Buffer reassembled = first;
+    reassembled.AddAtEnd(second);
+    reassembled.AddAtEnd(third);
+    NS_TEST_EXPECT_MSG_EQ(reassembled.GetVirtualPayloadSize(), size, "Reassembly materialized");
+    CheckPayload(reassembled, 0, "Reassembly");
+    CheckPayload(second, 1000, "Fragment after the reassembly");
+
+    // Fragments out of order are materialized
+    Buffer swapped = second;
+    swapped.AddAtEnd(first);
+    NS_TEST_EXPECT_MSG_EQ(swapped.GetVirtualPayloadSize(), 0, "Swapped fragments virtual");
+    CheckPayload(swapped.CreateFragment(0, 1500), 1000, "First swapped fragment");
+    CheckPayload(swapped.CreateFragment(1500, 1000), 0, "Second swapped fragment");
+
+    // Headers and trailers are written around the payload
+    Buffer framed = second;
+    framed.AddAtStart(2);
+    framed.Begin().WriteU16(0xabcd);
+    framed.AddAtEnd(1);
+    Buffer::Iterator trailer = framed.End();
+    trailer.Prev();
+    trailer.WriteU8(0xef);
+    NS_TEST_EXPECT_MSG_EQ(framed.GetVirtualPayloadSize(), 1500, "Header materialized");
+    CheckPayload(framed.CreateFragment(2, 1500), 1000, "Framed payload");
+    NS_TEST_EXPECT_MSG_EQ(framed.Begin().ReadU16(), 0xabcd, "Bad header");
+    trailer = framed.End();
+    trailer.Prev();
+    NS_TEST_EXPECT_MSG_EQ(trailer.ReadU8(), 0xef, "Bad trailer");
+
+    // Serialization materializes the payload: the zero area is empty, and
+    // the bytes are split between the start and end data
+    std::vector<uint32_t> serialized((framed.GetSerializedSize() + 3) / 4);
+    auto raw = reinterpret_cast<uint8_t*>(serialized.data());
+    NS_TEST_ASSERT_MSG_EQ(framed.Serialize(raw, framed.GetSerializedSize()),
+                          1,
+                          "Serialization failed");
+    NS_TEST_EXPECT_MSG_EQ(serialized[0], 0, "Virtual payload serialized");
+    uint32_t startLength = serialized[1];
+    uint32_t endIndex = 2 + (startLength + 3) / 4;
+    NS_TEST_ASSERT_MSG_LT(endIndex, serialized.size(), "Bad start data length");
+    uint32_t endLength = serialized[endIndex];
+    NS_TEST_ASSERT_MSG_EQ(startLength + endLength, 1503, "Bad data lengths");
+    Buffer copy;
+    copy.AddAtStart(1503);
+    Buffer::Iterator it = copy.Begin();
+    it.Write(raw + 8, startLength);
+    it.Write(raw + 4 * (endIndex + 1), endLength);
+    CheckPayload(copy.CreateFragment(2, 1500), 1000, "Serialized payload");
+
+    // Zero-filled payloads are unchanged
+    Buffer zeros(100);
+    NS_TEST_EXPECT_MSG_EQ(zeros.GetVirtualPayloadSize(), 100, "Zeros not virtual");
+    zeros.AddAtEnd(Buffer(50));
+    NS_TEST_EXPECT_MSG_EQ(zeros.GetVirtualPayloadSize(), 150, "Zeros materialized");
+    std::vector<uint8_t> bytes(150, 1);
+    zeros.CopyData(bytes.data(), bytes.size());
+    NS_TEST_EXPECT_MSG_EQ(std::count(bytes.begin(), bytes.end(), 0), 150, "Bad zeros");
+    Buffer mixed = second.CreateFragment(0, 10);
+    mixed.AddAtEnd(Buffer(10));
+    NS_TEST_EXPECT_MSG_EQ(mixed.GetVirtualPayloadSize(), 0, "Mixed payloads virtual");
+    CheckPayload(mixed.CreateFragment(0, 10), 1000, "Generated part of mixed payloads");
+    Buffer::Iterator zero = mixed.Begin();
+    zero.Next(10);
+    NS_TEST_EXPECT_MSG_EQ(zero.ReadU8(), 0, "Bad zero part of mixed payloads");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer scatter-gather unit tests.
+ */
+class BufferScatterGatherTest : public TestCase
+{
+  public:
+    BufferScatterGatherTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check the bytes of a buffer, read with CopyData and with iterators.
+     * \param b The buffer to check
+     * \param expected The expected bytes
+     * \param msg The message printed on failure
+     */
+    void CheckBytes(const Buffer& b, const std::vector<uint8_t>& expected, const std::string& msg);
+};
+
+BufferScatterGatherTest::BufferScatterGatherTest()
+    : TestCase("Buffer scatter-gather")
+{
+}
+
+void
+BufferScatterGatherTest::CheckBytes(const Buffer& b,
+                                    const std::vector<uint8_t>& expected,
+                                    const std::string& msg)
+{
+    NS_TEST_ASSERT_MSG_EQ(b.GetSize(), expected.size(), msg << ": bad size");
+    std::vector<uint8_t> copied(b.GetSize());
+    NS_TEST_ASSERT_MSG_EQ(b.CopyData(copied.data(), copied.size()),
+                          expected.size(),
+                          msg << ": bad copied size");
+    std::vector<uint8_t> read(b.GetSize());
+    b.Begin().Read(read.data(), read.size());
+    Buffer::Iterator it = b.Begin();
+    for (uint32_t i = 0; i < expected.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(copied[i], expected[i], msg << ": bad copied byte " << i);
+        NS_TEST_ASSERT_MSG_EQ(read[i], expected[i], msg << ": bad read byte " << i);
+        NS_TEST_ASSERT_MSG_EQ(it.ReadU8(), expected[i], msg << ": bad iterated byte " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(it.IsEnd(), true, msg << ": iterator not at the end");
+    // The checksum sums each segment at once, from an even or odd offset
+    for (uint32_t start : {0, 1})
+    {
+        it = b.Begin();
+        it.Next(start);
+        uint32_t n = expected.size() - start;
+        NS_TEST_EXPECT_MSG_EQ(it.CalculateIpChecksum(n),
+                              Checksum(expected.data() + start, n),
+                              msg << ": bad checksum from byte " << start);
+    }
+    std::ostringstream os;
+    b.CopyData(&os, b.GetSize());
+    NS_TEST_EXPECT_MSG_EQ((os.str() == std::string(expected.begin(), expected.end())),
+                          true,
+                          msg << ": bad bytes copied to a stream");
+}
+
+void
+BufferScatterGatherTest::DoRun()
+{
+    bool enabled = Buffer::IsScatterGatherEnabled();
+    MemoryAccounting::Enable();
+    auto chains = MemoryAccounting::GetUsage("Buffer::Chain");
+
+    const uint32_t size = 4000;
+    std::vector<uint8_t> bytes(size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        bytes[i] = static_cast<uint8_t>(i * 13 + i / 256);
+    }
+    Buffer original;
+    original.AddAtStart(size);
+    original.Begin().Write(bytes.data(), size);
+
+    Buffer::EnableScatterGather();
+    NS_TEST_EXPECT_MSG_EQ(Buffer::IsScatterGatherEnabled(), true, "Not enabled");
+
+    // Large fragments reference the bytes of the original buffer, and take
+    // headers without modifying it
+    const uint32_t offsets[] = {0, 1400, 2800, size};
+    std::vector<Buffer> fragments;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        uint32_t length = offsets[i + 1] - offsets[i];
+        Buffer fragment = original.CreateFragment(offsets[i], length);
+        NS_TEST_EXPECT_MSG_EQ(fragment.GetVirtualPayloadSize(), 0, "Chained bytes virtual");
+        fragment.AddAtStart(4);
+        fragment.Begin().WriteHtonU32(0xdead0000 + i);
+        std::vector<uint8_t> expected = {0xde, 0xad, 0x00, static_cast<uint8_t>(i)};
+        expected.insert(expected.end(),
+                        bytes.begin() + offsets[i],
+                        bytes.begin() + offsets[i + 1]);
+        CheckBytes(fragment, expected, "Fragment " + std::to_string(i));
+        fragments.push_back(fragment);
+    }
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(MemoryAccounting::GetUsage("Buffer::Chain").count,
+                                chains.count + 3,
+                                "Fragments not chained");
+    CheckBytes(original, bytes, "Original after the fragmentation");
+
+    // Small fragments are copied
+    CheckBytes(original.CreateFragment(10, 100),
+               std::vector<uint8_t>(bytes.begin() + 10, bytes.begin() + 110),
+               "Small fragment");
+
+    // The reassembly chains the fragments
+    Buffer reassembled;
+    for (auto fragment : fragments)
+    {
+        fragment.RemoveAtStart(4);
+        reassembled.AddAtEnd(fragment);
+    }
+    CheckBytes(reassembled, bytes, "Reassembly");
+
+    // The multi-byte reads cross the segments
+    Buffer::Iterator it = reassembled.Begin();
+    it.Next(1398);
+    uint32_t value = 0;
+    for (uint32_t i = 1398; i < 1402; ++i)
+    {
+        value = (value << 8) | bytes[i];
+    }
+    NS_TEST_EXPECT_MSG_EQ(it.ReadNtohU32(), value, "Bad read across segments");
+    NS_TEST_EXPECT_MSG_EQ(it.GetDistanceFrom(reassembled.Begin()), 1402, "Bad distance");
+
+    // Headers, trailers and removals around a chain
+    Buffer framed = reassembled;
+    framed.AddAtStart(2);
+    framed.Begin().WriteU16(0xabcd);
+    framed.AddAtEnd(1);
+    it = framed.End();
+    it.Prev();
+    it.WriteU8(0xef);
+    framed.RemoveAtStart(1);
+    framed.RemoveAtEnd(1);
+    std::vector<uint8_t> framedBytes = {0xab};
+    framedBytes.insert(framedBytes.end(), bytes.begin(), bytes.end());
+    CheckBytes(framed, framedBytes, "Framed chain");
+    CheckBytes(reassembled, bytes, "Reassembly after the framing");
+    CheckBytes(framed.CreateFragment(1000, 2000),
+               std::vector<uint8_t>(framedBytes.begin() + 1000, framedBytes.begin() + 3000),
+               "Fragment of a chain");
+
+    // A buffer appended to itself
+    Buffer twice = reassembled;
+    twice.AddAtEnd(twice);
+    std::vector<uint8_t> twiceBytes = bytes;
+    twiceBytes.insert(twiceBytes.end(), bytes.begin(), bytes.end());
+    CheckBytes(twice, twiceBytes, "Buffer appended to itself");
+
+    // A short buffer appended to a chain is chained, not copied with it
+    Buffer small;
+    small.AddAtStart(10);
+    small.Begin().Write(bytes.data(), 10);
+    auto before = MemoryAccounting::GetUsage("Buffer::Chain").count;
+    Buffer extended = reassembled;
+    extended.AddAtEnd(small);
+    NS_TEST_EXPECT_MSG_EQ(MemoryAccounting::GetUsage("Buffer::Chain").count,
+                          before + 1,
+                          "Chain copied");
+    std::vector<uint8_t> extendedBytes = bytes;
+    extendedBytes.insert(extendedBytes.end(), bytes.begin(), bytes.begin() + 10);
+    CheckBytes(extended, extendedBytes, "Short buffer appended to a chain");
+
+    // The serialization and PeekData linearize the chain
+    std::vector<uint32_t> serialized((framed.GetSerializedSize() + 3) / 4);
+    auto raw = reinterpret_cast<uint8_t*>(serialized.data());
+    NS_TEST_ASSERT_MSG_EQ(framed.Serialize(raw, framed.GetSerializedSize()),
+                          1,
+                          "Serialization failed");
+    NS_TEST_EXPECT_MSG_EQ(serialized[0], 0, "Chain serialized as zeroes");
+    Buffer deserialized;
+    // the size includes the length which precedes the buffer in a packet
+    deserialized.Deserialize(raw, framed.GetSerializedSize() + 4);
+    CheckBytes(deserialized, framedBytes, "Deserialized chain");
+    NS_TEST_EXPECT_MSG_EQ(memcmp(framed.PeekData(), framedBytes.data(), framedBytes.size()),
+                          0,
+                          "Bad linearized bytes");
+
+    // The buffers built in the scatter-gather mode outlive it
+    Buffer::EnableScatterGather(false);
+    Buffer copied = reassembled;
+    copied.AddAtEnd(fragments[0]);
+    std::vector<uint8_t> copiedBytes = bytes;
+    copiedBytes.insert(copiedBytes.end(), {0xde, 0xad, 0x00, 0x00});
+    copiedBytes.insert(copiedBytes.end(), bytes.begin(), bytes.begin() + 1400);
+    CheckBytes(copied, copiedBytes, "Copy of a chain");
+
+    fragments.clear();
+    reassembled = Buffer();
+    framed = Buffer();
+    twice = Buffer();
+    extended = Buffer();
+    copied = Buffer();
+    NS_TEST_EXPECT_MSG_EQ(MemoryAccounting::GetUsage("Buffer::Chain").count,
+                          chains.count,
+                          "Chains not released");
+    Buffer::EnableScatterGather(enabled);
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -411,6 +809,8 @@ BufferTestSuite::BufferTestSuite()
     : TestSuite("buffer", UNIT)
 {
     AddTestCase(new BufferTest, TestCase::QUICK);
+    AddTestCase(new BufferVirtualPayloadTest, TestCase::QUICK);
+    AddTestCase(new BufferScatterGatherTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
@@ -25,6 +25,7 @@
 #include <cstdarg>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -326,7 +327,11 @@ HistoryTrailer<N>::Deserialize(Buffer::Iterator start)
 class PacketMetadataTest : public TestCase
 {
   public:
-    PacketMetadataTest();
+    /**
+     * Constructor
+     * \param engine The representation of the metadata
+     */
+    PacketMetadataTest(PacketMetadata::Engine engine);
     ~PacketMetadataTest() override;
     /**
      * Checks the packet header and trailer history
@@ -344,10 +349,15 @@ class PacketMetadataTest : public TestCase
      * \return The packet with the header added.
      */
     Ptr<Packet> DoAddHeader(Ptr<Packet> p);
+    /// Run the checks with the engine selected.
+    void DoRunChecks();
+
+    PacketMetadata::Engine m_engine; //!< The representation of the metadata
 };
 
-PacketMetadataTest::PacketMetadataTest()
-    : TestCase("Packet metadata")
+PacketMetadataTest::PacketMetadataTest(PacketMetadata::Engine engine)
+    : TestCase(engine == PacketMetadata::LIST ? "Packet metadata" : "Packet metadata (arena)"),
+      m_engine(engine)
 {
 }
 
@@ -413,6 +423,10 @@ PacketMetadataTest::CheckHistory(Ptr<Packet> p, uint32_t n, ...)
         got.push_back(item.currentSize);
     }
 
+    if (got.size() != expected.size())
+    {
+        goto error;
+    }
     for (auto i = got.begin(), j = expected.begin(); i != got.end(); i++, j++)
     {
         NS_ASSERT(j != expected.end());
@@ -480,6 +494,15 @@ void
 PacketMetadataTest::DoRun()
 {
     PacketMetadata::Enable();
+    PacketMetadata::Engine engine = PacketMetadata::GetEngine();
+    PacketMetadata::SetEngine(m_engine);
+    DoRunChecks();
+    PacketMetadata::SetEngine(engine);
+}
+
+void
+PacketMetadataTest::DoRunChecks()
+{
 
     Ptr<Packet> p = Create<Packet>(0);
     Ptr<Packet> p1 = Create<Packet>(0);
@@ -881,6 +904,184 @@ PacketMetadataTest::DoRun()
                           "Could not find original data in received packet");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet Metadata engines unit tests: the ARENA engine must record the
+ * same items as the LIST engine, share them between copies, and work with
+ * packets created with the LIST engine.
+ */
+class PacketMetadataEngineTest : public TestCase
+{
+  public:
+    PacketMetadataEngineTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Describe the items of a packet
+     * \param p The packet
+     * \return The description of the items
+     */
+    static std::string Describe(Ptr<const Packet> p);
+    /**
+     * Build packets through headers, trailers, fragmentation and reassembly
+     * \return The descriptions of the packets
+     */
+    static std::vector<std::string> RunScenario();
+    /**
+     * Get the number of nodes of the ARENA engine in use
+     * \return The number of nodes
+     */
+    static int64_t GetNodes();
+};
+
+PacketMetadataEngineTest::PacketMetadataEngineTest()
+    : TestCase("Packet metadata engines")
+{
+}
+
+std::string
+PacketMetadataEngineTest::Describe(Ptr<const Packet> p)
+{
+    std::ostringstream oss;
+    PacketMetadata::ItemIterator k = p->BeginItem();
+    while (k.HasNext())
+    {
+        PacketMetadata::Item item = k.Next();
+        oss << item.type << ":" << item.tid.GetUid() << ":" << item.currentSize << ":"
+            << item.isFragment << ":" << item.currentTrimmedFromStart << " ";
+    }
+    return oss.str();
+}
+
+std::vector<std::string>
+PacketMetadataEngineTest::RunScenario()
+{
+    std::vector<std::string> descriptions;
+    Ptr<Packet> p = Create<Packet>(1000);
+    ADD_HEADER(p, 8);
+    ADD_HEADER(p, 20);
+    ADD_TRAILER(p, 4);
+    descriptions.push_back(Describe(p));
+
+    // Fragments reassembled in order merge back, out of order they do not
+    std::vector<Ptr<Packet>> fragments;
+    for (uint32_t offset = 0; offset < p->GetSize(); offset += 100)
+    {
+        fragments.push_back(p->CreateFragment(offset, std::min(100U, p->GetSize() - offset)));
+    }
+    descriptions.push_back(Describe(fragments[0]));
+    descriptions.push_back(Describe(fragments.back()));
+    Ptr<Packet> inOrder = Create<Packet>();
+    for (const auto& fragment : fragments)
+    {
+        inOrder->AddAtEnd(fragment);
+    }
+    descriptions.push_back(Describe(inOrder));
+    Ptr<Packet> swapped = fragments[1]->Copy();
+    swapped->AddAtEnd(fragments[0]);
+    swapped->AddAtEnd(fragments[2]);
+    descriptions.push_back(Describe(swapped));
+
+    // Copies evolve independently
+    Ptr<Packet> copy = inOrder->Copy();
+    REM_HEADER(copy, 20);
+    REM_TRAILER(copy, 4);
+    ADD_HEADER(copy, 6);
+    descriptions.push_back(Describe(copy));
+    descriptions.push_back(Describe(inOrder));
+    copy->RemoveAtStart(10);
+    copy->RemoveAtEnd(500);
+    descriptions.push_back(Describe(copy));
+
+    // Serialization
+    uint32_t size = copy->GetSerializedSize();
+    std::vector<uint8_t> buffer(size);
+    copy->Serialize(buffer.data(), size);
+    descriptions.push_back(Describe(Create<Packet>(buffer.data(), size, true)));
+    return descriptions;
+}
+
+int64_t
+PacketMetadataEngineTest::GetNodes()
+{
+    return PacketMetadata::GetArenaNodes();
+}
+
+void
+PacketMetadataEngineTest::DoRun()
+{
+    PacketMetadata::Enable();
+    PacketMetadata::Engine engine = PacketMetadata::GetEngine();
+
+    PacketMetadata::SetEngine(PacketMetadata::LIST);
+    std::vector<std::string> expected = RunScenario();
+    PacketMetadata::SetEngine(PacketMetadata::ARENA);
+    std::vector<std::string> got = RunScenario();
+    NS_TEST_ASSERT_MSG_EQ(got.size(), expected.size(), "Wrong number of packets");
+    for (std::size_t i = 0; i < got.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(got[i], expected[i], "Different items in packet " << i);
+    }
+
+    // Packets created with different engines are concatenated
+    PacketMetadata::SetEngine(PacketMetadata::LIST);
+    Ptr<Packet> list = Create<Packet>(10);
+    ADD_HEADER(list, 2);
+    Ptr<Packet> otherList = Create<Packet>(20);
+    ADD_TRAILER(otherList, 3);
+    Ptr<Packet> listFirst = list->Copy();
+    listFirst->AddAtEnd(otherList);
+    Ptr<Packet> otherFirst = otherList->Copy();
+    otherFirst->AddAtEnd(list);
+    PacketMetadata::SetEngine(PacketMetadata::ARENA);
+    Ptr<Packet> arena = Create<Packet>(20);
+    ADD_TRAILER(arena, 3);
+    Ptr<Packet> mixed = list->Copy();
+    mixed->AddAtEnd(arena);
+    NS_TEST_EXPECT_MSG_EQ(Describe(mixed), Describe(listFirst), "Wrong items, list first");
+    mixed = arena->Copy();
+    mixed->AddAtEnd(list);
+    NS_TEST_EXPECT_MSG_EQ(Describe(mixed), Describe(otherFirst), "Wrong items, arena first");
+
+    // The copies share their items
+    Ptr<Packet> p = Create<Packet>(100);
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        ADD_HEADER(p, 1);
+    }
+    int64_t nodes = GetNodes();
+    std::vector<Ptr<Packet>> copies;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        copies.push_back(p->Copy());
+    }
+    NS_TEST_EXPECT_MSG_EQ(GetNodes(), nodes, "Copies do not share their items");
+    for (const auto& copy : copies)
+    {
+        REM_HEADER(copy, 1);
+        ADD_HEADER(copy, 2);
+    }
+    // each copy has new nodes on the path to its first item only
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(GetNodes(), nodes + 100 * 12, "Copies do not share their items");
+    PacketMetadata::ItemIterator k = copies[0]->BeginItem();
+    NS_TEST_EXPECT_MSG_EQ(k.Next().currentSize, 2, "Wrong first item");
+    uint32_t items = 1;
+    for (; k.HasNext(); k.Next())
+    {
+        ++items;
+    }
+    NS_TEST_EXPECT_MSG_EQ(items, 17, "Wrong number of items");
+    copies.clear();
+    p = nullptr;
+    NS_TEST_EXPECT_MSG_LT(GetNodes(), nodes, "Nodes not released");
+
+    PacketMetadata::SetEngine(engine);
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -896,7 +1097,9 @@ class PacketMetadataTestSuite : public TestSuite
 PacketMetadataTestSuite::PacketMetadataTestSuite()
     : TestSuite("packet-metadata", UNIT)
 {
-    AddTestCase(new PacketMetadataTest, TestCase::QUICK);
+    AddTestCase(new PacketMetadataTest(PacketMetadata::LIST), TestCase::QUICK);
+    AddTestCase(new PacketMetadataTest(PacketMetadata::ARENA), TestCase::QUICK);
+    AddTestCase(new PacketMetadataEngineTest, TestCase::QUICK);
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
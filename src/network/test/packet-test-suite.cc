@@ -16,6 +16,7 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/memory-accounting.h"
 #include "ns3/packet-tag-list.h"
 #include "ns3/packet.h"
 #include "ns3/test.h"
@@ -26,6 +27,7 @@
 #include <iostream>
 #include <limits> // std:numeric_limits
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -956,6 +958,49 @@ PacketTest::DoRun()
         ALargeTestTag a;
         tmp->AddPacketTag(a);
     }
+
+    /* Test virtual payloads through fragmentation and reassembly */
+    {
+        auto generator = [](uint8_t* buffer, uint32_t offset, uint32_t size) {
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                buffer[i] = static_cast<uint8_t>(offset + i);
+            }
+        };
+        Ptr<Packet> tmp = Create<Packet>(1000, generator);
+        tmp->AddHeader(ATestHeader<10>());
+        NS_TEST_EXPECT_MSG_EQ(tmp->GetVirtualPayloadSize(), 1000, "Payload not virtual");
+        Ptr<Packet> reassembled = tmp->CreateFragment(0, 400);
+        reassembled->AddAtEnd(tmp->CreateFragment(400, 610));
+        NS_TEST_EXPECT_MSG_EQ(reassembled->GetSize(), 1010, "Bad reassembled size");
+        NS_TEST_EXPECT_MSG_EQ(reassembled->GetVirtualPayloadSize(), 1000, "Payload materialized");
+        ATestHeader<10> header;
+        reassembled->RemoveHeader(header);
+        NS_TEST_EXPECT_MSG_EQ(header.m_error, false, "Bad header");
+        uint8_t bytes[1000];
+        reassembled->CopyData(bytes, 1000);
+        bool same = true;
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            same &= (bytes[i] == static_cast<uint8_t>(i));
+        }
+        NS_TEST_EXPECT_MSG_EQ(same, true, "Bad generated payload");
+
+        std::vector<uint8_t> serialized(tmp->GetSerializedSize());
+        NS_TEST_ASSERT_MSG_EQ(tmp->Serialize(serialized.data(), serialized.size()),
+                              1,
+                              "Serialization failed");
+        Ptr<Packet> deserialized = Create<Packet>(serialized.data(), serialized.size(), true);
+        NS_TEST_EXPECT_MSG_EQ(deserialized->GetSize(), 1010, "Bad deserialized size");
+        deserialized->RemoveHeader(header);
+        deserialized->CopyData(bytes, 1000);
+        same = true;
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            same &= (bytes[i] == static_cast<uint8_t>(i));
+        }
+        NS_TEST_EXPECT_MSG_EQ(same, true, "Bad deserialized payload");
+    }
 }
 
 /**
@@ -1205,6 +1250,59 @@ PacketTagListTest::DoRun()
         ReplaceCheck(7);
     }
 
+    // Inline tags
+    {
+        std::cout << GetName() << "check inline tags and iteration order" << std::endl;
+        Ptr<Packet> p = Create<Packet>(10);
+        ATestTag<1> a(1);
+        ATestTag<2> b(2);
+        ATestTag<3> c(3);
+        p->AddPacketTag(a);
+        p->AddPacketTag(b);
+        p->AddPacketTag(c);
+        Ptr<Packet> copy = p->Copy();
+        ATestTag<2> replacement(5);
+        copy->ReplacePacketTag(replacement);
+        copy->RemovePacketTag(a);
+
+        // The most recent tag comes first
+        std::vector<TypeId> tids;
+        PacketTagIterator i = p->GetPacketTagIterator();
+        while (i.HasNext())
+        {
+            tids.push_back(i.Next().GetTypeId());
+        }
+        NS_TEST_ASSERT_MSG_EQ(tids.size(), 3, "Wrong number of tags");
+        NS_TEST_EXPECT_MSG_EQ(tids[0], c.GetTypeId(), "Wrong first tag");
+        NS_TEST_EXPECT_MSG_EQ(tids[2], a.GetTypeId(), "Wrong last tag");
+        ATestTag<2> peeked;
+        NS_TEST_EXPECT_MSG_EQ(p->PeekPacketTag(peeked), true, "Missing tag in original");
+        NS_TEST_EXPECT_MSG_EQ(peeked.GetData(), 2, "Copy changed the original");
+        NS_TEST_EXPECT_MSG_EQ(copy->PeekPacketTag(peeked), true, "Missing tag in copy");
+        NS_TEST_EXPECT_MSG_EQ(peeked.GetData(), 5, "Tag not replaced in copy");
+        NS_TEST_EXPECT_MSG_EQ(copy->PeekPacketTag(a), false, "Tag not removed from copy");
+
+        // Spill the tags out of the packet, and back
+        ALargeTestTag large;
+        copy->AddPacketTag(large);
+        NS_TEST_EXPECT_MSG_EQ(copy->PeekPacketTag(c), true, "Tag lost when spilled");
+        NS_TEST_EXPECT_MSG_EQ(copy->RemovePacketTag(large), true, "Large tag not removed");
+        NS_TEST_EXPECT_MSG_EQ(copy->PeekPacketTag(peeked), true, "Tag lost when inlined");
+        NS_TEST_EXPECT_MSG_EQ(peeked.GetData(), 5, "Wrong tag when inlined");
+
+        // Serialization keeps the order
+        uint32_t size = p->GetSerializedSize();
+        std::vector<uint8_t> buffer(size);
+        p->Serialize(buffer.data(), size);
+        Ptr<Packet> deserialized = Create<Packet>(buffer.data(), size, true);
+        i = deserialized->GetPacketTagIterator();
+        for (const auto& tid : tids)
+        {
+            NS_TEST_ASSERT_MSG_EQ(i.HasNext(), true, "Missing deserialized tag");
+            NS_TEST_EXPECT_MSG_EQ(i.Next().GetTypeId(), tid, "Wrong deserialized tag");
+        }
+    }
+
     // Timing
     {
         std::cout << GetName() << "add+remove timing" << std::endl;
@@ -1268,6 +1366,65 @@ PacketTagListTest::DoRun()
     } // Timing
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet memory accounting unit tests.
+ */
+class PacketMemoryAccountingTest : public TestCase
+{
+  public:
+    PacketMemoryAccountingTest();
+
+  private:
+    void DoRun() override;
+    /**
+     * Get the bytes of Buffer::Data in use, outside of the free list.
+     * \returns The number of bytes.
+     */
+    int64_t GetBufferBytesInUse() const;
+};
+
+PacketMemoryAccountingTest::PacketMemoryAccountingTest()
+    : TestCase("Check the memory accounted for by the packets")
+{
+}
+
+int64_t
+PacketMemoryAccountingTest::GetBufferBytesInUse() const
+{
+    return MemoryAccounting::GetUsage("Buffer::Data").bytes -
+           MemoryAccounting::GetUsage("Buffer::Data (free list)").bytes;
+}
+
+void
+PacketMemoryAccountingTest::DoRun()
+{
+    MemoryAccounting::Enable();
+    // The packets created before the accounting was enabled make the
+    // absolute values meaningless here: only check the changes
+    auto packets = MemoryAccounting::GetUsage("Packet");
+    int64_t buffers = GetBufferBytesInUse();
+    {
+        // Real bytes, since a zero-filled payload is not stored
+        std::vector<uint8_t> data(1000, 1);
+        Ptr<Packet> p = Create<Packet>(data.data(), data.size());
+        Ptr<Packet> copy = p->Copy();
+        Ptr<Packet> fragment = p->CreateFragment(0, 500);
+        auto usage = MemoryAccounting::GetUsage("Packet");
+        NS_TEST_EXPECT_MSG_EQ(usage.count, packets.count + 3, "Wrong number of packets");
+        NS_TEST_EXPECT_MSG_EQ(usage.bytes,
+                              packets.bytes + 3 * static_cast<int64_t>(sizeof(Packet)),
+                              "Wrong packet bytes");
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(GetBufferBytesInUse(), buffers + 1000, "Buffer not counted");
+    }
+    auto usage = MemoryAccounting::GetUsage("Packet");
+    NS_TEST_EXPECT_MSG_EQ(usage.count, packets.count, "Packets not released");
+    NS_TEST_EXPECT_MSG_EQ(usage.bytes, packets.bytes, "Packet bytes not released");
+    NS_TEST_EXPECT_MSG_EQ(GetBufferBytesInUse(), buffers, "Buffers not released");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1285,6 +1442,7 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::QUICK);
+    AddTestCase(new PacketMemoryAccountingTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
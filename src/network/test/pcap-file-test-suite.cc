@@ -19,12 +19,18 @@
 #include "ns3/pcap-file.h"
 #include "ns3/test.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <sstream>
 
+#ifndef __WIN32__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("pcap-file-test-suite");
@@ -1375,6 +1381,173 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that asynchronous writes produce the same file
+ * as synchronous ones, also in a process forked while a file is being written.
+ */
+class AsyncWriteTestCase : public TestCase
+{
+  public:
+    AsyncWriteTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write the test records to a file.
+     * \param filename the file name
+     * \param bufferSize the async buffer size, or 0 for synchronous writes
+     */
+    void WriteRecords(const std::string& filename, uint32_t bufferSize);
+};
+
+/// Number of records written by AsyncWriteTestCase
+static const uint32_t N_ASYNC_RECORDS = 1000;
+/// Snapshot length used by AsyncWriteTestCase
+static const uint32_t ASYNC_SNAPLEN = 100;
+
+AsyncWriteTestCase::AsyncWriteTestCase()
+    : TestCase("Check that asynchronous writes match synchronous writes")
+{
+}
+
+void
+AsyncWriteTestCase::WriteRecords(const std::string& filename, uint32_t bufferSize)
+{
+    PcapFile f;
+    f.Open(filename, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(),
+                          false,
+                          "Open (" << filename << ", \"std::ios::out\") returns error");
+    if (bufferSize)
+    {
+        f.EnableAsync(bufferSize);
+        NS_TEST_ASSERT_MSG_EQ(f.IsAsync(), true, "EnableAsync() did not enable async mode");
+    }
+    f.Init(1, ASYNC_SNAPLEN);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Init (1, " << ASYNC_SNAPLEN << ") returns error");
+
+    uint8_t data[2 * ASYNC_SNAPLEN];
+    for (uint32_t i = 0; i < N_ASYNC_RECORDS; ++i)
+    {
+        uint32_t size = 1 + (i * 7) % sizeof(data);
+        for (uint32_t j = 0; j < size; ++j)
+        {
+            data[j] = static_cast<uint8_t>(i + j);
+        }
+        f.Write(i / 100, (i % 100) * 1000, data, size);
+        if (i == N_ASYNC_RECORDS / 2)
+        {
+            f.Flush();
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Write must not fail");
+    f.Close();
+}
+
+void
+AsyncWriteTestCase::DoRun()
+{
+    std::string syncName = CreateTempDirFilename("sync.pcap");
+    std::string asyncName = CreateTempDirFilename("async.pcap");
+
+    WriteRecords(syncName, 0);
+    // A small buffer forces many blocks through the writer thread
+    WriteRecords(asyncName, 512);
+
+    uint32_t sec(0);
+    uint32_t usec(0);
+    uint32_t packets(0);
+    bool diff = PcapFile::Diff(syncName, asyncName, sec, usec, packets, ASYNC_SNAPLEN);
+    NS_TEST_EXPECT_MSG_EQ(diff, false, "Async file differs from sync file");
+    NS_TEST_EXPECT_MSG_EQ(packets, N_ASYNC_RECORDS, "Unexpected number of records compared");
+
+    //
+    // Read the async file back to make sure the record headers honour the snaplen
+    //
+    PcapFile f;
+    f.Open(asyncName, std::ios::in);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Open (" << asyncName << ") returns error");
+    uint8_t data[ASYNC_SNAPLEN];
+    uint32_t tsSec;
+    uint32_t tsUsec;
+    uint32_t inclLen;
+    uint32_t origLen;
+    uint32_t readLen;
+    for (uint32_t i = 0; i < N_ASYNC_RECORDS; ++i)
+    {
+        uint32_t size = 1 + (i * 7) % (2 * ASYNC_SNAPLEN);
+        f.Read(data, sizeof(data), tsSec, tsUsec, inclLen, origLen, readLen);
+        NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Read() of record " << i << " returns error");
+        NS_TEST_EXPECT_MSG_EQ(origLen, size, "Wrong original length in record " << i);
+        NS_TEST_EXPECT_MSG_EQ(inclLen,
+                              std::min(size, ASYNC_SNAPLEN),
+                              "Wrong included length in record " << i);
+        NS_TEST_EXPECT_MSG_EQ(data[inclLen - 1],
+                              static_cast<uint8_t>(i + inclLen - 1),
+                              "Wrong data in record " << i);
+    }
+    f.Read(data, 1, tsSec, tsUsec, inclLen, origLen, readLen);
+    NS_TEST_EXPECT_MSG_EQ(f.Eof(), true, "Async file has trailing data");
+    f.Close();
+
+#ifndef __WIN32__
+    //
+    // Fork while the writer thread has blocks of another file: the child
+    // writes its own file, and the parent completes the other one
+    //
+    std::string parentName = CreateTempDirFilename("parent.pcap");
+    std::string childName = CreateTempDirFilename("child.pcap");
+    PcapFile g;
+    g.Open(parentName, std::ios::out);
+    g.EnableAsync(512);
+    g.Init(1, ASYNC_SNAPLEN);
+    std::memset(data, 0, sizeof(data));
+    for (uint32_t i = 0; i < N_ASYNC_RECORDS / 2; ++i)
+    {
+        g.Write(0, i, data, sizeof(data));
+    }
+    pid_t pid = fork();
+    NS_TEST_ASSERT_MSG_NE(pid, -1, "fork() failed");
+    if (pid == 0)
+    {
+        // A child blocked on the writer is killed
+        alarm(60);
+        WriteRecords(childName, 512);
+        _exit(IsStatusFailure() ? 1 : 0);
+    }
+    for (uint32_t i = N_ASYNC_RECORDS / 2; i < N_ASYNC_RECORDS; ++i)
+    {
+        g.Write(0, i, data, sizeof(data));
+    }
+    g.Close();
+    int status = 0;
+    NS_TEST_ASSERT_MSG_EQ(waitpid(pid, &status, 0), pid, "waitpid() failed");
+    NS_TEST_ASSERT_MSG_EQ(WIFEXITED(status), true, "Child killed by signal " << WTERMSIG(status));
+    NS_TEST_EXPECT_MSG_EQ(WEXITSTATUS(status), 0, "Child failed");
+
+    packets = 0;
+    diff = PcapFile::Diff(syncName, childName, sec, usec, packets, ASYNC_SNAPLEN);
+    NS_TEST_EXPECT_MSG_EQ(diff, false, "File of the child differs from sync file");
+    NS_TEST_EXPECT_MSG_EQ(packets, N_ASYNC_RECORDS, "Unexpected number of child records");
+
+    g.Open(parentName, std::ios::in);
+    NS_TEST_ASSERT_MSG_EQ(g.Fail(), false, "Open (" << parentName << ") returns error");
+    for (uint32_t i = 0; i < N_ASYNC_RECORDS; ++i)
+    {
+        g.Read(data, sizeof(data), tsSec, tsUsec, inclLen, origLen, readLen);
+        NS_TEST_ASSERT_MSG_EQ(g.Fail(), false, "Read() of record " << i << " returns error");
+        NS_TEST_EXPECT_MSG_EQ(tsUsec, i, "Wrong record " << i << " in the parent file");
+    }
+    g.Read(data, 1, tsSec, tsUsec, inclLen, origLen, readLen);
+    NS_TEST_EXPECT_MSG_EQ(g.Eof(), true, "Parent file has trailing data");
+    g.Close();
+#endif
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1398,6 +1571,7 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new AsyncWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
@@ -48,7 +48,19 @@ PcapFileWrapper::GetTypeId()
                           "microseconds(default).",
                           BooleanValue(false),
                           MakeBooleanAccessor(&PcapFileWrapper::m_nanosecMode),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute("AsyncWrite",
+                          "Whether the packets are written to the file by a background "
+                          "thread, from a buffer of the file, rather than by the simulation.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PcapFileWrapper::m_async),
+                          MakeBooleanChecker())
+            .AddAttribute("AsyncBufferSize",
+                          "The size of the buffer of the packets written by a background "
+                          "thread, handed over to the thread when it is full.",
+                          UintegerValue(PcapFile::ASYNC_BUFFER_DEFAULT),
+                          MakeUintegerAccessor(&PcapFileWrapper::m_asyncBufferSize),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -91,6 +103,13 @@ PcapFileWrapper::Close()
     m_file.Close();
 }
 
+void
+PcapFileWrapper::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    m_file.Flush();
+}
+
 void
 PcapFileWrapper::Open(const std::string& filename, std::ios::openmode mode)
 {
@@ -115,6 +134,10 @@ PcapFileWrapper::Init(uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrect
     {
         m_file.Init(dataLinkType, m_snapLen, tzCorrection, false, m_nanosecMode);
     }
+    if (m_async)
+    {
+        m_file.EnableAsync(m_asyncBufferSize);
+    }
 }
 
 void
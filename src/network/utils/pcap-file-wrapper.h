@@ -83,6 +83,12 @@ class PcapFileWrapper : public Object
      */
     void Close();
 
+    /**
+     * Write the packets not yet written by the background thread, with the
+     * AsyncWrite attribute, and flush the underlying pcap file.
+     */
+    void Flush();
+
     /**
      * Initialize the pcap file associated with this wrapper.  This file must have
      * been previously opened with write permissions.
@@ -103,6 +109,9 @@ class PcapFileWrapper : public Object
      * time zone from UTC/GMT.  For example, Pacific Standard Time in the US is
      * GMT-8, so one would enter -8 for that correction.  Defaults to 0 (UTC).
      *
+     * With the AsyncWrite attribute, the next packets are written to the
+     * file by a background thread, see PcapFile::EnableAsync().
+     *
      * \warning Calling this method on an existing file will result in the loss
      * any existing data.
      */
@@ -222,9 +231,11 @@ class PcapFileWrapper : public Object
     uint32_t GetDataLinkType();
 
   private:
-    PcapFile m_file;    //!< Pcap file
-    uint32_t m_snapLen; //!< max length of saved packets
-    bool m_nanosecMode; //!< Timestamps in nanosecond mode
+    PcapFile m_file;            //!< Pcap file
+    uint32_t m_snapLen;         //!< max length of saved packets
+    bool m_nanosecMode;         //!< Timestamps in nanosecond mode
+    bool m_async;               //!< Packets written by a background thread
+    uint32_t m_asyncBufferSize; //!< Size of the buffer of the background writes
 };
 
 } // namespace ns3
@@ -28,8 +28,19 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifndef __WIN32__
+#include <pthread.h>
+#endif
 
 //
 // This file is used as part of the ns-3 test framework, so please refrain from
@@ -51,6 +62,191 @@ const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2; /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4; /**< Minor version of supported pcap file format */
 
+namespace
+{
+
+/**
+ * The number of bytes handed over to the writer thread, by all the files,
+ * beyond which the simulation waits.
+ */
+constexpr std::size_t MAX_PENDING_BYTES = 64 * 1024 * 1024;
+/** The number of empty buffers kept for reuse by the writer thread. */
+constexpr std::size_t MAX_FREE_BLOCKS = 16;
+
+/** A buffer of records. */
+struct Block
+{
+    std::unique_ptr<char[]> data; //!< The records
+    std::size_t size{0};          //!< The size of the records
+    std::size_t capacity{0};      //!< The size of the buffer
+};
+
+/**
+ * The thread which writes the blocks of records of the asynchronous files,
+ * in the order they are handed over.
+ *
+ * A process forked from the simulation has no writer thread, and a copy of
+ * the mutex which may be locked: the child resets the writer, which starts
+ * a new thread when it is handed a block.
+ */
+class AsyncWriter
+{
+  public:
+    AsyncWriter()
+    {
+#ifndef __WIN32__
+        pthread_atfork(&AsyncWriter::Prepare, &AsyncWriter::Parent, &AsyncWriter::Child);
+#endif
+    }
+
+    /**
+     * Hand a block over to the writer.  Waits while too many bytes are
+     * pending.
+     * \param [in] file The file to write the block to.
+     * \param [in,out] block The block, replaced by an empty one, which may
+     *                  have a buffer.
+     */
+    void Submit(std::fstream* file, Block& block)
+    {
+        std::unique_lock lock(m_mutex);
+        if (!m_writer.joinable())
+        {
+            m_writer = std::thread(&AsyncWriter::Write, this);
+        }
+        m_cv.wait(lock, [this]() {
+            return m_pending.empty() || m_pendingBytes < MAX_PENDING_BYTES;
+        });
+        m_pendingBytes += block.size;
+        m_pending.push_back({file, std::move(block)});
+        block = Block();
+        if (!m_free.empty())
+        {
+            block = std::move(m_free.back());
+            m_free.pop_back();
+        }
+        m_cv.notify_all();
+    }
+
+    /**
+     * Wait until all the blocks of a file handed over are written.
+     * \param [in] file The file.
+     */
+    void Flush(const std::fstream* file)
+    {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this, file]() {
+            return m_busy != file &&
+                   std::none_of(m_pending.begin(), m_pending.end(), [file](const Job& job) {
+                       return job.file == file;
+                   });
+        });
+    }
+
+  private:
+    /** A block to write. */
+    struct Job
+    {
+        std::fstream* file; //!< The file to write to
+        Block block;        //!< The records
+    };
+
+#ifndef __WIN32__
+    /** Before a fork: wait until the writer thread leaves the critical section. */
+    static void Prepare();
+    /** After a fork, in the parent: let the writer thread go on. */
+    static void Parent();
+    /**
+     * After a fork, in the child: forget the writer thread, which does not
+     * exist there, and the blocks of the parent, which the parent writes.
+     */
+    static void Child();
+#endif
+
+    /** The writer thread. */
+    void Write()
+    {
+        std::unique_lock lock(m_mutex);
+        while (true)
+        {
+            m_cv.wait(lock, [this]() { return !m_pending.empty(); });
+            Job job = std::move(m_pending.front());
+            m_pending.pop_front();
+            m_busy = job.file;
+            lock.unlock();
+
+            job.file->write(job.block.data.get(), job.block.size);
+
+            lock.lock();
+            m_busy = nullptr;
+            m_pendingBytes -= job.block.size;
+            if (m_free.size() < MAX_FREE_BLOCKS)
+            {
+                job.block.size = 0;
+                m_free.push_back(std::move(job.block));
+            }
+            m_cv.notify_all();
+        }
+    }
+
+    std::mutex m_mutex;                  //!< Protects the members below
+    std::condition_variable m_cv;        //!< Signals changes of the members below
+    std::deque<Job> m_pending;           //!< The blocks to write
+    std::size_t m_pendingBytes{0};       //!< The size of the blocks to write
+    std::vector<Block> m_free;           //!< The blocks to reuse
+    const std::fstream* m_busy{nullptr}; //!< The file being written
+    std::thread m_writer;                //!< The writer thread
+};
+
+/**
+ * Get the writer of the asynchronous files.
+ * \returns The writer.
+ */
+AsyncWriter&
+GetAsyncWriter()
+{
+    // Never destroyed, as the files may be closed by the destructors of
+    // other static objects
+    static auto writer = new AsyncWriter;
+    return *writer;
+}
+
+#ifndef __WIN32__
+void
+AsyncWriter::Prepare()
+{
+    GetAsyncWriter().m_mutex.lock();
+}
+
+void
+AsyncWriter::Parent()
+{
+    GetAsyncWriter().m_mutex.unlock();
+}
+
+void
+AsyncWriter::Child()
+{
+    AsyncWriter& writer = GetAsyncWriter();
+    // The copies are not destroyed: the mutex was locked before the fork,
+    // and the thread object refers to a thread of the parent
+    new (&writer.m_mutex) std::mutex;
+    new (&writer.m_cv) std::condition_variable;
+    new (&writer.m_writer) std::thread;
+    writer.m_pending.clear();
+    writer.m_pendingBytes = 0;
+    writer.m_busy = nullptr;
+}
+#endif
+
+} // unnamed namespace
+
+/** The records of an asynchronous file not yet handed over to the writer. */
+struct PcapFile::AsyncBuffer
+{
+    Block block;   //!< The records
+    uint32_t size; //!< The size of the buffer
+};
+
 PcapFile::PcapFile()
     : m_file(),
       m_swapMode(false),
@@ -71,6 +267,7 @@ bool
 PcapFile::Fail() const
 {
     NS_LOG_FUNCTION(this);
+    WaitAsync();
     return m_file.fail();
 }
 
@@ -78,6 +275,7 @@ bool
 PcapFile::Eof() const
 {
     NS_LOG_FUNCTION(this);
+    WaitAsync();
     return m_file.eof();
 }
 
@@ -85,6 +283,7 @@ void
 PcapFile::Clear()
 {
     NS_LOG_FUNCTION(this);
+    WaitAsync();
     m_file.clear();
 }
 
@@ -92,9 +291,74 @@ void
 PcapFile::Close()
 {
     NS_LOG_FUNCTION(this);
+    WaitAsync();
+    m_async.reset();
     m_file.close();
 }
 
+void
+PcapFile::EnableAsync(uint32_t bufferSize)
+{
+    NS_LOG_FUNCTION(this << bufferSize);
+    NS_ASSERT(bufferSize > 0);
+    if (!m_async)
+    {
+        m_async = std::make_unique<AsyncBuffer>();
+    }
+    m_async->size = bufferSize;
+}
+
+bool
+PcapFile::IsAsync() const
+{
+    return m_async != nullptr;
+}
+
+void
+PcapFile::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    WaitAsync();
+    m_file.flush();
+}
+
+void
+PcapFile::WaitAsync() const
+{
+    NS_LOG_FUNCTION(this);
+    if (m_async)
+    {
+        if (m_async->block.size > 0)
+        {
+            GetAsyncWriter().Submit(const_cast<std::fstream*>(&m_file), m_async->block);
+        }
+        GetAsyncWriter().Flush(&m_file);
+    }
+}
+
+uint8_t*
+PcapFile::Reserve(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    Block& block = m_async->block;
+    if (block.size + size > block.capacity || !block.data)
+    {
+        if (block.size > 0)
+        {
+            GetAsyncWriter().Submit(&m_file, block);
+        }
+        std::size_t capacity = std::max(m_async->size, size);
+        if (block.capacity < capacity)
+        {
+            block.data = std::make_unique<char[]>(capacity);
+            block.capacity = capacity;
+        }
+    }
+    auto bytes = reinterpret_cast<uint8_t*>(block.data.get() + block.size);
+    block.size += size;
+    return bytes;
+}
+
 uint32_t
 PcapFile::GetMagic()
 {
@@ -332,6 +596,8 @@ PcapFile::Open(const std::string& filename, std::ios::openmode mode)
 {
     NS_LOG_FUNCTION(this << filename << mode);
     NS_ASSERT((mode & std::ios::app) == 0);
+    WaitAsync();
+    m_async.reset();
     NS_ASSERT(!m_file.fail());
     //
     // All pcap files are binary files, so we just do this automatically.
@@ -406,6 +672,7 @@ PcapFile::Init(uint32_t dataLinkType,
     //
     m_swapMode = swapMode || bigEndian;
 
+    WaitAsync();
     WriteFileHeader();
 }
 
@@ -413,7 +680,7 @@ uint32_t
 PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen);
-    NS_ASSERT(m_file.good());
+    NS_ASSERT(m_async || m_file.good());
 
     uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -428,6 +695,16 @@ PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
         Swap(&header, &header);
     }
 
+    if (m_async)
+    {
+        uint8_t* bytes = Reserve(16);
+        std::memcpy(bytes, &header.m_tsSec, sizeof(header.m_tsSec));
+        std::memcpy(bytes + 4, &header.m_tsUsec, sizeof(header.m_tsUsec));
+        std::memcpy(bytes + 8, &header.m_inclLen, sizeof(header.m_inclLen));
+        std::memcpy(bytes + 12, &header.m_origLen, sizeof(header.m_origLen));
+        return inclLen;
+    }
+
     //
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
@@ -445,6 +722,11 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const uint8_t* const data, uint
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &data << totalLen);
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalLen);
+    if (m_async)
+    {
+        std::memcpy(Reserve(inclLen), data, inclLen);
+        return;
+    }
     m_file.write((const char*)data, inclLen);
     NS_BUILD_DEBUG(m_file.flush());
 }
@@ -454,6 +736,12 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << p);
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize());
+    if (m_async)
+    {
+        // only the bytes within the snap length are copied
+        p->CopyData(Reserve(inclLen), inclLen);
+        return;
+    }
     p->CopyData(&m_file, inclLen);
     NS_BUILD_DEBUG(m_file.flush());
 }
@@ -470,6 +758,13 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const Header& header, Ptr<const
     headerBuffer.AddAtStart(headerSize);
     header.Serialize(headerBuffer.Begin());
     uint32_t toCopy = std::min(headerSize, inclLen);
+    if (m_async)
+    {
+        headerBuffer.CopyData(Reserve(toCopy), toCopy);
+        inclLen -= toCopy;
+        p->CopyData(Reserve(inclLen), inclLen);
+        return;
+    }
     headerBuffer.CopyData(&m_file, toCopy);
     inclLen -= toCopy;
     p->CopyData(&m_file, inclLen);
@@ -485,6 +780,7 @@ PcapFile::Read(uint8_t* const data,
                uint32_t& readLen)
 {
     NS_LOG_FUNCTION(this << &data << maxBytes << tsSec << tsUsec << inclLen << origLen << readLen);
+    WaitAsync();
     NS_ASSERT(m_file.good());
 
     PcapRecordHeader header;
@@ -23,6 +23,7 @@
 #include "ns3/ptr.h"
 
 #include <fstream>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -38,6 +39,19 @@ class Header;
  * A class representing a pcap file.  This allows easy creation, writing and
  * reading of files composed of stored packets; which may be viewed using
  * standard tools.
+ *
+ * By default, each record is written to the file stream when it is
+ * written.  Once EnableAsync() is called, the records are instead copied
+ * into a large buffer of the file, truncated to the snap length, and the
+ * full buffers are written by a background thread shared by all the
+ * files, so that the simulation does not wait for the file system.  The
+ * memory of the buffers waiting to be written is bounded: when the
+ * background thread falls behind, the simulation waits for it.  The
+ * records are written in order, and all of them are in the file once
+ * Flush() or Close() returns; the state of the stream, such as Fail(), is
+ * checked after the pending records are written.  Flush the files before
+ * forking the process, as the background thread does not survive in the
+ * child process.
  */
 class PcapFile
 {
@@ -45,6 +59,8 @@ class PcapFile
     static const int32_t ZONE_DEFAULT = 0; //!< Time zone offset for current location
     static const uint32_t SNAPLEN_DEFAULT =
         65535; //!< Default value for maximum octets to save per packet
+    static const uint32_t ASYNC_BUFFER_DEFAULT =
+        64 * 1024; //!< Default size of the record buffer of an asynchronous file
 
   public:
     PcapFile();
@@ -82,10 +98,30 @@ class PcapFile
     void Open(const std::string& filename, std::ios::openmode mode);
 
     /**
-     * Close the underlying file.
+     * Close the underlying file, after writing the pending records.
      */
     void Close();
 
+    /**
+     * Write the next records asynchronously, from a buffer of the file
+     * written by a background thread.  The file must have been opened with
+     * write permissions, and is synchronous again once closed.
+     *
+     * \param bufferSize The size of the record buffer of the file: the
+     * records are handed over to the background thread when it is full.
+     */
+    void EnableAsync(uint32_t bufferSize = ASYNC_BUFFER_DEFAULT);
+
+    /**
+     * \return true if the records are written asynchronously.
+     */
+    bool IsAsync() const;
+
+    /**
+     * Write the pending records, if any, and flush the underlying file.
+     */
+    void Flush();
+
     /**
      * Initialize the pcap file associated with this object.  This file must have
      * been previously opened with write permissions.
@@ -373,11 +409,31 @@ class PcapFile
      */
     void ReadAndVerifyFileHeader();
 
-    std::string m_filename;      //!< file name
-    std::fstream m_file;         //!< file stream
-    PcapFileHeader m_fileHeader; //!< file header
-    bool m_swapMode;             //!< swap mode
-    bool m_nanosecMode;          //!< nanosecond timestamp mode
+    /**
+     * \brief Reserve room for bytes at the end of the record buffer of an
+     * asynchronous file, handing the buffer over to the background thread
+     * if it is full.
+     *
+     * \param size the number of bytes
+     * \returns the bytes to fill
+     */
+    uint8_t* Reserve(uint32_t size);
+
+    /**
+     * \brief Write the pending records of an asynchronous file, so that the
+     * file stream may be used by the calling thread.
+     */
+    void WaitAsync() const;
+
+    /// The record buffer of an asynchronous file
+    struct AsyncBuffer;
+
+    std::string m_filename;               //!< file name
+    std::fstream m_file;                  //!< file stream
+    PcapFileHeader m_fileHeader;          //!< file header
+    bool m_swapMode;                      //!< swap mode
+    bool m_nanosecMode;                   //!< nanosecond timestamp mode
+    std::unique_ptr<AsyncBuffer> m_async; //!< record buffer, if asynchronous
 };
 
 } // namespace ns3
@@ -0,0 +1,249 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of creating, copying and invoking the
+// common shapes of Callbacks: functions and member functions with up to
+// two bound arguments, which are stored in the Callback, and the same
+// member function bound with Callback::Bind() or a lambda, which are
+// allocated.  It also counts the allocations made by each creation.
+// Sample usage:  ./ns3 run 'bench-callback --operations=10000000'
+
+#include "ns3/callback.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace ns3;
+
+/** Output field width for numeric data. */
+const int g_fwidth = 12;
+
+/** Output field width for the Callback shapes. */
+const int g_nwidth = 32;
+
+/** Number of allocations made by operator new. */
+static uint64_t g_allocations = 0;
+
+void*
+operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t size [[maybe_unused]]) noexcept
+{
+    std::free(p);
+}
+
+/** Accumulator of the results, so that the calls are not optimized out. */
+static int64_t g_sink = 0;
+
+/**
+ * Function target of the Callbacks.
+ * \param [in] a A passed argument.
+ * \returns The argument.
+ */
+static int64_t
+Function(int64_t a)
+{
+    return a;
+}
+
+/**
+ * Function target of the bound Callbacks.
+ * \param [in] a A bound argument.
+ * \param [in] b A passed argument.
+ * \returns The sum of the arguments.
+ */
+static int64_t
+BoundFunction(int64_t a, int64_t b)
+{
+    return a + b;
+}
+
+/**
+ * Object whose member function is the target of the Callbacks.
+ */
+class Target
+{
+  public:
+    /**
+     * Member function target of the Callbacks.
+     * \param [in] a A passed argument.
+     * \returns The sum of the argument and the member.
+     */
+    int64_t Member(int64_t a)
+    {
+        return m_value + a;
+    }
+
+    /**
+     * Member function target of the bound Callbacks.
+     * \param [in] a A bound argument.
+     * \param [in] b A bound argument.
+     * \param [in] c A passed argument.
+     * \returns The sum of the arguments and the member.
+     */
+    int64_t BoundMember(int64_t a, int64_t b, int64_t c)
+    {
+        return m_value + a + b + c;
+    }
+
+  private:
+    int64_t m_value{1}; //!< Added to the arguments.
+};
+
+/**
+ * Time a function.
+ * \param [in] f The function.
+ * \returns The time taken, in milliseconds.
+ */
+template <typename F>
+static int64_t
+Measure(F f)
+{
+    SystemWallClockMs timer;
+    timer.Start();
+    f();
+    return timer.End();
+}
+
+/**
+ * Time the creation, copy and invocation of a shape of Callbacks,
+ * and print the results.
+ * \param [in] name The name of the shape.
+ * \param [in] make The function creating a Callback from an index.
+ * \param [in] operations The number of times to run each operation.
+ */
+template <typename F>
+static void
+RunBench(const std::string& name, F make, uint64_t operations)
+{
+    // Store the Callbacks in turn in several slots, as objects keep them,
+    // so that neither the creations nor the copies are optimized out
+    std::vector<std::decay_t<decltype(make(0))>> callbacks(16);
+    auto create = Measure([&]() {
+        for (uint64_t i = 0; i < operations; ++i)
+        {
+            callbacks[i % callbacks.size()] = make(i);
+        }
+    });
+
+    uint64_t allocations = g_allocations;
+    {
+        auto cb = make(0);
+        allocations = g_allocations - allocations;
+        g_sink += cb.IsNull();
+    }
+
+    std::vector<std::decay_t<decltype(make(0))>> copies(callbacks.size());
+    auto copy = Measure([&]() {
+        for (uint64_t i = 0; i < operations; ++i)
+        {
+            copies[i % copies.size()] = callbacks[(i + 1) % callbacks.size()];
+        }
+    });
+
+    auto invoke = Measure([&]() {
+        for (uint64_t i = 0; i < operations; ++i)
+        {
+            g_sink += copies[i % copies.size()](i);
+        }
+    });
+
+    std::cout << std::left << std::setw(g_nwidth) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(g_fwidth) << create * 1e6 / operations
+              << std::setw(g_fwidth) << copy * 1e6 / operations << std::setw(g_fwidth)
+              << invoke * 1e6 / operations << std::setw(g_fwidth) << allocations << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t operations = 10000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the creation, copy and invocation of Callbacks.\n"
+              "The times are per operation, in nanoseconds, including the loop\n"
+              "overhead; the Allocs column is the number of allocations made\n"
+              "by each creation.");
+    cmd.AddValue("operations", "Number of runs of each operation", operations);
+    cmd.Parse(argc, argv);
+
+    Target target;
+    Target* object = &target;
+
+    std::cout << std::left << std::setw(g_nwidth) << "Callback" << std::right
+              << std::setw(g_fwidth) << "Create" << std::setw(g_fwidth) << "Copy"
+              << std::setw(g_fwidth) << "Invoke" << std::setw(g_fwidth) << "Allocs" << std::endl;
+
+    RunBench(
+        "MakeCallback(&f)",
+        [](uint64_t i [[maybe_unused]]) { return MakeCallback(&Function); },
+        operations);
+    RunBench(
+        "MakeBoundCallback(&f, a)",
+        [](uint64_t i) { return MakeBoundCallback(&BoundFunction, static_cast<int64_t>(i)); },
+        operations);
+    RunBench(
+        "MakeCallback(&C::m, p)",
+        [object](uint64_t i [[maybe_unused]]) { return MakeCallback(&Target::Member, object); },
+        operations);
+    RunBench(
+        "MakeCallback(&C::m, p, a, b)",
+        [object](uint64_t i) {
+            return MakeCallback(&Target::BoundMember, object, static_cast<int64_t>(i), int64_t(2));
+        },
+        operations);
+    RunBench(
+        "MakeCallback(&C::m, p).Bind(a, b)",
+        [object](uint64_t i) {
+            return MakeCallback(&Target::BoundMember, object)
+                .Bind(static_cast<int64_t>(i), int64_t(2));
+        },
+        operations);
+    RunBench(
+        "Callback(lambda)",
+        [object](uint64_t i) {
+            return Callback<int64_t, int64_t>(
+                [object, i](int64_t c) { return object->BoundMember(i, 2, c); });
+        },
+        operations);
+
+    if (g_sink == 0)
+    {
+        std::cerr << "Unexpected null result" << std::endl;
+    }
+    return 0;
+}
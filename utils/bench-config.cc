@@ -0,0 +1,162 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the time taken by Config::Connect(), Config::Set()
+// and Config::Batch to resolve wildcard paths, for topologies of various
+// numbers of nodes.
+// Sample usage:  ./ns3 run 'bench-config --nodes=1000,10000,50000'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/queue-size.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** The path of the transmit queues of all the devices. */
+const std::string g_queues = "/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/TxQueue/";
+
+/** Output field width for numeric data. */
+const int g_fwidth = 12;
+
+/**
+ * Packet trace sink.
+ * \param [in] packet The packet.
+ */
+static void
+PacketSink(Ptr<const Packet> packet [[maybe_unused]])
+{
+}
+
+/**
+ * Packet trace sink with context.
+ * \param [in] context The context.
+ * \param [in] packet The packet.
+ */
+static void
+PacketContextSink(std::string context [[maybe_unused]],
+                  Ptr<const Packet> packet [[maybe_unused]])
+{
+}
+
+/**
+ * Queue length trace sink.
+ * \param [in] oldValue The old length.
+ * \param [in] newValue The new length.
+ */
+static void
+LengthSink(uint32_t oldValue [[maybe_unused]], uint32_t newValue [[maybe_unused]])
+{
+}
+
+/**
+ * Time a function.
+ * \param [in] f The function.
+ * \returns The time taken, in milliseconds.
+ */
+template <typename F>
+static int64_t
+Measure(F f)
+{
+    SystemWallClockMs timer;
+    timer.Start();
+    f();
+    return timer.End();
+}
+
+/**
+ * Run the benchmarks for a number of nodes.
+ * \param [in] nodes The number of nodes.
+ * \param [in] devices The number of devices of each node.
+ */
+static void
+RunBench(uint32_t nodes, uint32_t devices)
+{
+    for (uint32_t i = 0; i < nodes; ++i)
+    {
+        Ptr<Node> node = CreateObject<Node>();
+        for (uint32_t j = 0; j < devices; ++j)
+        {
+            node->AddDevice(CreateObject<SimpleNetDevice>());
+        }
+    }
+
+    auto connect = Measure([]() {
+        Config::ConnectWithoutContext(g_queues + "Drop", MakeCallback(&PacketSink));
+    });
+    auto connectContext =
+        Measure([]() { Config::Connect(g_queues + "Drop", MakeCallback(&PacketContextSink)); });
+    auto set =
+        Measure([]() { Config::Set(g_queues + "MaxSize", QueueSizeValue(QueueSize("50p"))); });
+    auto separate = Measure([]() {
+        Config::ConnectWithoutContext(g_queues + "Enqueue", MakeCallback(&PacketSink));
+        Config::ConnectWithoutContext(g_queues + "Dequeue", MakeCallback(&PacketSink));
+        Config::ConnectWithoutContext(g_queues + "PacketsInQueue", MakeCallback(&LengthSink));
+        Config::Set(g_queues + "MaxSize", QueueSizeValue(QueueSize("60p")));
+    });
+    auto batch = Measure([]() {
+        Config::Batch batch;
+        batch.ConnectWithoutContext(g_queues + "Enqueue", MakeCallback(&PacketSink));
+        batch.ConnectWithoutContext(g_queues + "Dequeue", MakeCallback(&PacketSink));
+        batch.ConnectWithoutContext(g_queues + "PacketsInQueue", MakeCallback(&LengthSink));
+        batch.Set(g_queues + "MaxSize", QueueSizeValue(QueueSize("70p")));
+        batch.Apply();
+    });
+
+    std::cout << std::setw(g_fwidth) << nodes << std::setw(g_fwidth) << connect
+              << std::setw(g_fwidth) << connectContext << std::setw(g_fwidth) << set
+              << std::setw(g_fwidth) << separate << std::setw(g_fwidth) << batch << std::endl;
+
+    // Dispose of the nodes
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string nodes = "1000,5000,20000";
+    uint32_t devices = 2;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the resolution of Config paths.\n"
+              "Each node has SimpleNetDevices whose transmit queues are configured\n"
+              "through wildcard paths; the times are in milliseconds.");
+    cmd.AddValue("nodes", "Comma separated list of numbers of nodes", nodes);
+    cmd.AddValue("devices", "Number of devices of each node", devices);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::setw(g_fwidth) << "Nodes" << std::setw(g_fwidth) << "Connect"
+              << std::setw(g_fwidth) << "Context" << std::setw(g_fwidth) << "Set"
+              << std::setw(g_fwidth) << "4 paths" << std::setw(g_fwidth) << "Batch of 4"
+              << std::endl;
+
+    std::istringstream is(nodes);
+    std::string n;
+    while (std::getline(is, n, ','))
+    {
+        RunBench(std::stoul(n), devices);
+    }
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the time taken by Object::GetObject() to find an
+// aggregated Object, compared with a linear scan of the aggregates, for
+// aggregations of various sizes.
+// Sample usage:  ./ns3 run 'bench-object --aggregates=2,8,16 --lookups=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/object-factory.h"
+#include "ns3/object.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** Output field width for numeric data. */
+const int g_fwidth = 12;
+
+/** Distinct Object types to aggregate. */
+const std::vector<std::string> g_types = {
+    "ns3::UniformRandomVariable",
+    "ns3::ConstantRandomVariable",
+    "ns3::SequentialRandomVariable",
+    "ns3::ExponentialRandomVariable",
+    "ns3::ParetoRandomVariable",
+    "ns3::WeibullRandomVariable",
+    "ns3::NormalRandomVariable",
+    "ns3::LogNormalRandomVariable",
+    "ns3::GammaRandomVariable",
+    "ns3::ErlangRandomVariable",
+    "ns3::TriangularRandomVariable",
+    "ns3::ZipfRandomVariable",
+    "ns3::ZetaRandomVariable",
+    "ns3::DeterministicRandomVariable",
+    "ns3::EmpiricalRandomVariable",
+    "ns3::BinomialRandomVariable",
+    "ns3::BernoulliRandomVariable",
+    "ns3::ListScheduler",
+    "ns3::MapScheduler",
+    "ns3::HeapScheduler",
+    "ns3::CalendarScheduler",
+    "ns3::PriorityQueueScheduler",
+};
+
+/**
+ * Find an aggregate by scanning the aggregates and their TypeId
+ * hierarchy, as Object::GetObject() did before it cached its lookups.
+ * \param [in] object The Object.
+ * \param [in] tid The TypeId to find.
+ * \returns The aggregate, or \c nullptr.
+ */
+static Ptr<const Object>
+ScanGetObject(Ptr<const Object> object, TypeId tid)
+{
+    TypeId objectTid = Object::GetTypeId();
+    Object::AggregateIterator it = object->GetAggregateIterator();
+    while (it.HasNext())
+    {
+        Ptr<const Object> current = it.Next();
+        TypeId cur = current->GetInstanceTypeId();
+        while (cur != tid && cur != objectTid)
+        {
+            cur = cur.GetParent();
+        }
+        if (cur == tid)
+        {
+            return current;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Time a function.
+ * \param [in] f The function.
+ * \returns The time taken, in milliseconds.
+ */
+template <typename F>
+static int64_t
+Measure(F f)
+{
+    SystemWallClockMs timer;
+    timer.Start();
+    f();
+    return timer.End();
+}
+
+/**
+ * Run the benchmarks for a number of aggregates.
+ * \param [in] aggregates The number of aggregated Objects.
+ * \param [in] lookups The number of lookups.
+ */
+static void
+RunBench(uint32_t aggregates, uint64_t lookups)
+{
+    std::vector<TypeId> tids;
+    Ptr<Object> root;
+    for (uint32_t i = 0; i < aggregates; ++i)
+    {
+        ObjectFactory factory(g_types[i]);
+        Ptr<Object> object = factory.Create();
+        tids.push_back(object->GetInstanceTypeId());
+        if (root)
+        {
+            root->AggregateObject(object);
+        }
+        else
+        {
+            root = object;
+        }
+    }
+
+    // Look up each type in turn, so that no order of the aggregates helps
+    TypeId missingTid = TypeId::LookupByName("ns3::LadderScheduler");
+    uint64_t found = 0;
+    auto scan = Measure([&]() {
+        for (uint64_t i = 0; i < lookups; ++i)
+        {
+            found += ScanGetObject(root, tids[i % aggregates]) != nullptr;
+        }
+    });
+    auto getObject = Measure([&]() {
+        for (uint64_t i = 0; i < lookups; ++i)
+        {
+            found += root->GetObject<Object>(tids[i % aggregates]) != nullptr;
+        }
+    });
+    auto missing = Measure([&]() {
+        for (uint64_t i = 0; i < lookups; ++i)
+        {
+            found += root->GetObject<Object>(missingTid) != nullptr;
+        }
+    });
+    if (found != 2 * lookups)
+    {
+        std::cerr << "Wrong number of lookups found: " << found << std::endl;
+    }
+
+    std::cout << std::setw(g_fwidth) << aggregates << std::setw(g_fwidth) << scan
+              << std::setw(g_fwidth) << getObject << std::setw(g_fwidth) << missing << std::endl;
+    root->Dispose();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string aggregates = "2,8,16";
+    uint64_t lookups = 10000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark Object::GetObject().\n"
+              "Objects of distinct types are aggregated together, then looked up\n"
+              "in turn; the times are in milliseconds.  The Scan column is the\n"
+              "linear search of the aggregates, the GetObject column the cached\n"
+              "lookups and the Missing column the lookups of a type which is not\n"
+              "aggregated.");
+    cmd.AddValue("aggregates",
+                 "Comma separated list of numbers of aggregated Objects, at most 22",
+                 aggregates);
+    cmd.AddValue("lookups", "Number of lookups", lookups);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::setw(g_fwidth) << "Aggregates" << std::setw(g_fwidth) << "Scan"
+              << std::setw(g_fwidth) << "GetObject" << std::setw(g_fwidth) << "Missing"
+              << std::endl;
+
+    std::istringstream is(aggregates);
+    std::string n;
+    while (std::getline(is, n, ','))
+    {
+        uint32_t count = std::stoul(n);
+        if (count == 0 || count > g_types.size())
+        {
+            std::cerr << "Invalid number of aggregates: " << n << std::endl;
+            return 1;
+        }
+        RunBench(count, lookups);
+    }
+    return 0;
+}
@@ -20,7 +20,13 @@
 // This program can be used to benchmark packet serialization/deserialization
 // operations using Headers and Tags, for various numbers of packets 'n'
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
+// With --enable-printing, the packet metadata is recorded, by the engine
+// selected with --engine, or by each engine in turn with --engine=Both:
+//   ./ns3 run 'bench-packets --n=10000 --enable-printing --engine=Both'
+// With --scatter-gather, the buffers chain the fragments and concatenations
+// rather than copying them.
 
+#include "ns3/buffer.h"
 #include "ns3/command-line.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
@@ -32,6 +38,8 @@
 #include <sstream>
 #include <stdlib.h> // for exit ()
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -350,6 +358,77 @@ benchByteTags(uint32_t n)
     }
 }
 
+static void
+benchPacketTags(uint32_t n)
+{
+    // Flow monitor, timestamp and socket priority sized tags
+    BenchTag<20> flow;
+    BenchTag<8> timestamp;
+    BenchTag<1> priority;
+    BenchTag<2> missing;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(2000);
+        p->AddPacketTag(priority);
+        p->AddPacketTag(timestamp);
+        p->AddPacketTag(flow);
+        // Forward the packet over two hops
+        for (uint32_t hop = 0; hop < 2; hop++)
+        {
+            Ptr<Packet> o = p->Copy();
+            o->PeekPacketTag(flow);
+            o->PeekPacketTag(missing);
+            o->ReplacePacketTag(priority);
+            p = o;
+        }
+        p->PeekPacketTag(timestamp);
+        p->RemovePacketTag(flow);
+    }
+}
+
+static void
+benchFewByteTags(uint32_t n)
+{
+    BenchTag<4> flowId;
+    BenchTag<8> timestamp;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(2000);
+        p->AddByteTag(flowId);
+        p->AddByteTag(timestamp);
+        Ptr<Packet> o = p->Copy();
+        o->FindFirstMatchingByteTag(timestamp);
+    }
+}
+
+static void
+benchSegmentation(uint32_t n)
+{
+    BenchHeader<20> ipv4;
+    BenchHeader<20> tcp;
+    const uint32_t segmentSize = 1448;
+    std::vector<uint8_t> data(8 * segmentSize, 0x5a);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        // An application write, segmented by the sender and reassembled by
+        // the receiver
+        Ptr<Packet> write = Create<Packet>(data.data(), data.size());
+        Ptr<Packet> received = Create<Packet>();
+        for (uint32_t offset = 0; offset < data.size(); offset += segmentSize)
+        {
+            Ptr<Packet> segment = write->CreateFragment(offset, segmentSize);
+            segment->AddHeader(tcp);
+            segment->AddHeader(ipv4);
+            segment->RemoveHeader(ipv4);
+            segment->RemoveHeader(tcp);
+            received->AddAtEnd(segment);
+        }
+    }
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -382,6 +461,8 @@ main(int argc, char* argv[])
     uint32_t n = 0;
     uint32_t minIterations = 1;
     bool enablePrinting = false;
+    bool scatterGather = false;
+    std::string engine = "List";
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark Packet class");
@@ -390,6 +471,10 @@ main(int argc, char* argv[])
                  "number of subiterations to minimize iteration time over",
                  minIterations);
     cmd.AddValue("enable-printing", "enable packet printing", enablePrinting);
+    cmd.AddValue("engine",
+                 "packet metadata engine used with enable-printing: List, Arena or Both",
+                 engine);
+    cmd.AddValue("scatter-gather", "enable the scatter-gather buffers", scatterGather);
     cmd.Parse(argc, argv);
 
     if (n == 0)
@@ -401,12 +486,48 @@ main(int argc, char* argv[])
     std::cout << "Running bench-packets with n=" << n << std::endl;
     std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
 
-    runBench(&benchA, n, minIterations, "Copy packet, remove headers");
-    runBench(&benchB, n, minIterations, "Just add headers");
-    runBench(&benchC, n, minIterations, "Remove by func call");
-    runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
-    runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
-    runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    std::vector<std::pair<std::string, PacketMetadata::Engine>> engines;
+    if (engine == "List" || engine == "Both")
+    {
+        engines.emplace_back("List", PacketMetadata::LIST);
+    }
+    if (engine == "Arena" || engine == "Both")
+    {
+        engines.emplace_back("Arena", PacketMetadata::ARENA);
+    }
+    if (engines.empty())
+    {
+        std::cerr << "Error-- unknown packet metadata engine " << engine << std::endl;
+        exit(1);
+    }
+    Buffer::EnableScatterGather(scatterGather);
+    if (!enablePrinting)
+    {
+        // The engine is only used when the metadata is recorded
+        engines.resize(1);
+    }
+    else
+    {
+        Packet::EnablePrinting();
+    }
+
+    for (const auto& [name, value] : engines)
+    {
+        if (enablePrinting)
+        {
+            PacketMetadata::SetEngine(value);
+            std::cout << "Packet metadata engine: " << name << std::endl;
+        }
+        runBench(&benchA, n, minIterations, "Copy packet, remove headers");
+        runBench(&benchB, n, minIterations, "Just add headers");
+        runBench(&benchC, n, minIterations, "Remove by func call");
+        runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
+        runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
+        runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+        runBench(&benchPacketTags, n, minIterations, "Add, copy, peek and remove packet tags");
+        runBench(&benchFewByteTags, n, minIterations, "Add, copy and find a few byte tags");
+        runBench(&benchSegmentation, n, minIterations, "Segmentation and reassembly");
+    }
 
     return 0;
 }
@@ -100,13 +100,27 @@ class Bench
         m_total = total;
     }
 
+    /**
+     * Set the number of pending events to remove per event executed.
+     *
+     * Each removed event is replaced by a new one, as when a timer
+     * is cancelled and rescheduled, so the population is unchanged.
+     * \param [in] removes The number of removals per event executed.
+     */
+    void SetRemoves(const uint64_t removes)
+    {
+        m_removes = removes;
+    }
+
     /** The output. */
     struct Result
     {
-        double init;     /**< Time (s) for initialization. */
-        double simu;     /**< Time (s) for simulation. */
-        uint64_t pop;    /**< Event population. */
-        uint64_t events; /**< Number of events executed. */
+        double init;         /**< Time (s) for initialization. */
+        double simu;         /**< Time (s) for simulation. */
+        uint64_t pop;        /**< Event population. */
+        uint64_t events;     /**< Number of events executed. */
+        uint64_t created;    /**< Number of events created. */
+        uint64_t heapAllocs; /**< Number of heap allocations for events. */
     };
 
     /**
@@ -123,10 +137,27 @@ class Bench
      */
     void Cb();
 
-    Ptr<RandomVariableStream> m_rand; /**< Stream for event delays. */
-    uint64_t m_population;            /**< Event population size. */
-    uint64_t m_total;                 /**< Total number of events to execute. */
-    uint64_t m_count;                 /**< Count of events executed so far. */
+    /**
+     * Schedule a new event after a random delay.
+     * \returns The new event.
+     */
+    EventId ScheduleNext();
+    /**
+     * Keep an event as a candidate for removal, if removals are enabled.
+     * \param [in] id The event.
+     */
+    void Track(const EventId& id);
+    /** Remove and replace \c m_removes random pending events. */
+    void RemoveSome();
+
+    Ptr<RandomVariableStream> m_rand;   /**< Stream for event delays. */
+    uint64_t m_population;              /**< Event population size. */
+    uint64_t m_total;                   /**< Total number of events to execute. */
+    uint64_t m_count;                   /**< Count of events executed so far. */
+    uint64_t m_removes{0};              /**< Removals per event executed. */
+    std::vector<EventId> m_ids;         /**< Recently scheduled events, candidates for removal. */
+    uint64_t m_next{0};                 /**< Next slot in \c m_ids to overwrite. */
+    Ptr<UniformRandomVariable> m_slots; /**< Stream to pick events to remove. */
 
 }; // class Bench
 
@@ -139,12 +170,18 @@ Bench::Run()
 
     DEB("initializing");
     m_count = 0;
+    m_next = 0;
+    m_ids.assign(m_removes > 0 ? m_population : 0, EventId());
+    if (m_removes > 0 && !m_slots)
+    {
+        m_slots = CreateObject<UniformRandomVariable>();
+    }
+    auto memBefore = EventImpl::GetMemoryPoolStats();
 
     timer.Start();
     for (uint64_t i = 0; i < m_population; ++i)
     {
-        Time at = NanoSeconds(m_rand->GetValue());
-        Simulator::Schedule(at, &Bench::Cb, this);
+        Track(ScheduleNext());
     }
     init = timer.End() / 1000.0;
     DEB("initialization took " << init << "s");
@@ -156,8 +193,15 @@ Bench::Run()
     DEB("run took " << simu << "s");
 
     Simulator::Destroy();
-
-    return Result{init, simu, m_population, m_count};
+    m_ids.clear();
+    auto memAfter = EventImpl::GetMemoryPoolStats();
+
+    return Result{init,
+                  simu,
+                  m_population,
+                  m_count,
+                  memAfter.events - memBefore.events,
+                  memAfter.heapAllocations - memBefore.heapAllocations};
 }
 
 void
@@ -170,11 +214,42 @@ Bench::Cb()
     }
     DEB("event at " << Simulator::Now().GetSeconds() << "s");
 
-    Time after = NanoSeconds(m_rand->GetValue());
-    Simulator::Schedule(after, &Bench::Cb, this);
+    Track(ScheduleNext());
+    RemoveSome();
     ++m_count;
 }
 
+EventId
+Bench::ScheduleNext()
+{
+    Time after = NanoSeconds(m_rand->GetValue());
+    return Simulator::Schedule(after, &Bench::Cb, this);
+}
+
+void
+Bench::Track(const EventId& id)
+{
+    if (!m_ids.empty())
+    {
+        m_ids[m_next] = id;
+        m_next = (m_next + 1) % m_ids.size();
+    }
+}
+
+void
+Bench::RemoveSome()
+{
+    for (uint64_t i = 0; i < m_removes; ++i)
+    {
+        EventId& id = m_ids[m_slots->GetInteger(0, m_ids.size() - 1)];
+        if (!id.IsExpired())
+        {
+            Simulator::Remove(id);
+            id = ScheduleNext();
+        }
+    }
+}
+
 /** Benchmark which performs an ensemble of runs. */
 class BenchSuite
 {
@@ -191,6 +266,7 @@ class BenchSuite
      * \param [in] pop The event population size.
      * \param [in] total The total number of events to execute.
      * \param [in] runs The number of replications.
+     * \param [in] removes The number of removals per event executed.
      * \param [in] eventStream The random stream of event delays.
      * \param [in] calRev For the CalendarScheduler, whether the Reverse attribute was set.
      */
@@ -198,6 +274,7 @@ class BenchSuite
                uint64_t pop,
                uint64_t total,
                uint64_t runs,
+               uint64_t removes,
                Ptr<RandomVariableStream> eventStream,
                bool calRev);
 
@@ -221,6 +298,7 @@ class BenchSuite
     {
         PhaseResult init; /**< Initialization phase results. */
         PhaseResult run;  /**< Run (simulation) phase results. */
+        double allocs;    /**< Heap allocations per event created. */
         /**
          * Construct from the individual run result.
          *
@@ -249,7 +327,8 @@ BenchSuite::Result
 BenchSuite::Result::Bench(Bench::Result r)
 {
     return Result{{r.init, r.pop / r.init, r.init / r.pop},
-                  {r.simu, r.events / r.simu, r.simu / r.events}};
+                  {r.simu, r.events / r.simu, r.simu / r.events},
+                  static_cast<double>(r.heapAllocs) / r.created};
 }
 
 template <typename T>
@@ -261,18 +340,17 @@ BenchSuite::Result::Log(T label) const
     LOG(std::left << std::setw(g_fwidth) << label << std::setw(g_fwidth) << init.time
                   << std::setw(g_fwidth) << init.rate << std::setw(g_fwidth) << init.period
                   << std::setw(g_fwidth) << run.time << std::setw(g_fwidth) << run.rate
-                  << std::setw(g_fwidth) << run.period);
+                  << std::setw(g_fwidth) << run.period << std::setw(g_fwidth) << allocs);
 }
 
 BenchSuite::BenchSuite(ObjectFactory& factory,
                        uint64_t pop,
                        uint64_t total,
                        uint64_t runs,
+                       uint64_t removes,
                        Ptr<RandomVariableStream> eventStream,
                        bool calRev)
 {
-    Simulator::SetScheduler(factory);
-
     m_scheduler = factory.GetTypeId().GetName();
     if (m_scheduler == "ns3::CalendarScheduler")
     {
@@ -287,18 +365,22 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     bench.SetRandomStream(eventStream);
     bench.SetPopulation(pop);
     bench.SetTotal(total);
+    bench.SetRemoves(removes);
 
     m_results.reserve(runs);
     Header();
 
     // Prime
     DEB("priming");
+    Simulator::SetScheduler(factory);
     auto prime = bench.Run();
     Result::Bench(prime).Log("prime");
 
     // Perform the actual runs
     for (uint64_t i = 0; i < runs; i++)
     {
+        // Each run ends with Simulator::Destroy(), which forgets the scheduler.
+        Simulator::SetScheduler(factory);
         auto run = bench.Run();
         m_results.push_back(Result::Bench(run));
         m_results.back().Log(i);
@@ -320,12 +402,13 @@ BenchSuite::Header() const
                   << std::left << std::setw(g_fwidth) << "Rate (ev/s)" << std::left
                   << std::setw(g_fwidth) << "Per (s/ev)" << std::left << std::setw(g_fwidth)
                   << "Time (s)" << std::left << std::setw(g_fwidth) << "Rate (ev/s)" << std::left
-                  << "Per (s/ev)");
+                  << std::setw(g_fwidth) << "Per (s/ev)" << std::left << "Allocs/ev");
     LOG(std::setfill('-') << std::right << std::setw(g_fwidth) << " " << std::right
                           << std::setw(g_fwidth) << " " << std::right << std::setw(g_fwidth) << " "
                           << std::right << std::setw(g_fwidth) << " " << std::right
                           << std::setw(g_fwidth) << " " << std::right << std::setw(g_fwidth) << " "
-                          << std::right << std::setw(g_fwidth) << " " << std::setfill(' '));
+                          << std::right << std::setw(g_fwidth) << " " << std::right
+                          << std::setw(g_fwidth) << " " << std::setfill(' '));
 }
 
 void
@@ -346,7 +429,8 @@ BenchSuite::Log() const
     uint64_t n{0};                // number of samples
     Result average{m_results[0]}; // average
     Result moment2{{0, 0, 0},     // 2nd moment, to calculate stdev
-                   {0, 0, 0}};
+                   {0, 0, 0},
+                   0};
 
     for (; n < m_results.size(); ++n)
     {
@@ -369,6 +453,11 @@ BenchSuite::Log() const
         ACCUMULATE(run, period);
 
 #undef ACCUMULATE
+
+        deltaPre = run.allocs - average.allocs;
+        average.allocs += deltaPre / count;
+        deltaPost = run.allocs - average.allocs;
+        moment2.allocs += deltaPre * deltaPost;
     }
 
     auto stdev = Result{
@@ -378,6 +467,7 @@ BenchSuite::Log() const
         {std::sqrt(moment2.run.time / n),
          std::sqrt(moment2.run.rate / n),
          std::sqrt(moment2.run.period / n)},
+        std::sqrt(moment2.allocs / n),
     };
 
     average.Log("average");
@@ -457,6 +547,7 @@ main(int argc, char* argv[])
     bool allSched = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -464,6 +555,7 @@ main(int argc, char* argv[])
     uint64_t pop = 100000;
     uint64_t total = 1000000;
     uint64_t runs = 1;
+    uint64_t removes = 0;
     std::string filename = "";
     bool calRev = false;
 
@@ -477,11 +569,20 @@ main(int argc, char* argv[])
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
               "\n"
+              "The Allocs/ev column reports the heap allocations made for\n"
+              "events, per event created.  Compare with the EventImpl memory\n"
+              "pool disabled by setting NS_GLOBAL_VALUE=EventMemoryPool=false.\n"
+              "\n"
+              "With --removes=<n>, each event executed also removes n random\n"
+              "pending events, replacing each with a new one, to model timers\n"
+              "which are frequently cancelled and rescheduled.\n"
+              "\n"
               "If no scheduler is specified the MapScheduler will be run.");
     cmd.AddValue("all", "use all schedulers", allSched);
     cmd.AddValue("cal", "use CalendarScheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListScheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
@@ -489,6 +590,7 @@ main(int argc, char* argv[])
     cmd.AddValue("pop", "event population size", pop);
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
+    cmd.AddValue("removes", "number of events removed per event executed", removes);
     cmd.AddValue("file", "file of relative event times", filename);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
     cmd.Parse(argc, argv);
@@ -501,14 +603,15 @@ main(int argc, char* argv[])
     LOG("  Event population size:        " << pop);
     LOG("  Total events per run:         " << total);
     LOG("  Number of runs per scheduler: " << runs);
+    LOG("  Removals per event:           " << removes);
     DEB("debugging is ON");
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
@@ -520,17 +623,22 @@ main(int argc, char* argv[])
     {
         factory.SetTypeId("ns3::CalendarScheduler");
         factory.Set("Reverse", BooleanValue(calRev));
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, total, runs, removes, eventStream, calRev).Log();
         if (allSched)
         {
             factory.Set("Reverse", BooleanValue(!calRev));
-            BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            BenchSuite(factory, pop, total, runs, removes, eventStream, !calRev).Log();
         }
     }
     if (schedHeap)
     {
         factory.SetTypeId("ns3::HeapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, total, runs, removes, eventStream, calRev).Log();
+    }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        BenchSuite(factory, pop, total, runs, removes, eventStream, calRev).Log();
     }
     if (schedList)
     {
@@ -541,17 +649,17 @@ main(int argc, char* argv[])
             LOG("Running List scheduler with 1/10 total events");
             listTotal /= 10;
         }
-        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, listTotal, runs, removes, eventStream, calRev).Log();
     }
     if (schedMap)
     {
         factory.SetTypeId("ns3::MapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, total, runs, removes, eventStream, calRev).Log();
     }
     if (schedPQ)
     {
         factory.SetTypeId("ns3::PriorityQueueScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, total, runs, removes, eventStream, calRev).Log();
     }
 
     return 0;
@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the time taken by the common Time and int64x64_t
+// operations: conversions to and from the units, arithmetic, and the
+// transmission time computed by DataRate::CalculateBytesTxTime().
+// Sample usage:  ./ns3 run 'bench-time --operations=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/int64x64.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** Output field width for numeric data. */
+const int g_fwidth = 12;
+
+/** Output field width for the operation names. */
+const int g_nwidth = 28;
+
+/**
+ * Accumulator of the results, so that the operations are not optimized out.
+ */
+static int64_t g_sink = 0;
+
+/**
+ * A benchmarked operation.
+ */
+struct Operation
+{
+    std::string name;                     //!< The name of the operation.
+    std::function<int64_t(uint64_t)> run; //!< Run the operation on an index.
+};
+
+/**
+ * Time an operation, and print the result.
+ * \param [in] operation The operation.
+ * \param [in] count The number of times to run the operation.
+ */
+static void
+RunBench(const Operation& operation, uint64_t count)
+{
+    const auto& run = operation.run;
+    SystemWallClockMs timer;
+    timer.Start();
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        g_sink += run(i);
+    }
+    int64_t elapsed = timer.End();
+    std::cout << std::left << std::setw(g_nwidth) << operation.name << std::right
+              << std::setw(g_fwidth) << elapsed << std::setw(g_fwidth) << std::fixed
+              << std::setprecision(2) << elapsed * 1e6 / count << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t operations = 10000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the common Time operations.\n"
+              "Each operation runs on values which change with each call; the\n"
+              "times are the total, in milliseconds, and per operation, in\n"
+              "nanoseconds, including the loop overhead.");
+    cmd.AddValue("operations", "Number of runs of each operation", operations);
+    cmd.Parse(argc, argv);
+
+    // Freeze the resolution, as a running simulation does, so that the
+    // Time constructors no longer record the new instances
+    Simulator::Run();
+
+    const Time base = MilliSeconds(1234);
+    const int64x64_t rate(100000000); // DataRate of 100 Mb/s, in bits per second
+    const int64x64_t fraction(0.3);
+
+    const std::vector<Operation> benches = {
+        {"Seconds(double)", [](uint64_t i) { return Seconds(i * 1e-6).GetTimeStep(); }},
+        {"NanoSeconds(int)", [](uint64_t i) { return NanoSeconds(i).GetTimeStep(); }},
+        {"MicroSeconds(int)", [](uint64_t i) { return MicroSeconds(i).GetTimeStep(); }},
+        {"GetSeconds()",
+         [&base](uint64_t i) {
+             return static_cast<int64_t>((base + NanoSeconds(i)).GetSeconds());
+         }},
+        {"GetMilliSeconds()", [](uint64_t i) { return NanoSeconds(i).GetMilliSeconds(); }},
+        {"GetMicroSeconds()", [](uint64_t i) { return NanoSeconds(i).GetMicroSeconds(); }},
+        {"Time + Time", [&base](uint64_t i) { return (base + NanoSeconds(i)).GetTimeStep(); }},
+        {"Time * int", [&base](uint64_t i) { return (base * (i & 0xff)).GetTimeStep(); }},
+        {"Time * double", [&base](uint64_t i) { return (base * (i * 1e-3)).GetTimeStep(); }},
+        {"Time / int", [&base](uint64_t i) { return (base / ((i & 0xff) + 1)).GetTimeStep(); }},
+        {"Time / Time", [&base](uint64_t i) { return (base / NanoSeconds(i + 1)).GetHigh(); }},
+        {"int64x64_t * int64x64_t",
+         [&fraction](uint64_t i) { return (int64x64_t(i) * fraction).GetHigh(); }},
+        {"int64x64_t / int64x64_t",
+         [&fraction](uint64_t i) { return (int64x64_t(i) / fraction).GetHigh(); }},
+        {"CalculateBytesTxTime()",
+         [&rate](uint64_t i) {
+             // As DataRate::CalculateBytesTxTime(), which is not in this module
+             return Seconds(int64x64_t((i & 0xfff) * 8) / rate).GetTimeStep();
+         }},
+    };
+
+    std::cout << std::left << std::setw(g_nwidth) << "Operation" << std::right
+              << std::setw(g_fwidth) << "Total (ms)" << std::setw(g_fwidth) << "Per op (ns)"
+              << std::endl;
+    for (const auto& bench : benches)
+    {
+        RunBench(bench, operations);
+    }
+    Simulator::Destroy();
+    if (g_sink == 0)
+    {
+        std::cerr << "Unexpected null result" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of firing packet trace sources with 0, 1
+// and 4 connected sinks: TracedCallbacks fired directly, and the packets
+// sent through a pair of PointToPointNetDevices, whose trace sources all
+// get the sinks.
+// Sample usage:  ./ns3 run 'bench-traced-callback --sources=1000 --packets=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/traced-callback.h"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** Output field width for numeric data. */
+const int g_fwidth = 12;
+
+/** The numbers of sinks connected to each trace source. */
+const std::vector<uint32_t> g_sinks = {0, 1, 4};
+
+/** The packet trace sources of PointToPointNetDevice. */
+const std::vector<std::string> g_sources = {"MacTx",
+                                            "MacTxDrop",
+                                            "MacPromiscRx",
+                                            "MacRx",
+                                            "PhyTxBegin",
+                                            "PhyTxEnd",
+                                            "PhyTxDrop",
+                                            "PhyRxEnd",
+                                            "PhyRxDrop",
+                                            "Sniffer",
+                                            "PromiscSniffer"};
+
+/** Number of invocations of the sinks. */
+static uint64_t g_count = 0;
+
+/**
+ * Packet trace sink.
+ * \param [in] packet The packet.
+ */
+static void
+PacketSink(Ptr<const Packet> packet [[maybe_unused]])
+{
+    ++g_count;
+}
+
+/**
+ * Time the invocations of chains of Callbacks.
+ *
+ * The sinks are connected to the chains in turn, and the chains invoked
+ * in turn, as the trace sources of many objects would be.
+ *
+ * \param [in] sinks The number of sinks to connect to each chain.
+ * \param [in] sources The number of chains.
+ * \param [in] calls The number of invocations.
+ * \returns The time taken, in milliseconds.
+ */
+template <typename T>
+static int64_t
+BenchTrace(uint32_t sinks, uint32_t sources, uint64_t calls)
+{
+    std::vector<T> traces(sources);
+    for (uint32_t i = 0; i < sinks; ++i)
+    {
+        for (auto& trace : traces)
+        {
+            trace.ConnectWithoutContext(MakeCallback(&PacketSink));
+        }
+    }
+    Ptr<const Packet> packet = Create<Packet>(100);
+    SystemWallClockMs timer;
+    timer.Start();
+    for (uint64_t i = 0; i < calls; ++i)
+    {
+        traces[i % sources](packet);
+    }
+    return timer.End();
+}
+
+/**
+ * Time the transmission of packets between two PointToPointNetDevices.
+ * \param [in] sinks The number of sinks to connect to each trace source.
+ * \param [in] packets The number of packets.
+ * \returns The time taken, in milliseconds.
+ */
+static int64_t
+BenchDevice(uint32_t sinks, uint64_t packets)
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("100Gbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("1us"));
+    NetDeviceContainer devices = p2p.Install(nodes);
+    for (uint32_t d = 0; d < devices.GetN(); ++d)
+    {
+        for (const auto& source : g_sources)
+        {
+            for (uint32_t i = 0; i < sinks; ++i)
+            {
+                devices.Get(d)->TraceConnectWithoutContext(source, MakeCallback(&PacketSink));
+            }
+        }
+    }
+
+    // Send the packets in bursts which fit in the transmit queue
+    const uint64_t burst = 50;
+    Ptr<NetDevice> device = devices.Get(0);
+    Address destination = devices.Get(1)->GetAddress();
+    SystemWallClockMs timer;
+    timer.Start();
+    for (uint64_t sent = 0; sent < packets; sent += burst)
+    {
+        for (uint64_t i = 0; i < burst; ++i)
+        {
+            device->Send(Create<Packet>(100), destination, 0x0800);
+        }
+        Simulator::Run();
+    }
+    int64_t elapsed = timer.End();
+    Simulator::Destroy();
+    return elapsed;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t sources = 1000;
+    uint64_t calls = 10000000;
+    uint64_t packets = 1000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the firing of TracedCallbacks.\n"
+              "The times are in milliseconds.  The TracedCallback column is\n"
+              "TracedCallbacks fired in turn for a number of trace sources.\n"
+              "The Device column is the packets sent between two\n"
+              "PointToPointNetDevices, whose packet trace sources all get the sinks.");
+    cmd.AddValue("sources", "Number of trace sources invoked directly", sources);
+    cmd.AddValue("calls", "Number of direct invocations", calls);
+    cmd.AddValue("packets", "Number of packets sent between the devices", packets);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::setw(g_fwidth) << "Sinks" << std::setw(g_fwidth + 4) << "TracedCallback"
+              << std::setw(g_fwidth) << "Device" << std::endl;
+    for (auto sinks : g_sinks)
+    {
+        auto tracedTime = BenchTrace<TracedCallback<Ptr<const Packet>>>(sinks, sources, calls);
+        auto deviceTime = BenchDevice(sinks, packets);
+        std::cout << std::setw(g_fwidth) << sinks << std::setw(g_fwidth + 4) << tracedTime
+                  << std::setw(g_fwidth) << deviceTime << std::endl;
+    }
+    if (g_count == 0)
+    {
+        std::cerr << "No sink invoked" << std::endl;
+    }
+    return 0;
+}
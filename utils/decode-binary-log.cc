@@ -0,0 +1,65 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup utils
+ * Print the messages of a binary log written with LogSetBinaryFile().
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/log.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Print the messages of a binary log as the NS_LOG macros would have.");
+    cmd.AddNonOption("input", "The binary log file.", input);
+    cmd.AddValue("output", "The text file, instead of the standard output.", output);
+    cmd.Parse(argc, argv);
+
+    std::ifstream is(input, std::ios::binary);
+    if (!is.is_open())
+    {
+        std::cerr << "Cannot open " << input << std::endl;
+        return 1;
+    }
+    std::ofstream ofs;
+    if (!output.empty())
+    {
+        ofs.open(output);
+        if (!ofs.is_open())
+        {
+            std::cerr << "Cannot open " << output << std::endl;
+            return 1;
+        }
+    }
+
+    if (!LogBinaryDecode(is, output.empty() ? std::cout : ofs))
+    {
+        std::cerr << input << " is truncated or corrupted" << std::endl;
+        return 1;
+    }
+    return 0;
+}